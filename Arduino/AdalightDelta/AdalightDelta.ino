@@ -0,0 +1,177 @@
+/*
+ * AdalightDelta.ino
+ *
+ *  Created on: 19.10.2026
+ *     Project: Lightpack
+ *
+ *  Reference decoder of the "Adz" (delta) variant of the Adalight protocol,
+ *  see Software/src/AdalightDeltaCodec.hpp for the packet format.
+ *  Plain "Ada" frames are accepted too, so the sketch works with both modes.
+ *
+ *  Lightpack is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Lightpack is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <FastLED.h>
+
+#define NUM_LEDS        255
+#define DATA_PIN        6
+#define SERIAL_RATE     115200
+#define BYTE_TIMEOUT_MS 100
+
+#define FILL_FLAG       0x80
+
+CRGB leds[NUM_LEDS];
+
+// Deltas are applied to the colors of previous frames only after keyframe
+bool haveKeyframe = false;
+
+int readByte()
+{
+    unsigned long start = millis();
+
+    while (Serial.available() == 0)
+    {
+        if (millis() - start > BYTE_TIMEOUT_MS)
+            return -1;
+    }
+    return Serial.read();
+}
+
+bool readColor(CRGB & color)
+{
+    int r = readByte();
+    int g = readByte();
+    int b = readByte();
+
+    if (r < 0 || g < 0 || b < 0)
+        return false;
+
+    color = CRGB(r, g, b);
+    return true;
+}
+
+bool readAda(int ledsCount)
+{
+    for (int i = 0; i < ledsCount; i++)
+    {
+        CRGB color;
+        if (readColor(color) == false)
+            return false;
+        if (i < NUM_LEDS)
+            leds[i] = color;
+    }
+    return true;
+}
+
+bool readAdz(int ledsCount)
+{
+    int type = readByte();
+    int spansHi = readByte();
+    int spansLo = readByte();
+
+    if (spansLo < 0)
+        return false;
+
+    if (type == 'K')
+    {
+        fill_solid(leds, NUM_LEDS, CRGB::Black);
+        haveKeyframe = true;
+    }
+    else if (type != 'D')
+    {
+        return false;
+    }
+
+    // Spans of the delta are still read to keep sync with the stream
+    bool isApplied = haveKeyframe;
+    int spansCount = (spansHi << 8) | spansLo;
+
+    for (int span = 0; span < spansCount; span++)
+    {
+        int startHi = readByte();
+        int startLo = readByte();
+        int control = readByte();
+
+        if (control < 0)
+            return false;
+
+        int start = (startHi << 8) | startLo;
+        int spanLeds = (control & ~FILL_FLAG) + 1;
+
+        if (start + spanLeds > ledsCount)
+            return false;
+
+        if (control & FILL_FLAG)
+        {
+            CRGB color;
+            if (readColor(color) == false)
+                return false;
+
+            for (int i = start; isApplied && i < start + spanLeds && i < NUM_LEDS; i++)
+                leds[i] = color;
+        } else {
+            for (int i = start; i < start + spanLeds; i++)
+            {
+                CRGB color;
+                if (readColor(color) == false)
+                    return false;
+                if (isApplied && i < NUM_LEDS)
+                    leds[i] = color;
+            }
+        }
+    }
+
+    return isApplied;
+}
+
+void setup()
+{
+    FastLED.addLeds<WS2812B, DATA_PIN, RGB>(leds, NUM_LEDS);
+    FastLED.show();
+
+    Serial.begin(SERIAL_RATE);
+}
+
+void loop()
+{
+    // Look for 'A' 'd' then 'a' or 'z'
+    if (readByte() != 'A' || readByte() != 'd')
+        return;
+
+    int variant = readByte();
+    if (variant != 'a' && variant != 'z')
+        return;
+
+    int countHi = readByte();
+    int countLo = readByte();
+    int checksum = readByte();
+
+    if (checksum < 0 || checksum != (countHi ^ countLo ^ 0x55))
+        return;
+
+    int ledsCount = ((countHi << 8) | countLo) + 1;
+
+    bool ok = (variant == 'a') ? readAda(ledsCount) : readAdz(ledsCount);
+
+    if (ok)
+    {
+        FastLED.show();
+    }
+    else if (variant == 'z')
+    {
+        // Part of delta may be lost, wait for the next keyframe
+        haveKeyframe = false;
+    }
+}
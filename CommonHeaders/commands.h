@@ -36,10 +36,20 @@ enum COMMANDS{
     CMD_SET_PWM_LEVEL_MAX_VALUE, /* deprecated */
     CMD_SET_SMOOTH_SLOWDOWN,
     CMD_SET_BRIGHTNESS,
+    CMD_UPDATE_LEDS_PARTIAL,
+    CMD_SET_SMOOTH_OPTIONS,
+    CMD_REQUEST_FEEDBACK,
 
     CMD_NOP = 0x0F
 };
 
+// Curves of smooth change colors, CMD_SET_SMOOTH_OPTIONS
+enum SMOOTH_CURVES{
+    SMOOTH_CURVE_LINEAR,
+    SMOOTH_CURVE_EASE_OUT,
+    SMOOTH_CURVE_EXPONENTIAL,
+};
+
 enum PRESCALLERS{
     CMD_SET_PRESCALLER_1,
     CMD_SET_PRESCALLER_8,
@@ -54,4 +64,23 @@ enum DATA_VERSION_INDEXES{
     INDEX_FW_VER_MINOR,
 };
 
+// Id of the frame in CMD_UPDATE_LEDS and CMD_UPDATE_LEDS_PARTIAL, two bytes
+// after colors of all LEDs, low byte first. Id 0 is for frames without id
+enum DATA_FRAME_ID_INDEXES{
+    INDEX_FRAME_ID = 61,
+};
+
+// Feedback in the IN report after the firmware version, 16-bit values with
+// low byte first. Tick is the frame boundary of the timer ISR: each timer
+// interrupt on hw6, each PWM period on hw4 and hw5.
+// Firmware takes feedback on CMD_REQUEST_FEEDBACK, the report doesn't change till the next one
+enum DATA_FEEDBACK_INDEXES{
+    INDEX_LATCHED_FRAME_ID = 3,     // id of the last frame shown by LED drivers
+    INDEX_LATCHED_TICK = 5,         // tick when it was shown
+    INDEX_CURRENT_TICK = 7,         // tick when CMD_REQUEST_FEEDBACK was processed
+    INDEX_TICK_US = 9,              // tick duration in microseconds, includes ISR run time on hw4 and hw5
+    INDEX_DROPPED_FRAMES = 11,      // frames replaced by the next one before they were shown
+    INDEX_ISR_OVERRUNS = 13,        // timer interrupts lost while the ISR was running
+};
+
 #endif /* COMMANDS_H_INCLUDED */
@@ -43,23 +43,23 @@
 
 static const uint8_t LedsNumberForOneDriver = 5;
 
-static inline void _SPI_Write12(uint16_t byte)
+// 12-bit words of both drivers: 16 channels each, channel 15 isn't connected
+#define DRIVERS_WORDS_COUNT  32
+
+static uint16_t s_driversWords[DRIVERS_WORDS_COUNT];
+
+static inline void _SPI_Write8(const uint8_t byte)
 {
-    CLR(MOSI_PIN);
+    SPDR = byte;
+    while ((SPSR & (1 << SPIF)) == false) { }
+}
 
-    // 12-bits
-    for (uint16_t bit = 0x0800; bit != 0; bit >>= 1)
-    {
-        if (byte & bit)
-        {
-            SET(MOSI_PIN);
-        } else {
-            CLR(MOSI_PIN);
-        }
-
-        SET(SCK_PIN);
-        CLR(SCK_PIN);
-    }
+// Two 12-bit words are shifted out as 3 bytes, MSB first
+static inline void _SPI_Write24(const uint16_t first, const uint16_t second)
+{
+    _SPI_Write8(first >> 4);
+    _SPI_Write8(((first & 0x0f) << 4) | ((second >> 8) & 0x0f));
+    _SPI_Write8(second & 0xff);
 }
 
 static inline void _LedDriver_LatchPulse(void)
@@ -79,6 +79,11 @@ void LedDriver_Init(void)
     CLR(SCK_PIN);
     CLR(MOSI_PIN);
 
+    // Setup SPI Master with max SPI clock speed (F_CPU / 2), mode 0, MSB first.
+    // LATCH_PIN is SS, it is output so SPI stays in master mode
+    SPSR = (1 << SPI2X);
+    SPCR = (1 << SPE) | (1 << MSTR);
+
     LedDriver_OffLeds();
 }
 
@@ -92,32 +97,37 @@ void LedDriver_Update(const RGB_t imageFrame[LEDS_COUNT])
     //       5     4     3     2     1
     // 0 B G R B G R B G R B G R B G R
 
-    _SPI_Write12(0);
+    uint16_t *word = s_driversWords;
+
+    *word++ = 0;
 
     for (uint8_t i = LedsNumberForOneDriver; i < LEDS_COUNT; i++)
     {
-        _SPI_Write12(imageFrame[i].b);
-        _SPI_Write12(imageFrame[i].g);
-        _SPI_Write12(imageFrame[i].r);
+        *word++ = imageFrame[i].b;
+        *word++ = imageFrame[i].g;
+        *word++ = imageFrame[i].r;
     }
 
-    _SPI_Write12(0);
-
+    *word++ = 0;
 
     for (uint8_t i = 0; i < LedsNumberForOneDriver; i++)
     {
-        _SPI_Write12(imageFrame[i].b);
-        _SPI_Write12(imageFrame[i].g);
-        _SPI_Write12(imageFrame[i].r);
+        *word++ = imageFrame[i].b;
+        *word++ = imageFrame[i].g;
+        *word++ = imageFrame[i].r;
     }
 
+    // 48 bytes on the hardware SPI instead of 384 bit-banged bits
+    for (uint8_t i = 0; i < DRIVERS_WORDS_COUNT; i += 2)
+        _SPI_Write24(s_driversWords[i], s_driversWords[i + 1]);
+
     _LedDriver_LatchPulse();
 }
 
 void LedDriver_OffLeds(void)
 {
-    for (uint8_t i = 0; i < 16; i++)
-        _SPI_Write12(0x0000);
+    for (uint8_t i = 0; i < 16; i += 2)
+        _SPI_Write24(0x0000, 0x0000);
 
     _LedDriver_LatchPulse();
 }
@@ -23,72 +23,248 @@
 
 #include "Lightpack.h"
 #include "LedDriver.h"
+#include "LedManager.h"
+
+#include "../CommonHeaders/COMMANDS.h"
+
+RGB_t * LedManager_BeginBackImage(const uint8_t isFullFrame)
+{
+    uint8_t isBackLatest;
+
+    ATOMIC_BLOCK( ATOMIC_RESTORESTATE ){
+        // Take back image from timer ISR if it isn't swapped yet
+        isBackLatest = g_Images.isBackReady;
+        g_Images.isBackReady = false;
+    }
+
+    // Frame which wasn't shown is replaced by the new one
+    if (isBackLatest)
+        g_Feedback.droppedFramesCount++;
+
+    // Otherwise back image is the previous frame, ISR doesn't write end image
+    // so it is copied without lock
+    if (isBackLatest == false && isFullFrame == false)
+        memcpy(g_Images.back, g_Images.end, sizeof(RGB_t) * LEDS_COUNT);
+
+    return g_Images.back;
+}
+
+void LedManager_SubmitBackImage(const uint16_t changedMask, const uint8_t isJump)
+{
+    ATOMIC_BLOCK( ATOMIC_RESTORESTATE ){
+        g_Images.backChangedMask |= changedMask;
+        g_Images.isBackJump |= isJump;
+        g_Images.isBackReady = true;
+    }
+}
 
 void LedManager_FillImages(const uint8_t red, const uint8_t green, const uint8_t blue)
 {
+    RGB_t *image = LedManager_BeginBackImage(true);
+
     for (uint8_t i = 0; i < LEDS_COUNT; i++)
     {
-        g_Images.start[i].r = red;
-        g_Images.start[i].g = green;
-        g_Images.start[i].b = blue;
+        image[i].r = red;
+        image[i].g = green;
+        image[i].b = blue;
+    }
 
-        g_Images.current[i].r = red;
-        g_Images.current[i].g = green;
-        g_Images.current[i].b = blue;
+    // Not a frame of the host
+    g_Images.backFrameId = 0;
 
-        g_Images.end[i].r = red;
-        g_Images.end[i].g = green;
-        g_Images.end[i].b = blue;
-    }
+    LedManager_SubmitBackImage(ALL_LEDS_MASK, true);
 }
 
 #if (LIGHTPACK_HW == 6)
+typedef uint32_t ScaledColor_t;
+#else
+typedef uint16_t ScaledColor_t;
+#endif
+
+// Image scaled by g_Settings.brightness, it is shown instead of the source one.
+// It is scaled again only when brightness, source image or its colors change
+static RGB_t s_brightnessImage[LEDS_COUNT];
+static const RGB_t * s_brightnessSource;
+static volatile uint8_t s_isBrightnessImageValid;
+
+void LedManager_SetBrightness(const uint16_t brightness)
+{
+    // Timer ISR reads 16-bit brightness
+    ATOMIC_BLOCK( ATOMIC_RESTORESTATE ){
+        g_Settings.brightness = brightness;
+        s_isBrightnessImageValid = false;
+    }
+}
+
+static inline const RGB_t * _ApplyBrightness(const RGB_t * image)
+{
+    if (g_Settings.brightness >= 256)
+        return image;
+
+    if (s_isBrightnessImageValid && image == s_brightnessSource)
+        return s_brightnessImage;
+
+    for (uint8_t i = 0; i < LEDS_COUNT; i++)
+    {
+        s_brightnessImage[i].r = ((ScaledColor_t)image[i].r * g_Settings.brightness) >> 8;
+        s_brightnessImage[i].g = ((ScaledColor_t)image[i].g * g_Settings.brightness) >> 8;
+        s_brightnessImage[i].b = ((ScaledColor_t)image[i].b * g_Settings.brightness) >> 8;
+    }
+
+    s_brightnessSource = image;
+    s_isBrightnessImageValid = true;
+
+    return s_brightnessImage;
+}
 
+// Called from timer ISR at the frame boundary, never waits for the USB
+static inline void _SwapImages(void)
+{
+    g_Feedback.tick++;
+
+    if (g_Images.isBackReady == false)
+        return;
+
+    g_Feedback.latchedFrameId = g_Images.backFrameId;
+    g_Feedback.latchedTick = g_Feedback.tick;
+
+    RGB_t *front = g_Images.back;
+    g_Images.back = g_Images.end;
+    g_Images.end = front;
+
+    uint16_t changedMask = g_Images.backChangedMask;
+
+    for (uint8_t i = 0; i < LEDS_COUNT; i++, changedMask >>= 1)
+    {
+        if (g_Images.isBackJump)
+        {
+            g_Images.current[i].r = g_Images.start[i].r = g_Images.end[i].r;
+            g_Images.current[i].g = g_Images.start[i].g = g_Images.end[i].g;
+            g_Images.current[i].b = g_Images.start[i].b = g_Images.end[i].b;
+
+        } else if (changedMask & 1) {
+
+            g_Images.start[i].r = g_Images.current[i].r;
+            g_Images.start[i].g = g_Images.current[i].g;
+            g_Images.start[i].b = g_Images.current[i].b;
+
+            // If pixel changed, then restart smooth algorithm
+            // for current pixel by clearing smoothIndex
+            if (g_Images.start[i].r != g_Images.end[i].r ||
+                g_Images.start[i].g != g_Images.end[i].g ||
+                g_Images.start[i].b != g_Images.end[i].b)
+            {
+                g_Images.smoothIndex[i] = 0;
+            }
+        }
+    }
+
+    g_Images.backChangedMask = 0;
+    g_Images.isBackJump = false;
+    g_Images.isBackReady = false;
+
+    s_isBrightnessImageValid = false;
+}
+
+// Progress of the smooth change by linear or ease-out curve, 0..0xffff
+static inline uint16_t _SmoothProgress(const uint8_t smoothIndex)
+{
+    // smoothIndex < smoothSlowdown, so it doesn't overflow
+    uint16_t progress = smoothIndex * g_Settings.smoothReciprocal;
+
+    if (g_Settings.smoothCurve == SMOOTH_CURVE_EASE_OUT)
+    {
+        // 1 - (1 - progress)^2, fast start and slow finish
+        uint16_t rest = 0xffff - progress;
+        progress = 0xffff - (((uint32_t)rest * rest) >> 16);
+    }
+
+    return progress;
+}
+
+static inline uint16_t _Interpolate(const uint16_t start, const uint16_t end, const uint16_t progress)
+{
+    return start + ((((int32_t)end - start) * progress) >> 16);
+}
+
+// Exponential curve: each step passes smoothExpCoef part of the rest way
+static inline uint16_t _Approach(const uint16_t current, const uint16_t end)
+{
+    return current + ((((int32_t)end - current) * g_Settings.smoothExpCoef + 0x8000) >> 16);
+}
+
+// Smooth change evaluation without division: progress is smoothIndex multiplied
+// by the reciprocal of smoothSlowdown, which is evaluated in LedManager_UpdateSmoothSteps()
 void EvalCurrentImage_SmoothlyAlg(void)
 {
     for (uint8_t i = 0; i < LEDS_COUNT; i++)
     {
         if (g_Images.smoothIndex[i] >= g_Settings.smoothSlowdown)
         {
+            // Last step of the smooth change may leave current image short of the end one
+            if (g_Images.current[i].r != g_Images.end[i].r ||
+                g_Images.current[i].g != g_Images.end[i].g ||
+                g_Images.current[i].b != g_Images.end[i].b)
+            {
+                s_isBrightnessImageValid = false;
+            }
+
             // Smooth change colors complete, rewrite start image
             g_Images.current[i].r = g_Images.start[i].r = g_Images.end[i].r;
             g_Images.current[i].g = g_Images.start[i].g = g_Images.end[i].g;
             g_Images.current[i].b = g_Images.start[i].b = g_Images.end[i].b;
 
-        } else {
-            uint32_t coefEnd = ((uint32_t)g_Images.smoothIndex[i] << 16) / g_Settings.smoothSlowdown;
-            uint32_t coefStart = (1UL << 16) - coefEnd;
+        } else if (g_Settings.smoothCurve == SMOOTH_CURVE_EXPONENTIAL) {
+
+            g_Images.current[i].r = _Approach(g_Images.current[i].r, g_Images.end[i].r);
+            g_Images.current[i].g = _Approach(g_Images.current[i].g, g_Images.end[i].g);
+            g_Images.current[i].b = _Approach(g_Images.current[i].b, g_Images.end[i].b);
 
-            g_Images.current[i].r = (
-                    coefStart * g_Images.start[i].r +
-                    coefEnd   * g_Images.end  [i].r) >> 16;
+            g_Images.smoothIndex[i]++;
+            s_isBrightnessImageValid = false;
 
-            g_Images.current[i].g = (
-                    coefStart * g_Images.start[i].g +
-                    coefEnd   * g_Images.end  [i].g) >> 16;
+        } else {
+            uint16_t progress = _SmoothProgress(g_Images.smoothIndex[i]);
 
-            g_Images.current[i].b = (
-                    coefStart * g_Images.start[i].b +
-                    coefEnd   * g_Images.end  [i].b) >> 16;
+            g_Images.current[i].r = _Interpolate(g_Images.start[i].r, g_Images.end[i].r, progress);
+            g_Images.current[i].g = _Interpolate(g_Images.start[i].g, g_Images.end[i].g, progress);
+            g_Images.current[i].b = _Interpolate(g_Images.start[i].b, g_Images.end[i].b, progress);
 
             g_Images.smoothIndex[i]++;
+            s_isBrightnessImageValid = false;
         }
     }
 }
 
+#if (LIGHTPACK_HW == 6)
+
+// Timer runs free, compare interrupt comes once in 0x10000 ticks
+static inline uint16_t _SmoothStepUs(void)
+{
+    return 0x10000UL / (F_CPU / 1000000UL);
+}
+
 void LedManager_UpdateColors(void)
 {
+    _SwapImages();
     EvalCurrentImage_SmoothlyAlg();
 
     if (g_Settings.isSmoothEnabled)
-    	LedDriver_Update(g_Images.current);
+    	LedDriver_Update(_ApplyBrightness(g_Images.current));
     else
-    	LedDriver_Update(g_Images.end);
+    	LedDriver_Update(_ApplyBrightness(g_Images.end));
 }
 
 
 #elif (LIGHTPACK_HW == 5 || LIGHTPACK_HW == 4)
 
+// Time when LEDs are switched OFF between PWM periods, in 256 timer ticks
+static const uint8_t PwmOffTime = 50;
+
+// Timer ticks of the ISR entry and run time, timer is cleared at the end of the ISR,
+// so each PWM step takes this time more than OCR1A ticks
+static volatile uint16_t s_stepOverheadTicks;
+
 
 static inline void _StartConstantTime(void)
 {
@@ -100,72 +276,66 @@ static inline void _EndConstantTime(const uint8_t time)
     while(TCNT1 < time * 256UL) { }
 }
 
-void EvalCurrentImage_SmoothlyAlg(void)
+// Smooth step is made once in PWM period
+static inline uint16_t _SmoothStepUs(void)
 {
-    for (uint8_t i = 0; i < LEDS_COUNT; i++)
-    {
-        if (g_Images.smoothIndex[i] >= g_Settings.smoothSlowdown)
-        {
-            // Smooth change colors complete, rewrite start image
-            g_Images.current[i].r = g_Images.start[i].r = g_Images.end[i].r;
-            g_Images.current[i].g = g_Images.start[i].g = g_Images.end[i].g;
-            g_Images.current[i].b = g_Images.start[i].b = g_Images.end[i].b;
-
-        } else {
-            uint16_t coefEnd = ((uint16_t)g_Images.smoothIndex[i] << 8) / g_Settings.smoothSlowdown;
-            uint16_t coefStart = (1UL << 8) - coefEnd;
+    uint16_t overheadTicks;
 
-            g_Images.current[i].r = (
-                    coefStart * g_Images.start[i].r +
-                    coefEnd   * g_Images.end  [i].r) >> 8;
-
-            g_Images.current[i].g = (
-                    coefStart * g_Images.start[i].g +
-                    coefEnd   * g_Images.end  [i].g) >> 8;
+    ATOMIC_BLOCK( ATOMIC_RESTORESTATE ){
+        overheadTicks = s_stepOverheadTicks;
+    }
 
-            g_Images.current[i].b = (
-                    coefStart * g_Images.start[i].b +
-                    coefEnd   * g_Images.end  [i].b) >> 8;
+    uint32_t periodTicks = (uint32_t)g_Settings.maxPwmValue * (g_Settings.timerOutputCompareRegValue + overheadTicks) + PwmOffTime * 256UL;
 
-            g_Images.smoothIndex[i]++;
-        }
-    }
+    return periodTicks / (F_CPU / 1000000UL);
 }
 
 static inline void _PulseWidthModulation(void)
 {
     static uint8_t s_pwmIndex = 0; // index of current PWM level
+    static const RGB_t * s_pwmImage = g_Images.frames[0]; // image shown in current PWM period
+
+    uint8_t isPeriodStart = (s_pwmIndex == g_Settings.maxPwmValue);
 
-    if (s_pwmIndex == g_Settings.maxPwmValue)
+    if (isPeriodStart)
     {
         s_pwmIndex = 0;
 
         _StartConstantTime();
 
-        // Switch OFF LEDs on time sets in g_Settings.brightness
+        // Switch OFF LEDs on PwmOffTime
         LedDriver_OffLeds();
 
-        // Also eval current image
+        // New frame is taken only between PWM periods
+        _SwapImages();
+
+        // Also eval current image and scale it once for the whole PWM period
         if (g_Settings.isSmoothEnabled)
         {
             EvalCurrentImage_SmoothlyAlg();
+            s_pwmImage = _ApplyBrightness(g_Images.current);
+        } else {
+            s_pwmImage = _ApplyBrightness(g_Images.end);
         }
 
-        _EndConstantTime(g_Settings.brightness);
-    }
-
+        _EndConstantTime(PwmOffTime);
 
-    if (g_Settings.isSmoothEnabled)
-    {
-        LedDriver_UpdatePWM(g_Images.current, s_pwmIndex);
-    } else {
-        LedDriver_UpdatePWM(g_Images.end, s_pwmIndex);
+        // Timer passed OCR1A while LEDs were off, it isn't an overrun
+        TIFR1 = _BV(OCF1A);
     }
 
+    LedDriver_UpdatePWM(s_pwmImage, s_pwmIndex);
+
     s_pwmIndex++;
 
+    uint16_t stepTicks = TCNT1;
+
     // Clear timer counter
     TCNT1 = 0x0000;
+
+    // Timer of the first step is cleared when LEDs are switched off, other steps are measured
+    if (isPeriodStart == false && stepTicks > OCR1A)
+        s_stepOverheadTicks = stepTicks - OCR1A;
 }
 
 void LedManager_UpdateColors(void)
@@ -174,3 +344,59 @@ void LedManager_UpdateColors(void)
 }
 
 #endif
+
+uint16_t LedManager_TickUs(void)
+{
+    return _SmoothStepUs();
+}
+
+static void _UpdateSmoothSteps(const uint8_t curve)
+{
+    // Divisions are here, not in the timer interrupt
+    uint8_t slowdown = g_Settings.smoothSteps;
+    uint16_t reciprocal = 0;
+    uint16_t expCoef = 0;
+
+    if (g_Settings.smoothTimeMs != 0)
+    {
+        uint32_t steps = ((uint32_t)g_Settings.smoothTimeMs * 1000UL) / _SmoothStepUs();
+
+        if (steps == 0)
+            steps = 1;
+        else if (steps > 0xff)
+            steps = 0xff;
+
+        slowdown = steps;
+    }
+
+    if (slowdown != 0)
+    {
+        reciprocal = 0xffff / slowdown;
+
+        // Rest of the way after slowdown steps is exp(-5) < 1%, it is done by the last step
+        uint32_t coef = 5UL * reciprocal;
+        expCoef = (coef > 0xffff) ? 0xffff : coef;
+    }
+
+    // Timer ISR must not see new number of steps with old reciprocal
+    ATOMIC_BLOCK( ATOMIC_RESTORESTATE ){
+        g_Settings.isSmoothEnabled = (slowdown != 0);
+        g_Settings.smoothSlowdown = slowdown;
+        g_Settings.smoothCurve = curve;
+        g_Settings.smoothReciprocal = reciprocal;
+        g_Settings.smoothExpCoef = expCoef;
+    }
+}
+
+void LedManager_UpdateSmoothSteps(void)
+{
+    _UpdateSmoothSteps(g_Settings.smoothCurve);
+}
+
+void LedManager_SetSmooth(const uint8_t curve, const uint8_t steps, const uint16_t timeMs)
+{
+    g_Settings.smoothSteps = steps;
+    g_Settings.smoothTimeMs = timeMs;
+
+    _UpdateSmoothSteps(curve);
+}
@@ -24,8 +24,23 @@
 #ifndef LEDMANAGER_H_INCLUDED
 #define LEDMANAGER_H_INCLUDED
 
+#include "datatypes.h"
+
 extern void LedManager_UpdateColors(void);
 extern void LedManager_FillImages(const uint8_t red, const uint8_t green, const uint8_t blue);
+// Evaluates smooth steps from smoothTimeMs or smoothSteps, call it after timer settings change
+extern void LedManager_UpdateSmoothSteps(void);
+// Sets number of smooth steps or time of smooth change in ms if it isn't 0, zeros disable smoothing
+extern void LedManager_SetSmooth(const uint8_t curve, const uint8_t steps, const uint16_t timeMs);
+// Duration of the frame tick of the timer ISR
+extern uint16_t LedManager_TickUs(void);
+// Brightness coefficient 0..256, scaled image is evaluated by the timer ISR when it changes
+extern void LedManager_SetBrightness(const uint16_t brightness);
+
+// Back image is written between these calls, outside of the timer ISR.
+// Image which isn't shown yet is reused, so only the last one of fast incoming frames is shown
+extern RGB_t * LedManager_BeginBackImage(const uint8_t isFullFrame);
+extern void LedManager_SubmitBackImage(const uint16_t changedMask, const uint8_t isJump);
 
 #endif /* LEDMANAGER_H_INCLUDED */
 
@@ -29,12 +29,20 @@
 #include "LedManager.h"
 #include "LightpackUSB.h"
 
+#include "../CommonHeaders/COMMANDS.h"
+
 volatile uint8_t g_Flags = 0;
 
 uint8_t t0_counter = 0;
 const uint8_t T0_POSTPRESCALER = 30;
 
-Images_t g_Images = { };
+Images_t g_Images =
+{
+        .end  = g_Images.frames[0],
+        .back = g_Images.frames[1],
+};
+
+Feedback_t g_Feedback;
 
 Settings_t g_Settings =
 {
@@ -43,7 +51,18 @@ Settings_t g_Settings =
         // Number of intermediate colors between old and new
         .smoothSlowdown = 100,
 
-        .brightness = 50,
+        .smoothCurve = SMOOTH_CURVE_LINEAR,
+
+        .smoothSteps = 100,
+
+        // Number of steps is set by smoothSlowdown
+        .smoothTimeMs = 0,
+
+        .smoothReciprocal = 0xffff / 100,
+        .smoothExpCoef = 5 * (0xffff / 100),
+
+        // Full brightness, host sets it with CMD_SET_BRIGHTNESS
+        .brightness = 256,
 
         // Maximum number of different colors for each channel (Red, Green and Blue)
         .maxPwmValue = 128,
@@ -59,6 +78,10 @@ ISR( TIMER1_COMPA_vect )
 {
 	LedManager_UpdateColors();
 
+    // Compare match came again while colors were updated, it is lost
+    if (TIFR1 & _BV(OCF1A))
+        g_Feedback.isrOverrunsCount++;
+
     // Clear timer interrupt flag
     TIFR1 = _BV(OCF1A);
 }
@@ -26,6 +26,7 @@
 
 #include "Lightpack.h"
 #include "LightpackUSB.h"
+#include "LedManager.h"
 #include "version.h"
 
 #include "../CommonHeaders/COMMANDS.h"
@@ -88,6 +89,29 @@ void EVENT_USB_Device_StartOfFrame(void)
     HID_Device_MillisecondElapsed(&Generic_HID_Interface);
 }
 
+static inline void _EncodeWord(uint8_t * data, const uint16_t value)
+{
+    data[0] = value & 0xff;
+    data[1] = value >> 8;
+}
+
+// Feedback taken on CMD_REQUEST_FEEDBACK. IN report doesn't follow the timer ticks,
+// so LUFA sends it when host asks, not each ms
+static Feedback_t s_feedback;
+static uint16_t s_feedbackTickUs;
+static uint8_t s_isFeedbackRequested;
+
+static void _TakeFeedback(void)
+{
+    // Timer ISR changes 16-bit values
+    ATOMIC_BLOCK( ATOMIC_RESTORESTATE ){
+        s_feedback = g_Feedback;
+    }
+
+    s_feedbackTickUs = LedManager_TickUs();
+    s_isFeedbackRequested = true;
+}
+
 /** HID class driver callback function for the creation of HID reports to the host.
  *
  *  \param[in]     HIDInterfaceInfo  Pointer to the HID class interface configuration structure being referenced
@@ -110,8 +134,21 @@ bool CALLBACK_HID_Device_CreateHIDReport(USB_ClassInfo_HID_Device_t* const HIDIn
     ReportData_u8[INDEX_FW_VER_MAJOR] = VERSION_OF_FIRMWARE_MAJOR;
     ReportData_u8[INDEX_FW_VER_MINOR] = VERSION_OF_FIRMWARE_MINOR;
 
+    _EncodeWord(ReportData_u8 + INDEX_LATCHED_FRAME_ID, s_feedback.latchedFrameId);
+    _EncodeWord(ReportData_u8 + INDEX_LATCHED_TICK, s_feedback.latchedTick);
+    _EncodeWord(ReportData_u8 + INDEX_CURRENT_TICK, s_feedback.tick);
+    _EncodeWord(ReportData_u8 + INDEX_TICK_US, s_feedbackTickUs);
+    _EncodeWord(ReportData_u8 + INDEX_DROPPED_FRAMES, s_feedback.droppedFramesCount);
+    _EncodeWord(ReportData_u8 + INDEX_ISR_OVERRUNS, s_feedback.isrOverrunsCount);
+
     *ReportSize = GENERIC_REPORT_SIZE;
-    return true;
+
+    // Requested report is sent even if it is the same as the previous one,
+    // otherwise library sends it only when it changes
+    uint8_t isForced = s_isFeedbackRequested;
+    s_isFeedbackRequested = false;
+
+    return isForced;
 }
 
 inline void UpdateUsbLed(void)
@@ -119,6 +156,41 @@ inline void UpdateUsbLed(void)
     TOGGLE(USBLED);
 }
 
+// Bytes of one LED in CMD_UPDATE_LEDS report: 8 high bits of R, G, B and 4 low bits of R, G, B
+#define LED_DATA_SIZE   6
+
+// Decodes color of the LED from the report data
+static inline void _DecodeLedColor(RGB_t * image, const uint8_t i, const uint8_t * data)
+{
+#   if (LIGHTPACK_HW == 6)
+
+    image[i].r = ((uint16_t)data[0] << 4);
+    image[i].g = ((uint16_t)data[1] << 4);
+    image[i].b = ((uint16_t)data[2] << 4);
+
+    image[i].r |= (uint16_t)(data[3] & 0x0f);
+    image[i].g |= (uint16_t)(data[4] & 0x0f);
+    image[i].b |= (uint16_t)(data[5] & 0x0f);
+
+
+#   else /* (LIGHTPACK_HW == 6) */
+
+    image[i].r = data[0];
+    image[i].g = data[1];
+    image[i].b = data[2];
+
+#endif
+}
+
+// Frame id follows colors of all LEDs, reports of old hosts have zeros there
+static inline uint16_t _DecodeFrameId(const uint8_t * data, const uint16_t size)
+{
+    if (size < INDEX_FRAME_ID + 2)
+        return 0;
+
+    return ((uint16_t)data[INDEX_FRAME_ID + 1] << 8) | data[INDEX_FRAME_ID];
+}
+
 /** HID class driver callback function for the processing of HID reports from the host.
  *
  *  \param[in] HIDInterfaceInfo  Pointer to the HID class interface configuration structure being referenced
@@ -145,50 +217,59 @@ void CALLBACK_HID_Device_ProcessHIDReport(USB_ClassInfo_HID_Device_t* const HIDI
     case CMD_UPDATE_LEDS:
     {
 
-        _FlagSet(Flag_ChangingColors);
+        // Timer ISR shows the frame after LedManager_SubmitBackImage()
+        RGB_t *image = LedManager_BeginBackImage(true);
 
         uint8_t reportDataIndex = 1; // new data starts form ReportData_u8[1]
 
         for (uint8_t i = 0; i < LEDS_COUNT; i++)
         {
-            g_Images.start[i].r = g_Images.current[i].r;
-            g_Images.start[i].g = g_Images.current[i].g;
-            g_Images.start[i].b = g_Images.current[i].b;
+            _DecodeLedColor(image, i, ReportData_u8 + reportDataIndex);
+            reportDataIndex += LED_DATA_SIZE;
+        }
 
+        g_Images.backFrameId = _DecodeFrameId(ReportData_u8, ReportSize);
 
-#           if (LIGHTPACK_HW == 6)
+        LedManager_SubmitBackImage(ALL_LEDS_MASK, false);
+        _FlagSet(Flag_HaveNewColors);
 
-            g_Images.end[i].r = ((uint16_t)ReportData_u8[reportDataIndex++] << 4);
-            g_Images.end[i].g = ((uint16_t)ReportData_u8[reportDataIndex++] << 4);
-            g_Images.end[i].b = ((uint16_t)ReportData_u8[reportDataIndex++] << 4);
+        break;
+    }
+    case CMD_UPDATE_LEDS_PARTIAL:
+    {
+        // ReportData_u8[1..2] is the bitmask of changed LEDs (LED1 is bit 0),
+        // colors of changed LEDs follow it, other LEDs keep smoothing
+        uint16_t changedMask = ((uint16_t)ReportData_u8[2] << 8) | ReportData_u8[1];
+        uint16_t decodedMask = 0;
 
-            g_Images.end[i].r |= (uint16_t)(ReportData_u8[reportDataIndex++] & 0x0f);
-            g_Images.end[i].g |= (uint16_t)(ReportData_u8[reportDataIndex++] & 0x0f);
-            g_Images.end[i].b |= (uint16_t)(ReportData_u8[reportDataIndex++] & 0x0f);
+        RGB_t *image = LedManager_BeginBackImage(false);
 
+        uint8_t reportDataIndex = 3;
 
-#           else /* (LIGHTPACK_HW == 6) */
+        // Colors don't overlap frame id
+        uint16_t frameId = _DecodeFrameId(ReportData_u8, ReportSize);
+        uint16_t reportDataEnd = (ReportSize < INDEX_FRAME_ID) ? ReportSize : INDEX_FRAME_ID;
 
-            g_Images.end[i].r = ReportData_u8[reportDataIndex++];
-            g_Images.end[i].g = ReportData_u8[reportDataIndex++];
-            g_Images.end[i].b = ReportData_u8[reportDataIndex++];
+        for (uint8_t i = 0; i < LEDS_COUNT; i++, changedMask >>= 1)
+        {
+            if (changedMask == 0)
+                break;
 
-            reportDataIndex++;
-            reportDataIndex++;
-            reportDataIndex++;
-#endif
+            if ((changedMask & 1) == 0)
+                continue;
+
+            if (reportDataIndex + LED_DATA_SIZE > reportDataEnd)
+                break;
 
-            // If pixel changed, then restart smooth algorithm
-            // for current pixel by clearing smoothIndex
-            if (g_Images.start[i].r != g_Images.end[i].r ||
-                g_Images.start[i].g != g_Images.end[i].g ||
-                g_Images.start[i].b != g_Images.end[i].b)
-            {
-                g_Images.smoothIndex[i] = 0;
-            }
+            _DecodeLedColor(image, i, ReportData_u8 + reportDataIndex);
+            reportDataIndex += LED_DATA_SIZE;
+
+            decodedMask |= (1 << i);
         }
 
-        _FlagClear(Flag_ChangingColors);
+        g_Images.backFrameId = frameId;
+
+        LedManager_SubmitBackImage(decodedMask, false);
         _FlagSet(Flag_HaveNewColors);
 
         break;
@@ -206,24 +287,52 @@ void CALLBACK_HID_Device_ProcessHIDReport(USB_ClassInfo_HID_Device_t* const HIDI
 
         _FlagSet(Flag_TimerOptionsChanged);
 
+        // Smooth step time depends on timer
+        LedManager_UpdateSmoothSteps();
+
         break;
 
     case CMD_SET_PWM_LEVEL_MAX_VALUE:
 
         g_Settings.maxPwmValue = ReportData_u8[1];
 
+        LedManager_UpdateSmoothSteps();
+
         break;
 
     case CMD_SET_SMOOTH_SLOWDOWN:
 
-        g_Settings.isSmoothEnabled = ReportData_u8[1];
-        g_Settings.smoothSlowdown  = ReportData_u8[1]; /* not a bug */
+        // Zero steps disable smoothing
+        LedManager_SetSmooth(g_Settings.smoothCurve, ReportData_u8[1], 0);
+
+        break;
+
+    case CMD_SET_SMOOTH_OPTIONS:
+
+        // ReportData_u8[1] is curve, ReportData_u8[2..3] is time of smooth change in ms,
+        // zero time disables smoothing
+        LedManager_SetSmooth(ReportData_u8[1],
+                0, ((uint16_t)ReportData_u8[3] << 8) | ReportData_u8[2]);
 
         break;
 
     case CMD_SET_BRIGHTNESS:
+    {
+        // Host sends brightness in percents, convert it to coefficient
+        // here so LedManager scales colors without division
+        uint8_t percent = ReportData_u8[1];
+
+        if (percent > 100)
+            percent = 100;
+
+        LedManager_SetBrightness(((uint16_t)percent << 8) / 100);
+
+        break;
+    }
+
+    case CMD_REQUEST_FEEDBACK:
 
-        g_Settings.brightness = ReportData_u8[1];
+        _TakeFeedback();
 
         break;
 
@@ -48,11 +48,26 @@ typedef struct
 } RGB_t;
 #endif
 
+#define ALL_LEDS_MASK   ((1UL << LEDS_COUNT) - 1)
+
 typedef struct
 {
     RGB_t start[LEDS_COUNT];
     RGB_t current[LEDS_COUNT];
-    RGB_t end[LEDS_COUNT];
+
+    // End image (front) is read by timer ISR, reports are decoded to back image.
+    // Timer ISR swaps them at the frame boundary when back image is ready
+    RGB_t frames[2][LEDS_COUNT];
+    RGB_t *end;
+    RGB_t *back;
+
+    volatile uint8_t isBackReady;
+    // LEDs changed in back image, smooth change restarts only for them
+    uint16_t backChangedMask;
+    // Back image is shown without smooth change
+    uint8_t isBackJump;
+    // Frame id from the host, it is reported back when the image is shown
+    uint16_t backFrameId;
 
     uint8_t smoothIndex[LEDS_COUNT];
 
@@ -60,12 +75,33 @@ typedef struct
 
 typedef struct
 {
+    // Read by timer ISR, written together by LedManager_UpdateSmoothSteps()
     uint8_t isSmoothEnabled;
+    // Number of smooth steps, it is evaluated from smoothTimeMs if it isn't 0
     uint8_t smoothSlowdown;
-    uint8_t brightness;
+    uint8_t smoothCurve;
+    // Requested by host, timer ISR doesn't read them
+    uint8_t smoothSteps;
+    uint16_t smoothTimeMs;
+    // 0xffff / smoothSlowdown and coefficient of the exponential curve
+    uint16_t smoothReciprocal;
+    uint16_t smoothExpCoef;
+    // Brightness coefficient 0..256, where 256 is 100%
+    uint16_t brightness;
     uint8_t maxPwmValue;
     uint16_t timerOutputCompareRegValue;
 
 } Settings_t;
 
+// Written by timer ISR, copied to the IN report on CMD_REQUEST_FEEDBACK
+typedef struct
+{
+    uint16_t tick;
+    uint16_t latchedFrameId;
+    uint16_t latchedTick;
+    uint16_t droppedFramesCount;
+    uint16_t isrOverrunsCount;
+
+} Feedback_t;
+
 #endif /* DATATYPES_H_INCLUDED */
@@ -0,0 +1,305 @@
+/*
+ * SimAvr.c
+ *
+ *  Created on: 19.10.2026
+ *     Project: Lightpack
+ *
+ *  Copyright (c) 2011 Mike Shatohin, mikeshatohin [at] gmail.com
+ *
+ *  Lightpack is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Lightpack is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+#include "SimAvr.h"
+
+uint64_t g_SimCycles = 0;
+SimStats_t g_SimIsrStats;
+
+volatile uint8_t DDRB, PINB, PORTC, DDRC, PINC, PORTD, DDRD, PIND;
+volatile uint8_t TCCR1A, TCCR1B, TCCR1C, TCCR0A, TCCR0B, TCNT0;
+volatile uint8_t TIMSK0, TIMSK1, WDTCSR, SPCR;
+volatile uint16_t OCR1A;
+
+static volatile uint8_t s_portB;
+static uint8_t s_portBSeen;
+
+static uint8_t s_spiData[SIM_FRAME_MAX_SIZE];
+static uint8_t s_spiDataSize;
+static uint8_t s_spiOverflow;
+static volatile uint8_t s_spiStatus;
+static uint64_t s_spiDoneCycle;
+
+static uint8_t s_bits1[SIM_FRAME_MAX_SIZE];
+static uint8_t s_bits2[SIM_FRAME_MAX_SIZE];
+static uint8_t s_bits1Size, s_bits2Size;
+
+static volatile uint16_t s_timer1;
+static uint16_t s_timer1Seen;
+static uint64_t s_timer1Base;
+static uint64_t s_lastCompareCycle;
+static uint8_t s_isCompareFlagSet;
+static uint8_t s_wasTimer1Running;
+
+// Unused bit 7 of TIFR1 is cleared when firmware writes the register
+#define TIFR1_NOT_WRITTEN   _BV(7)
+
+static volatile uint8_t s_timer1Flags = TIFR1_NOT_WRITTEN;
+
+static SimFrame_t s_frames[SIM_FRAMES_RING_SIZE];
+static uint32_t s_framesCount;
+static uint32_t s_isrNumber;
+
+uint64_t SimHost_TimeNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+void SimAvr_AddCycles(const uint32_t cycles)
+{
+    g_SimCycles += cycles;
+}
+
+static void _LatchFrame(void)
+{
+    SimFrame_t *frame = &s_frames[s_framesCount % SIM_FRAMES_RING_SIZE];
+
+#if (LIGHTPACK_HW == 4)
+    memcpy(frame->data, s_bits1, s_bits1Size);
+    frame->size = s_bits1Size;
+    memcpy(frame->data2, s_bits2, s_bits2Size);
+    frame->size2 = s_bits2Size;
+
+    s_bits1Size = 0;
+    s_bits2Size = 0;
+#else
+    memcpy(frame->data, s_spiData, s_spiDataSize);
+    frame->size = s_spiOverflow ? 0 : s_spiDataSize;
+    frame->size2 = 0;
+
+    s_spiDataSize = 0;
+    s_spiOverflow = false;
+#endif
+
+    frame->isrNumber = s_isrNumber;
+    frame->cycle = g_SimCycles;
+
+    s_framesCount++;
+}
+
+static inline uint8_t _IsRising(const uint8_t before, const uint8_t after, const uint8_t bit)
+{
+    return (before & _BV(bit)) == 0 && (after & _BV(bit)) != 0;
+}
+
+static void _PortBChanged(const uint8_t before, const uint8_t after)
+{
+#if (LIGHTPACK_HW == 4)
+    // CLK_1 (B5) and CLK_2 (B1) shift DATA_1 (B6) and DATA_2 (B2), LATCH_1 (B4) latches both
+    if (_IsRising(before, after, 5) && s_bits1Size < SIM_FRAME_MAX_SIZE)
+        s_bits1[s_bits1Size++] = (after & _BV(6)) ? 1 : 0;
+
+    if (_IsRising(before, after, 1) && s_bits2Size < SIM_FRAME_MAX_SIZE)
+        s_bits2[s_bits2Size++] = (after & _BV(2)) ? 1 : 0;
+
+    if (_IsRising(before, after, 4))
+        _LatchFrame();
+#else
+    // LATCH (B0)
+    if (_IsRising(before, after, 0))
+        _LatchFrame();
+#endif
+}
+
+void SimAvr_Flush(void)
+{
+    if (s_portB != s_portBSeen)
+    {
+        uint8_t before = s_portBSeen;
+        s_portBSeen = s_portB;
+        _PortBChanged(before, s_portBSeen);
+    }
+}
+
+volatile uint8_t * SimAvr_PortB(void)
+{
+    // Result of the previous access is seen here
+    SimAvr_Flush();
+    g_SimCycles += SIM_PORT_ACCESS_CYCLES;
+
+    return &s_portB;
+}
+
+volatile uint8_t * SimAvr_SpiData(void)
+{
+    // Firmware only writes SPDR, each access is a new transfer
+    g_SimCycles += 1;
+    s_spiDoneCycle = g_SimCycles + ((s_spiStatus & _BV(SPI2X)) ? 16 : 32);
+
+    if (s_spiDataSize == SIM_FRAME_MAX_SIZE)
+    {
+        s_spiOverflow = true;
+        s_spiDataSize = 0;
+    }
+
+    return &s_spiData[s_spiDataSize++];
+}
+
+volatile uint8_t * SimAvr_SpiStatus(void)
+{
+    // Polling of SPIF waits till the end of the transfer
+    if (g_SimCycles < s_spiDoneCycle)
+        g_SimCycles = s_spiDoneCycle;
+
+    g_SimCycles += SIM_PORT_ACCESS_CYCLES;
+    s_spiStatus |= _BV(SPIF);
+
+    return &s_spiStatus;
+}
+
+// Timer is stopped till clock is selected
+static inline uint8_t _IsTimer1Running(void)
+{
+    return (TCCR1B & (_BV(CS12) | _BV(CS11) | _BV(CS10))) != 0;
+}
+
+// Sets OCF1A for compare matches till now, counter runs from s_timer1Base
+static void _UpdateCompareFlag(void)
+{
+    if (_IsTimer1Running() == false)
+        return;
+
+    uint64_t compare = s_timer1Base + OCR1A;
+
+    if (compare <= s_lastCompareCycle)
+        compare += ((s_lastCompareCycle - compare) / 0x10000 + 1) * 0x10000;
+
+    if (compare > g_SimCycles)
+        return;
+
+    // Missed matches are merged in one flag like on the hardware
+    s_lastCompareCycle = compare + (g_SimCycles - compare) / 0x10000 * 0x10000;
+    s_isCompareFlagSet = true;
+}
+
+static uint16_t _Timer1Value(void)
+{
+    uint8_t isRunning = _IsTimer1Running();
+
+    // Value written by firmware restarts counting from it, stopped timer keeps its value
+    if (s_timer1 != s_timer1Seen || isRunning == false || s_wasTimer1Running == false)
+    {
+        if (isRunning && s_wasTimer1Running)
+            _UpdateCompareFlag();
+
+        s_timer1Base = g_SimCycles - s_timer1;
+        s_timer1Seen = s_timer1;
+    }
+
+    s_wasTimer1Running = isRunning;
+
+    return (uint16_t)(g_SimCycles - s_timer1Base);
+}
+
+volatile uint16_t * SimAvr_Timer1Counter(void)
+{
+    g_SimCycles += SIM_TIMER_READ_CYCLES;
+
+    s_timer1 = s_timer1Seen = _Timer1Value();
+
+    return &s_timer1;
+}
+
+static void _UpdateTimer1(void)
+{
+    _Timer1Value();
+
+    // Writing 1 to OCF1A clears it
+    if ((s_timer1Flags & TIFR1_NOT_WRITTEN) == 0 && (s_timer1Flags & _BV(OCF1A)))
+        s_isCompareFlagSet = false;
+
+    s_timer1Flags = TIFR1_NOT_WRITTEN;
+
+    _UpdateCompareFlag();
+}
+
+volatile uint8_t * SimAvr_Timer1Flags(void)
+{
+    g_SimCycles += SIM_PORT_ACCESS_CYCLES;
+
+    _UpdateTimer1();
+
+    if (s_isCompareFlagSet)
+        s_timer1Flags |= _BV(OCF1A);
+
+    return &s_timer1Flags;
+}
+
+void SimAvr_RunDueInterrupts(void)
+{
+    for (;;)
+    {
+        _UpdateTimer1();
+
+        if (s_isCompareFlagSet == false || (TIMSK1 & _BV(OCIE1A)) == 0)
+            break;
+
+        // Flag is cleared when the interrupt vector is called
+        s_isCompareFlagSet = false;
+
+        uint64_t startCycles = g_SimCycles;
+        uint64_t startNs = SimHost_TimeNs();
+
+        s_isrNumber = ++g_SimIsrStats.count;
+
+        g_SimCycles += SIM_ISR_OVERHEAD_CYCLES;
+        TIMER1_COMPA_vect();
+        SimAvr_Flush();
+
+        s_isrNumber = 0;
+
+        uint64_t hostNs = SimHost_TimeNs() - startNs;
+        uint32_t cycles = g_SimCycles - startCycles;
+
+        g_SimIsrStats.cycles += cycles;
+        g_SimIsrStats.hostNs += hostNs;
+
+        if (cycles > g_SimIsrStats.maxCycles)
+            g_SimIsrStats.maxCycles = cycles;
+        if (hostNs > g_SimIsrStats.maxHostNs)
+            g_SimIsrStats.maxHostNs = hostNs;
+    }
+}
+
+uint32_t SimAvr_FramesCount(void)
+{
+    return s_framesCount;
+}
+
+const SimFrame_t * SimAvr_Frame(const uint32_t index)
+{
+    if (index >= s_framesCount || s_framesCount - index > SIM_FRAMES_RING_SIZE)
+        return NULL;
+
+    return &s_frames[index % SIM_FRAMES_RING_SIZE];
+}
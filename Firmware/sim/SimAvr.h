@@ -0,0 +1,104 @@
+/*
+ * SimAvr.h
+ *
+ *  Created on: 19.10.2026
+ *     Project: Lightpack
+ *
+ *  Copyright (c) 2011 Mike Shatohin, mikeshatohin [at] gmail.com
+ *
+ *  Lightpack is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Lightpack is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef SIMAVR_H_INCLUDED
+#define SIMAVR_H_INCLUDED
+
+#include <stdint.h>
+
+/*
+ *  AVR model for the host build of the firmware.
+ *
+ *  Registers are plain variables, except the ones with side effects which
+ *  are accessed through functions returning a pointer to the register value:
+ *  PORTB (LED driver pins), SPDR and SPSR (SPI transfers), TCNT1 and TIFR1
+ *  (timer).
+ *
+ *  Cycles are counted only for I/O: port and timer register accesses, SPI
+ *  transfers and ISR entry/exit. Computation isn't emulated, its cost is
+ *  measured as host time of the ISR, so compare builds on the same machine.
+ */
+
+// Emulated cycles since start, F_CPU cycles per second
+extern uint64_t g_SimCycles;
+
+#define SIM_CYCLES_PER_US   (F_CPU / 1000000UL)
+
+// Costs of the emulated operations, in cycles
+#define SIM_PORT_ACCESS_CYCLES      2
+#define SIM_TIMER_READ_CYCLES       4
+#define SIM_ISR_OVERHEAD_CYCLES     40
+
+volatile uint8_t * SimAvr_PortB(void);
+volatile uint8_t * SimAvr_SpiData(void);
+volatile uint8_t * SimAvr_SpiStatus(void);
+volatile uint16_t * SimAvr_Timer1Counter(void);
+volatile uint8_t * SimAvr_Timer1Flags(void);
+
+// Data latched into LED drivers by one latch pulse
+#define SIM_FRAME_MAX_SIZE  64
+
+typedef struct
+{
+    // SPI bytes on hw5 and hw6, bits of the first driver on hw4
+    uint8_t data[SIM_FRAME_MAX_SIZE];
+    uint8_t size;
+    // Bits of the second driver on hw4
+    uint8_t data2[SIM_FRAME_MAX_SIZE];
+    uint8_t size2;
+
+    // Number of the timer ISR which latched the frame, 0 - outside of ISR
+    uint32_t isrNumber;
+    uint64_t cycle;
+
+} SimFrame_t;
+
+typedef struct
+{
+    uint32_t count;
+    uint64_t cycles;
+    uint32_t maxCycles;
+    uint64_t hostNs;
+    uint64_t maxHostNs;
+
+} SimStats_t;
+
+extern SimStats_t g_SimIsrStats;
+
+void SimAvr_AddCycles(const uint32_t cycles);
+
+// Handles pending port changes, called after each firmware call
+void SimAvr_Flush(void);
+
+// Calls timer ISR for each compare match till g_SimCycles
+void SimAvr_RunDueInterrupts(void);
+
+// Frames are kept in a ring of SIM_FRAMES_RING_SIZE, older ones are lost
+#define SIM_FRAMES_RING_SIZE    4096
+
+uint32_t SimAvr_FramesCount(void);
+const SimFrame_t * SimAvr_Frame(const uint32_t index);
+
+uint64_t SimHost_TimeNs(void);
+
+#endif /* SIMAVR_H_INCLUDED */
@@ -0,0 +1,875 @@
+/*
+ * SimMain.c
+ *
+ *  Created on: 19.10.2026
+ *     Project: Lightpack
+ *
+ *  Copyright (c) 2011 Mike Shatohin, mikeshatohin [at] gmail.com
+ *
+ *  Lightpack is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Lightpack is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ *  Host build of the firmware: tests of the LED output and benchmark of
+ *  the timer ISR. Firmware main() runs in its own context, it returns to
+ *  the harness from wdt_reset() of the main loop when the requested time
+ *  is over. Each test is run in a child process, so it starts from reset.
+ *
+ *  Usage: sim_hwN [--bench [frames.lpframes] [--partial]]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ucontext.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "../Lightpack.h"
+#include "../../CommonHeaders/COMMANDS.h"
+
+#include "SimAvr.h"
+#include "SimUsb.h"
+
+int firmware_main(void);
+
+// Cost of one pass of the main loop without reports, in cycles
+#define SIM_MAIN_LOOP_CYCLES    24
+
+#define FIRMWARE_STACK_SIZE     (256 * 1024)
+
+#if (LIGHTPACK_HW == 6)
+#   define SIM_COLOR_MAX        0x0fff
+#   define SIM_DRIVERS_FRAME_SIZE   48
+#else
+// PWM shows colors up to maxPwmValue
+#   define SIM_COLOR_MAX        120
+#endif
+
+static ucontext_t s_harnessContext;
+static ucontext_t s_firmwareContext;
+static char s_firmwareStack[FIRMWARE_STACK_SIZE];
+static uint64_t s_runUntilCycle;
+static uint8_t s_isFirmwareStarted;
+
+void SimMain_Idle(void)
+{
+    SimAvr_Flush();
+    g_SimCycles += SIM_MAIN_LOOP_CYCLES;
+
+    SimAvr_RunDueInterrupts();
+
+    if (g_SimCycles >= s_runUntilCycle)
+        swapcontext(&s_firmwareContext, &s_harnessContext);
+}
+
+static void _FirmwareEntry(void)
+{
+    firmware_main();
+
+    fprintf(stderr, "firmware main() returned\n");
+    exit(2);
+}
+
+static void Sim_RunUntil(const uint64_t cycle)
+{
+    s_runUntilCycle = cycle;
+
+    if (s_isFirmwareStarted == false)
+    {
+        getcontext(&s_firmwareContext);
+        s_firmwareContext.uc_stack.ss_sp = s_firmwareStack;
+        s_firmwareContext.uc_stack.ss_size = sizeof(s_firmwareStack);
+        s_firmwareContext.uc_link = NULL;
+        makecontext(&s_firmwareContext, _FirmwareEntry, 0);
+
+        s_isFirmwareStarted = true;
+    }
+
+    swapcontext(&s_harnessContext, &s_firmwareContext);
+}
+
+static void Sim_RunForUs(const uint32_t us)
+{
+    Sim_RunUntil(g_SimCycles + (uint64_t)us * SIM_CYCLES_PER_US);
+}
+
+// Waits till the firmware takes all queued reports
+static void Sim_ProcessReports(void)
+{
+    while (SimUsb_PendingReports() != 0)
+        Sim_RunUntil(g_SimCycles);
+}
+
+static void Sim_QueueReport(const uint8_t * report, const uint16_t size)
+{
+    if (SimUsb_QueueReport(report, size) == false)
+    {
+        Sim_ProcessReports();
+        SimUsb_QueueReport(report, size);
+    }
+}
+
+static void Sim_Command(const uint8_t cmd, const uint8_t arg1, const uint8_t arg2, const uint8_t arg3)
+{
+    uint8_t report[SIM_REPORT_SIZE] = { cmd, arg1, arg2, arg3 };
+
+    Sim_QueueReport(report, sizeof(report));
+    Sim_ProcessReports();
+}
+
+static void _EncodeLedColor(uint8_t * data, const RGB_t * color)
+{
+#if (LIGHTPACK_HW == 6)
+    data[0] = color->r >> 4;
+    data[1] = color->g >> 4;
+    data[2] = color->b >> 4;
+    data[3] = color->r & 0x0f;
+    data[4] = color->g & 0x0f;
+    data[5] = color->b & 0x0f;
+#else
+    data[0] = color->r;
+    data[1] = color->g;
+    data[2] = color->b;
+#endif
+}
+
+static void Sim_QueueUpdateLeds(const RGB_t colors[LEDS_COUNT], const uint16_t frameId)
+{
+    uint8_t report[SIM_REPORT_SIZE] = { CMD_UPDATE_LEDS };
+
+    for (uint8_t i = 0; i < LEDS_COUNT; i++)
+        _EncodeLedColor(report + 1 + i * 6, &colors[i]);
+
+    report[INDEX_FRAME_ID] = frameId & 0xff;
+    report[INDEX_FRAME_ID + 1] = frameId >> 8;
+
+    Sim_QueueReport(report, sizeof(report));
+}
+
+// Report is cut after the last changed LED if it has no frame id
+static void Sim_QueueUpdateLedsPartial(const RGB_t colors[LEDS_COUNT], const uint16_t mask, const uint16_t frameId)
+{
+    uint8_t report[SIM_REPORT_SIZE] = { CMD_UPDATE_LEDS_PARTIAL, mask & 0xff, mask >> 8 };
+    uint8_t index = 3;
+
+    for (uint8_t i = 0; i < LEDS_COUNT; i++)
+    {
+        if (mask & (1 << i))
+        {
+            _EncodeLedColor(report + index, &colors[i]);
+            index += 6;
+        }
+    }
+
+    if (frameId != 0)
+    {
+        report[INDEX_FRAME_ID] = frameId & 0xff;
+        report[INDEX_FRAME_ID + 1] = frameId >> 8;
+        index = SIM_REPORT_SIZE;
+    }
+
+    Sim_QueueReport(report, index);
+}
+
+static void Sim_UpdateLeds(const RGB_t colors[LEDS_COUNT])
+{
+    Sim_QueueUpdateLeds(colors, 0);
+    Sim_ProcessReports();
+}
+
+typedef struct
+{
+    uint8_t versionMajor;
+    uint8_t versionMinor;
+    uint16_t latchedFrameId;
+    uint16_t latchedTick;
+    uint16_t tick;
+    uint16_t tickUs;
+    uint16_t droppedFramesCount;
+    uint16_t isrOverrunsCount;
+
+} SimFeedback_t;
+
+static uint16_t _ReportWord(const uint8_t * report, const uint8_t index)
+{
+    return ((uint16_t)report[index + 1] << 8) | report[index];
+}
+
+static SimFeedback_t Sim_ReadFeedback(void)
+{
+    uint8_t report[SIM_REPORT_SIZE];
+    SimFeedback_t feedback;
+
+    Sim_Command(CMD_REQUEST_FEEDBACK, 0, 0, 0);
+    SimUsb_ReadInReport(report);
+
+    feedback.versionMajor = report[INDEX_FW_VER_MAJOR];
+    feedback.versionMinor = report[INDEX_FW_VER_MINOR];
+    feedback.latchedFrameId = _ReportWord(report, INDEX_LATCHED_FRAME_ID);
+    feedback.latchedTick = _ReportWord(report, INDEX_LATCHED_TICK);
+    feedback.tick = _ReportWord(report, INDEX_CURRENT_TICK);
+    feedback.tickUs = _ReportWord(report, INDEX_TICK_US);
+    feedback.droppedFramesCount = _ReportWord(report, INDEX_DROPPED_FRAMES);
+    feedback.isrOverrunsCount = _ReportWord(report, INDEX_ISR_OVERRUNS);
+
+    return feedback;
+}
+
+#if (LIGHTPACK_HW == 6)
+
+static uint16_t _FrameWord(const SimFrame_t * frame, const uint8_t index)
+{
+    const uint8_t *data = frame->data + (index / 2) * 3;
+
+    if (index % 2 == 0)
+        return ((uint16_t)data[0] << 4) | (data[1] >> 4);
+    else
+        return ((uint16_t)(data[1] & 0x0f) << 8) | data[2];
+}
+
+// Colors shown by LED drivers: the last latched frame
+static uint8_t Sim_ShownColors(RGB_t colors[LEDS_COUNT])
+{
+    for (uint32_t n = SimAvr_FramesCount(); n > 0; n--)
+    {
+        const SimFrame_t *frame = SimAvr_Frame(n - 1);
+
+        if (frame == NULL)
+            break;
+
+        // LedDriver_OffLeds() frame is shorter
+        if (frame->size != SIM_DRIVERS_FRAME_SIZE)
+            continue;
+
+        for (uint8_t i = 0; i < LEDS_COUNT; i++)
+        {
+            // Word 0 and 16 are not connected channels
+            uint8_t word = (i < 5) ? 17 + i * 3 : 1 + (i - 5) * 3;
+
+            colors[i].b = _FrameWord(frame, word);
+            colors[i].g = _FrameWord(frame, word + 1);
+            colors[i].r = _FrameWord(frame, word + 2);
+        }
+        return true;
+    }
+    return false;
+}
+
+#else
+
+// LEDs which are on in one PWM step, bit 3 * LED + channel (r, g, b)
+static uint32_t _FrameLedsOn(const SimFrame_t * frame)
+{
+    uint32_t ledsOn = 0;
+
+#   if (LIGHTPACK_HW == 5)
+    // First word is for LEDs 6..10, second one is for LEDs 1..5
+    uint16_t words[2] = {
+        ((uint16_t)frame->data[0] << 8) | frame->data[1],
+        ((uint16_t)frame->data[2] << 8) | frame->data[3],
+    };
+
+    ledsOn = ((uint32_t)words[0] << 15) | words[1];
+#   else
+    // Each driver gets 4 LEDs from the last one as NC, B, G, R bits
+    for (uint8_t j = 0; j < 4; j++)
+    {
+        for (uint8_t channel = 0; channel < 3; channel++)
+        {
+            uint8_t bit = j * 4 + 3 - channel;
+
+            if (bit < frame->size && frame->data[bit])
+                ledsOn |= 1UL << ((3 - j) * 3 + channel);
+            if (bit < frame->size2 && frame->data2[bit])
+                ledsOn |= 1UL << ((7 - j) * 3 + channel);
+        }
+    }
+#   endif
+
+    return ledsOn;
+}
+
+// Frame which switches LEDs off between PWM periods, it is the first of two frames of the ISR
+static uint8_t _IsPeriodStart(const uint32_t n)
+{
+    const SimFrame_t *frame = SimAvr_Frame(n);
+    const SimFrame_t *next = SimAvr_Frame(n + 1);
+
+    return frame != NULL && next != NULL && frame->isrNumber != 0 && frame->isrNumber == next->isrNumber;
+}
+
+// Colors shown by LED drivers: duty of each channel in the last complete PWM period
+static uint8_t Sim_ShownColors(RGB_t colors[LEDS_COUNT])
+{
+    uint32_t end = 0;
+
+    for (uint32_t n = SimAvr_FramesCount(); n > 1; n--)
+    {
+        if (_IsPeriodStart(n - 2) == false)
+            continue;
+
+        if (end == 0)
+        {
+            end = n - 2;
+            continue;
+        }
+
+        uint32_t start = n - 2;
+
+        if (end - start - 1 != g_Settings.maxPwmValue)
+            return false;
+
+        memset(colors, 0, sizeof(RGB_t) * LEDS_COUNT);
+
+        for (uint32_t k = start + 1; k < end; k++)
+        {
+            uint32_t ledsOn = _FrameLedsOn(SimAvr_Frame(k));
+
+            for (uint8_t i = 0; i < LEDS_COUNT; i++)
+            {
+                colors[i].r += (ledsOn >> (i * 3)) & 1;
+                colors[i].g += (ledsOn >> (i * 3 + 1)) & 1;
+                colors[i].b += (ledsOn >> (i * 3 + 2)) & 1;
+            }
+        }
+        return true;
+    }
+    return false;
+}
+
+#endif /* (LIGHTPACK_HW == 6) */
+
+/*
+ *  Tests
+ */
+
+#define SIM_CHECK(condition, ...) \
+    if (!(condition)) \
+    { \
+        fprintf(stderr, "    %s:%d: ", __FILE__, __LINE__); \
+        fprintf(stderr, __VA_ARGS__); \
+        fprintf(stderr, "\n"); \
+        exit(1); \
+    }
+
+static void _CheckShownColors(const RGB_t expected[LEDS_COUNT])
+{
+    RGB_t shown[LEDS_COUNT];
+
+    SIM_CHECK(Sim_ShownColors(shown), "no frames latched");
+
+    for (uint8_t i = 0; i < LEDS_COUNT; i++)
+    {
+        SIM_CHECK(shown[i].r == expected[i].r && shown[i].g == expected[i].g && shown[i].b == expected[i].b,
+                "LED%d shows (%u, %u, %u) instead of (%u, %u, %u)", i + 1,
+                shown[i].r, shown[i].g, shown[i].b, expected[i].r, expected[i].g, expected[i].b);
+    }
+}
+
+static void _FillTestColors(RGB_t colors[LEDS_COUNT], const uint8_t seed)
+{
+    for (uint8_t i = 0; i < LEDS_COUNT; i++)
+    {
+        colors[i].r = (SIM_COLOR_MAX * (i + 1) / LEDS_COUNT + seed) % (SIM_COLOR_MAX + 1);
+        colors[i].g = (SIM_COLOR_MAX * (LEDS_COUNT - i) / LEDS_COUNT + seed * 3) % (SIM_COLOR_MAX + 1);
+        colors[i].b = (i * 7 + seed * 5) % (SIM_COLOR_MAX + 1);
+    }
+}
+
+static void _StartWithoutSmooth(void)
+{
+    Sim_RunForUs(0);
+    Sim_Command(CMD_SET_SMOOTH_SLOWDOWN, 0, 0, 0);
+}
+
+static void Test_UpdateLeds(void)
+{
+    RGB_t colors[LEDS_COUNT];
+
+    _StartWithoutSmooth();
+    _FillTestColors(colors, 1);
+
+    Sim_UpdateLeds(colors);
+    Sim_RunForUs(20000);
+
+    _CheckShownColors(colors);
+}
+
+static void Test_UpdateLedsPartial(void)
+{
+    RGB_t colors[LEDS_COUNT];
+    RGB_t changed[LEDS_COUNT];
+
+    _StartWithoutSmooth();
+    _FillTestColors(colors, 1);
+    _FillTestColors(changed, 2);
+
+    Sim_UpdateLeds(colors);
+    Sim_RunForUs(20000);
+
+    uint16_t mask = (1 << 1) | (1 << 3) | (1 << (LEDS_COUNT - 1));
+
+    for (uint8_t i = 0; i < LEDS_COUNT; i++)
+        if (mask & (1 << i))
+            colors[i] = changed[i];
+
+    Sim_QueueUpdateLedsPartial(colors, mask, 0);
+    Sim_ProcessReports();
+    Sim_RunForUs(20000);
+
+    _CheckShownColors(colors);
+}
+
+static void Test_Brightness(void)
+{
+    RGB_t colors[LEDS_COUNT];
+
+    _StartWithoutSmooth();
+    _FillTestColors(colors, 3);
+
+    Sim_Command(CMD_SET_BRIGHTNESS, 50, 0, 0);
+    Sim_UpdateLeds(colors);
+    Sim_RunForUs(20000);
+
+    // 50% is 128 / 256
+    for (uint8_t i = 0; i < LEDS_COUNT; i++)
+    {
+        colors[i].r = (colors[i].r * 128) >> 8;
+        colors[i].g = (colors[i].g * 128) >> 8;
+        colors[i].b = (colors[i].b * 128) >> 8;
+    }
+
+    _CheckShownColors(colors);
+}
+
+// Scaled image is cached, it has to follow brightness without a new frame
+static void Test_BrightnessOfShownFrame(void)
+{
+    RGB_t colors[LEDS_COUNT];
+    RGB_t scaled[LEDS_COUNT];
+
+    _StartWithoutSmooth();
+    _FillTestColors(colors, 8);
+
+    Sim_Command(CMD_SET_BRIGHTNESS, 50, 0, 0);
+    Sim_UpdateLeds(colors);
+    Sim_RunForUs(20000);
+
+    Sim_Command(CMD_SET_BRIGHTNESS, 25, 0, 0);
+    Sim_RunForUs(20000);
+
+    // 25% is 64 / 256
+    for (uint8_t i = 0; i < LEDS_COUNT; i++)
+    {
+        scaled[i].r = (colors[i].r * 64) >> 8;
+        scaled[i].g = (colors[i].g * 64) >> 8;
+        scaled[i].b = (colors[i].b * 64) >> 8;
+    }
+
+    _CheckShownColors(scaled);
+
+    Sim_Command(CMD_SET_BRIGHTNESS, 100, 0, 0);
+    Sim_RunForUs(20000);
+
+    _CheckShownColors(colors);
+}
+
+static void Test_OffAll(void)
+{
+    RGB_t colors[LEDS_COUNT];
+
+    _StartWithoutSmooth();
+    _FillTestColors(colors, 4);
+
+    Sim_UpdateLeds(colors);
+    Sim_RunForUs(20000);
+
+    Sim_Command(CMD_OFF_ALL, 0, 0, 0);
+    Sim_RunForUs(20000);
+
+    memset(colors, 0, sizeof(colors));
+    _CheckShownColors(colors);
+}
+
+static void Test_LastReportWins(void)
+{
+    RGB_t first[LEDS_COUNT];
+    RGB_t last[LEDS_COUNT];
+
+    _StartWithoutSmooth();
+    _FillTestColors(first, 5);
+    _FillTestColors(last, 6);
+
+    uint32_t framesBefore = SimAvr_FramesCount();
+
+    // Both reports are decoded before the next frame boundary
+    Sim_QueueUpdateLeds(first, 0);
+    Sim_QueueUpdateLeds(last, 0);
+    Sim_ProcessReports();
+    Sim_RunForUs(20000);
+
+    _CheckShownColors(last);
+
+#if (LIGHTPACK_HW == 6)
+    for (uint32_t n = framesBefore; n < SimAvr_FramesCount(); n++)
+    {
+        const SimFrame_t *frame = SimAvr_Frame(n);
+
+        SIM_CHECK(frame->size != SIM_DRIVERS_FRAME_SIZE || _FrameWord(frame, 19) != first[0].r,
+                "frame %u shows the first report", n);
+    }
+#else
+    (void)framesBefore;
+#endif
+}
+
+static void Test_Feedback(void)
+{
+    RGB_t colors[LEDS_COUNT];
+
+    _StartWithoutSmooth();
+    _FillTestColors(colors, 7);
+
+    SimFeedback_t feedback = Sim_ReadFeedback();
+
+    SIM_CHECK(feedback.versionMajor == VERSION_OF_FIRMWARE_MAJOR && feedback.versionMinor == VERSION_OF_FIRMWARE_MINOR,
+            "version %u.%u", feedback.versionMajor, feedback.versionMinor);
+    SIM_CHECK(feedback.tickUs != 0, "tick duration is 0");
+
+    Sim_QueueUpdateLeds(colors, 0x1234);
+    Sim_ProcessReports();
+    Sim_RunForUs(20000);
+
+    feedback = Sim_ReadFeedback();
+
+    SIM_CHECK(feedback.latchedFrameId == 0x1234, "latched frame id 0x%x", feedback.latchedFrameId);
+    SIM_CHECK((uint16_t)(feedback.tick - feedback.latchedTick) <= 20000 / feedback.tickUs,
+            "frame latched at tick %u, now tick %u", feedback.latchedTick, feedback.tick);
+    SIM_CHECK(feedback.droppedFramesCount == 0, "%u frames dropped", feedback.droppedFramesCount);
+
+    // The first one is replaced before the frame boundary
+    Sim_QueueUpdateLeds(colors, 1);
+    Sim_QueueUpdateLeds(colors, 2);
+    Sim_ProcessReports();
+    Sim_RunForUs(20000);
+
+    feedback = Sim_ReadFeedback();
+
+    SIM_CHECK(feedback.latchedFrameId == 2, "latched frame id %u", feedback.latchedFrameId);
+    SIM_CHECK(feedback.droppedFramesCount == 1, "%u frames dropped", feedback.droppedFramesCount);
+
+    colors[0].r = colors[0].r / 2;
+    Sim_QueueUpdateLedsPartial(colors, 1, 3);
+    Sim_ProcessReports();
+    Sim_RunForUs(20000);
+
+    feedback = Sim_ReadFeedback();
+
+    SIM_CHECK(feedback.latchedFrameId == 3, "latched frame id %u", feedback.latchedFrameId);
+    SIM_CHECK(feedback.isrOverrunsCount == 0, "%u ISR overruns", feedback.isrOverrunsCount);
+
+    // Timer ticks don't change the report till the next request, so it isn't sent each ms
+    uint8_t report[SIM_REPORT_SIZE];
+    uint8_t reportLater[SIM_REPORT_SIZE];
+
+    SimUsb_ReadInReport(report);
+    Sim_RunForUs(20000);
+    SimUsb_ReadInReport(reportLater);
+
+    SIM_CHECK(memcmp(report, reportLater, sizeof(report)) == 0, "IN report changed without request");
+
+    _CheckShownColors(colors);
+}
+
+static void Test_SmoothLinear(void)
+{
+    static const uint16_t SmoothTimeMs = 200;
+
+    RGB_t colors[LEDS_COUNT];
+    RGB_t shown[LEDS_COUNT];
+
+    _StartWithoutSmooth();
+
+    memset(colors, 0, sizeof(colors));
+    Sim_UpdateLeds(colors);
+    Sim_RunForUs(20000);
+
+    Sim_Command(CMD_SET_SMOOTH_OPTIONS, SMOOTH_CURVE_LINEAR, SmoothTimeMs & 0xff, SmoothTimeMs >> 8);
+
+    for (uint8_t i = 0; i < LEDS_COUNT; i++)
+        colors[i].r = colors[i].g = colors[i].b = SIM_COLOR_MAX;
+
+    Sim_UpdateLeds(colors);
+
+    uint64_t start = g_SimCycles;
+    uint16_t previous = 0;
+    uint16_t atHalf = 0;
+
+    // Steps of the loop are a bit longer than 1 ms, time is taken from emulated cycles
+    for (uint32_t ms = 0; ms <= 2 * SmoothTimeMs; ms = (g_SimCycles - start) / (1000 * SIM_CYCLES_PER_US))
+    {
+        Sim_RunForUs(1000);
+
+        if (Sim_ShownColors(shown) == false)
+            continue;
+
+        SIM_CHECK(shown[0].r >= previous, "color goes back at %u ms: %u < %u", ms, shown[0].r, previous);
+        previous = shown[0].r;
+
+        if (ms <= SmoothTimeMs / 2)
+            atHalf = previous;
+    }
+
+    // Step time includes the timer ISR run time, so linear change passes half of the way at the half of smooth time
+    SIM_CHECK(atHalf > SIM_COLOR_MAX * 4 / 10 && atHalf < SIM_COLOR_MAX * 6 / 10, "color is %u at the half of smooth time", atHalf);
+
+    _CheckShownColors(colors);
+}
+
+typedef struct
+{
+    const char *name;
+    void (*run)(void);
+
+} SimTest_t;
+
+static const SimTest_t Tests[] =
+{
+    { "UpdateLeds",         Test_UpdateLeds },
+    { "UpdateLedsPartial",  Test_UpdateLedsPartial },
+    { "Brightness",         Test_Brightness },
+    { "BrightnessOfShownFrame", Test_BrightnessOfShownFrame },
+    { "OffAll",             Test_OffAll },
+    { "LastReportWins",     Test_LastReportWins },
+    { "Feedback",           Test_Feedback },
+    { "SmoothLinear",       Test_SmoothLinear },
+};
+
+static int RunTests(void)
+{
+    int failed = 0;
+
+    for (uint8_t i = 0; i < sizeof(Tests) / sizeof(Tests[0]); i++)
+    {
+        fflush(stdout);
+
+        pid_t pid = fork();
+
+        if (pid == 0)
+        {
+            Tests[i].run();
+            exit(0);
+        }
+
+        int status = -1;
+        waitpid(pid, &status, 0);
+
+        uint8_t isPassed = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+
+        printf("%s hw%d %s\n", isPassed ? "PASS" : "FAIL", LIGHTPACK_HW, Tests[i].name);
+
+        if (isPassed == false)
+            failed++;
+    }
+
+    printf("hw%d: %d of %d tests failed\n", LIGHTPACK_HW, failed, (int)(sizeof(Tests) / sizeof(Tests[0])));
+
+    return failed ? 1 : 0;
+}
+
+/*
+ *  Benchmark
+ */
+
+// Frames of FrameRecorder log, see Software/src/FrameRecorder.hpp
+typedef struct
+{
+    uint64_t timestamp;
+    uint32_t sequence;
+    uint16_t ledsCount;
+    uint16_t reserved;
+
+} FrameLogRecord_t;
+
+#define FRAME_LOG_MAGIC         "LPFRAMES"
+#define SYNTHETIC_FRAMES_COUNT  600
+#define SYNTHETIC_FRAME_NS      (1000000000ULL / 60)
+
+static uint16_t _ColorFromRgb8(const uint8_t value)
+{
+#if (LIGHTPACK_HW == 6)
+    return ((uint16_t)value << 4) | (value >> 4);
+#else
+    return (uint16_t)value * SIM_COLOR_MAX / 0xff;
+#endif
+}
+
+// Returns false at the end of the frames
+static uint8_t _ReadFrame(FILE * file, uint64_t * timestamp, RGB_t colors[LEDS_COUNT], const uint32_t index)
+{
+    if (file == NULL)
+    {
+        if (index == SYNTHETIC_FRAMES_COUNT)
+            return false;
+
+        // Slow gradient on most of the LEDs, a flash on the last ones now and then
+        *timestamp = index * SYNTHETIC_FRAME_NS;
+
+        for (uint8_t i = 0; i < LEDS_COUNT; i++)
+        {
+            uint8_t isFlash = (i >= LEDS_COUNT - 2) && (index % 30 < 3);
+
+            colors[i].r = _ColorFromRgb8(isFlash ? 0xff : (index / 4 + i * 10) & 0xff);
+            colors[i].g = _ColorFromRgb8(isFlash ? 0xff : 0x40);
+            colors[i].b = _ColorFromRgb8(isFlash ? 0xff : (0xff - index / 8) & 0xff);
+        }
+        return true;
+    }
+
+    FrameLogRecord_t record;
+
+    if (fread(&record, sizeof(record), 1, file) != 1 || record.ledsCount == 0)
+        return false;
+
+    for (uint16_t i = 0; i < record.ledsCount; i++)
+    {
+        uint32_t rgb;
+
+        if (fread(&rgb, sizeof(rgb), 1, file) != 1)
+            return false;
+
+        if (i < LEDS_COUNT)
+        {
+            colors[i].r = _ColorFromRgb8((rgb >> 16) & 0xff);
+            colors[i].g = _ColorFromRgb8((rgb >> 8) & 0xff);
+            colors[i].b = _ColorFromRgb8(rgb & 0xff);
+        }
+    }
+
+    for (uint16_t i = record.ledsCount; i < LEDS_COUNT; i++)
+        colors[i].r = colors[i].g = colors[i].b = 0;
+
+    *timestamp = record.timestamp;
+    return true;
+}
+
+static int RunBenchmark(const char * fileName, const uint8_t isPartial)
+{
+    FILE *file = NULL;
+
+    if (fileName != NULL)
+    {
+        char magic[8];
+        uint32_t version, headerSize;
+
+        file = fopen(fileName, "rb");
+
+        if (file == NULL || fread(magic, 8, 1, file) != 1 || memcmp(magic, FRAME_LOG_MAGIC, 8) != 0
+                || fread(&version, 4, 1, file) != 1 || fread(&headerSize, 4, 1, file) != 1
+                || fseek(file, headerSize, SEEK_SET) != 0)
+        {
+            fprintf(stderr, "%s: not a frames log\n", fileName);
+            return 1;
+        }
+    }
+
+    Sim_RunForUs(0);
+
+    RGB_t colors[LEDS_COUNT];
+    RGB_t sent[LEDS_COUNT];
+    uint64_t timestamp = 0;
+    uint64_t firstTimestamp = 0;
+    uint32_t framesCount = 0;
+
+    memset(sent, 0, sizeof(sent));
+    memset(&g_SimIsrStats, 0, sizeof(g_SimIsrStats));
+    memset(&g_SimReportStats, 0, sizeof(g_SimReportStats));
+
+    uint64_t startCycles = g_SimCycles;
+
+    while (_ReadFrame(file, &timestamp, colors, framesCount))
+    {
+        if (framesCount == 0)
+            firstTimestamp = timestamp;
+
+        Sim_RunUntil(startCycles + (timestamp - firstTimestamp) * SIM_CYCLES_PER_US / 1000);
+
+        uint16_t mask = 0;
+
+        for (uint8_t i = 0; i < LEDS_COUNT; i++)
+            if (memcmp(&colors[i], &sent[i], sizeof(RGB_t)) != 0)
+                mask |= 1 << i;
+
+        if (isPartial && mask != ALL_LEDS_MASK)
+        {
+            if (mask != 0)
+                Sim_QueueUpdateLedsPartial(colors, mask, 0);
+        } else {
+            Sim_QueueUpdateLeds(colors, 0);
+        }
+
+        memcpy(sent, colors, sizeof(sent));
+        framesCount++;
+    }
+
+    Sim_ProcessReports();
+    Sim_RunForUs(100000);
+
+    if (file != NULL)
+        fclose(file);
+
+    uint64_t cycles = g_SimCycles - startCycles;
+    uint32_t isrCount = g_SimIsrStats.count ? g_SimIsrStats.count : 1;
+    uint32_t reportsCount = g_SimReportStats.count ? g_SimReportStats.count : 1;
+
+    printf("hw%d: %u frames, %u reports in %.1f ms\n", LIGHTPACK_HW,
+            framesCount, g_SimReportStats.count, cycles / (double)(SIM_CYCLES_PER_US * 1000));
+    printf("  ISR:    %u calls, I/O %.1f cycles avg, %u max, load %.1f%%\n",
+            g_SimIsrStats.count, g_SimIsrStats.cycles / (double)isrCount, g_SimIsrStats.maxCycles,
+            100.0 * g_SimIsrStats.cycles / (double)cycles);
+    printf("          host %.0f ns avg, %llu ns max\n",
+            g_SimIsrStats.hostNs / (double)isrCount, (unsigned long long)g_SimIsrStats.maxHostNs);
+    printf("  Report: host %.0f ns avg, %llu ns max\n",
+            g_SimReportStats.hostNs / (double)reportsCount, (unsigned long long)g_SimReportStats.maxHostNs);
+
+    SimFeedback_t feedback = Sim_ReadFeedback();
+
+    printf("  Device: %u frames dropped, %u ISR overruns, tick %u us\n",
+            feedback.droppedFramesCount, feedback.isrOverrunsCount, feedback.tickUs);
+
+    return 0;
+}
+
+int main(int argc, char * argv[])
+{
+    if (argc > 1 && strcmp(argv[1], "--bench") == 0)
+    {
+        const char *fileName = NULL;
+        uint8_t isPartial = false;
+
+        for (int i = 2; i < argc; i++)
+        {
+            if (strcmp(argv[i], "--partial") == 0)
+                isPartial = true;
+            else
+                fileName = argv[i];
+        }
+
+        return RunBenchmark(fileName, isPartial);
+    }
+
+    return RunTests();
+}
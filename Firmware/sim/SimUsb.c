@@ -0,0 +1,121 @@
+/*
+ * SimUsb.c
+ *
+ *  Created on: 19.10.2026
+ *     Project: Lightpack
+ *
+ *  Copyright (c) 2011 Mike Shatohin, mikeshatohin [at] gmail.com
+ *
+ *  Lightpack is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Lightpack is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <string.h>
+
+#include <LUFA/Drivers/USB/USB.h>
+
+#include "SimUsb.h"
+
+SimStats_t g_SimReportStats;
+
+static uint8_t s_reports[SIM_REPORTS_QUEUE_SIZE][SIM_REPORT_SIZE];
+static uint16_t s_reportsSize[SIM_REPORTS_QUEUE_SIZE];
+static uint8_t s_reportsHead;
+static uint8_t s_reportsCount;
+
+static USB_ClassInfo_HID_Device_t * s_hidInterface;
+
+uint8_t SimUsb_QueueReport(const uint8_t * data, const uint16_t size)
+{
+    if (s_reportsCount == SIM_REPORTS_QUEUE_SIZE || size > SIM_REPORT_SIZE)
+        return false;
+
+    uint8_t index = (s_reportsHead + s_reportsCount) % SIM_REPORTS_QUEUE_SIZE;
+
+    memset(s_reports[index], 0, SIM_REPORT_SIZE);
+    memcpy(s_reports[index], data, size);
+    s_reportsSize[index] = size;
+    s_reportsCount++;
+
+    return true;
+}
+
+uint8_t SimUsb_PendingReports(void)
+{
+    return s_reportsCount;
+}
+
+uint16_t SimUsb_ReadInReport(uint8_t * data)
+{
+    uint8_t reportId = 0;
+    uint16_t size = 0;
+
+    memset(data, 0, SIM_REPORT_SIZE);
+    CALLBACK_HID_Device_CreateHIDReport(s_hidInterface, &reportId, HID_REPORT_ITEM_In, data, &size);
+
+    return size;
+}
+
+void USB_Init(void)
+{
+    EVENT_USB_Device_Connect();
+    EVENT_USB_Device_ConfigurationChanged();
+}
+
+void USB_USBTask(void)
+{
+}
+
+void USB_Device_EnableSOFEvents(void)
+{
+}
+
+bool HID_Device_ConfigureEndpoints(USB_ClassInfo_HID_Device_t * const HIDInterfaceInfo)
+{
+    s_hidInterface = HIDInterfaceInfo;
+    return true;
+}
+
+void HID_Device_ProcessControlRequest(USB_ClassInfo_HID_Device_t * const HIDInterfaceInfo)
+{
+    (void)HIDInterfaceInfo;
+}
+
+void HID_Device_MillisecondElapsed(USB_ClassInfo_HID_Device_t * const HIDInterfaceInfo)
+{
+    (void)HIDInterfaceInfo;
+}
+
+void HID_Device_USBTask(USB_ClassInfo_HID_Device_t * const HIDInterfaceInfo)
+{
+    if (s_reportsCount == 0)
+        return;
+
+    uint8_t index = s_reportsHead;
+    s_reportsHead = (s_reportsHead + 1) % SIM_REPORTS_QUEUE_SIZE;
+    s_reportsCount--;
+
+    uint64_t startNs = SimHost_TimeNs();
+
+    CALLBACK_HID_Device_ProcessHIDReport(HIDInterfaceInfo, 0, HID_REPORT_ITEM_Out,
+            s_reports[index], s_reportsSize[index]);
+    SimAvr_Flush();
+
+    uint64_t hostNs = SimHost_TimeNs() - startNs;
+
+    g_SimReportStats.count++;
+    g_SimReportStats.hostNs += hostNs;
+    if (hostNs > g_SimReportStats.maxHostNs)
+        g_SimReportStats.maxHostNs = hostNs;
+}
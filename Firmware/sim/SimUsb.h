@@ -0,0 +1,50 @@
+/*
+ * SimUsb.h
+ *
+ *  Created on: 19.10.2026
+ *     Project: Lightpack
+ *
+ *  Copyright (c) 2011 Mike Shatohin, mikeshatohin [at] gmail.com
+ *
+ *  Lightpack is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Lightpack is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef SIMUSB_H_INCLUDED
+#define SIMUSB_H_INCLUDED
+
+#include <stdint.h>
+
+#include "SimAvr.h"
+
+/*
+ *  USB side of the host build: reports queued by the harness are passed to
+ *  CALLBACK_HID_Device_ProcessHIDReport() from HID_Device_USBTask(), one
+ *  report per pass of the firmware main loop like LUFA does.
+ */
+
+#define SIM_REPORT_SIZE         64
+#define SIM_REPORTS_QUEUE_SIZE  16
+
+// Returns false if the queue is full, the report is dropped then
+uint8_t SimUsb_QueueReport(const uint8_t * data, const uint16_t size);
+uint8_t SimUsb_PendingReports(void);
+
+// IN report of the firmware as the host reads it, returns its size
+uint16_t SimUsb_ReadInReport(uint8_t * data);
+
+// Host time of the report processing
+extern SimStats_t g_SimReportStats;
+
+#endif /* SIMUSB_H_INCLUDED */
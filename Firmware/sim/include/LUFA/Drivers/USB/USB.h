@@ -0,0 +1,93 @@
+/*
+ * x
+ *
+ *  Created on: 19.10.2026
+ *     Project: Lightpack
+ *
+ *  Copyright (c) 2011 Mike Shatohin, mikeshatohin [at] gmail.com
+ *
+ *  Lightpack is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Lightpack is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef SIM_LUFA_USB_H_INCLUDED
+#define SIM_LUFA_USB_H_INCLUDED
+
+/*
+ *  Part of LUFA USB and HID class driver API used by the firmware.
+ *  Reports are passed by ../../../../SimUsb.c instead of the USB controller.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <util/atomic.h>
+
+#define ATTR_WARN_UNUSED_RESULT
+#define ATTR_NON_NULL_PTR_ARG(...)
+
+#define HID_REPORT_ITEM_In          0
+#define HID_REPORT_ITEM_Out         1
+#define HID_REPORT_ITEM_Feature     2
+
+typedef struct { uint8_t unused; } USB_Descriptor_Configuration_Header_t;
+typedef struct { uint8_t unused; } USB_Descriptor_Interface_t;
+typedef struct { uint8_t unused; } USB_HID_Descriptor_HID_t;
+typedef struct { uint8_t unused; } USB_Descriptor_Endpoint_t;
+
+typedef struct
+{
+    struct
+    {
+        uint8_t InterfaceNumber;
+
+        uint8_t ReportINEndpointNumber;
+        uint16_t ReportINEndpointSize;
+        bool ReportINEndpointDoubleBank;
+
+        void *PrevReportINBuffer;
+        uint8_t PrevReportINBufferSize;
+    } Config;
+
+} USB_ClassInfo_HID_Device_t;
+
+void USB_Init(void);
+void USB_USBTask(void);
+void USB_Device_EnableSOFEvents(void);
+
+void EVENT_USB_Device_Connect(void);
+void EVENT_USB_Device_Disconnect(void);
+void EVENT_USB_Device_ConfigurationChanged(void);
+void EVENT_USB_Device_ControlRequest(void);
+void EVENT_USB_Device_StartOfFrame(void);
+
+void HID_Device_USBTask(USB_ClassInfo_HID_Device_t * const HIDInterfaceInfo);
+bool HID_Device_ConfigureEndpoints(USB_ClassInfo_HID_Device_t * const HIDInterfaceInfo);
+void HID_Device_ProcessControlRequest(USB_ClassInfo_HID_Device_t * const HIDInterfaceInfo);
+void HID_Device_MillisecondElapsed(USB_ClassInfo_HID_Device_t * const HIDInterfaceInfo);
+
+bool CALLBACK_HID_Device_CreateHIDReport(USB_ClassInfo_HID_Device_t * const HIDInterfaceInfo,
+        uint8_t * const ReportID,
+        const uint8_t ReportType,
+        void * ReportData,
+        uint16_t * const ReportSize);
+
+void CALLBACK_HID_Device_ProcessHIDReport(USB_ClassInfo_HID_Device_t * const HIDInterfaceInfo,
+        const uint8_t ReportID,
+        const uint8_t ReportType,
+        const void * ReportData,
+        const uint16_t ReportSize);
+
+#endif /* SIM_LUFA_USB_H_INCLUDED */
@@ -0,0 +1,77 @@
+/*
+ * avr/io.h
+ *
+ *  Created on: 19.10.2026
+ *     Project: Lightpack
+ *
+ *  Copyright (c) 2011 Mike Shatohin, mikeshatohin [at] gmail.com
+ *
+ *  Lightpack is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Lightpack is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef SIM_AVR_IO_H_INCLUDED
+#define SIM_AVR_IO_H_INCLUDED
+
+/*
+ *  Registers of AT90USB162 used by the firmware, see ../../SimAvr.h
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "../../SimAvr.h"
+
+#define _BV(bit)    (1 << (bit))
+
+extern volatile uint8_t DDRB, PINB, PORTC, DDRC, PINC, PORTD, DDRD, PIND;
+extern volatile uint8_t TCCR1A, TCCR1B, TCCR1C, TCCR0A, TCCR0B, TCNT0;
+extern volatile uint8_t TIMSK0, TIMSK1, WDTCSR, SPCR;
+extern volatile uint16_t OCR1A;
+
+#define PORTB   (*SimAvr_PortB())
+#define SPDR    (*SimAvr_SpiData())
+#define SPSR    (*SimAvr_SpiStatus())
+#define TCNT1   (*SimAvr_Timer1Counter())
+#define TIFR1   (*SimAvr_Timer1Flags())
+
+// TCCR0B, TCCR1B
+#define CS00    0
+#define CS01    1
+#define CS02    2
+#define CS10    0
+#define CS11    1
+#define CS12    2
+
+// TIMSK0, TIMSK1, TIFR1
+#define TOIE0   0
+#define OCIE1A  1
+#define OCF1A   1
+
+// WDTCSR
+#define WDIE    6
+
+// SPCR, SPSR
+#define SPR0    0
+#define SPR1    1
+#define CPHA    2
+#define CPOL    3
+#define MSTR    4
+#define DORD    5
+#define SPE     6
+#define SPIE    7
+#define SPI2X   0
+#define SPIF    7
+
+#endif /* SIM_AVR_IO_H_INCLUDED */
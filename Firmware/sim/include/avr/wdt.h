@@ -0,0 +1,37 @@
+/*
+ * x
+ *
+ *  Created on: 19.10.2026
+ *     Project: Lightpack
+ *
+ *  Copyright (c) 2011 Mike Shatohin, mikeshatohin [at] gmail.com
+ *
+ *  Lightpack is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Lightpack is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef SIM_AVR_WDT_H_INCLUDED
+#define SIM_AVR_WDT_H_INCLUDED
+
+#define WDTO_250MS  4
+
+#define wdt_enable(timeout)
+
+// Main loop of the firmware resets watchdog on each pass,
+// simulation runs timer interrupts and USB events here
+void SimMain_Idle(void);
+
+#define wdt_reset() SimMain_Idle()
+
+#endif /* SIM_AVR_WDT_H_INCLUDED */
@@ -0,0 +1,34 @@
+/*
+ * x
+ *
+ *  Created on: 19.10.2026
+ *     Project: Lightpack
+ *
+ *  Copyright (c) 2011 Mike Shatohin, mikeshatohin [at] gmail.com
+ *
+ *  Lightpack is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Lightpack is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef SIM_UTIL_ATOMIC_H_INCLUDED
+#define SIM_UTIL_ATOMIC_H_INCLUDED
+
+// Interrupts are called only between passes of the main loop,
+// so the firmware code is atomic anyway
+#define ATOMIC_RESTORESTATE     0
+#define ATOMIC_FORCEON          0
+
+#define ATOMIC_BLOCK(type)      for (uint8_t _atomicOnce = 1; _atomicOnce; _atomicOnce = 0)
+
+#endif /* SIM_UTIL_ATOMIC_H_INCLUDED */
@@ -31,6 +31,9 @@
 
 TEMPLATE = subdirs
 SUBDIRS = src tests
+unix:!macx {
+    SUBDIRS += tests/benchmark
+}
 win32 {
     SUBDIRS += libraryinjector \
                hooks
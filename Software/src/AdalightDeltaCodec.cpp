@@ -0,0 +1,260 @@
+/*
+ * AdalightDeltaCodec.cpp
+ *
+ *  Created on: 19.10.2026
+ *     Project: Lightpack
+ *
+ *  Lightpack is very simple implementation of the backlight for a laptop
+ *
+ *  Copyright (c) 2011 Mike Shatohin, mikeshatohin [at] gmail.com
+ *
+ *  Lightpack is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Lightpack is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <string.h>
+#include "AdalightDeltaCodec.hpp"
+
+// 'A' 'd' 'z' countHi countLo checksum type spansHi spansLo
+const int AdalightDeltaCodec::HeaderSize = 9;
+const int AdalightDeltaCodec::SpanHeaderSize = 3;
+const int AdalightDeltaCodec::MaximumSpanLeds = 128;
+const int AdalightDeltaCodec::KeyframeIntervalDefault = 50;
+
+namespace
+{
+const char KeyframeType = 'K';
+const char DeltaType = 'D';
+const unsigned char FillFlag = 0x80;
+
+// Shorter runs of one color are cheaper to send in literal span
+const int FillRunMinimum = 3;
+// Unchanged LEDs between changes cost as much as header of the new span
+const int MergeGapLeds = 1;
+
+inline bool isSameColor(const char * a, const char * b)
+{
+    return a[0] == b[0] && a[1] == b[1] && a[2] == b[2];
+}
+}
+
+AdalightDeltaCodec::AdalightDeltaCodec()
+{
+    m_keyframeInterval = KeyframeIntervalDefault;
+    reset();
+}
+
+void AdalightDeltaCodec::setKeyframeInterval(int frames)
+{
+    m_keyframeInterval = frames > 0 ? frames : 1;
+}
+
+void AdalightDeltaCodec::reset()
+{
+    m_previous.clear();
+    m_framesSinceKeyframe = 0;
+}
+
+void AdalightDeltaCodec::encode(const QByteArray & colors, QByteArray & packet)
+{
+    int ledsCount = colors.size() / 3;
+
+    bool isKeyframe = (m_previous.size() != colors.size()) || (m_framesSinceKeyframe >= m_keyframeInterval);
+
+    if (isKeyframe == false)
+    {
+        // Span covers at least one LED, so it takes no more than 6 bytes per LED
+        packet.resize(HeaderSize + 6 * ledsCount);
+        m_changed.resize(ledsCount);
+
+        const char * current = colors.constData();
+        const char * previous = m_previous.constData();
+        char * changed = m_changed.data();
+
+        for (int i = 0; i < ledsCount; i++)
+            changed[i] = !isSameColor(current + 3 * i, previous + 3 * i);
+
+        char * out = packet.data() + HeaderSize;
+        int spansCount = encodeSpans(current, changed, ledsCount, out);
+        int packetSize = out - packet.constData();
+
+        if (packetSize <= HeaderSize + 3 * ledsCount)
+        {
+            writeHeader(packet.data(), ledsCount, DeltaType, spansCount);
+            packet.resize(packetSize);
+
+            memcpy(m_previous.data(), current, colors.size());
+            m_framesSinceKeyframe++;
+            return;
+        }
+        // Too many changes, keyframe is smaller
+    }
+
+    encodeKeyframe(colors, packet);
+
+    m_previous = colors;
+    m_framesSinceKeyframe = 0;
+}
+
+int AdalightDeltaCodec::encodeKeyframe(const QByteArray & colors, QByteArray & packet)
+{
+    int ledsCount = colors.size() / 3;
+
+    packet.resize(HeaderSize + 6 * ledsCount);
+    m_changed.fill(1, ledsCount);
+
+    char * out = packet.data() + HeaderSize;
+    int spansCount = encodeSpans(colors.constData(), m_changed.constData(), ledsCount, out);
+
+    writeHeader(packet.data(), ledsCount, KeyframeType, spansCount);
+    packet.resize(out - packet.constData());
+
+    return spansCount;
+}
+
+int AdalightDeltaCodec::encodeSpans(const char * colors, const char * changed, int ledsCount, char * & out)
+{
+    int spansCount = 0;
+    int i = 0;
+
+    while (i < ledsCount)
+    {
+        if (!changed[i])
+        {
+            i++;
+            continue;
+        }
+
+        // Region of changed LEDs with short unchanged gaps
+        int regionEnd = i + 1;
+        for (int j = i + 1; j < ledsCount && j - regionEnd <= MergeGapLeds; j++)
+        {
+            if (changed[j])
+                regionEnd = j + 1;
+        }
+
+        while (i < regionEnd)
+        {
+            int run = 1;
+            while (i + run < regionEnd && run < MaximumSpanLeds && isSameColor(colors + 3 * i, colors + 3 * (i + run)))
+                run++;
+
+            int spanLeds;
+            bool isFill = run >= FillRunMinimum;
+
+            if (isFill)
+            {
+                spanLeds = run;
+            } else {
+                // Literal span lasts until the next run which is worth to fill
+                spanLeds = run;
+                while (i + spanLeds < regionEnd && spanLeds < MaximumSpanLeds)
+                {
+                    const char * color = colors + 3 * (i + spanLeds);
+                    int next = 1;
+                    while (i + spanLeds + next < regionEnd && next < FillRunMinimum && isSameColor(color, color + 3 * next))
+                        next++;
+                    if (next >= FillRunMinimum)
+                        break;
+                    spanLeds += next;
+                }
+                if (spanLeds > MaximumSpanLeds)
+                    spanLeds = MaximumSpanLeds;
+            }
+
+            *out++ = (char)((i >> 8) & 0xff);
+            *out++ = (char)(i & 0xff);
+            *out++ = (char)((isFill ? FillFlag : 0) | (spanLeds - 1));
+
+            if (isFill)
+            {
+                memcpy(out, colors + 3 * i, 3);
+                out += 3;
+            } else {
+                memcpy(out, colors + 3 * i, 3 * spanLeds);
+                out += 3 * spanLeds;
+            }
+
+            spansCount++;
+            i += spanLeds;
+        }
+    }
+
+    return spansCount;
+}
+
+void AdalightDeltaCodec::writeHeader(char * out, int ledsCount, char type, int spansCount)
+{
+    int ledsCountHi = ((ledsCount - 1) >> 8) & 0xff;
+    int ledsCountLo = (ledsCount  - 1) & 0xff;
+
+    out[0] = 'A';
+    out[1] = 'd';
+    out[2] = 'z';
+    out[3] = (char)ledsCountHi;
+    out[4] = (char)ledsCountLo;
+    out[5] = (char)(ledsCountHi ^ ledsCountLo ^ 0x55);
+    out[6] = type;
+    out[7] = (char)((spansCount >> 8) & 0xff);
+    out[8] = (char)(spansCount & 0xff);
+}
+
+bool AdalightDeltaCodec::decode(const QByteArray & packet, QByteArray & colors)
+{
+    const unsigned char * in = (const unsigned char *)packet.constData();
+    int size = packet.size();
+
+    if (size < HeaderSize || in[0] != 'A' || in[1] != 'd' || in[2] != 'z')
+        return false;
+
+    if ((in[3] ^ in[4] ^ 0x55) != in[5])
+        return false;
+
+    int ledsCount = ((in[3] << 8) | in[4]) + 1;
+    int spansCount = (in[7] << 8) | in[8];
+
+    if (in[6] == KeyframeType)
+        colors.fill(0, 3 * ledsCount);
+    else if (in[6] != DeltaType || colors.size() != 3 * ledsCount)
+        return false; // Unknown type or delta before the keyframe
+
+    char * out = colors.data();
+    int pos = HeaderSize;
+
+    for (int span = 0; span < spansCount; span++)
+    {
+        if (pos + SpanHeaderSize > size)
+            return false;
+
+        int start = (in[pos] << 8) | in[pos + 1];
+        bool isFill = in[pos + 2] & FillFlag;
+        int spanLeds = (in[pos + 2] & ~FillFlag) + 1;
+        pos += SpanHeaderSize;
+
+        if (start + spanLeds > ledsCount || pos + (isFill ? 3 : 3 * spanLeds) > size)
+            return false;
+
+        if (isFill)
+        {
+            for (int i = start; i < start + spanLeds; i++)
+                memcpy(out + 3 * i, in + pos, 3);
+            pos += 3;
+        } else {
+            memcpy(out + 3 * start, in + pos, 3 * spanLeds);
+            pos += 3 * spanLeds;
+        }
+    }
+
+    return pos == size;
+}
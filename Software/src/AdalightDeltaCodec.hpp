@@ -0,0 +1,80 @@
+/*
+ * AdalightDeltaCodec.hpp
+ *
+ *  Created on: 19.10.2026
+ *     Project: Lightpack
+ *
+ *  Lightpack is very simple implementation of the backlight for a laptop
+ *
+ *  Copyright (c) 2011 Mike Shatohin, mikeshatohin [at] gmail.com
+ *
+ *  Lightpack is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Lightpack is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <QByteArray>
+#include "SerialOutputEngine.hpp"
+
+/*!
+  "Adz" variant of the Adalight protocol: only changed LEDs are sent.
+
+  Packet:
+    'A' 'd' 'z' countHi countLo (countHi ^ countLo ^ 0x55)  -- as in "Ada", count is LEDs - 1
+    type                                                    -- 'K' keyframe or 'D' delta
+    spansHi spansLo                                         -- number of spans
+    spans
+
+  Span:
+    startHi startLo control                                 -- first LED, control = fill flag (0x80) | (LEDs - 1)
+    r g b                                                   -- if fill flag is set, one color for all LEDs of span
+    r g b ... r g b                                         -- otherwise color of each LED
+
+  Keyframe covers all LEDs and is sent periodically, after reset and when
+  LEDs count changes. Decoder ignores deltas until it gets a keyframe.
+  Colors are in the wire order, i.e. after the color sequence is applied.
+*/
+class AdalightDeltaCodec : public SerialFrameEncoder
+{
+public:
+    AdalightDeltaCodec();
+
+    void setKeyframeInterval(int frames);
+    int keyframeInterval() const { return m_keyframeInterval; }
+
+    // Next encoded frame will be a keyframe
+    void reset();
+
+    void encode(const QByteArray & colors, QByteArray & packet);
+
+    // Reference decoder: applies packet to the colors of previous frames
+    static bool decode(const QByteArray & packet, QByteArray & colors);
+
+    static const int HeaderSize;
+    static const int SpanHeaderSize;
+    static const int MaximumSpanLeds;
+    static const int KeyframeIntervalDefault;
+
+private:
+    int encodeSpans(const char * colors, const char * changed, int ledsCount, char * & out);
+    int encodeKeyframe(const QByteArray & colors, QByteArray & packet);
+    void writeHeader(char * out, int ledsCount, char type, int spansCount);
+
+private:
+    QByteArray m_previous;
+    QByteArray m_changed;
+    int m_keyframeInterval;
+    int m_framesSinceKeyframe;
+};
@@ -26,6 +26,13 @@
 
 #include <QtNetwork>
 #include <stdlib.h>
+#include <string.h>
+
+#ifdef Q_OS_LINUX
+#include <errno.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
 
 #include "ApiServer.hpp"
 #include "LightpackPluginInterface.hpp"
@@ -83,6 +90,14 @@ const char * ApiServer::CmdGetScreenSize = "getscreensize";
 const char * ApiServer:: CmdResultScreenSize = "screensize:";
 
 
+const char * ApiServer::CmdGetUdpSession = "getudpsession";
+// Necessary to add a new line after filling results!
+const char * ApiServer::CmdResultUdpSession = "udpsession:";
+const char * ApiServer::CmdResultUdpSession_Disabled = "udpsession:disabled\r\n";
+
+const char * ApiServer::CmdGetUdpStats = "getudpstats";
+const char * ApiServer::CmdResultUdpStats = "udpstats:";
+
 const char * ApiServer::CmdGetBacklight = "getmode";
 const char * ApiServer::CmdResultBacklight_Ambilight = "mode:ambilight\r\n";
 const char * ApiServer::CmdResultBacklight_Moodlamp = "mode:moodlamp\r\n";
@@ -109,6 +124,8 @@ const char * ApiServer::CmdSetBrightness = "setbrightness:";
 const char * ApiServer::CmdSetSmooth = "setsmooth:";
 const char * ApiServer::CmdSetProfile = "setprofile:";
 const char * ApiServer::CmdSetLeds = "setleds:";
+// Switches connection to binary frames, see initHelpMessage()
+const char * ApiServer::CmdSetFrame = "setframe";
 
 const char * ApiServer::CmdNewProfile = "newprofile:";
 const char * ApiServer::CmdDeleteProfile = "deleteprofile:";
@@ -121,8 +138,27 @@ const char * ApiServer::CmdSetBacklight = "setmode:";
 const char * ApiServer::CmdSetBacklight_Ambilight = "ambilight";
 const char * ApiServer::CmdSetBacklight_Moodlamp = "moodlamp";
 
+// Events are pushed with the same lines as results of get-commands
+const char * ApiServer::CmdSubscribe = "subscribe:";
+const char * ApiServer::CmdUnsubscribe = "unsubscribe:";
+const char * ApiServer::CmdSubscribe_Colors = "colors";
+const char * ApiServer::CmdSubscribe_Fps = "fps";
+const char * ApiServer::CmdSubscribe_Status = "status";
+const char * ApiServer::CmdSubscribe_Profile = "profile";
+const char * ApiServer::CmdSubscribe_Lock = "lock";
+
 const int ApiServer::SignalWaitTimeoutMs = 1000; // 1 second
 
+const int ApiServer::PushColorsDefaultRate = 25;
+const int ApiServer::PushColorsMaxRate = 100;
+const int ApiServer::PushFpsIntervalMs = 1000;
+const int ApiServer::PushTimerIntervalMs = 10;
+const int ApiServer::PushMaxBacklogBytes = 16 * 1024;
+
+const char * ApiServer::FrameMagic = "LF";
+const int ApiServer::FrameHeaderSize = 6;
+const int ApiServer::UdpHeaderSize = 12 + FrameHeaderSize;
+
 ApiServer::ApiServer(QObject *parent)
     : QTcpServer(parent)
 {
@@ -132,7 +168,7 @@ ApiServer::ApiServer(QObject *parent)
     initShortHelpMessage();
 }
 
-ApiServer::ApiServer(quint16 port, QObject *parent)
+ApiServer::ApiServer(quint16 port, quint16 udpPort, const QString & localSocketName, QObject *parent)
     : QTcpServer(parent)
 {
     // This constructor is for using in ApiTests
@@ -149,6 +185,18 @@ ApiServer::ApiServer(quint16 port, QObject *parent)
     {
         qFatal("%s listen(Any, %d) fail", Q_FUNC_INFO, m_apiPort);
     }
+
+    m_isUdpEnabled = (udpPort != 0);
+    m_apiUdpPort = udpPort;
+
+    if (m_isUdpEnabled)
+        startUdpListening();
+
+    m_isLocalSocketEnabled = (localSocketName.isEmpty() == false);
+    m_localSocketName = localSocketName;
+
+    if (m_isLocalSocketEnabled)
+        startLocalListening();
 }
 
 void ApiServer::setInterface(LightpackPluginInterface *lightpackInterface)
@@ -156,9 +204,13 @@ void ApiServer::setInterface(LightpackPluginInterface *lightpackInterface)
     QString test = lightpack->Version();
     DEBUG_LOW_LEVEL << Q_FUNC_INFO << test;
     lightpack = lightpackInterface;
-    connect(m_apiSetColorTask, SIGNAL(taskParseSetColorDone(QList<QRgb>)), lightpack, SIGNAL(updateLedsColors(QList<QRgb>)), Qt::QueuedConnection);
-    connect(m_apiSetColorTask, SIGNAL(taskParseSetColorDone(const QList<QRgb> &)), lightpack, SLOT(updateColors(const QList<QRgb> &)), Qt::QueuedConnection);
 
+    // Queued, so pushes caused by commands of the client are written after the replies
+    connect(lightpack, SIGNAL(colorsChanged(QList<QRgb>)), this, SLOT(onColorsChanged(QList<QRgb>)), Qt::QueuedConnection);
+    connect(lightpack, SIGNAL(fpsChanged(double)),         this, SLOT(onFpsChanged(double)), Qt::QueuedConnection);
+    connect(lightpack, SIGNAL(ChangeStatus(int)),          this, SLOT(onStatusChanged(int)), Qt::QueuedConnection);
+    connect(lightpack, SIGNAL(ChangeProfile(QString)),     this, SLOT(onProfileChanged(QString)), Qt::QueuedConnection);
+    connect(lightpack, SIGNAL(ChangeLockStatus(bool)),     this, SLOT(onLockStatusChanged(bool)), Qt::QueuedConnection);
 }
 
 
@@ -210,34 +262,91 @@ void ApiServer::incomingConnection(int socketDescriptor)
     QTcpSocket *client = new QTcpSocket(this);
     client->setSocketDescriptor(socketDescriptor);
 
+    DEBUG_LOW_LEVEL << "Incoming connection from:" << client->peerAddress().toString();
+
+    addClient(client, !m_isAuthEnabled);
+}
+
+void ApiServer::localClientConnected()
+{
+    while (m_localServer->hasPendingConnections())
+    {
+        QLocalSocket *client = m_localServer->nextPendingConnection();
+
+        bool isTrusted = isLocalPeerTrusted(client);
+
+        DEBUG_LOW_LEVEL << "Incoming local connection, trusted:" << isTrusted;
+
+        // Trusted peer doesn't need apikey command
+        addClient(client, isTrusted || !m_isAuthEnabled);
+    }
+}
+
+bool ApiServer::isLocalPeerTrusted(QLocalSocket* client)
+{
+#ifdef Q_OS_LINUX
+    struct ucred cred;
+    socklen_t size = sizeof(cred);
+
+    if (getsockopt(client->socketDescriptor(), SOL_SOCKET, SO_PEERCRED, &cred, &size) != 0)
+    {
+        qWarning() << Q_FUNC_INFO << "SO_PEERCRED failed:" << strerror(errno);
+        return false;
+    }
+
+    // Process of the same user can read the API key from settings anyway
+    return cred.uid == getuid();
+#else
+    // No peer credentials, local clients use apikey command as TCP ones
+    Q_UNUSED(client);
+    return false;
+#endif
+}
+
+void ApiServer::addClient(QIODevice* client, bool isAuthorized)
+{
     ClientInfo cs;
-    cs.isAuthorized = !m_isAuthEnabled;
+    cs.isAuthorized = isAuthorized;
     cs.sessionKey = "API"+lightpack->GetSessionKey("API")+QString(m_clients.count());
+    cs.isFrameMode = false;
+    cs.frameFormat = FrameFormatRgb8;
+    cs.frameLedsCount = 0;
+    cs.setColorTasksCount = 0;
+    cs.udpToken = 0;
+    cs.udpSequence = 0;
+    cs.isUdpSequenceStarted = false;
+    cs.subscriptions = 0;
+    cs.pendingPushes = 0;
+    cs.colorsPushIntervalMs = 1000 / PushColorsDefaultRate;
 
     m_clients.insert(client, cs);
 
     client->write(ApiVersion);
 
-    DEBUG_LOW_LEVEL << "Incoming connection from:" << client->peerAddress().toString();
-
     connect(client, SIGNAL(readyRead()), this, SLOT(clientProcessCommands()));
     connect(client, SIGNAL(disconnected()), this, SLOT(clientDisconnected()));
+    connect(client, SIGNAL(bytesWritten(qint64)), this, SLOT(clientBytesWritten()));
 }
 
 void ApiServer::clientDisconnected()
 {
-    QTcpSocket *client = dynamic_cast<QTcpSocket*>(sender());
+    QIODevice *client = dynamic_cast<QIODevice*>(sender());
 
-    DEBUG_LOW_LEVEL << "Client disconnected:" << client->peerAddress().toString();
+    QTcpSocket *tcpClient = dynamic_cast<QTcpSocket*>(client);
+
+    DEBUG_LOW_LEVEL << "Client disconnected:" << (tcpClient ? tcpClient->peerAddress().toString() : "local");
 
     QString sessionKey = m_clients[client].sessionKey;
     if (lightpack->CheckLock(sessionKey)==1)
         lightpack->UnLock(sessionKey);
 
+    cancelSetColorTasks(client);
+    m_udpSessions.remove(m_clients[client].udpToken);
     m_clients.remove(client);
 
     disconnect(client, SIGNAL(readyRead()), this, SLOT(clientProcessCommands()));
     disconnect(client, SIGNAL(disconnected()), this, SLOT(clientDisconnected()));
+    disconnect(client, SIGNAL(bytesWritten(qint64)), this, SLOT(clientBytesWritten()));
 
     client->deleteLater();
 }
@@ -246,10 +355,33 @@ void ApiServer::clientProcessCommands()
 {
     API_DEBUG_OUT << Q_FUNC_INFO << "ApiServer thread id:" << this->thread()->currentThreadId();
 
-    QTcpSocket *client = dynamic_cast<QTcpSocket*>(sender());
+    QIODevice *client = dynamic_cast<QIODevice*>(sender());
+
+    processCommands(client);
+}
 
-    while (m_clients.contains(client) && client->canReadLine())
+void ApiServer::processCommands(QIODevice* client)
+{
+    while (m_clients.contains(client))
     {
+        if (m_clients[client].isFrameMode)
+        {
+            // Returns false while the next frame is not received completely
+            if (clientProcessFrames(client) == false)
+                return;
+            continue;
+        }
+
+        if (client->canReadLine() == false)
+            return;
+
+        // Only setcolor commands are pipelined, other commands wait for the replies of
+        // running setcolor tasks. So replies and changes of the device keep the order
+        // of commands. Processing continues from finishSetColorTask().
+        if (m_clients[client].setColorTasksCount > 0
+                && client->peek(strlen(CmdSetColor)) != CmdSetColor)
+            return;
+
         QString sessionKey =  m_clients[client].sessionKey;
         int m_lockedClient = lightpack->CheckLock(sessionKey);
 
@@ -408,6 +540,22 @@ void ApiServer::clientProcessCommands()
 
             result = QString("%1%2,%3,%4,%5\r\n").arg(CmdResultScreenSize).arg(screen.x()).arg(screen.y()).arg(screen.width()).arg(screen.height());
         }
+        else if (cmdBuffer == CmdGetUdpSession)
+        {
+            API_DEBUG_OUT << CmdGetUdpSession;
+
+            if (m_isUdpEnabled && m_udpSocket->state() == QAbstractSocket::BoundState)
+                result = startUdpSession(client);
+            else
+                result = CmdResultUdpSession_Disabled;
+        }
+        else if (cmdBuffer == CmdGetUdpStats)
+        {
+            API_DEBUG_OUT << CmdGetUdpStats;
+
+            result = QString("%1%2,%3,%4\r\n").arg(CmdResultUdpStats)
+                    .arg(m_udpReceivedCount).arg(m_udpLateCount).arg(m_udpDroppedCount);
+        }
         else if (cmdBuffer == CmdGetBacklight)
         {
             API_DEBUG_OUT << CmdGetBacklight;
@@ -459,41 +607,30 @@ void ApiServer::clientProcessCommands()
                 cmdBuffer.remove(0, cmdBuffer.indexOf(':') + 1);
                 API_DEBUG_OUT << QString(cmdBuffer);
 
-                if (m_isTaskSetColorDone)
-                {
-                    m_isTaskSetColorDone = false;
-                    m_isTaskSetColorParseSuccess = false;
-
-                    // Start task
-                    emit startParseSetColorTask(cmdBuffer);
+                startSetColorTask(client, cmdBuffer);
 
-                    // Wait signal from m_apiSetColorTask with success or fail result of parsing buffer.
-                    // After SignalWaitTimeoutMs milliseconds, the cycle of waiting will end and the
-                    // variable m_isTaskSetColorDone will be reset to 'true' state.
-                    // Also in cycle we process requests from over clients, if this request is setcolor when
-                    // it will be ignored because of m_isTaskSetColorDone == false
-
-                    m_time.restart();
-
-                    while (m_isTaskSetColorDone == false && m_time.elapsed() < SignalWaitTimeoutMs)
-                    {
-                        QApplication::processEvents(QEventLoop::WaitForMoreEvents, SignalWaitTimeoutMs);
-                    }
+                // Result is sent when the task is done, see taskSetColorDone()
+                continue;
+            }
+            else if (m_lockedClient == 0)
+            {
+                result = CmdSetResult_NotLocked;
+            }
+            else // m_lockedClient != client
+            {
+                result = CmdSetResult_Busy;
+            }
+        }
+        else if (cmdBuffer == CmdSetFrame)
+        {
+            API_DEBUG_OUT << CmdSetFrame;
 
-                    if (m_isTaskSetColorDone)
-                    {
-                        if (m_isTaskSetColorParseSuccess)
-                            result = CmdSetResult_Ok;
-                        else
-                            result = CmdSetResult_Error;
-                    } else {
-                        m_isTaskSetColorDone = true; // cmd setcolor is available
-                        result = CmdSetResult_Error;
-                        qWarning() << Q_FUNC_INFO << "Timeout waiting taskIsSuccess() signal from m_apiSetColorTask";
-                    }
-                } else {
-                    qWarning() << Q_FUNC_INFO << "Task setcolor is not completed (you should increase the delay to not skip commands), skip setcolor.";
-                }
+            if (m_lockedClient == 1)
+            {
+                // Next bytes of the stream are binary frames
+                m_clients[client].isFrameMode = true;
+                m_clients[client].frameLedsCount = 0;
+                result = CmdSetResult_Ok;
             }
             else if (m_lockedClient == 0)
             {
@@ -839,6 +976,20 @@ void ApiServer::clientProcessCommands()
                 result = CmdSetResult_Busy;
             }
         }
+        else if (cmdBuffer.startsWith(CmdSubscribe))
+        {
+            API_DEBUG_OUT << CmdSubscribe;
+
+            cmdBuffer.remove(0, cmdBuffer.indexOf(':') + 1);
+            result = processSubscribe(client, cmdBuffer, true);
+        }
+        else if (cmdBuffer.startsWith(CmdUnsubscribe))
+        {
+            API_DEBUG_OUT << CmdUnsubscribe;
+
+            cmdBuffer.remove(0, cmdBuffer.indexOf(':') + 1);
+            result = processSubscribe(client, cmdBuffer, false);
+        }
         else            
         {
             qWarning() << Q_FUNC_INFO << CmdUnknown << cmdBuffer;
@@ -848,10 +999,576 @@ void ApiServer::clientProcessCommands()
     }
 }
 
-void ApiServer::taskSetColorIsSuccess(bool isSuccess)
+bool ApiServer::clientProcessFrames(QIODevice* client)
+{
+    ClientInfo & info = m_clients[client];
+
+    while (true)
+    {
+        if (info.frameLedsCount == 0)
+        {
+            if (client->bytesAvailable() < FrameHeaderSize)
+                return false;
+
+            unsigned char header[FrameHeaderSize];
+            client->read((char *)header, FrameHeaderSize);
+
+            int format, ledsCount;
+
+            if (parseFrameHeader(header, format, ledsCount) == false)
+            {
+                API_DEBUG_OUT << CmdSetFrame << "Error (invalid frame header)";
+
+                // Stream is out of sync, drop received data and go back to text commands
+                client->readAll();
+                info.isFrameMode = false;
+                writeData(client, CmdSetResult_Error);
+                return true;
+            }
+
+            if (ledsCount == 0)
+            {
+                API_DEBUG_OUT << CmdSetFrame << "end of frames";
+
+                info.isFrameMode = false;
+                writeData(client, CmdSetResult_Ok);
+                return true;
+            }
+
+            info.frameFormat = format;
+            info.frameLedsCount = ledsCount;
+        }
+
+        int payloadSize = framePayloadSize(info.frameFormat, info.frameLedsCount);
+
+        if (client->bytesAvailable() < payloadSize)
+            return false;
+
+        m_frameBuffer.resize(payloadSize);
+        client->read(m_frameBuffer.data(), payloadSize);
+
+        decodeFrame((const unsigned char *)m_frameBuffer.constData(), info.frameFormat, info.frameLedsCount);
+        info.frameLedsCount = 0;
+
+        // Frames are not acknowledged, client gets reply only for rejected frame
+        int lockedClient = lightpack->CheckLock(info.sessionKey);
+
+        if (lockedClient == 1)
+            lightpack->SetFrameRgb(info.sessionKey, m_frameColors);
+        else if (lockedClient == 0)
+            writeData(client, CmdSetResult_NotLocked);
+        else
+            writeData(client, CmdSetResult_Busy);
+    }
+}
+
+bool ApiServer::parseFrameHeader(const unsigned char * header, int & format, int & ledsCount)
+{
+    format = header[2];
+    ledsCount = (header[4] << 8) | header[5];
+
+    // Count is checked before the payload is buffered, word allows up to 65535 LEDs
+    return memcmp(header, FrameMagic, 2) == 0 && header[3] == 0
+            && (format == FrameFormatRgb8 || format == FrameFormatRgb16)
+            && ledsCount <= MaximumNumberOfLeds::AbsoluteMaximum;
+}
+
+int ApiServer::framePayloadSize(int format, int ledsCount)
 {
-    m_isTaskSetColorDone = true;
-    m_isTaskSetColorParseSuccess = isSuccess;
+    return ledsCount * (format == FrameFormatRgb16 ? 6 : 3);
+}
+
+void ApiServer::decodeFrame(const unsigned char * data, int format, int ledsCount)
+{
+    if (m_frameColors.size() != ledsCount)
+    {
+        m_frameColors.clear();
+        for (int i = 0; i < ledsCount; i++)
+            m_frameColors << 0;
+    }
+
+    if (format == FrameFormatRgb16)
+    {
+        // Colors are 8 bit per channel, take high bytes of big endian words
+        for (int i = 0; i < ledsCount; i++, data += 6)
+            m_frameColors[i] = qRgb(data[0], data[2], data[4]);
+    } else {
+        for (int i = 0; i < ledsCount; i++, data += 3)
+            m_frameColors[i] = qRgb(data[0], data[1], data[2]);
+    }
+}
+
+QString ApiServer::processSubscribe(QIODevice* client, const QByteArray & args, bool isSubscribe)
+{
+    ClientInfo & info = m_clients[client];
+
+    QList<QByteArray> names = args.split(',');
+    int events = 0;
+    int colorsRate = PushColorsDefaultRate;
+
+    for (int i = 0; i < names.count(); i++)
+    {
+        QByteArray name = names[i].trimmed();
+
+        int rateIndex = name.indexOf('=');
+        if (rateIndex != -1)
+        {
+            bool ok = false;
+            colorsRate = name.mid(rateIndex + 1).toInt(&ok);
+            name.truncate(rateIndex);
+
+            // Rate is only for colors subscription
+            if (!ok || !isSubscribe || name != CmdSubscribe_Colors || colorsRate < 1 || colorsRate > PushColorsMaxRate)
+            {
+                API_DEBUG_OUT << Q_FUNC_INFO << "Error (invalid rate):" << names[i];
+                return CmdSetResult_Error;
+            }
+        }
+
+        if (name == CmdSubscribe_Colors)
+            events |= SubscribeColors;
+        else if (name == CmdSubscribe_Fps)
+            events |= SubscribeFps;
+        else if (name == CmdSubscribe_Status)
+            events |= SubscribeStatus;
+        else if (name == CmdSubscribe_Profile)
+            events |= SubscribeProfile;
+        else if (name == CmdSubscribe_Lock)
+            events |= SubscribeLock;
+        else
+        {
+            API_DEBUG_OUT << Q_FUNC_INFO << "Error (unknown event):" << name;
+            return CmdSetResult_Error;
+        }
+    }
+
+    if (isSubscribe == false)
+    {
+        info.subscriptions &= ~events;
+        info.pendingPushes &= ~events;
+        return CmdSetResult_Ok;
+    }
+
+    if (events & SubscribeColors)
+        info.colorsPushIntervalMs = 1000 / colorsRate;
+
+    // Take current values, other subscribers get them too if they are changed
+    if (events & SubscribeColors)
+        onColorsChanged(lightpack->GetColors());
+    if (events & SubscribeStatus)
+        onStatusChanged(lightpack->GetStatus());
+    if (events & SubscribeFps)
+        onFpsChanged(lightpack->GetFPS());
+    if (events & SubscribeProfile)
+        onProfileChanged(lightpack->GetProfile());
+    if (events & SubscribeLock)
+        onLockStatusChanged(lightpack->GetStatusAPI());
+
+    // New subscriber starts with current values
+    int newEvents = events & ~info.subscriptions;
+
+    info.subscriptions |= events;
+    info.pendingPushes |= newEvents;
+
+    // Pushes are written after the reply, see pushTimeout()
+    if (info.pendingPushes != 0 && m_timerPush->isActive() == false)
+        m_timerPush->start();
+
+    return CmdSetResult_Ok;
+}
+
+void ApiServer::notifySubscribers(int event)
+{
+    QMap<QIODevice*, ClientInfo>::iterator i;
+    for (i = m_clients.begin(); i != m_clients.end(); ++i)
+    {
+        if (i.value().subscriptions & event)
+        {
+            i.value().pendingPushes |= event;
+            flushPushes(i.key());
+        }
+    }
+}
+
+void ApiServer::flushPushes(QIODevice* client)
+{
+    ClientInfo & info = m_clients[client];
+
+    if (info.pendingPushes == 0)
+        return;
+
+    // Slow client gets only the latest values when its backlog is written, see clientBytesWritten()
+    if (client->bytesToWrite() > PushMaxBacklogBytes)
+        return;
+
+    QByteArray data;
+
+    for (int event = SubscribeStatus; event <= SubscribeColors; event <<= 1)
+    {
+        if ((info.pendingPushes & event) == 0)
+            continue;
+
+        QTime *pushTime = NULL;
+        int intervalMs = 0;
+
+        if (event == SubscribeColors)
+        {
+            pushTime = &info.colorsPushTime;
+            intervalMs = info.colorsPushIntervalMs;
+        }
+        else if (event == SubscribeFps)
+        {
+            pushTime = &info.fpsPushTime;
+            intervalMs = PushFpsIntervalMs;
+        }
+
+        if (pushTime != NULL)
+        {
+            // Rate limit, the latest value is pushed later by pushTimeout()
+            if (pushTime->isValid() && pushTime->elapsed() < intervalMs)
+            {
+                if (m_timerPush->isActive() == false)
+                    m_timerPush->start();
+                continue;
+            }
+            pushTime->restart();
+        }
+
+        data += pushMessage(event);
+        info.pendingPushes &= ~event;
+    }
+
+    if (data.isEmpty() == false)
+    {
+        API_DEBUG_OUT << Q_FUNC_INFO << data;
+        client->write(data);
+    }
+}
+
+QByteArray ApiServer::pushMessage(int event)
+{
+    switch (event)
+    {
+    case SubscribeStatus:
+        if (m_pushStatus == 1) return CmdResultStatus_On;
+        if (m_pushStatus == 0) return CmdResultStatus_Off;
+        if (m_pushStatus == -1) return CmdResultStatus_DeviceError;
+        return CmdResultStatus_Unknown;
+
+    case SubscribeProfile:
+        return (CmdResultProfile + m_pushProfile + "\r\n").toUtf8();
+
+    case SubscribeLock:
+        return m_isPushLocked ? CmdResultStatusAPI_Busy : CmdResultStatusAPI_Idle;
+
+    case SubscribeFps:
+        return QString("%1%2\r\n").arg(CmdResultFPS).arg(m_pushFps).toUtf8();
+
+    case SubscribeColors:
+        if (m_pushColorsMessage.isEmpty())
+        {
+            // Same as getcolors result, but without QString formatting for each frame
+            m_pushColorsMessage = CmdResultGetColors;
+
+            for (int i = 0; i < m_pushColors.count(); i++)
+            {
+                m_pushColorsMessage += QByteArray::number(i) + '-';
+                m_pushColorsMessage += QByteArray::number(qRed(m_pushColors[i])) + ',';
+                m_pushColorsMessage += QByteArray::number(qGreen(m_pushColors[i])) + ',';
+                m_pushColorsMessage += QByteArray::number(qBlue(m_pushColors[i])) + ';';
+            }
+            m_pushColorsMessage += "\r\n";
+        }
+        return m_pushColorsMessage;
+    }
+
+    return QByteArray();
+}
+
+void ApiServer::clientBytesWritten()
+{
+    QIODevice *client = dynamic_cast<QIODevice*>(sender());
+
+    if (m_clients.contains(client))
+        flushPushes(client);
+}
+
+void ApiServer::pushTimeout()
+{
+    bool isPending = false;
+
+    QMap<QIODevice*, ClientInfo>::iterator i;
+    for (i = m_clients.begin(); i != m_clients.end(); ++i)
+    {
+        flushPushes(i.key());
+
+        // Clients with backlog are flushed from clientBytesWritten()
+        if (i.value().pendingPushes != 0 && i.key()->bytesToWrite() <= PushMaxBacklogBytes)
+            isPending = true;
+    }
+
+    if (isPending == false)
+        m_timerPush->stop();
+}
+
+void ApiServer::onColorsChanged(const QList<QRgb> & colors)
+{
+    if (colors == m_pushColors)
+        return;
+
+    m_pushColors = colors;
+    m_pushColorsMessage.clear();
+
+    notifySubscribers(SubscribeColors);
+}
+
+void ApiServer::onFpsChanged(double fps)
+{
+    if (fps == m_pushFps)
+        return;
+
+    m_pushFps = fps;
+
+    notifySubscribers(SubscribeFps);
+}
+
+void ApiServer::onStatusChanged(int status)
+{
+    if (status == m_pushStatus)
+        return;
+
+    m_pushStatus = status;
+
+    notifySubscribers(SubscribeStatus);
+}
+
+void ApiServer::onProfileChanged(QString profile)
+{
+    if (profile == m_pushProfile)
+        return;
+
+    m_pushProfile = profile;
+
+    notifySubscribers(SubscribeProfile);
+}
+
+void ApiServer::onLockStatusChanged(bool isLocked)
+{
+    if (isLocked == m_isPushLocked)
+        return;
+
+    m_isPushLocked = isLocked;
+
+    notifySubscribers(SubscribeLock);
+}
+
+QString ApiServer::startUdpSession(QIODevice* client)
+{
+    ClientInfo & info = m_clients[client];
+
+    if (info.udpToken == 0)
+    {
+        // Token is random, datagrams with unknown token are dropped
+        QByteArray uuid = QUuid::createUuid().toRfc4122();
+        quint64 token = 0;
+
+        for (int i = 0; i < 8; i++)
+            token = (token << 8) | (quint8)uuid[i];
+
+        if (token == 0 || m_udpSessions.contains(token))
+            return CmdSetResult_Error;
+
+        info.udpToken = token;
+        m_udpSessions.insert(token, client);
+    }
+
+    // Sequence numbers start over for the new sender
+    info.isUdpSequenceStarted = false;
+
+    return QString("%1%2,%3\r\n").arg(CmdResultUdpSession).arg(m_apiUdpPort).arg(info.udpToken, 16, 16, QChar('0'));
+}
+
+void ApiServer::startUdpListening()
+{
+    DEBUG_LOW_LEVEL << Q_FUNC_INFO << m_apiUdpPort;
+
+    if (m_udpSocket->bind(QHostAddress::Any, m_apiUdpPort) == false)
+    {
+        qWarning() << Q_FUNC_INFO << "API UDP port" << m_apiUdpPort << "bind failed:" << m_udpSocket->errorString();
+    }
+}
+
+void ApiServer::udpProcessDatagrams()
+{
+    while (m_udpSocket->hasPendingDatagrams())
+    {
+        int size = m_udpSocket->pendingDatagramSize();
+
+        m_udpBuffer.resize(qMax(size, 0));
+        size = m_udpSocket->readDatagram(m_udpBuffer.data(), m_udpBuffer.size());
+
+        if (size < 0)
+            break;
+
+        m_udpReceivedCount++;
+
+        processDatagram(m_udpBuffer.constData(), size);
+    }
+}
+
+void ApiServer::processDatagram(const char * data, int size)
+{
+    const unsigned char *datagram = (const unsigned char *)data;
+    int format, ledsCount;
+
+    if (size < UdpHeaderSize || parseFrameHeader(datagram + 12, format, ledsCount) == false
+            || ledsCount == 0 || size != UdpHeaderSize + framePayloadSize(format, ledsCount))
+    {
+        API_DEBUG_OUT << Q_FUNC_INFO << "invalid datagram, size:" << size;
+        m_udpDroppedCount++;
+        return;
+    }
+
+    quint64 token = 0;
+    for (int i = 0; i < 8; i++)
+        token = (token << 8) | datagram[i];
+
+    quint32 sequence = (datagram[8] << 24) | (datagram[9] << 16) | (datagram[10] << 8) | datagram[11];
+
+    QIODevice *client = m_udpSessions.value(token, NULL);
+
+    if (client == NULL)
+    {
+        API_DEBUG_OUT << Q_FUNC_INFO << "unknown session";
+        m_udpDroppedCount++;
+        return;
+    }
+
+    ClientInfo & info = m_clients[client];
+
+    // Serial number arithmetic, so sequence can wrap around
+    if (info.isUdpSequenceStarted && (qint32)(sequence - info.udpSequence) <= 0)
+    {
+        API_DEBUG_OUT << Q_FUNC_INFO << "late datagram:" << sequence << "last:" << info.udpSequence;
+        m_udpLateCount++;
+        return;
+    }
+
+    info.udpSequence = sequence;
+    info.isUdpSequenceStarted = true;
+
+    if (lightpack->CheckLock(info.sessionKey) != 1)
+    {
+        API_DEBUG_OUT << Q_FUNC_INFO << "session is not locked";
+        m_udpDroppedCount++;
+        return;
+    }
+
+    decodeFrame(datagram + UdpHeaderSize, format, ledsCount);
+
+    lightpack->SetFrameRgb(info.sessionKey, m_frameColors);
+}
+
+void ApiServer::startSetColorTask(QIODevice* client, const QByteArray & buffer)
+{
+    SetColorTaskInfo task;
+    task.id = m_lastSetColorTaskId = (m_lastSetColorTaskId + 1) & 0x7fffffff;
+    task.client = client;
+    task.time.start();
+
+    m_setColorTasks.enqueue(task);
+    m_clients[client].setColorTasksCount++;
+
+    if (m_timerSetColorTasks->isActive() == false)
+        restartSetColorTasksTimer();
+
+    emit startParseSetColorTask(task.id, buffer);
+}
+
+void ApiServer::taskSetColorDone(int taskId, bool isSuccess, const QList<QRgb> & colors)
+{
+    // Tasks are done in order of start, so if it isn't the first one it is already timed out
+    if (m_setColorTasks.isEmpty() || m_setColorTasks.head().id != taskId)
+    {
+        API_DEBUG_OUT << Q_FUNC_INFO << "task is timed out:" << taskId;
+        return;
+    }
+
+    SetColorTaskInfo task = m_setColorTasks.dequeue();
+
+    restartSetColorTasksTimer();
+
+    if (task.client == NULL)
+        return;
+
+    QString result = CmdSetResult_Error;
+
+    if (isSuccess)
+    {
+        // Lock is checked again, client could lose it while task was running
+        QString sessionKey = m_clients[task.client].sessionKey;
+        int lockedClient = lightpack->CheckLock(sessionKey);
+
+        if (lockedClient == 1)
+        {
+            lightpack->SetFrameRgb(sessionKey, colors);
+            result = CmdSetResult_Ok;
+        }
+        else if (lockedClient == 0)
+            result = CmdSetResult_NotLocked;
+        else
+            result = CmdSetResult_Busy;
+    }
+
+    finishSetColorTask(task.client, result);
+}
+
+void ApiServer::setColorTasksTimeout()
+{
+    while (m_setColorTasks.isEmpty() == false && m_setColorTasks.head().time.elapsed() >= SignalWaitTimeoutMs)
+    {
+        SetColorTaskInfo task = m_setColorTasks.dequeue();
+
+        qWarning() << Q_FUNC_INFO << "Timeout waiting taskParseSetColorDone() signal from m_apiSetColorTask, task:" << task.id;
+
+        if (task.client != NULL)
+            finishSetColorTask(task.client, CmdSetResult_Error);
+    }
+
+    restartSetColorTasksTimer();
+}
+
+void ApiServer::finishSetColorTask(QIODevice* client, const QString & result)
+{
+    writeData(client, result);
+
+    if (--m_clients[client].setColorTasksCount == 0)
+    {
+        // Continue with commands which wait for setcolor replies
+        processCommands(client);
+    }
+}
+
+void ApiServer::restartSetColorTasksTimer()
+{
+    if (m_setColorTasks.isEmpty())
+    {
+        m_timerSetColorTasks->stop();
+        return;
+    }
+
+    // Fires when the oldest task times out, next ones are checked after it
+    int remainingMs = SignalWaitTimeoutMs - m_setColorTasks.head().time.elapsed();
+    m_timerSetColorTasks->start(qMax(remainingMs, 0));
+}
+
+void ApiServer::cancelSetColorTasks(QIODevice* client)
+{
+    for (int i = 0; i < m_setColorTasks.count(); i++)
+    {
+        if (m_setColorTasks[i].client == client)
+            m_setColorTasks[i].client = NULL;
+    }
 }
 
 void ApiServer::initPrivateVariables()
@@ -859,19 +1576,48 @@ void ApiServer::initPrivateVariables()
     m_apiPort = Settings::getApiPort();
     m_apiAuthKey = Settings::getApiAuthKey();
     m_isAuthEnabled = Settings::isApiAuthEnabled();
+    m_isUdpEnabled = Settings::isApiUdpEnabled();
+    m_apiUdpPort = Settings::getApiUdpPort();
+    m_isLocalSocketEnabled = Settings::isApiLocalSocketEnabled();
+    m_localSocketName = Settings::getApiLocalSocketName();
+
+    // Moves to the ApiServer thread with its parent
+    m_localServer = new QLocalServer(this);
+    connect(m_localServer, SIGNAL(newConnection()), this, SLOT(localClientConnected()));
+
+    // Moves to the ApiServer thread with its parent
+    m_udpSocket = new QUdpSocket(this);
+    connect(m_udpSocket, SIGNAL(readyRead()), this, SLOT(udpProcessDatagrams()));
+
+    m_udpReceivedCount = 0;
+    m_udpLateCount = 0;
+    m_udpDroppedCount = 0;
+
+    // Same values as results of lightpack->GetStatus(), -2 is unknown
+    m_pushFps = -1;
+    m_pushStatus = -2;
+    m_isPushLocked = false;
+
+    m_timerPush = new QTimer(this);
+    m_timerPush->setInterval(PushTimerIntervalMs);
+    connect(m_timerPush, SIGNAL(timeout()), this, SLOT(pushTimeout()));
 }
 
 void ApiServer::initApiSetColorTask()
 {
-    m_isTaskSetColorDone = true;
+    m_lastSetColorTaskId = 0;
+
+    // Moves to the ApiServer thread with its parent
+    m_timerSetColorTasks = new QTimer(this);
+    m_timerSetColorTasks->setSingleShot(true);
+    connect(m_timerSetColorTasks, SIGNAL(timeout()), this, SLOT(setColorTasksTimeout()));
 
     m_apiSetColorTaskThread = new QThread();
     m_apiSetColorTask = new ApiServerSetColorTask();
 
-    //connect(m_apiSetColorTask, SIGNAL(taskParseSetColorDone(QList<QRgb>)), this, SIGNAL(updateLedsColors(QList<QRgb>)), Qt::QueuedConnection);
-    connect(m_apiSetColorTask, SIGNAL(taskParseSetColorIsSuccess(bool)), this, SLOT(taskSetColorIsSuccess(bool)), Qt::QueuedConnection);
+    connect(m_apiSetColorTask, SIGNAL(taskParseSetColorDone(int,bool,QList<QRgb>)), this, SLOT(taskSetColorDone(int,bool,QList<QRgb>)), Qt::QueuedConnection);
 
-    connect(this, SIGNAL(startParseSetColorTask(QByteArray)), m_apiSetColorTask, SLOT(startParseSetColorTask(QByteArray)), Qt::QueuedConnection);
+    connect(this, SIGNAL(startParseSetColorTask(int,QByteArray)), m_apiSetColorTask, SLOT(startParseSetColorTask(int,QByteArray)), Qt::QueuedConnection);
     connect(this, SIGNAL(updateApiDeviceNumberOfLeds(int)),   m_apiSetColorTask, SLOT(setApiDeviceNumberOfLeds(int)), Qt::QueuedConnection);
     connect(this, SIGNAL(clearColorBuffers()),                m_apiSetColorTask, SLOT(reinitColorBuffers()));
 
@@ -895,6 +1641,58 @@ void ApiServer::startListening()
 
         emit errorOnStartListening(errorStr);
     }
+
+    if (m_isUdpEnabled)
+        startUdpListening();
+
+    if (m_isLocalSocketEnabled)
+        startLocalListening();
+}
+
+QString ApiServer::localSocketPath(const QString & name)
+{
+#ifdef Q_OS_LINUX
+    if (name.contains('/'))
+        return name;
+
+    // Runtime dir is private to the user, so nobody else can create the socket there
+    QString runtimeDir = QString::fromLocal8Bit(qgetenv("XDG_RUNTIME_DIR"));
+    if (runtimeDir.isEmpty() == false && QFileInfo(runtimeDir).isDir())
+        return QDir(runtimeDir).absoluteFilePath(name);
+
+    // Shared temp dir, other users get their own names
+    return QDir(QDir::tempPath()).absoluteFilePath(QString("%1-%2").arg(name).arg(getuid()));
+#else
+    // Temp dir is per user on Mac OS X, named pipes on Windows aren't files
+    return name;
+#endif
+}
+
+void ApiServer::startLocalListening()
+{
+    QString path = localSocketPath(m_localSocketName);
+
+    DEBUG_LOW_LEVEL << Q_FUNC_INFO << path;
+
+#ifdef Q_OS_LINUX
+    // Removes socket file left by crashed instance, Lightpack is single application.
+    // File of the other user is never removed, listen() fails on it instead
+    QFileInfo socketInfo(path);
+    if (socketInfo.exists() || socketInfo.isSymLink())
+    {
+        if (socketInfo.isSymLink() == false && socketInfo.ownerId() == getuid())
+            QLocalServer::removeServer(path);
+        else
+            qWarning() << Q_FUNC_INFO << "API local socket" << path << "is not owned by the current user";
+    }
+#else
+    QLocalServer::removeServer(path);
+#endif
+
+    if (m_localServer->listen(path) == false)
+    {
+        qWarning() << Q_FUNC_INFO << "API local socket" << path << "listen failed:" << m_localServer->errorString();
+    }
 }
 
 void ApiServer::stopListening()
@@ -904,27 +1702,42 @@ void ApiServer::stopListening()
     // Closes the server. The server will no longer listen for incoming connections.
     close();
 
-    QMap<QTcpSocket*, ClientInfo>::iterator i;
+    QMap<QIODevice*, ClientInfo>::iterator i;
     for (i = m_clients.begin(); i != m_clients.end(); ++i)
     {
 
-        QTcpSocket * client = dynamic_cast<QTcpSocket*>(i.key());
+        QIODevice * client = i.key();
 
         QString sessionKey = m_clients[client].sessionKey;
         if (lightpack->CheckLock(sessionKey)==1)
             lightpack->UnLock(sessionKey);
 
+        cancelSetColorTasks(client);
+
         disconnect(client, SIGNAL(readyRead()), this, SLOT(clientProcessCommands()));
         disconnect(client, SIGNAL(disconnected()), this, SLOT(clientDisconnected()));
+        disconnect(client, SIGNAL(bytesWritten(qint64)), this, SLOT(clientBytesWritten()));
+
+        QTcpSocket *tcpClient = dynamic_cast<QTcpSocket*>(client);
+        QLocalSocket *localClient = dynamic_cast<QLocalSocket*>(client);
+
+        if (tcpClient)
+            tcpClient->abort();
+        else if (localClient)
+            localClient->abort();
 
-        client->abort();
         client->deleteLater();
     }
 
     m_clients.clear();
+    m_udpSessions.clear();
+    m_timerPush->stop();
+
+    m_udpSocket->close();
+    m_localServer->close();
 }
 
-void ApiServer::writeData(QTcpSocket* client, const QString & data)
+void ApiServer::writeData(QIODevice* client, const QString & data)
 {
     if (m_clients.contains(client) == false)
     {
@@ -978,7 +1791,7 @@ void ApiServer::initHelpMessage()
 
     m_helpMessage += formatHelp(
                 CmdApiKey,
-                "Command for enter an authorization key (see key in GUI)",
+                "Command for enter an authorization key (see key in GUI). Not needed on the local socket for clients of the same user (Linux only).",
                 formatHelp(CmdApiKey + QString("{1ccf5dca-119d-45a0-a683-7d90a00c418f}")) +
                 formatHelp(CmdApiKey + QString("IDDQD")),
                 formatHelp(CmdApiKeyResult_Ok) +
@@ -1049,6 +1862,18 @@ void ApiServer::initHelpMessage()
                 "Get size screen",
                 formatHelp(CmdResultScreenSize + QString("0,0,1024,768"))
                 );
+    m_helpMessage += formatHelp(
+                CmdGetUdpSession,
+                "Get port and session token for frames over UDP, if UDP is enabled in settings. Datagram is the token (8 bytes, big endian), "
+                "sequence number (4 bytes, big endian) and frame as in setframe. Datagrams with not newer sequence number are skipped, frames are applied only on locking time (see lock).",
+                formatHelp(CmdResultUdpSession + QString("3637,8c1f02d94e7ab615")) +
+                formatHelp(CmdResultUdpSession_Disabled)
+                );
+    m_helpMessage += formatHelp(
+                CmdGetUdpStats,
+                "Get count of received, late (skipped by sequence number) and dropped UDP datagrams",
+                formatHelp(CmdResultUdpStats + QString("1200,3,0"))
+                );
     m_helpMessage += formatHelp(
                 CmdGetBacklight,
                 "Get mode of the current profile",
@@ -1066,9 +1891,17 @@ void ApiServer::initHelpMessage()
 
     m_helpMessage += formatHelp(
                 CmdSetColor,
-                "Set colors on several LEDs. Format: \"N-R,G,B;\", where N - number of led, R, G, B - red, green and blue color components. Works only on locking time (see lock).",
+                "Set colors on several LEDs. Format: \"N-R,G,B;\", where N - number of led, R, G, B - red, green and blue color components. "
+                "Range of LEDs \"N..M\" and hex color \"#RRGGBB\" are also accepted. Works only on locking time (see lock).",
                 formatHelp(CmdSetColor + QString("1-255,255,30;")) +
-                formatHelp(CmdSetColor + QString("1-255,255,30;2-12,12,12;3-1,2,3;")),
+                formatHelp(CmdSetColor + QString("1-255,255,30;2-12,12,12;3-1,2,3;")) +
+                formatHelp(CmdSetColor + QString("1..10-#ff8000;11-0,0,255;")),
+                helpCmdSetResults);
+
+    m_helpMessage += formatHelp(
+                CmdSetFrame,
+                "Switch connection to binary frames, for fast updates of all LEDs. Frame is 6 bytes header: \"LF\", format (1 - RGB8, 2 - RGB16 big endian), zero byte, number of LEDs (big endian word, up to 255), followed by colors of LEDs starting from the first one. "
+                "Frames are not acknowledged, only rejected frame gets \"not locked\" or \"busy\". Header with zero number of LEDs returns to text commands with \"ok\", invalid header with \"error\". Works only on locking time (see lock).",
                 helpCmdSetResults);
 
     m_helpMessage += formatHelp(
@@ -1137,6 +1970,23 @@ void ApiServer::initHelpMessage()
                 formatHelp(CmdSetBacklight + QString(CmdSetBacklight_Moodlamp)),
                 helpCmdSetResults);
 
+    m_helpMessage += formatHelp(
+                CmdSubscribe,
+                QString("Subscribe to changes of colors, fps, status, profile and lock (API status). Changes are pushed with the same lines as results of "
+                        "getcolors, getfps, getstatus, getprofile and getstatusapi, starting with current values. Colors are pushed at most N times per second "
+                        "(\"colors=N\", %1 - %2, default %3), fps once per second. Slow client gets only the latest values.")
+                .arg(1).arg(PushColorsMaxRate).arg(PushColorsDefaultRate),
+                formatHelp(CmdSubscribe + QString("colors")) +
+                formatHelp(CmdSubscribe + QString("colors=60,status,profile,lock")),
+                formatHelp(CmdSetResult_Ok) +
+                formatHelp(CmdSetResult_Error));
+
+    m_helpMessage += formatHelp(
+                CmdUnsubscribe,
+                QString("Unsubscribe from changes (see subscribe)."),
+                formatHelp(CmdUnsubscribe + QString("colors,fps")),
+                formatHelp(CmdSetResult_Ok) +
+                formatHelp(CmdSetResult_Error));
 
     m_helpMessage += formatHelp(CmdHelpShort, "Short version of this help");
 
@@ -1154,8 +2004,10 @@ void ApiServer::initShortHelpMessage()
     cmds << CmdApiKey << CmdLock << CmdUnlock
          << CmdGetStatus << CmdGetStatusAPI
          << CmdGetProfile << CmdGetProfiles << CmdGetCountLeds
-         << CmdSetColor << CmdSetGamma << CmdSetBrightness
+         << CmdGetUdpSession << CmdGetUdpStats
+         << CmdSetColor << CmdSetFrame << CmdSetGamma << CmdSetBrightness
          << CmdSetSmooth << CmdSetProfile << CmdSetStatus
+         << CmdSubscribe << CmdUnsubscribe
          << CmdExit << CmdHelp << CmdHelpShort;
 
     QString line = "    ";
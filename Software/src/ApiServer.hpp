@@ -29,10 +29,16 @@
 #include <QStringList>
 #include <QTcpServer>
 #include <QTcpSocket>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QUdpSocket>
+#include <QHash>
 #include <QMap>
+#include <QQueue>
 #include <QSet>
 #include <QRgb>
 #include <QTime>
+#include <QTimer>
 #include "SettingsWindow.hpp"
 #include "LightpackPluginInterface.hpp"
 #include "ApiServerSetColorTask.hpp"
@@ -43,22 +49,48 @@ struct ClientInfo
 {
     bool isAuthorized;
     QString sessionKey;
+    // Binary frames after setframe command, see ApiServer::CmdSetFrame
+    bool isFrameMode;
+    int frameFormat;
+    int frameLedsCount; // 0 while waiting for the frame header
+    // Next commands of the client wait for replies of these setcolor tasks
+    int setColorTasksCount;
+    // Frames over UDP, 0 - no session, see ApiServer::CmdGetUdpSession
+    quint64 udpToken;
+    quint32 udpSequence;
+    bool isUdpSequenceStarted;
+    // Pushed events, see ApiServer::CmdSubscribe
+    int subscriptions;
+    int pendingPushes; // written when the client has no backlog and rate limit allows
+    int colorsPushIntervalMs;
+    QTime colorsPushTime;
+    QTime fpsPushTime;
     // Think about it. May be we need to save gamma,
     // smooth and brightness and after success lock send
     // this values to device?
 };
 
+struct SetColorTaskInfo
+{
+    int id;
+    QIODevice *client; // NULL if client is disconnected
+    QTime time;
+};
+
 class ApiServer : public QTcpServer
 {
     Q_OBJECT
 
 public:
     ApiServer(QObject *parent = 0);
-    ApiServer(quint16 port, QObject *parent = 0);
+    ApiServer(quint16 port, quint16 udpPort = 0, const QString & localSocketName = QString(), QObject *parent = 0);
 
     void setInterface(LightpackPluginInterface *lightpackInterface);
     void firstStart();
 
+    // Full name of the local socket which clients of the same user connect to
+    static QString localSocketPath(const QString & name);
+
 public:
     static const char * ApiVersion;   
     static const char * CmdUnknown;
@@ -102,6 +134,13 @@ public:
     static const char * CmdGetScreenSize;
     static const char * CmdResultScreenSize;
 
+    static const char * CmdGetUdpSession;
+    static const char * CmdResultUdpSession;
+    static const char * CmdResultUdpSession_Disabled;
+
+    static const char * CmdGetUdpStats;
+    static const char * CmdResultUdpStats;
+
     static const char * CmdGetBacklight;
     static const char * CmdResultBacklight_Ambilight;
     static const char * CmdResultBacklight_Moodlamp;
@@ -126,6 +165,7 @@ public:
     static const char * CmdSetSmooth;
     static const char * CmdSetProfile;
     static const char * CmdSetLeds;
+    static const char * CmdSetFrame;
 
     static const char * CmdNewProfile;
     static const char * CmdDeleteProfile;
@@ -138,10 +178,45 @@ public:
     static const char * CmdSetBacklight_Ambilight;
     static const char * CmdSetBacklight_Moodlamp;
 
+    static const char * CmdSubscribe;
+    static const char * CmdUnsubscribe;
+    static const char * CmdSubscribe_Colors;
+    static const char * CmdSubscribe_Fps;
+    static const char * CmdSubscribe_Status;
+    static const char * CmdSubscribe_Profile;
+    static const char * CmdSubscribe_Lock;
+
     static const int SignalWaitTimeoutMs;
 
+    enum SubscribeEvent
+    {
+        SubscribeStatus = 0x01,
+        SubscribeProfile = 0x02,
+        SubscribeLock = 0x04,
+        SubscribeFps = 0x08,
+        SubscribeColors = 0x10
+    };
+    // Colors rate limit is set per client: "subscribe:colors=N", N frames per second
+    static const int PushColorsDefaultRate;
+    static const int PushColorsMaxRate;
+    static const int PushFpsIntervalMs;
+    static const int PushTimerIntervalMs;
+    // Pushes to the client wait while it has more bytes to write
+    static const int PushMaxBacklogBytes;
+
+    // Binary frame header: magic "LF", format, reserved zero byte, LED count (big endian)
+    enum FrameFormat
+    {
+        FrameFormatRgb8 = 1,
+        FrameFormatRgb16 = 2
+    };
+    static const char * FrameMagic;
+    static const int FrameHeaderSize;
+    // UDP datagram: session token (8 bytes), sequence number (4 bytes), frame header, colors
+    static const int UdpHeaderSize;
+
 signals:
-    void startParseSetColorTask(QByteArray buffer);
+    void startParseSetColorTask(int taskId, QByteArray buffer);
     void errorOnStartListening(QString errorMessage);
     void clearColorBuffers();
     void updateApiDeviceNumberOfLeds(int value);
@@ -155,9 +230,19 @@ protected:
     void incomingConnection(int socketDescriptor);
 
 private slots:
+    void localClientConnected();
     void clientDisconnected();
     void clientProcessCommands();
-    void taskSetColorIsSuccess(bool isSuccess);
+    void taskSetColorDone(int taskId, bool isSuccess, const QList<QRgb> & colors);
+    void setColorTasksTimeout();
+    void udpProcessDatagrams();
+    void clientBytesWritten();
+    void pushTimeout();
+    void onColorsChanged(const QList<QRgb> & colors);
+    void onFpsChanged(double fps);
+    void onStatusChanged(int status);
+    void onProfileChanged(QString profile);
+    void onLockStatusChanged(bool isLocked);
 
 private:
     LightpackPluginInterface *lightpack;
@@ -165,7 +250,26 @@ private:
     void initApiSetColorTask();
     void startListening();
     void stopListening();
-    void writeData(QTcpSocket* client, const QString & data);
+    void startUdpListening();
+    void startLocalListening();
+    void addClient(QIODevice* client, bool isAuthorized);
+    bool isLocalPeerTrusted(QLocalSocket* client);
+    void processDatagram(const char * data, int size);
+    QString startUdpSession(QIODevice* client);
+    void processCommands(QIODevice* client);
+    void startSetColorTask(QIODevice* client, const QByteArray & buffer);
+    void finishSetColorTask(QIODevice* client, const QString & result);
+    void restartSetColorTasksTimer();
+    void cancelSetColorTasks(QIODevice* client);
+    void writeData(QIODevice* client, const QString & data);
+    bool clientProcessFrames(QIODevice* client);
+    static bool parseFrameHeader(const unsigned char * header, int & format, int & ledsCount);
+    static int framePayloadSize(int format, int ledsCount);
+    void decodeFrame(const unsigned char * data, int format, int ledsCount);
+    QString processSubscribe(QIODevice* client, const QByteArray & args, bool isSubscribe);
+    void notifySubscribers(int event);
+    void flushPushes(QIODevice* client);
+    QByteArray pushMessage(int event);
     QString formatHelp(const QString & cmd);
     QString formatHelp(const QString & cmd, const QString & description);
     QString formatHelp(const QString & cmd, const QString & description, const QString & results);
@@ -177,15 +281,43 @@ private:
     int m_apiPort;
     QString m_apiAuthKey;
     bool m_isAuthEnabled;
-    QTime m_time;
 
-    QMap <QTcpSocket*, ClientInfo> m_clients;
+    QMap <QIODevice*, ClientInfo> m_clients;
 
     QThread *m_apiSetColorTaskThread;
     ApiServerSetColorTask *m_apiSetColorTask;
 
-    bool m_isTaskSetColorDone;
-    bool m_isTaskSetColorParseSuccess;
+    // Tasks are done by m_apiSetColorTask in order of start
+    QQueue<SetColorTaskInfo> m_setColorTasks;
+    QTimer *m_timerSetColorTasks;
+    int m_lastSetColorTaskId;
+
+    // Only the lock owner sends frames, so buffers are shared by all clients
+    QByteArray m_frameBuffer;
+    QList<QRgb> m_frameColors;
+
+    bool m_isUdpEnabled;
+    int m_apiUdpPort;
+    QUdpSocket *m_udpSocket;
+    QByteArray m_udpBuffer;
+    QHash<quint64, QIODevice*> m_udpSessions;
+    quint32 m_udpReceivedCount;
+    quint32 m_udpLateCount;
+    quint32 m_udpDroppedCount;
+
+    // Clients are QTcpSocket or QLocalSocket, commands are the same
+    bool m_isLocalSocketEnabled;
+    QString m_localSocketName;
+    QLocalServer *m_localServer;
+
+    // Last values for subscribers, pushed only when changed
+    QList<QRgb> m_pushColors;
+    QByteArray m_pushColorsMessage; // formatted once for all clients, empty until needed
+    double m_pushFps;
+    int m_pushStatus;
+    QString m_pushProfile;
+    bool m_isPushLocked;
+    QTimer *m_timerPush;
 
     QString m_helpMessage;
     QString m_shortHelpMessage;
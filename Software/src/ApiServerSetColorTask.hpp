@@ -28,6 +28,8 @@
 
 #include <QObject>
 #include <QRgb>
+#include <QVector>
+#include "SetColorParser.hpp"
 #include "debug.h"
 
 class ApiServerSetColorTask : public QObject
@@ -37,21 +39,18 @@ public:
     explicit ApiServerSetColorTask(QObject *parent = 0);
 
 signals:
-    void taskParseSetColorDone(const QList<QRgb> & colors);
-    void taskParseSetColorIsSuccess(bool isSuccess);
+    // Colors are valid only if isSuccess is true
+    void taskParseSetColorDone(int taskId, bool isSuccess, const QList<QRgb> & colors);
 
 public slots:
-    void startParseSetColorTask(QByteArray buffer);
+    void startParseSetColorTask(int taskId, QByteArray buffer);
     void reinitColorBuffers();
     void setApiDeviceNumberOfLeds(int value);
 
 private:
     QList<QRgb> m_colors;
+    QVector<QRgb> m_parsedColors;
     int m_numberOfLeds;
 
-    enum BuffRgbIndexes{
-        bRed, bGreen, bBlue, bSize
-    };
-    int buffRgb[bSize]; // buffer for store temp red, green and blue values
-
+    SetColorParser m_parser;
 };
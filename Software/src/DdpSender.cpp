@@ -0,0 +1,142 @@
+/*
+ * DdpSender.cpp
+ *
+ *  Created on: 19.10.2026
+ *     Project: Lightpack
+ *
+ *  Lightpack is very simple implementation of the backlight for a laptop
+ *
+ *  Copyright (c) 2011 Mike Shatohin, mikeshatohin [at] gmail.com
+ *
+ *  Lightpack is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Lightpack is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <string.h>
+
+#include "DdpSender.hpp"
+#include "debug.h"
+
+const quint16 DdpSender::DefaultPort = 4048;
+const int DdpSender::DefaultMtu = 1500;
+const int DdpSender::HeaderSize = 10;
+const int DdpSender::TransportOverhead = 28;
+const quint8 DdpSender::FlagVersion1 = 0x40;
+const quint8 DdpSender::FlagPush = 0x01;
+const quint8 DdpSender::DataTypeRgb8 = 0x0B;
+const quint8 DdpSender::DestinationDisplay = 0x01;
+
+DdpSender::DdpSender()
+{
+    m_port = DefaultPort;
+    m_mtu = DefaultMtu;
+    m_sequence = 0;
+}
+
+bool DdpSender::open(const QString & host, quint16 port)
+{
+    DEBUG_LOW_LEVEL << Q_FUNC_INFO << host << port;
+
+    m_address = UdpPacketSender::resolveHost(host);
+    m_port = port;
+
+    if (m_address.isNull())
+        return false;
+
+    if (m_sender.open() == false)
+        return false;
+
+    m_sender.setDestination(m_address, m_port);
+    m_sequence = 0;
+
+    return true;
+}
+
+void DdpSender::close()
+{
+    m_sender.close();
+}
+
+void DdpSender::setMtu(int mtu)
+{
+    // Packet should hold at least one LED
+    m_mtu = qMax(mtu, TransportOverhead + HeaderSize + 3);
+}
+
+int DdpSender::payloadSize() const
+{
+    int size = m_mtu - TransportOverhead - HeaderSize;
+
+    // Don't split LED between packets
+    return size - size % 3;
+}
+
+int DdpSender::packetsPerFrame(int size) const
+{
+    int payload = payloadSize();
+
+    return (size + payload - 1) / payload;
+}
+
+bool DdpSender::sendFrame(const char * data, int size)
+{
+    if (m_sender.isOpen() == false || size <= 0)
+        return false;
+
+    int payload = payloadSize();
+    int packetsCount = packetsPerFrame(size);
+
+    // Buffers are reallocated only when frame size or MTU changes
+    if (m_sender.packetsCount() != packetsCount || m_sender.packetCapacity() != HeaderSize + payload)
+    {
+        m_sender.resize(packetsCount, HeaderSize + payload);
+        m_sender.setDestination(m_address, m_port);
+    }
+
+    m_sequence = (m_sequence % 15) + 1;
+
+    for (int i = 0; i < packetsCount; i++)
+    {
+        int offset = i * payload;
+        int length = qMin(payload, size - offset);
+        bool isLast = (i == packetsCount - 1);
+
+        unsigned char *packet = (unsigned char *)m_sender.packet(i);
+
+        packet[0] = FlagVersion1 | (isLast ? FlagPush : 0);
+        packet[1] = m_sequence;
+        packet[2] = DataTypeRgb8;
+        packet[3] = DestinationDisplay;
+        packet[4] = (offset >> 24) & 0xff;
+        packet[5] = (offset >> 16) & 0xff;
+        packet[6] = (offset >> 8) & 0xff;
+        packet[7] = offset & 0xff;
+        packet[8] = (length >> 8) & 0xff;
+        packet[9] = length & 0xff;
+
+        memcpy(packet + HeaderSize, data + offset, length);
+
+        m_sender.setPacketSize(i, HeaderSize + length);
+    }
+
+    int sent = m_sender.sendAll();
+
+    if (sent != packetsCount)
+    {
+        DEBUG_MID_LEVEL << Q_FUNC_INFO << "sent" << sent << "of" << packetsCount << "packets";
+        return false;
+    }
+
+    return true;
+}
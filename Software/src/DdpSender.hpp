@@ -0,0 +1,85 @@
+/*
+ * DdpSender.hpp
+ *
+ *  Created on: 19.10.2026
+ *     Project: Lightpack
+ *
+ *  Lightpack is very simple implementation of the backlight for a laptop
+ *
+ *  Copyright (c) 2011 Mike Shatohin, mikeshatohin [at] gmail.com
+ *
+ *  Lightpack is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Lightpack is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <QString>
+
+#include "UdpPacketSender.hpp"
+
+/*!
+  Distributed Display Protocol (DDP) sender, used by WLED, ESPixelStick and
+  other ESP based controllers.
+
+  Frame of RGB bytes is split to packets which fit into the MTU, each packet
+  carries whole LEDs. All packets of the frame have the same sequence number
+  (1..15), the last one has PUSH flag, so controller shows the frame only
+  when it is complete.
+
+  Packet: header (10 bytes) + data
+    0     flags: version 1 (0x40) | PUSH (0x01)
+    1     sequence number, low 4 bits
+    2     data type: RGB, 8 bit per channel (0x0B)
+    3     destination id: 1 - default output device
+    4..7  data offset in bytes, big endian
+    8..9  data length in bytes, big endian
+*/
+class DdpSender
+{
+public:
+    DdpSender();
+
+    bool open(const QString & host, quint16 port = DefaultPort);
+    void close();
+    bool isOpen() const { return m_sender.isOpen(); }
+
+    void setMtu(int mtu);
+    int mtu() const { return m_mtu; }
+
+    // Data is RGB bytes, 3 bytes per LED
+    bool sendFrame(const char * data, int size);
+
+    int packetsPerFrame(int size) const;
+    int payloadSize() const;
+    quint8 sequence() const { return m_sequence; }
+
+    static const quint16 DefaultPort;
+    static const int DefaultMtu;
+    static const int HeaderSize;
+    // IPv4 and UDP headers
+    static const int TransportOverhead;
+
+    static const quint8 FlagVersion1;
+    static const quint8 FlagPush;
+    static const quint8 DataTypeRgb8;
+    static const quint8 DestinationDisplay;
+
+private:
+    UdpPacketSender m_sender;
+    QHostAddress m_address;
+    quint16 m_port;
+    int m_mtu;
+    quint8 m_sequence;
+};
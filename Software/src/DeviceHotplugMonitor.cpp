@@ -0,0 +1,187 @@
+/*
+ * DeviceHotplugMonitor.cpp
+ *
+ *  Created on: 19.10.2026
+ *     Project: Lightpack
+ *
+ *  Lightpack is very simple implementation of the backlight for a laptop
+ *
+ *  Copyright (c) 2011 Mike Shatohin, mikeshatohin [at] gmail.com
+ *
+ *  Lightpack is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Lightpack is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <QSocketNotifier>
+#include <QStringList>
+
+#include "DeviceHotplugMonitor.hpp"
+#include "debug.h"
+
+#ifdef Q_OS_LINUX
+#   include <libudev.h>
+
+// PRODUCT property of usb device: "3eb/204f/100", available on remove too
+static bool parseUsbProduct(const char * product, int & vid, int & pid)
+{
+    if (product == NULL)
+        return false;
+
+    QStringList ids = QString(product).split('/');
+    if (ids.count() < 2)
+        return false;
+
+    bool okVid = false, okPid = false;
+    vid = ids[0].toInt(&okVid, 16);
+    pid = ids[1].toInt(&okPid, 16);
+
+    return okVid && okPid;
+}
+
+// HID_ID property of hid device: "0003:000003EB:0000204F"
+static bool parseHidId(const char * hidId, int & vid, int & pid)
+{
+    if (hidId == NULL)
+        return false;
+
+    QStringList ids = QString(hidId).split(':');
+    if (ids.count() < 3)
+        return false;
+
+    bool okVid = false, okPid = false;
+    vid = ids[1].toInt(&okVid, 16);
+    pid = ids[2].toInt(&okPid, 16);
+
+    return okVid && okPid;
+}
+#endif
+
+DeviceHotplugMonitor::DeviceHotplugMonitor(QObject * parent) : QObject(parent)
+{
+    DEBUG_LOW_LEVEL << Q_FUNC_INFO;
+
+    m_udev = NULL;
+    m_udevMonitor = NULL;
+    m_socketNotifier = NULL;
+
+#ifdef Q_OS_LINUX
+    m_udev = udev_new();
+    if (m_udev == NULL)
+    {
+        qWarning() << Q_FUNC_INFO << "udev_new fail";
+        return;
+    }
+
+    m_udevMonitor = udev_monitor_new_from_netlink(m_udev, "udev");
+    if (m_udevMonitor == NULL)
+    {
+        qWarning() << Q_FUNC_INFO << "udev_monitor_new_from_netlink fail";
+        return;
+    }
+
+    // usb_device comes for libusb backend, hidraw when node for hidraw backend is ready
+    udev_monitor_filter_add_match_subsystem_devtype(m_udevMonitor, "usb", "usb_device");
+    udev_monitor_filter_add_match_subsystem_devtype(m_udevMonitor, "hidraw", NULL);
+    udev_monitor_filter_add_match_subsystem_devtype(m_udevMonitor, "tty", NULL);
+
+    if (udev_monitor_enable_receiving(m_udevMonitor) < 0)
+    {
+        qWarning() << Q_FUNC_INFO << "udev_monitor_enable_receiving fail";
+        return;
+    }
+
+    m_socketNotifier = new QSocketNotifier(udev_monitor_get_fd(m_udevMonitor), QSocketNotifier::Read, this);
+    connect(m_socketNotifier, SIGNAL(activated(int)), this, SLOT(processMonitorEvent()));
+
+    DEBUG_LOW_LEVEL << Q_FUNC_INFO << "udev monitor started";
+#endif
+}
+
+DeviceHotplugMonitor::~DeviceHotplugMonitor()
+{
+    DEBUG_LOW_LEVEL << Q_FUNC_INFO;
+
+    delete m_socketNotifier;
+
+#ifdef Q_OS_LINUX
+    if (m_udevMonitor != NULL)
+        udev_monitor_unref(m_udevMonitor);
+    if (m_udev != NULL)
+        udev_unref(m_udev);
+#endif
+}
+
+bool DeviceHotplugMonitor::isSamePort(const QString & deviceNode, const QString & portName)
+{
+    if (deviceNode.isEmpty() || portName.isEmpty())
+        return false;
+
+    // Port name in settings may be given without "/dev/"
+    return deviceNode == portName || deviceNode.endsWith("/" + portName);
+}
+
+void DeviceHotplugMonitor::processMonitorEvent()
+{
+#ifdef Q_OS_LINUX
+    udev_device *device = udev_monitor_receive_device(m_udevMonitor);
+    if (device == NULL)
+        return;
+
+    QString action = udev_device_get_action(device);
+    QString subsystem = udev_device_get_subsystem(device);
+
+    DEBUG_MID_LEVEL << Q_FUNC_INFO << action << subsystem << udev_device_get_devpath(device);
+
+    bool isAdd = (action == "add");
+    bool isRemove = (action == "remove");
+
+    if (isAdd || isRemove)
+    {
+        int vid = 0, pid = 0;
+
+        if (subsystem == "usb")
+        {
+            if (parseUsbProduct(udev_device_get_property_value(device, "PRODUCT"), vid, pid))
+            {
+                if (isAdd)
+                    emit hidDeviceAdded(vid, pid);
+                else
+                    emit hidDeviceRemoved(vid, pid);
+            }
+        }
+        else if (subsystem == "hidraw")
+        {
+            // Removal is reported by usb device, parent of hidraw is gone at that moment
+            udev_device *hid = udev_device_get_parent_with_subsystem_devtype(device, "hid", NULL);
+
+            if (isAdd && hid != NULL && parseHidId(udev_device_get_property_value(hid, "HID_ID"), vid, pid))
+                emit hidDeviceAdded(vid, pid);
+        }
+        else if (subsystem == "tty")
+        {
+            QString deviceNode = udev_device_get_property_value(device, "DEVNAME");
+
+            if (deviceNode.isEmpty() == false)
+            {
+                if (isAdd)
+                    emit serialPortAdded(deviceNode);
+                else
+                    emit serialPortRemoved(deviceNode);
+            }
+        }
+    }
+
+    udev_device_unref(device);
+#endif
+}
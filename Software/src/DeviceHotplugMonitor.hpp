@@ -0,0 +1,67 @@
+/*
+ * DeviceHotplugMonitor.hpp
+ *
+ *  Created on: 19.10.2026
+ *     Project: Lightpack
+ *
+ *  Lightpack is very simple implementation of the backlight for a laptop
+ *
+ *  Copyright (c) 2011 Mike Shatohin, mikeshatohin [at] gmail.com
+ *
+ *  Lightpack is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Lightpack is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QString>
+
+class QSocketNotifier;
+struct udev;
+struct udev_monitor;
+
+/*!
+  Reports plugging and unplugging of USB HID devices and serial ports.
+
+  On Linux udev monitor socket is watched by QSocketNotifier, so nothing is
+  sent to the devices while they are idle. On other systems isAvailable()
+  returns false and LED devices keep pinging.
+*/
+class DeviceHotplugMonitor : public QObject
+{
+    Q_OBJECT
+public:
+    DeviceHotplugMonitor(QObject * parent = 0);
+    ~DeviceHotplugMonitor();
+
+    bool isAvailable() const { return m_socketNotifier != NULL; }
+
+    static bool isSamePort(const QString & deviceNode, const QString & portName);
+
+signals:
+    // May come twice for one plug: for usb device and for its hidraw node
+    void hidDeviceAdded(int vid, int pid);
+    void hidDeviceRemoved(int vid, int pid);
+    void serialPortAdded(const QString & deviceNode);
+    void serialPortRemoved(const QString & deviceNode);
+
+private slots:
+    void processMonitorEvent();
+
+private:
+    udev *m_udev;
+    udev_monitor *m_udevMonitor;
+    QSocketNotifier *m_socketNotifier;
+};
@@ -0,0 +1,350 @@
+/*
+ * DmxNetworkSender.cpp
+ *
+ *  Created on: 19.10.2026
+ *     Project: Lightpack
+ *
+ *  Lightpack is very simple implementation of the backlight for a laptop
+ *
+ *  Copyright (c) 2011 Mike Shatohin, mikeshatohin [at] gmail.com
+ *
+ *  Lightpack is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Lightpack is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <string.h>
+#include <QUuid>
+
+#include "DmxNetworkSender.hpp"
+#include "debug.h"
+
+const int DmxNetworkSender::UniverseSize = 512;
+const int DmxNetworkSender::E131Port = 5568;
+const int DmxNetworkSender::E131DataHeaderSize = 126;
+const int DmxNetworkSender::E131SyncPacketSize = 49;
+const int DmxNetworkSender::ArtNetPort = 6454;
+const int DmxNetworkSender::ArtNetDataHeaderSize = 18;
+const int DmxNetworkSender::ArtNetSyncPacketSize = 14;
+
+// Offsets of the bytes which are changed for every frame
+static const int E131SequenceIndex = 111;
+static const int E131SyncSequenceIndex = 44;
+static const int ArtNetSequenceIndex = 12;
+
+static const char SourceName[] = "Lightpack";
+
+static void writeWord(char * buffer, int value)
+{
+    buffer[0] = (value >> 8) & 0xff;
+    buffer[1] = value & 0xff;
+}
+
+static void writeLong(char * buffer, quint32 value)
+{
+    writeWord(buffer, value >> 16);
+    writeWord(buffer + 2, value & 0xffff);
+}
+
+// ACN root layer, common for E1.31 data and sync packets
+static void writeE131RootLayer(char * packet, int packetSize, quint32 vector, const QByteArray & cid)
+{
+    static const char AcnPacketIdentifier[12] = { 'A', 'S', 'C', '-', 'E', '1', '.', '1', '7', 0, 0, 0 };
+
+    writeWord(packet + 0, 0x0010);              // preamble size
+    writeWord(packet + 2, 0x0000);              // postamble size
+    memcpy(packet + 4, AcnPacketIdentifier, sizeof(AcnPacketIdentifier));
+    writeWord(packet + 16, 0x7000 | (packetSize - 16));
+    writeLong(packet + 18, vector);
+    memcpy(packet + 22, cid.constData(), 16);
+}
+
+DmxNetworkSender::DmxNetworkSender()
+{
+    m_protocol = ProtocolE131;
+    m_port = E131Port;
+    m_firstUniverse = 1;
+    m_startAddress = 1;
+    m_isSyncEnabled = false;
+    m_syncUniverse = 0;
+
+    m_ledsCount = 0;
+    m_universesCount = 0;
+    m_isLayoutChanged = true;
+
+    m_sequence = 0;
+    m_syncSequence = 0;
+}
+
+bool DmxNetworkSender::open(Protocol protocol, const QString & host, quint16 port)
+{
+    DEBUG_LOW_LEVEL << Q_FUNC_INFO << protocol << host << port;
+
+    m_protocol = protocol;
+    m_port = (port != 0) ? port : (m_protocol == ProtocolArtNet ? ArtNetPort : E131Port);
+    m_isLayoutChanged = true;
+
+    if (host.isEmpty())
+    {
+        // Multicast for E1.31 is set per universe in buildPackets()
+        m_address = (m_protocol == ProtocolArtNet) ? QHostAddress(QHostAddress::Broadcast) : QHostAddress();
+    } else {
+        m_address = UdpPacketSender::resolveHost(host);
+
+        if (m_address.isNull())
+            return false;
+    }
+
+    // Receivers tell sources apart by CID
+    m_cid = QUuid::createUuid().toRfc4122();
+
+    return m_sender.open();
+}
+
+void DmxNetworkSender::close()
+{
+    m_sender.close();
+}
+
+void DmxNetworkSender::setUniverse(int firstUniverse, int startAddress)
+{
+    // At least one LED should fit into the first universe
+    m_firstUniverse = firstUniverse;
+    m_startAddress = qBound(1, startAddress, UniverseSize - 2);
+    m_isLayoutChanged = true;
+}
+
+void DmxNetworkSender::setSyncEnabled(bool isEnabled, int syncUniverse)
+{
+    m_isSyncEnabled = isEnabled;
+    m_syncUniverse = syncUniverse;
+    m_isLayoutChanged = true;
+}
+
+int DmxNetworkSender::ledsInUniverse(int index) const
+{
+    if (index == 0)
+        return (UniverseSize - (m_startAddress - 1)) / 3;
+
+    return UniverseSize / 3;
+}
+
+int DmxNetworkSender::universesCount(int ledsCount) const
+{
+    int firstLeds = ledsInUniverse(0);
+
+    if (ledsCount <= firstLeds)
+        return 1;
+
+    int universeLeds = ledsInUniverse(1);
+
+    return 1 + (ledsCount - firstLeds + universeLeds - 1) / universeLeds;
+}
+
+int DmxNetworkSender::minUniverse(Protocol protocol)
+{
+    // Universe 0 is reserved by E1.31, Art-Net port-address 0 is valid
+    return (protocol == ProtocolArtNet) ? 0 : 1;
+}
+
+int DmxNetworkSender::maxUniverse(Protocol protocol)
+{
+    // Art-Net port-address is 15 bits: Net, Sub-Net and Universe
+    return (protocol == ProtocolArtNet) ? 32767 : 63999;
+}
+
+QHostAddress DmxNetworkSender::e131MulticastAddress(int universe)
+{
+    return QHostAddress((239u << 24) | (255u << 16) | (((universe >> 8) & 0xff) << 8) | (universe & 0xff));
+}
+
+int DmxNetworkSender::dataHeaderSize() const
+{
+    return (m_protocol == ProtocolArtNet) ? ArtNetDataHeaderSize : E131DataHeaderSize;
+}
+
+int DmxNetworkSender::firstUniverse() const
+{
+    return qBound(minUniverse(m_protocol), m_firstUniverse, maxUniverse(m_protocol));
+}
+
+int DmxNetworkSender::syncUniverse() const
+{
+    return (m_syncUniverse > 0) ? m_syncUniverse : firstUniverse();
+}
+
+void DmxNetworkSender::buildPackets(int ledsCount)
+{
+    m_ledsCount = ledsCount;
+    m_universesCount = universesCount(ledsCount);
+
+    int packetsCount = m_universesCount + (m_isSyncEnabled ? 1 : 0);
+
+    m_sender.resize(packetsCount, dataHeaderSize() + UniverseSize);
+
+    int ledsLeft = ledsCount;
+
+    for (int i = 0; i < m_universesCount; i++)
+    {
+        int universe = firstUniverse() + i;
+        int firstSlot = (i == 0) ? m_startAddress - 1 : 0;
+        int leds = qMin(ledsLeft, ledsInUniverse(i));
+        int slotsCount = firstSlot + leds * 3;
+
+        ledsLeft -= leds;
+
+        char *packet = m_sender.packet(i);
+        memset(packet, 0, m_sender.packetCapacity());
+
+        if (m_protocol == ProtocolArtNet)
+        {
+            // Art-Net data length must be even
+            slotsCount += slotsCount % 2;
+            buildArtNetDataPacket(packet, universe, slotsCount);
+            m_sender.setPacketSize(i, ArtNetDataHeaderSize + slotsCount);
+            m_sender.setDestination(i, m_address, m_port);
+        } else {
+            buildE131DataPacket(packet, universe, slotsCount);
+            m_sender.setPacketSize(i, E131DataHeaderSize + slotsCount);
+            m_sender.setDestination(i, m_address.isNull() ? e131MulticastAddress(universe) : m_address, m_port);
+        }
+    }
+
+    if (m_isSyncEnabled)
+    {
+        int index = m_universesCount;
+        char *packet = m_sender.packet(index);
+        memset(packet, 0, m_sender.packetCapacity());
+
+        if (m_protocol == ProtocolArtNet)
+        {
+            buildArtNetSyncPacket(packet);
+            m_sender.setPacketSize(index, ArtNetSyncPacketSize);
+            m_sender.setDestination(index, m_address, m_port);
+        } else {
+            buildE131SyncPacket(packet);
+            m_sender.setPacketSize(index, E131SyncPacketSize);
+            m_sender.setDestination(index, m_address.isNull() ? e131MulticastAddress(syncUniverse()) : m_address, m_port);
+        }
+    }
+
+    m_isLayoutChanged = false;
+
+    DEBUG_LOW_LEVEL << Q_FUNC_INFO << "leds:" << ledsCount << "universes:" << m_universesCount
+                    << "sync:" << m_isSyncEnabled;
+}
+
+void DmxNetworkSender::buildE131DataPacket(char * packet, int universe, int slotsCount)
+{
+    int packetSize = E131DataHeaderSize + slotsCount;
+
+    writeE131RootLayer(packet, packetSize, 0x00000004 /* VECTOR_ROOT_E131_DATA */, m_cid);
+
+    // Framing layer
+    writeWord(packet + 38, 0x7000 | (packetSize - 38));
+    writeLong(packet + 40, 0x00000002);         // VECTOR_E131_DATA_PACKET
+    strncpy(packet + 44, SourceName, 64);
+    packet[108] = 100;                          // priority
+    writeWord(packet + 109, m_isSyncEnabled ? syncUniverse() : 0);
+    packet[E131SequenceIndex] = 0;
+    packet[112] = 0;                            // options
+    writeWord(packet + 113, universe);
+
+    // DMP layer
+    writeWord(packet + 115, 0x7000 | (packetSize - 115));
+    packet[117] = 0x02;                         // VECTOR_DMP_SET_PROPERTY
+    packet[118] = (char)0xa1;                   // address and data type
+    writeWord(packet + 119, 0x0000);            // first property address
+    writeWord(packet + 121, 0x0001);            // address increment
+    writeWord(packet + 123, slotsCount + 1);    // property value count
+    packet[125] = 0x00;                         // DMX start code
+}
+
+void DmxNetworkSender::buildE131SyncPacket(char * packet)
+{
+    writeE131RootLayer(packet, E131SyncPacketSize, 0x00000008 /* VECTOR_ROOT_E131_EXTENDED */, m_cid);
+
+    writeWord(packet + 38, 0x7000 | (E131SyncPacketSize - 38));
+    writeLong(packet + 40, 0x00000001);         // VECTOR_E131_EXTENDED_SYNCHRONIZATION
+    packet[E131SyncSequenceIndex] = 0;
+    writeWord(packet + 45, syncUniverse());
+    writeWord(packet + 47, 0);                  // reserved
+}
+
+void DmxNetworkSender::buildArtNetDataPacket(char * packet, int universe, int slotsCount)
+{
+    memcpy(packet, "Art-Net", 8);
+    packet[8] = 0x00;                           // OpDmx 0x5000, little endian
+    packet[9] = 0x50;
+    writeWord(packet + 10, 14);                 // protocol version
+    packet[ArtNetSequenceIndex] = 0;
+    packet[13] = 0;                             // physical port
+    packet[14] = universe & 0xff;               // SubUni
+    packet[15] = (universe >> 8) & 0x7f;        // Net
+    writeWord(packet + 16, slotsCount);
+}
+
+void DmxNetworkSender::buildArtNetSyncPacket(char * packet)
+{
+    memcpy(packet, "Art-Net", 8);
+    packet[8] = 0x00;                           // OpSync 0x5200, little endian
+    packet[9] = 0x52;
+    writeWord(packet + 10, 14);
+    packet[12] = 0;                             // Aux1
+    packet[13] = 0;                             // Aux2
+}
+
+bool DmxNetworkSender::sendFrame(const char * data, int size)
+{
+    if (m_sender.isOpen() == false || size <= 0)
+        return false;
+
+    int ledsCount = size / 3;
+
+    if (m_isLayoutChanged || ledsCount != m_ledsCount)
+        buildPackets(ledsCount);
+
+    m_sequence++;
+    // Art-Net sequence 0 disables reordering on the node
+    if (m_protocol == ProtocolArtNet && m_sequence == 0)
+        m_sequence = 1;
+
+    int headerSize = dataHeaderSize();
+    int ledIndex = 0;
+
+    for (int i = 0; i < m_universesCount; i++)
+    {
+        char *packet = m_sender.packet(i);
+        int firstSlot = (i == 0) ? m_startAddress - 1 : 0;
+        int leds = qMin(ledsCount - ledIndex, ledsInUniverse(i));
+
+        memcpy(packet + headerSize + firstSlot, data + ledIndex * 3, leds * 3);
+        packet[(m_protocol == ProtocolArtNet) ? ArtNetSequenceIndex : E131SequenceIndex] = m_sequence;
+
+        ledIndex += leds;
+    }
+
+    if (m_isSyncEnabled && m_protocol == ProtocolE131)
+        m_sender.packet(m_universesCount)[E131SyncSequenceIndex] = m_syncSequence++;
+
+    // Sync packet is the last one in the batch, after all universes
+    int sent = m_sender.sendAll();
+
+    if (sent != m_sender.packetsCount())
+    {
+        DEBUG_MID_LEVEL << Q_FUNC_INFO << "sent" << sent << "of" << m_sender.packetsCount() << "packets";
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,114 @@
+/*
+ * DmxNetworkSender.hpp
+ *
+ *  Created on: 19.10.2026
+ *     Project: Lightpack
+ *
+ *  Lightpack is very simple implementation of the backlight for a laptop
+ *
+ *  Copyright (c) 2011 Mike Shatohin, mikeshatohin [at] gmail.com
+ *
+ *  Lightpack is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Lightpack is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <QString>
+
+#include "UdpPacketSender.hpp"
+
+/*!
+  Sends LED frame as DMX512 universes over E1.31 (sACN) or Art-Net.
+
+  First universe starts at the configured DMX address, next ones start at
+  channel 1. LED is never split between universes, so universe holds up to
+  170 LEDs. Packets of all universes are built once when the layout changes,
+  for each frame only DMX data and sequence bytes are written in place.
+
+  Without host E1.31 packets go to the multicast group of each universe
+  (239.255.hi.lo) and Art-Net packets are broadcast. When sync is enabled
+  data packets wait for E1.31 universe sync / ArtSync packet which is sent
+  after the last universe, so all universes are shown at the same time.
+*/
+class DmxNetworkSender
+{
+public:
+    enum Protocol
+    {
+        ProtocolE131,
+        ProtocolArtNet
+    };
+
+    DmxNetworkSender();
+
+    // Port 0 is for the standard port of the protocol
+    bool open(Protocol protocol, const QString & host, quint16 port = 0);
+    void close();
+    bool isOpen() const { return m_sender.isOpen(); }
+
+    // DMX address is 1..512 in the first universe. Universe is bound to
+    // the range of the protocol when packets are built
+    void setUniverse(int firstUniverse, int startAddress);
+    // E1.31 sync packets are addressed to syncUniverse, 0 is for the first universe
+    void setSyncEnabled(bool isEnabled, int syncUniverse = 0);
+
+    // Data is RGB bytes, 3 bytes per LED
+    bool sendFrame(const char * data, int size);
+
+    int universesCount(int ledsCount) const;
+    int ledsInUniverse(int index) const;
+
+    static QHostAddress e131MulticastAddress(int universe);
+    static int minUniverse(Protocol protocol);
+    static int maxUniverse(Protocol protocol);
+
+    static const int UniverseSize;
+    static const int E131Port;
+    static const int E131DataHeaderSize;
+    static const int E131SyncPacketSize;
+    static const int ArtNetPort;
+    static const int ArtNetDataHeaderSize;
+    static const int ArtNetSyncPacketSize;
+
+private:
+    void buildPackets(int ledsCount);
+    void buildE131DataPacket(char * packet, int universe, int slotsCount);
+    void buildE131SyncPacket(char * packet);
+    void buildArtNetDataPacket(char * packet, int universe, int slotsCount);
+    void buildArtNetSyncPacket(char * packet);
+    int dataHeaderSize() const;
+    int firstUniverse() const;
+    int syncUniverse() const;
+
+private:
+    UdpPacketSender m_sender;
+    Protocol m_protocol;
+    QHostAddress m_address;
+    quint16 m_port;
+
+    int m_firstUniverse;
+    int m_startAddress;
+    bool m_isSyncEnabled;
+    int m_syncUniverse;
+
+    // Layout of the packets which are in m_sender
+    int m_ledsCount;
+    int m_universesCount;
+    bool m_isLayoutChanged;
+
+    quint8 m_sequence;
+    quint8 m_syncSequence;
+    QByteArray m_cid;
+};
@@ -0,0 +1,183 @@
+/*
+ * FrameInterpolator.cpp
+ *
+ *  Created on: 19.10.2026
+ *     Project: Lightpack
+ *
+ *  Lightpack is very simple implementation of the backlight for a laptop
+ *
+ *  Copyright (c) 2011 Mike Shatohin, mikeshatohin [at] gmail.com
+ *
+ *  Lightpack is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Lightpack is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <cmath>
+#include <QTimer>
+
+#include "FrameInterpolator.hpp"
+#include "debug.h"
+
+const int FrameInterpolator::MinimumFrameIntervalMs = 4;
+const int FrameInterpolator::DefaultFrameIntervalMs = 16;
+
+// Firmware fades linearly in smoothSlowdown steps of about 1 ms, exponent
+// gets 95% of the way after 3 time constants
+static const double SmoothSlowdownStepsPerTimeConstant = 3.0;
+
+// Channel is at target when it is closer than half of the 8-bit step
+static const float TargetThreshold = 0.5f;
+
+FrameInterpolator::FrameInterpolator(QObject * parent)
+    : QObject(parent)
+{
+    m_timeConstantMs = 0;
+    m_frameIntervalMs = DefaultFrameIntervalMs;
+
+    m_timer = new QTimer(this);
+    m_timer->setInterval(m_frameIntervalMs);
+    connect(m_timer, SIGNAL(timeout()), this, SLOT(nextFrame()));
+}
+
+void FrameInterpolator::setSmoothSlowdown(int value)
+{
+    setTimeConstant(value / SmoothSlowdownStepsPerTimeConstant);
+}
+
+void FrameInterpolator::setTimeConstant(double ms)
+{
+    DEBUG_LOW_LEVEL << Q_FUNC_INFO << ms;
+
+    m_timeConstantMs = qMax(ms, 0.0);
+
+    if (isEnabled() == false)
+        m_timer->stop();
+}
+
+void FrameInterpolator::setFrameInterval(int ms)
+{
+    m_frameIntervalMs = qMax(ms, MinimumFrameIntervalMs);
+    m_timer->setInterval(m_frameIntervalMs);
+}
+
+void FrameInterpolator::resize(int ledsCount)
+{
+    m_current.fill(0, ledsCount * 3);
+    m_target.fill(0, ledsCount * 3);
+
+    m_frame.clear();
+    for (int i = 0; i < ledsCount; i++)
+        m_frame << 0;
+}
+
+void FrameInterpolator::setTarget(const QList<QRgb> & colors)
+{
+    // Nothing to ease from
+    if (m_current.count() != colors.count() * 3)
+    {
+        jumpTo(colors);
+        emit frameReady(m_frame);
+        return;
+    }
+
+    float *target = m_target.data();
+
+    for (int i = 0; i < colors.count(); i++)
+    {
+        *target++ = qRed(colors[i]);
+        *target++ = qGreen(colors[i]);
+        *target++ = qBlue(colors[i]);
+    }
+
+    if (m_timer->isActive() == false)
+    {
+        m_time.start();
+        m_timer->start();
+        advance(m_frameIntervalMs);
+    }
+}
+
+void FrameInterpolator::jumpTo(const QList<QRgb> & colors)
+{
+    m_timer->stop();
+
+    if (m_current.count() != colors.count() * 3)
+        resize(colors.count());
+
+    float *target = m_target.data();
+
+    for (int i = 0; i < colors.count(); i++)
+    {
+        *target++ = qRed(colors[i]);
+        *target++ = qGreen(colors[i]);
+        *target++ = qBlue(colors[i]);
+        m_frame[i] = colors[i];
+    }
+
+    m_current = m_target;
+}
+
+bool FrameInterpolator::isMoving() const
+{
+    return m_timer->isActive();
+}
+
+void FrameInterpolator::advance(double elapsedMs)
+{
+    float k = 1.0f;
+
+    if (m_timeConstantMs > 0)
+        k = 1.0f - (float)exp(-elapsedMs / m_timeConstantMs);
+
+    float *current = m_current.data();
+    const float *target = m_target.constData();
+    bool isReached = true;
+
+    for (int i = 0; i < m_frame.count(); i++)
+    {
+        int rgb[3];
+
+        for (int channel = 0; channel < 3; channel++)
+        {
+            float delta = *target - *current;
+
+            if (fabs(delta) < TargetThreshold)
+                *current = *target;
+            else {
+                *current += delta * k;
+                isReached = false;
+            }
+
+            rgb[channel] = (int)(*current + 0.5f);
+            current++;
+            target++;
+        }
+
+        m_frame[i] = qRgb(rgb[0], rgb[1], rgb[2]);
+    }
+
+    if (isReached)
+        m_timer->stop();
+
+    emit frameReady(m_frame);
+}
+
+void FrameInterpolator::nextFrame()
+{
+    // Timer ticks aren't exact, ease by the real time
+    double elapsedMs = m_time.nsecsElapsed() / 1e6;
+    m_time.restart();
+
+    advance(elapsedMs);
+}
@@ -0,0 +1,92 @@
+/*
+ * FrameInterpolator.hpp
+ *
+ *  Created on: 19.10.2026
+ *     Project: Lightpack
+ *
+ *  Lightpack is very simple implementation of the backlight for a laptop
+ *
+ *  Copyright (c) 2011 Mike Shatohin, mikeshatohin [at] gmail.com
+ *
+ *  Lightpack is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Lightpack is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QVector>
+#include <QList>
+#include <QElapsedTimer>
+#include <QColor>
+
+class QTimer;
+
+/*!
+  Host side smoothing for devices without firmware smoothing.
+
+  Colors ease from the current ones to the last target exponentially with
+  the time constant. While colors move, intermediate frames are emitted
+  every frame interval, which is set to the time link needs for one frame,
+  so output rate doesn't depend on grab rate. Timer stops when the target
+  is reached.
+*/
+class FrameInterpolator : public QObject
+{
+    Q_OBJECT
+public:
+    FrameInterpolator(QObject * parent = 0);
+
+    // Smooth slowdown of Lightpack firmware, 0 disables interpolation
+    void setSmoothSlowdown(int value);
+    void setTimeConstant(double ms);
+    double timeConstant() const { return m_timeConstantMs; }
+    bool isEnabled() const { return m_timeConstantMs > 0; }
+
+    void setFrameInterval(int ms);
+    int frameInterval() const { return m_frameIntervalMs; }
+
+    // First frame of the new target is emitted at once if colors were at rest
+    void setTarget(const QList<QRgb> & colors);
+    // Current colors are set to target without easing
+    void jumpTo(const QList<QRgb> & colors);
+    bool isMoving() const;
+
+    // Moves current colors towards target by elapsed time and emits frameReady()
+    void advance(double elapsedMs);
+
+    static const int MinimumFrameIntervalMs;
+    static const int DefaultFrameIntervalMs;
+
+signals:
+    void frameReady(const QList<QRgb> & colors);
+
+private slots:
+    void nextFrame();
+
+private:
+    void resize(int ledsCount);
+
+private:
+    double m_timeConstantMs;
+    int m_frameIntervalMs;
+
+    QTimer *m_timer;
+    QElapsedTimer m_time;
+
+    // r, g, b of each LED
+    QVector<float> m_current;
+    QVector<float> m_target;
+    QList<QRgb> m_frame;
+};
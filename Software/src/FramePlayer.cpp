@@ -0,0 +1,221 @@
+/*
+ * FramePlayer.cpp
+ *
+ *  Created on: 19.10.2026
+ *     Project: Lightpack
+ *
+ *  Lightpack is very simple implementation of the backlight for a laptop
+ *
+ *  Copyright (c) 2011 Mike Shatohin, mikeshatohin [at] gmail.com
+ *
+ *  Lightpack is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Lightpack is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <string.h>
+#include <QTimer>
+
+#include "FramePlayer.hpp"
+#include "debug.h"
+
+FramePlayer::FramePlayer(QObject * parent)
+    : QObject(parent)
+{
+    m_map = NULL;
+    m_speed = 1.0;
+    m_nextFrame = 0;
+    m_time.invalidate();
+
+    m_timer = new QTimer(this);
+    m_timer->setSingleShot(true);
+    connect(m_timer, SIGNAL(timeout()), this, SLOT(playDueFrames()));
+}
+
+FramePlayer::~FramePlayer()
+{
+    close();
+}
+
+bool FramePlayer::open(const QString & fileName)
+{
+    DEBUG_LOW_LEVEL << Q_FUNC_INFO << fileName;
+
+    close();
+
+    m_file.setFileName(fileName);
+
+    if (m_file.open(QIODevice::ReadOnly) == false)
+    {
+        qWarning() << Q_FUNC_INFO << "open fail:" << fileName << m_file.errorString();
+        return false;
+    }
+
+    qint64 size = m_file.size();
+    FrameLog::FileHeader header;
+
+    if (size >= (qint64)sizeof(header))
+        m_map = m_file.map(0, size);
+
+    if (m_map == NULL)
+    {
+        qWarning() << Q_FUNC_INFO << "map fail:" << fileName << m_file.errorString();
+        m_file.close();
+        return false;
+    }
+
+    memcpy(&header, m_map, sizeof(header));
+
+    if (memcmp(header.magic, FrameLog::Magic, sizeof(header.magic)) != 0
+            || header.version != FrameLog::Version
+            || header.headerSize < sizeof(header) || header.headerSize > size)
+    {
+        qWarning() << Q_FUNC_INFO << "not a frame log:" << fileName;
+        close();
+        return false;
+    }
+
+    m_records.clear();
+
+    qint64 offset = header.headerSize;
+
+    while (offset + (qint64)sizeof(FrameLog::RecordHeader) <= size)
+    {
+        FrameLog::RecordHeader record;
+        memcpy(&record, m_map + offset, sizeof(record));
+
+        qint64 recordSize = sizeof(record) + record.ledsCount * sizeof(QRgb);
+
+        // Preallocated tail or frame cut by a crash
+        if (record.ledsCount == 0 || offset + recordSize > size)
+            break;
+
+        m_records.append(offset);
+        offset += recordSize;
+    }
+
+    DEBUG_LOW_LEVEL << Q_FUNC_INFO << "frames:" << m_records.count();
+
+    return true;
+}
+
+void FramePlayer::close()
+{
+    stop();
+
+    if (m_map != NULL)
+    {
+        m_file.unmap(m_map);
+        m_map = NULL;
+    }
+
+    m_file.close();
+    m_records.clear();
+}
+
+FrameLog::RecordHeader FramePlayer::recordHeader(int index) const
+{
+    FrameLog::RecordHeader record;
+    memcpy(&record, m_map + m_records[index], sizeof(record));
+
+    return record;
+}
+
+qint64 FramePlayer::frameTimestamp(int index) const
+{
+    return recordHeader(index).timestamp;
+}
+
+quint32 FramePlayer::frameSequence(int index) const
+{
+    return recordHeader(index).sequence;
+}
+
+void FramePlayer::readFrame(int index, QList<QRgb> & colors) const
+{
+    FrameLog::RecordHeader record = recordHeader(index);
+    const uchar *data = m_map + m_records[index] + sizeof(record);
+
+    // Reuse nodes of the list, frames usually have the same size
+    while (colors.count() > record.ledsCount)
+        colors.removeLast();
+    while (colors.count() < record.ledsCount)
+        colors.append(0);
+
+    for (int i = 0; i < record.ledsCount; i++)
+    {
+        QRgb color;
+        memcpy(&color, data + i * sizeof(QRgb), sizeof(color));
+        colors[i] = color;
+    }
+}
+
+bool FramePlayer::isPlaying() const
+{
+    return m_nextFrame < m_records.count() && m_time.isValid();
+}
+
+void FramePlayer::start(double speed)
+{
+    DEBUG_LOW_LEVEL << Q_FUNC_INFO << speed;
+
+    if (m_map == NULL || m_records.isEmpty())
+    {
+        emit finished();
+        return;
+    }
+
+    m_speed = (speed > 0) ? speed : 1.0;
+    m_nextFrame = 0;
+    m_time.start();
+
+    playDueFrames();
+}
+
+void FramePlayer::stop()
+{
+    m_timer->stop();
+    m_time.invalidate();
+}
+
+void FramePlayer::playDueFrames()
+{
+    if (m_time.isValid() == false)
+        return;
+
+    // Timestamps of the log are relative to the first frame
+    qint64 firstTimestamp = frameTimestamp(0);
+    qint64 elapsed = m_time.nsecsElapsed();
+
+    while (m_nextFrame < m_records.count())
+    {
+        qint64 due = (frameTimestamp(m_nextFrame) - firstTimestamp) / m_speed;
+
+        if (due > elapsed)
+        {
+            // Round up, early timeout would spin here
+            m_timer->start((due - elapsed + 999999) / 1000000);
+            return;
+        }
+
+        readFrame(m_nextFrame, m_colors);
+        m_nextFrame++;
+
+        emit frameReady(m_colors);
+    }
+
+    DEBUG_LOW_LEVEL << Q_FUNC_INFO << "replay finished, frames:" << m_records.count();
+
+    m_time.invalidate();
+    emit finished();
+}
@@ -0,0 +1,90 @@
+/*
+ * FramePlayer.hpp
+ *
+ *  Created on: 19.10.2026
+ *     Project: Lightpack
+ *
+ *  Lightpack is very simple implementation of the backlight for a laptop
+ *
+ *  Copyright (c) 2011 Mike Shatohin, mikeshatohin [at] gmail.com
+ *
+ *  Lightpack is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Lightpack is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QFile>
+#include <QVector>
+#include <QList>
+#include <QElapsedTimer>
+#include <QColor>
+
+#include "FrameRecorder.hpp"
+
+class QTimer;
+
+/*!
+  Plays back frames recorded by FrameRecorder.
+
+  Log is mapped read-only and indexed once on open. Frames are emitted with
+  the recorded intervals divided by the speed factor, frames which are late
+  are emitted at once in the recorded order.
+*/
+class FramePlayer : public QObject
+{
+    Q_OBJECT
+public:
+    FramePlayer(QObject * parent = 0);
+    ~FramePlayer();
+
+    bool open(const QString & fileName);
+    void close();
+    bool isOpen() const { return m_map != NULL; }
+
+    int framesCount() const { return m_records.count(); }
+    qint64 frameTimestamp(int index) const;
+    quint32 frameSequence(int index) const;
+    void readFrame(int index, QList<QRgb> & colors) const;
+
+    bool isPlaying() const;
+
+public slots:
+    // Speed 1.0 is the recorded speed, 2.0 is twice faster
+    void start(double speed = 1.0);
+    void stop();
+
+signals:
+    void frameReady(const QList<QRgb> & colors);
+    void finished();
+
+private slots:
+    void playDueFrames();
+
+private:
+    FrameLog::RecordHeader recordHeader(int index) const;
+
+private:
+    QFile m_file;
+    uchar *m_map;
+    // Offsets of the records in the mapped file
+    QVector<qint64> m_records;
+
+    QTimer *m_timer;
+    QElapsedTimer m_time;
+    double m_speed;
+    int m_nextFrame;
+    QList<QRgb> m_colors;
+};
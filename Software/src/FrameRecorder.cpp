@@ -0,0 +1,188 @@
+/*
+ * FrameRecorder.cpp
+ *
+ *  Created on: 19.10.2026
+ *     Project: Lightpack
+ *
+ *  Lightpack is very simple implementation of the backlight for a laptop
+ *
+ *  Copyright (c) 2011 Mike Shatohin, mikeshatohin [at] gmail.com
+ *
+ *  Lightpack is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Lightpack is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <string.h>
+#include <stddef.h>
+#include <QDateTime>
+
+#include "FrameRecorder.hpp"
+#include "debug.h"
+
+const char FrameLog::Magic[8] = { 'L', 'P', 'F', 'R', 'A', 'M', 'E', 'S' };
+const quint32 FrameLog::Version = 1;
+
+const qint64 FrameRecorder::InitialCapacity = 1024 * 1024;
+const qint64 FrameRecorder::MaximumGrowStep = 64 * 1024 * 1024;
+
+FrameRecorder::FrameRecorder()
+{
+    m_map = NULL;
+    m_size = 0;
+    m_capacity = 0;
+    m_sequence = 0;
+}
+
+FrameRecorder::~FrameRecorder()
+{
+    close();
+}
+
+bool FrameRecorder::open(const QString & fileName)
+{
+    DEBUG_LOW_LEVEL << Q_FUNC_INFO << fileName;
+
+    close();
+
+    m_file.setFileName(fileName);
+
+    if (m_file.open(QIODevice::ReadWrite | QIODevice::Truncate) == false)
+    {
+        qWarning() << Q_FUNC_INFO << "open fail:" << fileName << m_file.errorString();
+        return false;
+    }
+
+    if (remap(InitialCapacity) == false)
+    {
+        m_file.close();
+        return false;
+    }
+
+    FrameLog::FileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, FrameLog::Magic, sizeof(header.magic));
+    header.version = FrameLog::Version;
+    header.headerSize = sizeof(header);
+    header.startTime = QDateTime::currentMSecsSinceEpoch();
+
+    memcpy(m_map, &header, sizeof(header));
+    m_size = sizeof(header);
+
+    m_sequence = 0;
+    m_time.start();
+
+    return true;
+}
+
+void FrameRecorder::close()
+{
+    if (m_file.isOpen() == false)
+        return;
+
+    DEBUG_LOW_LEVEL << Q_FUNC_INFO << m_file.fileName() << "frames:" << m_sequence << "bytes:" << m_size;
+
+    if (m_map != NULL)
+    {
+        m_file.unmap(m_map);
+        m_map = NULL;
+    }
+
+    // Cut the preallocated tail
+    m_file.resize(m_size);
+    m_file.close();
+
+    m_capacity = 0;
+}
+
+bool FrameRecorder::append(const QList<QRgb> & colors)
+{
+    if (m_map == NULL || colors.isEmpty())
+        return false;
+
+    int ledsCount = qMin(colors.count(), 0xffff);
+    qint64 recordSize = sizeof(FrameLog::RecordHeader) + ledsCount * sizeof(QRgb);
+
+    if (reserve(m_size + recordSize) == false)
+    {
+        // Keep what is already recorded
+        close();
+        return false;
+    }
+
+    uchar *record = m_map + m_size;
+    quint32 *data = (quint32 *)(record + sizeof(FrameLog::RecordHeader));
+
+    for (int i = 0; i < ledsCount; i++)
+        data[i] = colors[i];
+
+    FrameLog::RecordHeader header;
+    header.timestamp = m_time.nsecsElapsed();
+    header.sequence = m_sequence;
+    header.ledsCount = 0;
+    header.reserved = 0;
+
+    memcpy(record, &header, sizeof(header));
+
+    // Zero LEDs count marks the end of the log until the record is complete
+    header.ledsCount = ledsCount;
+    memcpy(record + offsetof(FrameLog::RecordHeader, ledsCount), &header.ledsCount, sizeof(header.ledsCount));
+
+    m_size += recordSize;
+    m_sequence++;
+
+    return true;
+}
+
+bool FrameRecorder::reserve(qint64 size)
+{
+    if (size <= m_capacity)
+        return true;
+
+    qint64 capacity = m_capacity;
+
+    while (capacity < size)
+        capacity += qMin(capacity, MaximumGrowStep);
+
+    return remap(capacity);
+}
+
+bool FrameRecorder::remap(qint64 capacity)
+{
+    if (m_map != NULL)
+    {
+        m_file.unmap(m_map);
+        m_map = NULL;
+    }
+
+    // New pages are zero filled, so the tail is always an end of the log
+    if (m_file.resize(capacity) == false)
+    {
+        qWarning() << Q_FUNC_INFO << "resize fail:" << capacity << m_file.errorString();
+        return false;
+    }
+
+    m_map = m_file.map(0, capacity);
+
+    if (m_map == NULL)
+    {
+        qWarning() << Q_FUNC_INFO << "map fail:" << capacity << m_file.errorString();
+        m_capacity = 0;
+        return false;
+    }
+
+    DEBUG_MID_LEVEL << Q_FUNC_INFO << "capacity:" << capacity;
+
+    m_capacity = capacity;
+    return true;
+}
@@ -0,0 +1,111 @@
+/*
+ * FrameRecorder.hpp
+ *
+ *  Created on: 19.10.2026
+ *     Project: Lightpack
+ *
+ *  Lightpack is very simple implementation of the backlight for a laptop
+ *
+ *  Copyright (c) 2011 Mike Shatohin, mikeshatohin [at] gmail.com
+ *
+ *  Lightpack is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Lightpack is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <QFile>
+#include <QList>
+#include <QElapsedTimer>
+#include <QColor>
+
+/*!
+  Binary log of the frames sent to the LED device.
+
+  File header (24 bytes):
+    0..7    magic "LPFRAMES"
+    8..11   format version
+    12..15  header size
+    16..23  recording start, msecs since epoch
+
+  Record (16 bytes + 4 bytes per LED):
+    0..7    monotonic timestamp, nsecs since recording start
+    8..11   frame sequence number, starts from 0
+    12..13  LEDs count
+    14..15  reserved
+    16..    QRgb colors
+
+  Numbers are in host byte order. File grows in large steps, so it may end
+  with zero bytes, first record with zero LEDs count is the end of the log.
+*/
+namespace FrameLog
+{
+struct FileHeader
+{
+    char magic[8];
+    quint32 version;
+    quint32 headerSize;
+    qint64 startTime;
+};
+
+struct RecordHeader
+{
+    quint64 timestamp;
+    quint32 sequence;
+    quint16 ledsCount;
+    quint16 reserved;
+};
+
+extern const char Magic[8];
+extern const quint32 Version;
+}
+
+/*!
+  Appends frames to the FrameLog file through memory mapping.
+
+  Append is a copy into the mapped file, no system calls are made except
+  when the file grows. Record is committed by writing its LEDs count last,
+  so log which is cut by a crash ends at the last complete frame.
+*/
+class FrameRecorder
+{
+public:
+    FrameRecorder();
+    ~FrameRecorder();
+
+    bool open(const QString & fileName);
+    void close();
+    bool isOpen() const { return m_map != NULL; }
+
+    bool append(const QList<QRgb> & colors);
+
+    quint32 framesCount() const { return m_sequence; }
+    qint64 size() const { return m_size; }
+
+    static const qint64 InitialCapacity;
+    static const qint64 MaximumGrowStep;
+
+private:
+    bool reserve(qint64 size);
+    bool remap(qint64 capacity);
+
+private:
+    QFile m_file;
+    uchar *m_map;
+    qint64 m_size;
+    qint64 m_capacity;
+
+    QElapsedTimer m_time;
+    quint32 m_sequence;
+};
@@ -37,6 +37,12 @@ class ILedDevice : public QObject
 public:
     ILedDevice(QObject * parent) : QObject(parent) {}
 
+    /*!
+      Locked while device prepares its colors buffer and while device is
+      recreated after change of the device type.
+    */
+    static QMutex * colorsMutex() { static QMutex mutex; return &mutex; }
+
 signals:
     void openDeviceSuccess(bool isSuccess);
     void ioDeviceSuccess(bool isSuccess);
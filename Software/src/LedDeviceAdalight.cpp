@@ -26,6 +26,7 @@
 
 #include "LedDeviceAdalight.hpp"
 #include "LightpackMath.hpp"
+#include "SharedFrame.hpp"
 #include "Settings.hpp"
 #include "debug.h"
 #include "stdio.h"
@@ -36,8 +37,28 @@ LedDeviceAdalight::LedDeviceAdalight(QObject * parent) : ILedDevice(parent)
 {
     DEBUG_LOW_LEVEL << Q_FUNC_INFO;
 
+    m_AdalightDevice = NULL;
+    m_serialOutput = new SerialOutputEngine(this);
+    m_isDeltaProtocolEnabled = false;
+    m_hotplugMonitor = new DeviceHotplugMonitor(this);
+    m_interpolator = new FrameInterpolator(this);
+    // Smooth slowdown of the profile is tuned for Lightpack firmware,
+    // on host it is applied only when enabled in main config
+    m_interpolator->setSmoothSlowdown(Settings::isHostSmoothingEnabled() ? Settings::getDeviceSmooth() : 0);
+    m_isLastWriteOk = true;
+
+    connect(m_interpolator, SIGNAL(frameReady(QList<QRgb>)), this, SLOT(writeInterpolatedFrame(QList<QRgb>)));
+
+    connect(m_hotplugMonitor, SIGNAL(serialPortAdded(QString)), this, SLOT(serialPortAdded(QString)));
+    connect(m_hotplugMonitor, SIGNAL(serialPortRemoved(QString)), this, SLOT(serialPortRemoved(QString)));
+
     m_gamma = Settings::getDeviceGamma();
     m_brightness = Settings::getDeviceBrightness();
+    m_dither.setEnabled(Settings::isTemporalDitheringEnabled());
+    // Remainders are carried only from frames which engine has sent
+    m_dither.setCommitDeferred(true);
+    connect(m_serialOutput, SIGNAL(frameSent()), this, SLOT(serialFrameSent()));
+
     m_colorSequence =Settings::getColorSequence(SupportedDevices::DeviceTypeAdalight);
 
     // TODO: think about init m_savedColors in all ILedDevices
@@ -58,13 +79,41 @@ void LedDeviceAdalight::setColors(const QList<QRgb> & colors)
     // Save colors for showing changes of the brightness
     m_colorsSaved = colors;
 
+    if (m_interpolator->isEnabled())
+    {
+        // Intermediate frames are written by interpolator at the link rate
+        m_interpolator->setTarget(colors);
+        emit commandCompleted(m_isLastWriteOk);
+        return;
+    }
+
+    bool ok = writeColors(colors);
+
+    emit commandCompleted(ok);
+}
+
+void LedDeviceAdalight::writeInterpolatedFrame(const QList<QRgb> & colors)
+{
+    m_isLastWriteOk = writeColors(colors);
+}
+
+bool LedDeviceAdalight::writeColors(const QList<QRgb> & colors)
+{
     resizeColorsBuffer(colors.count());
 
-    LightpackMath::gammaCorrection(m_gamma, colors, m_colorsBuffer);
+    LightpackMath::gammaCorrection(m_gamma, colors, m_colorsBuffer, 4096 /* 12-bit result */);
     LightpackMath::brightnessCorrection(m_brightness, m_colorsBuffer);
 
+    SharedFramePublisher::instance()->publish(m_colorsBuffer, 12);
+
+    // Device takes 8 bits, dropped low bits are carried to next frames
+    m_dither.apply(m_colorsBuffer);
+
     m_writeBuffer.clear();
-    m_writeBuffer.append(m_writeBufferHeader);
+
+    // In delta protocol header is written by m_deltaCodec
+    if (m_isDeltaProtocolEnabled == false)
+        m_writeBuffer.append(m_writeBufferHeader);
 
     for (int i = 0; i < m_colorsBuffer.count(); i++)
     {
@@ -108,9 +157,7 @@ void LedDeviceAdalight::setColors(const QList<QRgb> & colors)
         }
     }
 
-    bool ok = writeBuffer(m_writeBuffer);
-
-    emit commandCompleted(ok);
+    return writeBuffer(m_writeBuffer);
 }
 
 void LedDeviceAdalight::switchOffLeds()
@@ -121,6 +168,8 @@ void LedDeviceAdalight::switchOffLeds()
     for (int i = 0; i < count; i++)
         m_colorsSaved << 0;
 
+    // Switch off at once, without fading
+    m_interpolator->jumpTo(m_colorsSaved);
     setColors(m_colorsSaved);
 }
 
@@ -134,8 +183,11 @@ void LedDeviceAdalight::setColorDepth(int /*value*/)
     emit commandCompleted(true);
 }
 
-void LedDeviceAdalight::setSmoothSlowdown(int /*value*/)
+void LedDeviceAdalight::setSmoothSlowdown(int value)
 {
+    DEBUG_LOW_LEVEL << Q_FUNC_INFO << value;
+
+    m_interpolator->setSmoothSlowdown(Settings::isHostSmoothingEnabled() ? value : 0);
     emit commandCompleted(true);
 }
 
@@ -173,6 +225,7 @@ void LedDeviceAdalight::updateDeviceSettings()
 {
     DEBUG_LOW_LEVEL << Q_FUNC_INFO;
 
+    setDeltaProtocolEnabled(Settings::isAdalightDeltaProtocolEnabled());
     setGamma(Settings::getDeviceGamma());
     setBrightness(Settings::getDeviceBrightness());
     setColorSequence(Settings::getColorSequence(SupportedDevices::DeviceTypeAdalight));
@@ -184,6 +237,9 @@ void LedDeviceAdalight::open()
 
     m_gamma = Settings::getDeviceGamma();
     m_brightness = Settings::getDeviceBrightness();
+    m_dither.setEnabled(Settings::isTemporalDitheringEnabled());
+
+    closeDevice();
 
     m_AdalightDevice = new AbstractSerial();
 
@@ -213,6 +269,12 @@ void LedDeviceAdalight::open()
                 DEBUG_LOW_LEVEL << Q_FUNC_INFO << "Parity     :" << m_AdalightDevice->parity();
                 DEBUG_LOW_LEVEL << Q_FUNC_INFO << "Stop bits  :" << m_AdalightDevice->stopBits();
                 DEBUG_LOW_LEVEL << Q_FUNC_INFO << "Flow       :" << m_AdalightDevice->flowControl();
+
+                m_serialOutput->setBaudRate(Settings::getAdalightSerialPortBaudRate().toInt());
+                m_serialOutput->setSerialDevice(m_AdalightDevice);
+                updateFrameInterval();
+
+                setDeltaProtocolEnabled(Settings::isAdalightDeltaProtocolEnabled());
             } else {
                 qWarning() << Q_FUNC_INFO << "Set data bits 8 fail";
             }
@@ -231,18 +293,16 @@ bool LedDeviceAdalight::writeBuffer(const QByteArray & buff)
 {
     DEBUG_MID_LEVEL << Q_FUNC_INFO << "Hex:" << buff.toHex();
 
-    if (m_AdalightDevice->isOpen() == false)
+    if (m_AdalightDevice == NULL || m_AdalightDevice->isOpen() == false)
         return false;
 
-    int bytesWritten = m_AdalightDevice->write(buff);
-
-    if (bytesWritten != buff.count())
-    {
-        qWarning() << Q_FUNC_INFO << "bytesWritten != buff.count():" << bytesWritten << buff.count();
-        return false;
-    }
+    // Doesn't block device thread, frame waits in engine while UART is busy
+    return m_serialOutput->writeFrame(buff);
+}
 
-    return true;
+void LedDeviceAdalight::serialFrameSent()
+{
+    m_dither.commit();
 }
 
 void LedDeviceAdalight::resizeColorsBuffer(int buffSize)
@@ -264,9 +324,26 @@ void LedDeviceAdalight::resizeColorsBuffer(int buffSize)
         m_colorsBuffer << StructRgb();
     }
 
+    updateFrameInterval();
     reinitBufferHeader(buffSize);
 }
 
+void LedDeviceAdalight::updateFrameInterval()
+{
+    int ledsCount = m_colorsBuffer.count();
+    int frameSize = 6 + ledsCount * 3;
+
+    // Keyframe is the biggest packet of delta protocol
+    if (m_isDeltaProtocolEnabled)
+    {
+        int spansCount = (ledsCount + AdalightDeltaCodec::MaximumSpanLeds - 1) / AdalightDeltaCodec::MaximumSpanLeds;
+        frameSize = AdalightDeltaCodec::HeaderSize + spansCount * AdalightDeltaCodec::SpanHeaderSize + ledsCount * 3;
+    }
+
+    // Interpolated frames come as fast as the UART sends them
+    m_interpolator->setFrameInterval((int)ceil(m_serialOutput->wireTimeMs(frameSize)));
+}
+
 void LedDeviceAdalight::reinitBufferHeader(int ledsCount)
 {
     m_writeBufferHeader.clear();
@@ -282,3 +359,57 @@ void LedDeviceAdalight::reinitBufferHeader(int ledsCount)
     m_writeBufferHeader.append((char)ledsCountLo);
     m_writeBufferHeader.append((char)(ledsCountHi ^ ledsCountLo ^ 0x55));
 }
+
+void LedDeviceAdalight::setDeltaProtocolEnabled(bool isEnabled)
+{
+    DEBUG_LOW_LEVEL << Q_FUNC_INFO << isEnabled;
+
+    m_isDeltaProtocolEnabled = isEnabled;
+
+    // Device have to get keyframe before any delta
+    m_deltaCodec.reset();
+    // Dithered static frame would differ each time and never be skipped by delta
+    m_dither.setHoldUnchangedFrames(isEnabled);
+
+    updateFrameInterval();
+    m_serialOutput->setFrameEncoder(isEnabled ? &m_deltaCodec : NULL);
+}
+
+void LedDeviceAdalight::closeDevice()
+{
+    DEBUG_LOW_LEVEL << Q_FUNC_INFO;
+
+    m_serialOutput->setSerialDevice(NULL);
+
+    if (m_AdalightDevice != NULL)
+    {
+        m_AdalightDevice->close();
+        delete m_AdalightDevice;
+        m_AdalightDevice = NULL;
+    }
+}
+
+void LedDeviceAdalight::serialPortAdded(const QString & deviceNode)
+{
+    if (DeviceHotplugMonitor::isSamePort(deviceNode, Settings::getAdalightSerialPortName()) == false)
+        return;
+
+    DEBUG_LOW_LEVEL << Q_FUNC_INFO << deviceNode;
+
+    if (m_AdalightDevice == NULL || m_AdalightDevice->isOpen() == false)
+        open();
+}
+
+void LedDeviceAdalight::serialPortRemoved(const QString & deviceNode)
+{
+    if (DeviceHotplugMonitor::isSamePort(deviceNode, Settings::getAdalightSerialPortName()) == false)
+        return;
+
+    DEBUG_LOW_LEVEL << Q_FUNC_INFO << deviceNode;
+
+    if (m_AdalightDevice != NULL)
+    {
+        closeDevice();
+        emit ioDeviceSuccess(false);
+    }
+}
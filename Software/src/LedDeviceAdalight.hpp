@@ -28,7 +28,12 @@
 
 #include "ILedDevice.hpp"
 #include "StructRgb.hpp"
+#include "TemporalDither.hpp"
 #include "abstractserial.h"
+#include "SerialOutputEngine.hpp"
+#include "DeviceHotplugMonitor.hpp"
+#include "FrameInterpolator.hpp"
+#include "AdalightDeltaCodec.hpp"
 
 class LedDeviceAdalight : public ILedDevice
 {
@@ -43,20 +48,36 @@ public slots:
     void switchOffLeds();
     void setRefreshDelay(int /*value*/);
     void setColorDepth(int /*value*/);
-    void setSmoothSlowdown(int /*value*/);
+    void setSmoothSlowdown(int value);
     void setGamma(double /*value*/);
     void setBrightness(int /*value*/);
     void setColorSequence(QString value);
     void requestFirmwareVersion();
     void updateDeviceSettings();
 
+private slots:
+    void serialPortAdded(const QString & deviceNode);
+    void serialPortRemoved(const QString & deviceNode);
+    void writeInterpolatedFrame(const QList<QRgb> & colors);
+    void serialFrameSent();
+
 private:
+    bool writeColors(const QList<QRgb> & colors);
     bool writeBuffer(const QByteArray & buff);
     void resizeColorsBuffer(int buffSize);
+    void closeDevice();
     void reinitBufferHeader(int ledsCount);
+    void updateFrameInterval();
+    void setDeltaProtocolEnabled(bool isEnabled);
 
 private:
     AbstractSerial *m_AdalightDevice;
+    SerialOutputEngine *m_serialOutput;
+    DeviceHotplugMonitor *m_hotplugMonitor;
+    FrameInterpolator *m_interpolator;
+    bool m_isLastWriteOk;
+    AdalightDeltaCodec m_deltaCodec;
+    bool m_isDeltaProtocolEnabled;
 
     QByteArray m_writeBufferHeader;
     QByteArray m_writeBuffer;
@@ -67,4 +88,5 @@ private:
 
     QList<QRgb> m_colorsSaved;
     QList<StructRgb> m_colorsBuffer;
+    TemporalDither m_dither;
 };
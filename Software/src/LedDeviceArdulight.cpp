@@ -26,6 +26,7 @@
 
 #include "LedDeviceArdulight.hpp"
 #include "LightpackMath.hpp"
+#include "SharedFrame.hpp"
 #include "Settings.hpp"
 #include "debug.h"
 #include "stdio.h"
@@ -36,8 +37,26 @@ LedDeviceArdulight::LedDeviceArdulight(QObject * parent) : ILedDevice(parent)
 {
     DEBUG_LOW_LEVEL << Q_FUNC_INFO;
 
+    m_ArdulightDevice = NULL;
+    m_serialOutput = new SerialOutputEngine(this);
+    m_hotplugMonitor = new DeviceHotplugMonitor(this);
+    m_interpolator = new FrameInterpolator(this);
+    // Smooth slowdown of the profile is tuned for Lightpack firmware,
+    // on host it is applied only when enabled in main config
+    m_interpolator->setSmoothSlowdown(Settings::isHostSmoothingEnabled() ? Settings::getDeviceSmooth() : 0);
+    m_isLastWriteOk = true;
+
+    connect(m_interpolator, SIGNAL(frameReady(QList<QRgb>)), this, SLOT(writeInterpolatedFrame(QList<QRgb>)));
+
+    connect(m_hotplugMonitor, SIGNAL(serialPortAdded(QString)), this, SLOT(serialPortAdded(QString)));
+    connect(m_hotplugMonitor, SIGNAL(serialPortRemoved(QString)), this, SLOT(serialPortRemoved(QString)));
+
     m_gamma = Settings::getDeviceGamma();
     m_brightness = Settings::getDeviceBrightness();
+    m_dither.setEnabled(Settings::isTemporalDitheringEnabled());
+    // Remainders are carried only from frames which engine has sent
+    m_dither.setCommitDeferred(true);
+    connect(m_serialOutput, SIGNAL(frameSent()), this, SLOT(serialFrameSent()));
 
     m_writeBufferHeader.append((char)255);
 
@@ -61,10 +80,35 @@ void LedDeviceArdulight::setColors(const QList<QRgb> & colors)
     // Save colors for showing changes of the brightness
     m_colorsSaved = colors;
 
+    if (m_interpolator->isEnabled())
+    {
+        // Intermediate frames are written by interpolator at the link rate
+        m_interpolator->setTarget(colors);
+        emit commandCompleted(m_isLastWriteOk);
+        return;
+    }
+
+    bool ok = writeColors(colors);
+
+    emit commandCompleted(ok);
+}
+
+void LedDeviceArdulight::writeInterpolatedFrame(const QList<QRgb> & colors)
+{
+    m_isLastWriteOk = writeColors(colors);
+}
+
+bool LedDeviceArdulight::writeColors(const QList<QRgb> & colors)
+{
     resizeColorsBuffer(colors.count());
 
-    LightpackMath::gammaCorrection(m_gamma, colors, m_colorsBuffer);
+    LightpackMath::gammaCorrection(m_gamma, colors, m_colorsBuffer, 4096 /* 12-bit result */);
     LightpackMath::brightnessCorrection(m_brightness, m_colorsBuffer);
+
+    SharedFramePublisher::instance()->publish(m_colorsBuffer, 12);
+
+    // Device takes 8 bits, dropped low bits are carried to next frames
+    m_dither.apply(m_colorsBuffer);
     LightpackMath::maxCorrection(254,m_colorsBuffer);
 
     m_writeBuffer.clear();
@@ -113,9 +157,7 @@ void LedDeviceArdulight::setColors(const QList<QRgb> & colors)
         }
     }
 
-    bool ok = writeBuffer(m_writeBuffer);
-
-    emit commandCompleted(ok);
+    return writeBuffer(m_writeBuffer);
 }
 
 void LedDeviceArdulight::switchOffLeds()
@@ -126,6 +168,8 @@ void LedDeviceArdulight::switchOffLeds()
     for (int i = 0; i < count; i++)
         m_colorsSaved << 0;
 
+    // Switch off at once, without fading
+    m_interpolator->jumpTo(m_colorsSaved);
     setColors(m_colorsSaved);
 }
 
@@ -139,8 +183,11 @@ void LedDeviceArdulight::setColorDepth(int /*value*/)
     emit commandCompleted(true);
 }
 
-void LedDeviceArdulight::setSmoothSlowdown(int /*value*/)
+void LedDeviceArdulight::setSmoothSlowdown(int value)
 {
+    DEBUG_LOW_LEVEL << Q_FUNC_INFO << value;
+
+    m_interpolator->setSmoothSlowdown(Settings::isHostSmoothingEnabled() ? value : 0);
     emit commandCompleted(true);
 }
 
@@ -190,6 +237,9 @@ void LedDeviceArdulight::open()
 
     m_gamma = Settings::getDeviceGamma();
     m_brightness = Settings::getDeviceBrightness();
+    m_dither.setEnabled(Settings::isTemporalDitheringEnabled());
+
+    closeDevice();
 
     m_ArdulightDevice = new AbstractSerial();
 
@@ -219,6 +269,10 @@ void LedDeviceArdulight::open()
                 DEBUG_LOW_LEVEL << Q_FUNC_INFO << "Parity     :" << m_ArdulightDevice->parity();
                 DEBUG_LOW_LEVEL << Q_FUNC_INFO << "Stop bits  :" << m_ArdulightDevice->stopBits();
                 DEBUG_LOW_LEVEL << Q_FUNC_INFO << "Flow       :" << m_ArdulightDevice->flowControl();
+
+                m_serialOutput->setBaudRate(Settings::getArdulightSerialPortBaudRate().toInt());
+                m_serialOutput->setSerialDevice(m_ArdulightDevice);
+                updateFrameInterval();
             } else {
                 qWarning() << Q_FUNC_INFO << "Set data bits 8 fail";
             }
@@ -237,18 +291,16 @@ bool LedDeviceArdulight::writeBuffer(const QByteArray & buff)
 {
     DEBUG_MID_LEVEL << Q_FUNC_INFO << "Hex:" << buff.toHex();
 
-    if (m_ArdulightDevice->isOpen() == false)
+    if (m_ArdulightDevice == NULL || m_ArdulightDevice->isOpen() == false)
         return false;
 
-    int bytesWritten = m_ArdulightDevice->write(buff);
-
-    if (bytesWritten != buff.count())
-    {
-        qWarning() << Q_FUNC_INFO << "bytesWritten != buff.count():" << bytesWritten << buff.count();
-        return false;
-    }
+    // Doesn't block device thread, frame waits in engine while UART is busy
+    return m_serialOutput->writeFrame(buff);
+}
 
-    return true;
+void LedDeviceArdulight::serialFrameSent()
+{
+    m_dither.commit();
 }
 
 void LedDeviceArdulight::resizeColorsBuffer(int buffSize)
@@ -269,5 +321,51 @@ void LedDeviceArdulight::resizeColorsBuffer(int buffSize)
     {
         m_colorsBuffer << StructRgb();
     }
+
+    updateFrameInterval();
+}
+
+void LedDeviceArdulight::updateFrameInterval()
+{
+    // Interpolated frames come as fast as the UART sends them
+    m_interpolator->setFrameInterval((int)ceil(m_serialOutput->wireTimeMs(1 + m_colorsBuffer.count() * 3)));
+}
+
+void LedDeviceArdulight::closeDevice()
+{
+    DEBUG_LOW_LEVEL << Q_FUNC_INFO;
+
+    m_serialOutput->setSerialDevice(NULL);
+
+    if (m_ArdulightDevice != NULL)
+    {
+        m_ArdulightDevice->close();
+        delete m_ArdulightDevice;
+        m_ArdulightDevice = NULL;
+    }
 }
 
+void LedDeviceArdulight::serialPortAdded(const QString & deviceNode)
+{
+    if (DeviceHotplugMonitor::isSamePort(deviceNode, Settings::getArdulightSerialPortName()) == false)
+        return;
+
+    DEBUG_LOW_LEVEL << Q_FUNC_INFO << deviceNode;
+
+    if (m_ArdulightDevice == NULL || m_ArdulightDevice->isOpen() == false)
+        open();
+}
+
+void LedDeviceArdulight::serialPortRemoved(const QString & deviceNode)
+{
+    if (DeviceHotplugMonitor::isSamePort(deviceNode, Settings::getArdulightSerialPortName()) == false)
+        return;
+
+    DEBUG_LOW_LEVEL << Q_FUNC_INFO << deviceNode;
+
+    if (m_ArdulightDevice != NULL)
+    {
+        closeDevice();
+        emit ioDeviceSuccess(false);
+    }
+}
@@ -28,7 +28,11 @@
 
 #include "ILedDevice.hpp"
 #include "StructRgb.hpp"
+#include "TemporalDither.hpp"
 #include "abstractserial.h"
+#include "SerialOutputEngine.hpp"
+#include "DeviceHotplugMonitor.hpp"
+#include "FrameInterpolator.hpp"
 
 class LedDeviceArdulight : public ILedDevice
 {
@@ -43,19 +47,32 @@ public slots:
     void switchOffLeds();
     void setRefreshDelay(int /*value*/);
     void setColorDepth(int /*value*/);
-    void setSmoothSlowdown(int /*value*/);
+    void setSmoothSlowdown(int value);
     void setGamma(double /*value*/);
     void setBrightness(int /*value*/);
     void setColorSequence(QString value);
     void requestFirmwareVersion();
     void updateDeviceSettings();
 
+private slots:
+    void serialPortAdded(const QString & deviceNode);
+    void serialPortRemoved(const QString & deviceNode);
+    void writeInterpolatedFrame(const QList<QRgb> & colors);
+    void serialFrameSent();
+
 private:
+    bool writeColors(const QList<QRgb> & colors);
     bool writeBuffer(const QByteArray & buff);
     void resizeColorsBuffer(int buffSize);
+    void closeDevice();
+    void updateFrameInterval();
 
 private:
     AbstractSerial *m_ArdulightDevice;
+    SerialOutputEngine *m_serialOutput;
+    DeviceHotplugMonitor *m_hotplugMonitor;
+    FrameInterpolator *m_interpolator;
+    bool m_isLastWriteOk;
 
     QByteArray m_writeBufferHeader;
     QByteArray m_writeBuffer;
@@ -66,4 +83,5 @@ private:
 
     QList<QRgb> m_colorsSaved;
     QList<StructRgb> m_colorsBuffer;
+    TemporalDither m_dither;
 };
@@ -0,0 +1,187 @@
+/*
+ * LedDeviceE131.cpp
+ *
+ *  Created on: 19.10.2026
+ *     Project: Lightpack
+ *
+ *  Lightpack is very simple implementation of the backlight for a laptop
+ *
+ *  Copyright (c) 2011 Mike Shatohin, mikeshatohin [at] gmail.com
+ *
+ *  Lightpack is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Lightpack is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "LedDeviceE131.hpp"
+#include "LightpackMath.hpp"
+#include "SharedFrame.hpp"
+#include "Settings.hpp"
+#include "enums.hpp"
+#include "debug.h"
+
+using namespace SettingsScope;
+
+LedDeviceE131::LedDeviceE131(QObject * parent) : ILedDevice(parent)
+{
+    DEBUG_LOW_LEVEL << Q_FUNC_INFO;
+
+    m_gamma = Settings::getDeviceGamma();
+    m_brightness = Settings::getDeviceBrightness();
+
+    DEBUG_LOW_LEVEL << Q_FUNC_INFO << "initialized";
+}
+
+LedDeviceE131::~LedDeviceE131()
+{
+    m_dmxSender.close();
+}
+
+void LedDeviceE131::setColors(const QList<QRgb> & colors)
+{
+    // Save colors for showing changes of the brightness
+    m_colorsSaved = colors;
+
+    resizeColorsBuffer(colors.count());
+
+    LightpackMath::gammaCorrection(m_gamma, colors, m_colorsBuffer);
+    LightpackMath::brightnessCorrection(m_brightness, m_colorsBuffer);
+
+    SharedFramePublisher::instance()->publish(m_colorsBuffer);
+
+    char *data = m_writeBuffer.data();
+
+    for (int i = 0; i < m_colorsBuffer.count(); i++)
+    {
+        *data++ = m_colorsBuffer[i].r;
+        *data++ = m_colorsBuffer[i].g;
+        *data++ = m_colorsBuffer[i].b;
+    }
+
+    bool ok = m_dmxSender.isOpen();
+
+    if (ok && m_writeBuffer.isEmpty() == false)
+        ok = m_dmxSender.sendFrame(m_writeBuffer.constData(), m_writeBuffer.size());
+
+    emit commandCompleted(ok);
+}
+
+void LedDeviceE131::switchOffLeds()
+{
+    int count = m_colorsSaved.count();
+    m_colorsSaved.clear();
+
+    for (int i = 0; i < count; i++)
+        m_colorsSaved << 0;
+
+    setColors(m_colorsSaved);
+}
+
+void LedDeviceE131::setRefreshDelay(int /*value*/)
+{
+    emit commandCompleted(true);
+}
+
+void LedDeviceE131::setColorDepth(int /*value*/)
+{
+    emit commandCompleted(true);
+}
+
+void LedDeviceE131::setSmoothSlowdown(int /*value*/)
+{
+    emit commandCompleted(true);
+}
+
+void LedDeviceE131::setGamma(double value)
+{
+    DEBUG_LOW_LEVEL << Q_FUNC_INFO << value;
+
+    m_gamma = value;
+    setColors(m_colorsSaved);
+}
+
+void LedDeviceE131::setBrightness(int percent)
+{
+    DEBUG_LOW_LEVEL << Q_FUNC_INFO << percent;
+
+    m_brightness = percent;
+    setColors(m_colorsSaved);
+}
+
+void LedDeviceE131::setColorSequence(QString /*value*/)
+{
+    // Color order is configured on the node
+    emit commandCompleted(true);
+}
+
+void LedDeviceE131::requestFirmwareVersion()
+{
+    emit firmwareVersion("unknown (E1.31 / Art-Net device)");
+    emit commandCompleted(true);
+}
+
+void LedDeviceE131::updateDeviceSettings()
+{
+    DEBUG_LOW_LEVEL << Q_FUNC_INFO;
+
+    setGamma(Settings::getDeviceGamma());
+    setBrightness(Settings::getDeviceBrightness());
+}
+
+void LedDeviceE131::open()
+{
+    DEBUG_LOW_LEVEL << Q_FUNC_INFO;
+
+    m_gamma = Settings::getDeviceGamma();
+    m_brightness = Settings::getDeviceBrightness();
+
+    QString protocol = Settings::getE131Protocol();
+
+    m_dmxSender.setUniverse(Settings::getE131Universe(), Settings::getE131StartAddress());
+    m_dmxSender.setSyncEnabled(Settings::isE131SyncEnabled(), Settings::getE131SyncUniverse());
+
+    bool ok = m_dmxSender.open(protocol == Main::E131::ProtocolArtNet ? DmxNetworkSender::ProtocolArtNet : DmxNetworkSender::ProtocolE131,
+                               Settings::getE131Host());
+
+    if (ok)
+    {
+        DEBUG_LOW_LEVEL << Q_FUNC_INFO << protocol << "target" << Settings::getE131Host()
+                        << "universe" << Settings::getE131Universe() << "address" << Settings::getE131StartAddress();
+    } else {
+        qWarning() << Q_FUNC_INFO << protocol << "target" << Settings::getE131Host() << "open fail";
+    }
+
+    emit openDeviceSuccess(ok);
+}
+
+void LedDeviceE131::resizeColorsBuffer(int buffSize)
+{
+    if (m_colorsBuffer.count() == buffSize)
+        return;
+
+    m_colorsBuffer.clear();
+
+    if (buffSize > MaximumNumberOfLeds::E131)
+    {
+        qCritical() << Q_FUNC_INFO << "buffSize > MaximumNumberOfLeds::E131" << buffSize << ">" << MaximumNumberOfLeds::E131;
+
+        buffSize = MaximumNumberOfLeds::E131;
+    }
+
+    for (int i = 0; i < buffSize; i++)
+    {
+        m_colorsBuffer << StructRgb();
+    }
+
+    m_writeBuffer.fill(0, buffSize * 3);
+}
@@ -25,18 +25,35 @@
  */
 
 #include "LedDeviceLightpack.hpp"
-#include "LightpackApplication.hpp"
+#include "SharedFrame.hpp"
 
 #include <unistd.h>
 
 #include <QtDebug>
 #include "debug.h"
 #include "Settings.hpp"
+#include "LightpackFirmware.hpp"
 
 using namespace SettingsScope;
 
 const int LedDeviceLightpack::PingDeviceInterval = 1000;
+// Device node may be not accessible yet when hotplug event comes
+const int LedDeviceLightpack::ReopenDeviceInterval = 500;
+const int LedDeviceLightpack::ReopenDeviceAttemptsCount = 10;
 const int LedDeviceLightpack::MaximumLedsCount = MaximumNumberOfLeds::Lightpack6;
+const int LedDeviceLightpack::WriteBufferSize = 65;
+// Full frame is sent at least once a FullUpdateInterval ms in case device lost partial update
+const int LedDeviceLightpack::FullUpdateInterval = 1000;
+// Feedback is requested once a FeedbackInterval ms, firmware sends IN report on request
+const int LedDeviceLightpack::FeedbackInterval = 1000;
+// Waiting for the report of firmware version, the only blocking read
+const int LedDeviceLightpack::FeedbackReadTimeout = 20;
+// Report of the feedback is polled without blocking the device thread
+const int LedDeviceLightpack::FeedbackPollInterval = 1;
+const int LedDeviceLightpack::FeedbackPollsCount = 20;
+const int LedDeviceLightpack::FramesSentCount = 256;
+// Smooth options are re-sent when device step changes more than this, in percents
+const int LedDeviceLightpack::SmoothStepTolerance = 5;
 
 LedDeviceLightpack::LedDeviceLightpack(QObject *parent) :
     ILedDevice(parent)
@@ -45,6 +62,26 @@ LedDeviceLightpack::LedDeviceLightpack(QObject *parent) :
     DEBUG_LOW_LEVEL << Q_FUNC_INFO << "thread id: " << this->thread()->currentThreadId();
 
     m_hidDevice = NULL;
+    m_writeQueueDepth = 0;
+    m_isWaitingWriteSlot = false;
+    m_reopenAttemptsCount = 0;
+    m_isBrightnessInFirmware = false;
+    m_isPartialUpdateSupported = false;
+    m_isSmoothOptionsSupported = false;
+    m_isFeedbackSupported = false;
+    m_smoothSlowdown = 0;
+    m_smoothStepUs = 0;
+    m_frameId = 0;
+    m_droppedFramesCount = 0;
+    m_isrOverrunsCount = 0;
+    m_lastFeedbackTime = 0;
+    m_lastFeedbackTick = 0;
+    m_feedbackRequestTime = 0;
+    m_feedbackPollsCount = 0;
+
+    m_framesSentId.fill(0, FramesSentCount);
+    m_framesSentTime.fill(0, FramesSentCount);
+    m_feedbackClock.start();
 
     memset(m_writeBuffer, 0, sizeof(m_writeBuffer));
     memset(m_readBuffer, 0, sizeof(m_readBuffer));
@@ -55,6 +92,27 @@ LedDeviceLightpack::LedDeviceLightpack(QObject *parent) :
     connect(this, SIGNAL(ioDeviceSuccess(bool)), this, SLOT(restartPingDevice(bool)));
     connect(this, SIGNAL(openDeviceSuccess(bool)), this, SLOT(restartPingDevice(bool)));
 
+    // Device reports which frame it shows, it is read from time to time
+    m_timerFeedback = new QTimer(this);
+    connect(m_timerFeedback, SIGNAL(timeout()), this, SLOT(timerFeedbackTimeout()));
+
+    m_timerFeedbackPoll = new QTimer(this);
+    m_timerFeedbackPoll->setSingleShot(true);
+    m_timerFeedbackPoll->setInterval(FeedbackPollInterval);
+    connect(m_timerFeedbackPoll, SIGNAL(timeout()), this, SLOT(pollFeedback()));
+
+    // Opening after hotplug event is repeated a few times if it fails
+    m_timerReopenDevice = new QTimer(this);
+    m_timerReopenDevice->setSingleShot(true);
+    m_timerReopenDevice->setInterval(ReopenDeviceInterval);
+    connect(m_timerReopenDevice, SIGNAL(timeout()), this, SLOT(reopenPluggedDevice()));
+
+    // When hotplug events are available device isn't pinged and reopened on each frame
+    m_hotplugMonitor = new DeviceHotplugMonitor(this);
+
+    connect(m_hotplugMonitor, SIGNAL(hidDeviceAdded(int,int)), this, SLOT(hidDeviceAdded(int,int)));
+    connect(m_hotplugMonitor, SIGNAL(hidDeviceRemoved(int,int)), this, SLOT(hidDeviceRemoved(int,int)));
+
     DEBUG_LOW_LEVEL << Q_FUNC_INFO << "initialized";
 }
 
@@ -77,7 +135,7 @@ void LedDeviceLightpack::setColors(const QList<QRgb> & colors)
         return;
     }
 
-    QMutexLocker locker(&getLightpackApp()->m_mutex);
+    QMutexLocker locker(ILedDevice::colorsMutex());
 
     resizeColorsBuffer(colors.count());
 
@@ -85,31 +143,33 @@ void LedDeviceLightpack::setColors(const QList<QRgb> & colors)
     m_colorsSaved = colors;
 
     LightpackMath::gammaCorrection(m_gamma, colors, m_colorsBuffer, 4096 /* 12-bit result */);
-    LightpackMath::brightnessCorrection(m_brightness, m_colorsBuffer);
+    if (m_isBrightnessInFirmware == false)
+        LightpackMath::brightnessCorrection(m_brightness, m_colorsBuffer);
 
-    // First write_buffer[0] == 0x00 - ReportID, i have problems with using it
-    // Second byte of usb buffer is command (write_buffer[1] == CMD_UPDATE_LEDS, see below)
-    int buffIndex = WRITE_BUFFER_INDEX_DATA_START;
+    publishColors();
 
-    for (int i = 0; i < m_colorsBuffer.count(); i++)
-    {
-        StructRgb color = m_colorsBuffer[i];
+    int command = CMD_UPDATE_LEDS;
+    int reportSize = fillColorsReport(&command);
 
-        // Send main 8 bits for compability with existing devices
-        m_writeBuffer[buffIndex++] = (color.r & 0x0FF0) >> 4;
-        m_writeBuffer[buffIndex++] = (color.g & 0x0FF0) >> 4;
-        m_writeBuffer[buffIndex++] = (color.b & 0x0FF0) >> 4;
+    locker.unlock();
 
-        // Send over 4 bits for devices revision >= 6
-        // All existing devices ignore it
-        m_writeBuffer[buffIndex++] = (color.r & 0x000F);
-        m_writeBuffer[buffIndex++] = (color.g & 0x000F);
-        m_writeBuffer[buffIndex++] = (color.b & 0x000F);
+    if (reportSize == 0)
+    {
+        // Device already shows these colors
+        emit commandCompleted(true);
+        return;
     }
 
-    locker.unlock();
+    // Next frame is prepared while this one is on the bus,
+    // commandCompleted() is emitted when the queue has a free slot
+    if (m_writeQueueDepth > 0 && m_hidDevice != NULL && writeColorsAsync(command, reportSize))
+        return;
+
+    // Queue is full or broken, blocking write completes the command waiting
+    // for a slot, asyncWriteCompleted() shouldn't complete it once more
+    m_isWaitingWriteSlot = false;
 
-    bool ok = writeBufferToDeviceWithCheck(CMD_UPDATE_LEDS);
+    bool ok = writeBufferToDeviceWithCheck(command, reportSize);
 
     // WARNING: LedDeviceManager sends data only when the arrival of this signal
     emit commandCompleted(ok);
@@ -159,6 +219,15 @@ void LedDeviceLightpack::setSmoothSlowdown(int value)
 {
     DEBUG_LOW_LEVEL << Q_FUNC_INFO << value;
 
+    m_smoothSlowdown = value;
+
+    if (m_isSmoothOptionsSupported)
+    {
+        bool ok = writeSmoothOptions();
+        emit commandCompleted(ok);
+        return;
+    }
+
     m_writeBuffer[WRITE_BUFFER_INDEX_DATA_START] = (unsigned char)value;
 
     bool ok = writeBufferToDeviceWithCheck(CMD_SET_SMOOTH_SLOWDOWN);
@@ -188,6 +257,24 @@ void LedDeviceLightpack::setBrightness(int percent)
 
     m_brightness = percent;
 
+    if (m_isBrightnessInFirmware)
+    {
+        // One small report instead of re-sending the frame
+        m_writeBuffer[WRITE_BUFFER_INDEX_DATA_START] = (unsigned char)qBound(0, percent, 100);
+
+        bool ok = writeBufferToDeviceWithCheck(CMD_SET_BRIGHTNESS);
+
+        // Colors of the LEDs are changed without a new frame
+        if (ok)
+        {
+            QMutexLocker locker(ILedDevice::colorsMutex());
+            publishColors();
+        }
+
+        emit commandCompleted(ok);
+        return;
+    }
+
     if (Settings::isBacklightEnabled())
         setColors(m_colorsSaved);
     else
@@ -208,11 +295,46 @@ void LedDeviceLightpack::requestFirmwareVersion()
         int fw_major = m_readBuffer[INDEX_FW_VER_MAJOR];
         int fw_minor = m_readBuffer[INDEX_FW_VER_MINOR];
         fwVersion = QString::number(fw_major) + "." + QString::number(fw_minor);
+
+        int revision = LightpackFirmware::revision(fw_major, fw_minor);
+
+        m_isBrightnessInFirmware = (revision >= LightpackFirmware::RevisionBrightness);
+        m_isPartialUpdateSupported = (revision >= LightpackFirmware::RevisionPartialUpdate);
+        m_isSmoothOptionsSupported = (revision >= LightpackFirmware::RevisionSmoothOptions);
+        m_isFeedbackSupported = (revision >= LightpackFirmware::RevisionFeedback);
+
+        // Firmware with feedback reports its step, it includes time of the timer ISR
+        m_smoothStepUs = 0;
+
+        if (m_isFeedbackSupported)
+            m_smoothStepUs = m_readBuffer[INDEX_TICK_US] | (m_readBuffer[INDEX_TICK_US + 1] << 8);
+
+        if (m_smoothStepUs == 0)
+            m_smoothStepUs = estimatedSmoothStepUs(fw_major);
     } else {
         fwVersion = QApplication::tr("read device fail");
+
+        m_isBrightnessInFirmware = false;
+        m_isPartialUpdateSupported = false;
+        m_isSmoothOptionsSupported = false;
+        m_isFeedbackSupported = false;
     }
 
-    DEBUG_LOW_LEVEL << Q_FUNC_INFO << "Version:" << fwVersion;
+    DEBUG_LOW_LEVEL << Q_FUNC_INFO << "Version:" << fwVersion << "brightness in firmware:" << m_isBrightnessInFirmware
+                    << "partial update:" << m_isPartialUpdateSupported << "smooth options:" << m_isSmoothOptionsSupported
+                    << "feedback:" << m_isFeedbackSupported;
+
+    if (m_isFeedbackSupported)
+    {
+        // Counters of the device start from zero, don't warn about them
+        m_droppedFramesCount = -1;
+        m_isrOverrunsCount = -1;
+        m_lastFeedbackTime = 0;
+        m_timerFeedback->start(FeedbackInterval);
+    } else {
+        m_timerFeedback->stop();
+        m_timerFeedbackPoll->stop();
+    }
 
     emit firmwareVersion(fwVersion);
     emit commandCompleted(ok);
@@ -222,13 +344,14 @@ void LedDeviceLightpack::updateDeviceSettings()
 {
     DEBUG_LOW_LEVEL << Q_FUNC_INFO;
 
+    // Version is read first, it tells how brightness is applied
+    requestFirmwareVersion();
+
     setRefreshDelay(Settings::getDeviceRefreshDelay());
     setColorDepth(Settings::getDeviceColorDepth());
     setSmoothSlowdown(Settings::getDeviceSmooth());
     setGamma(Settings::getDeviceGamma());
     setBrightness(Settings::getDeviceBrightness());
-
-    requestFirmwareVersion();
 }
 
 
@@ -257,6 +380,18 @@ void LedDeviceLightpack::open()
     // Immediately return from hid_read() if no data available
     hid_set_nonblocking(m_hidDevice, 1);
 
+    // Colors of the device are unknown, next frame is sent in full
+    m_colorsSent.clear();
+
+    m_writeQueueDepth = 0;
+#ifdef HID_API_ASYNC_WRITE
+    int depth = Settings::getLightpackWriteQueueDepth();
+    if (depth > 0 && hid_set_write_depth(m_hidDevice, depth) == 0)
+        m_writeQueueDepth = depth;
+
+    DEBUG_LOW_LEVEL << Q_FUNC_INFO << "Write queue depth:" << m_writeQueueDepth;
+#endif
+
     DEBUG_LOW_LEVEL << Q_FUNC_INFO << "Lightpack opened";
 
     updateDeviceSettings();
@@ -268,7 +403,14 @@ bool LedDeviceLightpack::readDataFromDevice()
 {
     DEBUG_LOW_LEVEL << Q_FUNC_INFO;
 
-    int bytes_read = hid_read(m_hidDevice, m_readBuffer, sizeof(m_readBuffer));
+    // Firmware with feedback sends IN report when it is requested, older ones
+    // send it each ms and ignore the command. Queued reports are dropped
+    while (hid_read(m_hidDevice, m_readBuffer, sizeof(m_readBuffer)) > 0) { }
+
+    if (writeBufferToDevice(CMD_REQUEST_FEEDBACK) == false)
+        return false;
+
+    int bytes_read = hid_read_timeout(m_hidDevice, m_readBuffer, sizeof(m_readBuffer), FeedbackReadTimeout);
 
     if(bytes_read < 0){
         qWarning() << "Error reading data:" << bytes_read;
@@ -279,7 +421,7 @@ bool LedDeviceLightpack::readDataFromDevice()
     return true;
 }
 
-bool LedDeviceLightpack::writeBufferToDevice(int command)
+bool LedDeviceLightpack::writeBufferToDevice(int command, int size)
 {    
     DEBUG_MID_LEVEL << Q_FUNC_INFO << command;
 #if 0
@@ -289,11 +431,11 @@ bool LedDeviceLightpack::writeBufferToDevice(int command)
     m_writeBuffer[WRITE_BUFFER_INDEX_REPORT_ID] = 0x00;
     m_writeBuffer[WRITE_BUFFER_INDEX_COMMAND] = command;
 
-    int error = hid_write(m_hidDevice, m_writeBuffer, sizeof(m_writeBuffer));
+    int error = hid_write(m_hidDevice, m_writeBuffer, size);
     if (error < 0)
     {
         // Trying to repeat sending data:
-        error = hid_write(m_hidDevice, m_writeBuffer, sizeof(m_writeBuffer));
+        error = hid_write(m_hidDevice, m_writeBuffer, size);
         if(error < 0){
             qWarning() << "Error writing data:" << error;
             emit ioDeviceSuccess(false);
@@ -306,6 +448,13 @@ bool LedDeviceLightpack::writeBufferToDevice(int command)
 
 bool LedDeviceLightpack::tryToReopenDevice()
 {
+    if (m_hidDevice == NULL && m_hotplugMonitor->isAvailable())
+    {
+        // Device is unplugged, it will be opened in hidDeviceAdded(),
+        // failed open after the event is repeated by m_timerReopenDevice
+        return false;
+    }
+
     open();
 
     if (m_hidDevice == NULL)
@@ -339,18 +488,18 @@ bool LedDeviceLightpack::readDataFromDeviceWithCheck()
     }
 }
 
-bool LedDeviceLightpack::writeBufferToDeviceWithCheck(int command)
+bool LedDeviceLightpack::writeBufferToDeviceWithCheck(int command, int size)
 {
     DEBUG_MID_LEVEL << Q_FUNC_INFO;
 
     if (m_hidDevice != NULL)
     {
-        if (!writeBufferToDevice(command))
+        if (!writeBufferToDevice(command, size))
         {
-            if (!writeBufferToDevice(command))
+            if (!writeBufferToDevice(command, size))
             {
                 if (tryToReopenDevice())
-                    return writeBufferToDevice(command);
+                    return writeBufferToDevice(command, size);
                 else
                     return false;
             }
@@ -358,12 +507,145 @@ bool LedDeviceLightpack::writeBufferToDeviceWithCheck(int command)
         return true;
     } else {
         if (tryToReopenDevice())
-            return writeBufferToDevice(command);
+            return writeBufferToDevice(command, size);
         else
             return false;
     }
 }
 
+// Step of the smooth change of the firmware: a timer compare on hw6, a PWM period on hw4 and hw5
+int LedDeviceLightpack::estimatedSmoothStepUs(int major)
+{
+    static const int TimerTicksPerUs = 16;
+    static const int PwmOffTicks = 50 * 256;
+
+    if (major == 4 || major == 5)
+        return (Settings::getDeviceColorDepth() * Settings::getDeviceRefreshDelay() + PwmOffTicks) / TimerTicksPerUs;
+
+    return 0x10000 / TimerTicksPerUs;
+}
+
+int LedDeviceLightpack::smoothCurve(const QString & curve)
+{
+    if (curve == "ease-out")
+        return SMOOTH_CURVE_EASE_OUT;
+    else if (curve == "exponential")
+        return SMOOTH_CURVE_EXPONENTIAL;
+
+    return SMOOTH_CURVE_LINEAR;
+}
+
+bool LedDeviceLightpack::writeSmoothOptions()
+{
+    // Old firmwares made smooth slowdown steps, so the same time keeps fade of existing profiles.
+    // Firmware evaluates number of steps from the time, zero time disables smoothing
+    int timeMs = qMin(m_smoothSlowdown * m_smoothStepUs / 1000, 0xffff);
+
+    if (m_smoothSlowdown > 0 && timeMs == 0)
+        timeMs = 1;
+
+    DEBUG_LOW_LEVEL << Q_FUNC_INFO << "steps:" << m_smoothSlowdown << "step us:" << m_smoothStepUs << "time ms:" << timeMs;
+
+    m_writeBuffer[WRITE_BUFFER_INDEX_DATA_START] = smoothCurve(Settings::getLightpackSmoothCurve());
+    m_writeBuffer[WRITE_BUFFER_INDEX_DATA_START+1] = timeMs & 0xff;
+    m_writeBuffer[WRITE_BUFFER_INDEX_DATA_START+2] = (timeMs >> 8) & 0xff;
+
+    return writeBufferToDeviceWithCheck(CMD_SET_SMOOTH_OPTIONS);
+}
+
+void LedDeviceLightpack::writeLedColor(int *buffIndex, const StructRgb & color)
+{
+    // Send main 8 bits for compability with existing devices
+    m_writeBuffer[(*buffIndex)++] = (color.r & 0x0FF0) >> 4;
+    m_writeBuffer[(*buffIndex)++] = (color.g & 0x0FF0) >> 4;
+    m_writeBuffer[(*buffIndex)++] = (color.b & 0x0FF0) >> 4;
+
+    // Send over 4 bits for devices revision >= 6
+    // All existing devices ignore it
+    m_writeBuffer[(*buffIndex)++] = (color.r & 0x000F);
+    m_writeBuffer[(*buffIndex)++] = (color.g & 0x000F);
+    m_writeBuffer[(*buffIndex)++] = (color.b & 0x000F);
+}
+
+int LedDeviceLightpack::fillColorsReport(int *command)
+{
+    // First write_buffer[0] == 0x00 - ReportID, i have problems with using it
+    // Second byte of usb buffer is command (write_buffer[1] == CMD_UPDATE_LEDS, see writeBufferToDevice())
+    int buffIndex = WRITE_BUFFER_INDEX_DATA_START;
+
+    bool isFullUpdate = (m_isPartialUpdateSupported == false
+                         || m_colorsSent.count() != m_colorsBuffer.count()
+                         || m_fullUpdateTime.hasExpired(FullUpdateInterval));
+
+    quint16 changedMask = 0;
+    int changedCount = 0;
+
+    if (isFullUpdate == false)
+    {
+        for (int i = 0; i < m_colorsBuffer.count(); i++)
+        {
+            const StructRgb & color = m_colorsBuffer[i];
+            const StructRgb & sent = m_colorsSent[i];
+
+            if (color.r != sent.r || color.g != sent.g || color.b != sent.b)
+            {
+                changedMask |= (1 << i);
+                changedCount++;
+            }
+        }
+
+        if (changedCount == 0)
+            return 0;
+
+        // Partial report of all LEDs is bigger than the full one
+        if (changedCount == m_colorsBuffer.count())
+            isFullUpdate = true;
+    }
+
+    m_colorsSent = m_colorsBuffer;
+
+    if (m_isFeedbackSupported)
+    {
+        // Id 0 is for frames without id
+        if (++m_frameId == 0)
+            m_frameId = 1;
+
+        // Buffer has report id before the command, device indexes start from the command
+        m_writeBuffer[WRITE_BUFFER_INDEX_COMMAND + INDEX_FRAME_ID] = m_frameId & 0xff;
+        m_writeBuffer[WRITE_BUFFER_INDEX_COMMAND + INDEX_FRAME_ID + 1] = (m_frameId >> 8) & 0xff;
+
+        m_framesSentId[m_frameId % FramesSentCount] = m_frameId;
+        m_framesSentTime[m_frameId % FramesSentCount] = m_feedbackClock.nsecsElapsed();
+    }
+
+    if (isFullUpdate)
+    {
+        for (int i = 0; i < m_colorsBuffer.count(); i++)
+            writeLedColor(&buffIndex, m_colorsBuffer[i]);
+
+        m_fullUpdateTime.restart();
+
+        *command = CMD_UPDATE_LEDS;
+        return WriteBufferSize;
+    }
+
+    m_writeBuffer[buffIndex++] = changedMask & 0xff;
+    m_writeBuffer[buffIndex++] = (changedMask >> 8) & 0xff;
+
+    for (int i = 0; i < m_colorsBuffer.count(); i++)
+    {
+        if (changedMask & (1 << i))
+            writeLedColor(&buffIndex, m_colorsBuffer[i]);
+    }
+
+    DEBUG_MID_LEVEL << Q_FUNC_INFO << "changed leds:" << changedCount;
+
+    // Report is cut after the last changed LED, unused bytes aren't sent.
+    // Frame id is at the end of the report
+    *command = CMD_UPDATE_LEDS_PARTIAL;
+    return m_isFeedbackSupported ? WriteBufferSize : buffIndex;
+}
+
 void LedDeviceLightpack::resizeColorsBuffer(int buffSize)
 {
     if (m_colorsBuffer.count() == buffSize)
@@ -384,19 +666,114 @@ void LedDeviceLightpack::resizeColorsBuffer(int buffSize)
     }
 }
 
+void LedDeviceLightpack::publishColors()
+{
+    if (m_isBrightnessInFirmware == false)
+    {
+        SharedFramePublisher::instance()->publish(m_colorsBuffer, 12);
+        return;
+    }
+
+    // Readers get the colors which LEDs show, so brightness applied
+    // by the firmware is applied to the published copy too
+    QList<StructRgb> colors = m_colorsBuffer;
+    LightpackMath::brightnessCorrection(m_brightness, colors);
+
+    SharedFramePublisher::instance()->publish(colors, 12);
+}
+
 void LedDeviceLightpack::closeDevice()
 {
     DEBUG_MID_LEVEL << Q_FUNC_INFO;
 
+    m_timerFeedback->stop();
+    m_timerFeedbackPoll->stop();
+
+    // hid_close() cancels and frees writes in flight, their callbacks are
+    // called before it returns and carry the generation of the closed device
     hid_close(m_hidDevice);
     m_hidDevice = NULL;
+    m_deviceGeneration.ref();
+
+    if (m_isWaitingWriteSlot)
+    {
+        // Slot of the closed device will never be freed
+        m_isWaitingWriteSlot = false;
+        emit commandCompleted(false);
+    }
+}
+
+bool LedDeviceLightpack::writeColorsAsync(int command, int size)
+{
+#ifdef HID_API_ASYNC_WRITE
+    m_writeBuffer[WRITE_BUFFER_INDEX_REPORT_ID] = 0x00;
+    m_writeBuffer[WRITE_BUFFER_INDEX_COMMAND] = command;
+
+    int bytes = hid_write_async(m_hidDevice, m_writeBuffer, size, asyncWriteCallback, this);
+    if (bytes <= 0)
+    {
+        DEBUG_MID_LEVEL << Q_FUNC_INFO << "hid_write_async fail:" << bytes;
+        return false;
+    }
+
+    if (hid_write_async_in_flight(m_hidDevice) < m_writeQueueDepth)
+        emit commandCompleted(true);
+    else
+        m_isWaitingWriteSlot = true;
+
+    return true;
+#else
+    Q_UNUSED(command);
+    Q_UNUSED(size);
+    return false;
+#endif
+}
+
+void LedDeviceLightpack::asyncWriteCallback(hid_device * /*device*/, void *userData, int result)
+{
+    LedDeviceLightpack *self = static_cast<LedDeviceLightpack *>(userData);
+
+    QMetaObject::invokeMethod(self, "asyncWriteCompleted", Qt::QueuedConnection,
+                              Q_ARG(bool, result >= 0), Q_ARG(int, (int)self->m_deviceGeneration));
+}
+
+void LedDeviceLightpack::asyncWriteCompleted(bool isSuccess, int deviceGeneration)
+{
+    DEBUG_MID_LEVEL << Q_FUNC_INFO << isSuccess << deviceGeneration;
+
+    if (deviceGeneration != m_deviceGeneration)
+    {
+        // Write to the device which is already closed, closeDevice() has
+        // completed the command waiting for it
+        return;
+    }
+
+    if (isSuccess == false)
+    {
+        qWarning() << Q_FUNC_INFO << "Error writing data";
+        emit ioDeviceSuccess(false);
+
+        // Same as failed blocking write: open() closes the device, which
+        // cancels other writes in flight and completes the waiting command
+        tryToReopenDevice();
+        return;
+    }
+
+    emit ioDeviceSuccess(true);
+
+    if (m_isWaitingWriteSlot)
+    {
+        m_isWaitingWriteSlot = false;
+        emit commandCompleted(true);
+    }
 }
 
 void LedDeviceLightpack::restartPingDevice(bool isSuccess)
 {
     Q_UNUSED(isSuccess);
 
-    if (Settings::isBacklightEnabled() && Settings::isPingDeviceEverySecond())
+    if (Settings::isBacklightEnabled() && Settings::isPingDeviceEverySecond()
+            && m_hotplugMonitor->isAvailable() == false)
     {
         // Start ping device with PingDeviceInterval ms after last data transfer complete
         m_timerPingDevice->start(PingDeviceInterval);
@@ -445,3 +822,138 @@ void LedDeviceLightpack::timerPingDeviceTimeout()
 
     emit ioDeviceSuccess(true);
 }
+
+void LedDeviceLightpack::timerFeedbackTimeout()
+{
+    if (m_hidDevice == NULL || m_isFeedbackSupported == false)
+        return;
+
+    unsigned char report[sizeof(m_readBuffer)];
+
+    // Answer of the previous request could come late, it is dropped
+    while (hid_read(m_hidDevice, report, sizeof(report)) > 0) { }
+
+    if (writeBufferToDevice(CMD_REQUEST_FEEDBACK) == false)
+        return;
+
+    // Firmware takes feedback right after the report is written
+    m_feedbackRequestTime = m_feedbackClock.nsecsElapsed();
+    m_feedbackPollsCount = 0;
+    m_timerFeedbackPoll->start();
+}
+
+void LedDeviceLightpack::pollFeedback()
+{
+    if (m_hidDevice == NULL || m_isFeedbackSupported == false)
+        return;
+
+    unsigned char report[sizeof(m_readBuffer)];
+
+    int bytes = hid_read(m_hidDevice, report, sizeof(report));
+
+    if (bytes > INDEX_ISR_OVERRUNS + 1)
+    {
+        readFeedback(report, m_feedbackRequestTime);
+        return;
+    }
+
+    if (bytes < 0 || ++m_feedbackPollsCount >= FeedbackPollsCount)
+    {
+        DEBUG_MID_LEVEL << Q_FUNC_INFO << "no report:" << bytes;
+        return;
+    }
+
+    m_timerFeedbackPoll->start();
+}
+
+void LedDeviceLightpack::readFeedback(const unsigned char *report, qint64 readTime)
+{
+    quint16 latchedFrameId = report[INDEX_LATCHED_FRAME_ID] | (report[INDEX_LATCHED_FRAME_ID + 1] << 8);
+    quint16 latchedTick = report[INDEX_LATCHED_TICK] | (report[INDEX_LATCHED_TICK + 1] << 8);
+    quint16 tick = report[INDEX_CURRENT_TICK] | (report[INDEX_CURRENT_TICK + 1] << 8);
+    int tickUs = report[INDEX_TICK_US] | (report[INDEX_TICK_US + 1] << 8);
+    int droppedFramesCount = report[INDEX_DROPPED_FRAMES] | (report[INDEX_DROPPED_FRAMES + 1] << 8);
+    int isrOverrunsCount = report[INDEX_ISR_OVERRUNS] | (report[INDEX_ISR_OVERRUNS + 1] << 8);
+
+    // Step changes with timer settings, time of smooth change follows it like on old firmwares
+    if (m_smoothSlowdown > 0 && tickUs > 0 && qAbs(tickUs - m_smoothStepUs) * 100 > m_smoothStepUs * SmoothStepTolerance)
+    {
+        m_smoothStepUs = tickUs;
+        writeSmoothOptions();
+    }
+
+    // Tick duration is measured between polls when possible, it is more precise than reported one.
+    // Ticks are counted in 16 bits, difference is right after overflow too
+    double tickNs = tickUs * 1000.0;
+
+    if (m_lastFeedbackTime > 0 && tick != m_lastFeedbackTick)
+        tickNs = (double)(readTime - m_lastFeedbackTime) / (quint16)(tick - m_lastFeedbackTick);
+
+    m_lastFeedbackTime = readTime;
+    m_lastFeedbackTick = tick;
+
+    int index = latchedFrameId % FramesSentCount;
+
+    if (latchedFrameId != 0 && m_framesSentId[index] == latchedFrameId)
+    {
+        qint64 latchTime = readTime - (qint64)((quint16)(tick - latchedTick) * tickNs);
+        qint64 latencyUs = (latchTime - m_framesSentTime[index]) / 1000;
+
+        DEBUG_MID_LEVEL << Q_FUNC_INFO << "frame" << latchedFrameId << "latency us:" << latencyUs
+                        << "frames behind:" << (quint16)(m_frameId - latchedFrameId);
+    }
+
+    // Device counters grow when it can't keep up with the frames
+    if (m_droppedFramesCount >= 0 && droppedFramesCount != m_droppedFramesCount)
+        DEBUG_LOW_LEVEL << Q_FUNC_INFO << "device dropped frames:" << (quint16)(droppedFramesCount - m_droppedFramesCount);
+
+    if (m_isrOverrunsCount >= 0 && isrOverrunsCount != m_isrOverrunsCount)
+        qWarning() << Q_FUNC_INFO << "device timer overruns:" << (quint16)(isrOverrunsCount - m_isrOverrunsCount);
+
+    m_droppedFramesCount = droppedFramesCount;
+    m_isrOverrunsCount = isrOverrunsCount;
+}
+
+void LedDeviceLightpack::hidDeviceAdded(int vid, int pid)
+{
+    if (vid != USB_VENDOR_ID || pid != USB_PRODUCT_ID)
+        return;
+
+    DEBUG_LOW_LEVEL << Q_FUNC_INFO << "device plugged";
+
+    if (m_hidDevice == NULL)
+    {
+        m_reopenAttemptsCount = 0;
+        reopenPluggedDevice();
+    }
+}
+
+void LedDeviceLightpack::reopenPluggedDevice()
+{
+    if (m_hidDevice != NULL)
+        return;
+
+    open();
+
+    if (m_hidDevice == NULL && ++m_reopenAttemptsCount < ReopenDeviceAttemptsCount)
+    {
+        DEBUG_LOW_LEVEL << Q_FUNC_INFO << "open fail, attempt" << m_reopenAttemptsCount;
+        m_timerReopenDevice->start();
+    }
+}
+
+void LedDeviceLightpack::hidDeviceRemoved(int vid, int pid)
+{
+    if (vid != USB_VENDOR_ID || pid != USB_PRODUCT_ID)
+        return;
+
+    DEBUG_LOW_LEVEL << Q_FUNC_INFO << "device unplugged";
+
+    m_timerReopenDevice->stop();
+
+    if (m_hidDevice != NULL)
+    {
+        closeDevice();
+        emit ioDeviceSuccess(false);
+    }
+}
@@ -30,6 +30,7 @@
 #include "ILedDevice.hpp"
 #include "TimeEvaluations.hpp"
 #include "LightpackMath.hpp"
+#include "DeviceHotplugMonitor.hpp"
 
 #include "../../CommonHeaders/USB_ID.h"     /* For device VID, PID, vendor name and product name */
 #include "hidapi.h" /* USB HID API */
@@ -64,16 +65,35 @@ public slots:
 
 private: 
     bool readDataFromDevice();
-    bool writeBufferToDevice(int command);
+    bool writeBufferToDevice(int command, int size = WriteBufferSize);
     bool tryToReopenDevice();
     bool readDataFromDeviceWithCheck();
-    bool writeBufferToDeviceWithCheck(int command);    
+    bool writeBufferToDeviceWithCheck(int command, int size = WriteBufferSize);
     void resizeColorsBuffer(int buffSize);
+    void publishColors();
     void closeDevice();
+    bool writeColorsAsync(int command, int size);
+    int fillColorsReport(int *command);
+    void writeLedColor(int *buffIndex, const StructRgb & color);
+    bool writeSmoothOptions();
+
+    void readFeedback(const unsigned char *report, qint64 readTime);
+
+    static int smoothCurve(const QString & curve);
+    static int estimatedSmoothStepUs(int major);
+
+    // Called from hidapi thread which handles USB events
+    static void asyncWriteCallback(hid_device *device, void *userData, int result);
 
 private slots:
     void restartPingDevice(bool isSuccess);
     void timerPingDeviceTimeout();
+    void hidDeviceAdded(int vid, int pid);
+    void hidDeviceRemoved(int vid, int pid);
+    void reopenPluggedDevice();
+    void asyncWriteCompleted(bool isSuccess, int deviceGeneration);
+    void timerFeedbackTimeout();
+    void pollFeedback();
 
 private:
     hid_device *m_hidDevice;
@@ -83,12 +103,62 @@ private:
 
     double m_gamma;
     int m_brightness;    
+    // Firmware scales colors, host sends CMD_SET_BRIGHTNESS instead of correcting each frame
+    bool m_isBrightnessInFirmware;
+    // Firmware accepts CMD_UPDATE_LEDS_PARTIAL with changed LEDs only
+    bool m_isPartialUpdateSupported;
+    // Firmware accepts CMD_SET_SMOOTH_OPTIONS with curve and time of smooth change
+    bool m_isSmoothOptionsSupported;
+    // Firmware reports id of the shown frame, its timing and overload counters
+    bool m_isFeedbackSupported;
+    // Profile keeps smooth slowdown as number of steps of old firmwares,
+    // CMD_SET_SMOOTH_OPTIONS gets it as time in ms evaluated with the device step
+    int m_smoothSlowdown;
+    int m_smoothStepUs;
 
     QList<QRgb> m_colorsSaved;
     QList<StructRgb> m_colorsBuffer;
+    // Colors which device has, partial updates are made against them
+    QList<StructRgb> m_colorsSent;
+    QElapsedTimer m_fullUpdateTime;
 
     QTimer *m_timerPingDevice;
+    QTimer *m_timerFeedback;
+    QTimer *m_timerFeedbackPoll;
+    int m_feedbackPollsCount;
+    QTimer *m_timerReopenDevice;
+    int m_reopenAttemptsCount;
+
+    // Frame ids and m_feedbackClock nsecs when frames were sent, index is id % FramesSentCount
+    quint16 m_frameId;
+    QVector<quint16> m_framesSentId;
+    QVector<qint64> m_framesSentTime;
+    QElapsedTimer m_feedbackClock;
+    // m_feedbackClock nsecs when firmware got CMD_REQUEST_FEEDBACK
+    qint64 m_feedbackRequestTime;
+    int m_droppedFramesCount;
+    int m_isrOverrunsCount;
+    // Previous feedback, tick duration is measured between them
+    qint64 m_lastFeedbackTime;
+    quint16 m_lastFeedbackTick;
+    DeviceHotplugMonitor *m_hotplugMonitor;
+
+    int m_writeQueueDepth;
+    bool m_isWaitingWriteSlot;
+    // Incremented when the device is closed, read by asyncWriteCallback()
+    // to tell completions of the closed device from the current one
+    QAtomicInt m_deviceGeneration;
 
     static const int PingDeviceInterval;
+    static const int ReopenDeviceInterval;
+    static const int ReopenDeviceAttemptsCount;
     static const int MaximumLedsCount;
+    static const int WriteBufferSize;
+    static const int FullUpdateInterval;
+    static const int FeedbackInterval;
+    static const int FeedbackReadTimeout;
+    static const int FeedbackPollInterval;
+    static const int FeedbackPollsCount;
+    static const int FramesSentCount;
+    static const int SmoothStepTolerance;
 };
@@ -33,6 +33,9 @@
 #include "LedDeviceAdalight.hpp"
 #include "LedDeviceArdulight.hpp"
 #include "LedDeviceVirtual.hpp"
+#include "LedDeviceUdp.hpp"
+#include "LedDeviceE131.hpp"
+#include "FramePlayer.hpp"
 #include "Settings.hpp"
 
 using namespace SettingsScope;
@@ -48,6 +51,11 @@ LedDeviceManager::LedDeviceManager(QObject *parent)
 
     m_isColorsSaved = false;
 
+    // Player is moved to the manager thread together with the manager
+    m_framePlayer = new FramePlayer(this);
+    connect(m_framePlayer, SIGNAL(frameReady(QList<QRgb>)), this, SLOT(replayFrame(QList<QRgb>)));
+    connect(m_framePlayer, SIGNAL(finished()), this, SLOT(stopReplay()));
+
     for (int i = 0; i < SupportedDevices::DeviceTypesCount; i++)
         m_ledDevices.append(NULL);
 
@@ -70,7 +78,7 @@ void LedDeviceManager::switchOnLeds()
 
     m_backlightStatus = Backlight::StatusOn;
     if (m_isColorsSaved)
-        emit ledDeviceSetColors(m_savedColors);
+        processSetColors(m_savedColors);
 }
 
 void LedDeviceManager::setColors(const QList<QRgb> & colors)
@@ -78,6 +86,21 @@ void LedDeviceManager::setColors(const QList<QRgb> & colors)
     DEBUG_MID_LEVEL << Q_FUNC_INFO << "Is last command completed:" << m_isLastCommandCompleted
                     << " m_backlightStatus = " << m_backlightStatus;
 
+    if (m_framePlayer->isPlaying())
+        return;
+
+    queueSetColors(colors);
+}
+
+void LedDeviceManager::replayFrame(const QList<QRgb> & colors)
+{
+    DEBUG_MID_LEVEL << Q_FUNC_INFO << "Is last command completed:" << m_isLastCommandCompleted;
+
+    queueSetColors(colors);
+}
+
+void LedDeviceManager::queueSetColors(const QList<QRgb> & colors)
+{
     if (m_backlightStatus == Backlight::StatusOn)
     {
         m_savedColors = colors;
@@ -85,13 +108,51 @@ void LedDeviceManager::setColors(const QList<QRgb> & colors)
         if (m_isLastCommandCompleted)
         {
             m_isLastCommandCompleted = false;
-            emit ledDeviceSetColors(colors);
+            processSetColors(colors);
         } else {
             cmdQueueAppend(LedDeviceCommands::SetColors);
         }
     }
 }
 
+void LedDeviceManager::processSetColors(const QList<QRgb> & colors)
+{
+    // Device works in its own thread, recording costs it nothing
+    if (m_frameRecorder.isOpen())
+        m_frameRecorder.append(colors);
+
+    emit ledDeviceSetColors(colors);
+}
+
+void LedDeviceManager::startRecording(const QString & fileName)
+{
+    DEBUG_LOW_LEVEL << Q_FUNC_INFO << fileName;
+
+    m_frameRecorder.open(fileName);
+}
+
+void LedDeviceManager::stopRecording()
+{
+    DEBUG_LOW_LEVEL << Q_FUNC_INFO;
+
+    m_frameRecorder.close();
+}
+
+void LedDeviceManager::startReplay(const QString & fileName, double speed)
+{
+    DEBUG_LOW_LEVEL << Q_FUNC_INFO << fileName << speed;
+
+    if (m_framePlayer->open(fileName))
+        m_framePlayer->start(speed);
+}
+
+void LedDeviceManager::stopReplay()
+{
+    DEBUG_LOW_LEVEL << Q_FUNC_INFO;
+
+    m_framePlayer->close();
+}
+
 void LedDeviceManager::switchOffLeds()
 {
     DEBUG_MID_LEVEL << Q_FUNC_INFO << "Is last command completed:" << m_isLastCommandCompleted;
@@ -309,6 +370,14 @@ ILedDevice * LedDeviceManager::createLedDevice(SupportedDevices::DeviceType devi
         DEBUG_LOW_LEVEL << Q_FUNC_INFO << "SupportedDevices::ArdulightDevice";
         return (ILedDevice *)new LedDeviceArdulight();
 
+    case SupportedDevices::DeviceTypeUdp:
+        DEBUG_LOW_LEVEL << Q_FUNC_INFO << "SupportedDevices::UdpDevice";
+        return (ILedDevice *)new LedDeviceUdp();
+
+    case SupportedDevices::DeviceTypeE131:
+        DEBUG_LOW_LEVEL << Q_FUNC_INFO << "SupportedDevices::E131Device";
+        return (ILedDevice *)new LedDeviceE131();
+
     case SupportedDevices::DeviceTypeVirtual:
         DEBUG_LOW_LEVEL << Q_FUNC_INFO << "SupportedDevices::VirtualDevice";
         return (ILedDevice *)new LedDeviceVirtual();
@@ -405,7 +474,7 @@ void LedDeviceManager::cmdQueueProcessNext()
             break;
 
         case LedDeviceCommands::SetColors:
-            emit ledDeviceSetColors(m_savedColors);
+            processSetColors(m_savedColors);
             break;
 
         case LedDeviceCommands::SetRefreshDelay:
@@ -28,6 +28,9 @@
 
 #include "enums.hpp"
 #include "ILedDevice.hpp"
+#include "FrameRecorder.hpp"
+
+class FramePlayer;
 
 /*!
     This class creates \a ILedDevice implementations and manages them after.
@@ -75,8 +78,17 @@ public slots:
     void requestFirmwareVersion();
     void updateDeviceSettings();
 
+    // Frames sent to the device are written to the FrameLog file
+    void startRecording(const QString & fileName);
+    void stopRecording();
+
+    // Colors from grab, moodlamp and API are ignored until replay is finished
+    void startReplay(const QString & fileName, double speed);
+    void stopReplay();
+
 private slots:
     void ledDeviceCommandCompleted(bool ok);
+    void replayFrame(const QList<QRgb> & colors);
 
 private:    
     void initLedDevice();
@@ -86,6 +98,8 @@ private:
     void cmdQueueAppend(LedDeviceCommands::Cmd);
     void cmdQueueProcessNext();
     void processOffLeds();
+    void queueSetColors(const QList<QRgb> & colors);
+    void processSetColors(const QList<QRgb> & colors);
 
 private:
     bool m_isLastCommandCompleted;
@@ -102,6 +116,9 @@ private:
     int m_savedBrightness;
     QString m_savedColorSequence;
 
+    FrameRecorder m_frameRecorder;
+    FramePlayer *m_framePlayer;
+
     QList<ILedDevice *> m_ledDevices;
     ILedDevice *m_ledDevice;
     QThread *m_ledDeviceThread;
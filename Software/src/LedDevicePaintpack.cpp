@@ -25,7 +25,7 @@
  */
 
 #include "LedDevicePaintpack.hpp"
-#include "LightpackApplication.hpp"
+#include "SharedFrame.hpp"
 
 #include <unistd.h>
 
@@ -52,11 +52,18 @@ LedDevicePaintpack::LedDevicePaintpack(QObject *parent) : ILedDevice(parent)
 
     m_gamma = Settings::getDeviceGamma();
     m_brightness = Settings::getDeviceBrightness();
+    m_dither.setEnabled(Settings::isTemporalDitheringEnabled());
 
     connect(m_timerPingDevice, SIGNAL(timeout()), this, SLOT(timerPingDeviceTimeout()));
     connect(this, SIGNAL(ioDeviceSuccess(bool)), this, SLOT(restartPingDevice(bool)));
     connect(this, SIGNAL(openDeviceSuccess(bool)), this, SLOT(restartPingDevice(bool)));
 
+    // When hotplug events are available device isn't pinged and reopened on each frame
+    m_hotplugMonitor = new DeviceHotplugMonitor(this);
+
+    connect(m_hotplugMonitor, SIGNAL(hidDeviceAdded(int,int)), this, SLOT(hidDeviceAdded(int,int)));
+    connect(m_hotplugMonitor, SIGNAL(hidDeviceRemoved(int,int)), this, SLOT(hidDeviceRemoved(int,int)));
+
     DEBUG_LOW_LEVEL << Q_FUNC_INFO << "initialized";
 }
 
@@ -75,15 +82,20 @@ void LedDevicePaintpack::setColors(const QList<QRgb> & colors)
         return;
     }
 
-    QMutexLocker locker(&getLightpackApp()->m_mutex);
+    QMutexLocker locker(ILedDevice::colorsMutex());
 
     resizeColorsBuffer(colors.count());
 
     m_colorsSaved = colors;
 
-    LightpackMath::gammaCorrection(m_gamma, colors, m_colorsBuffer);
+    LightpackMath::gammaCorrection(m_gamma, colors, m_colorsBuffer, 4096 /* 12-bit result */);
     LightpackMath::brightnessCorrection(m_brightness, m_colorsBuffer);
 
+    SharedFramePublisher::instance()->publish(m_colorsBuffer, 12);
+
+    // Device takes 8 bits, dropped low bits are carried to next frames
+    m_dither.apply(m_colorsBuffer);
+
     int buffIndex = 3;
 
     for (int i = 0; i < m_colorsBuffer.count(); i++)
@@ -273,6 +285,12 @@ bool LedDevicePaintpack::writeBufferToDevice(int command)
 
 bool LedDevicePaintpack::tryToReopenDevice()
 {
+    if (m_hidDevice == NULL && m_hotplugMonitor->isAvailable())
+    {
+        // Device is unplugged, it will be opened in hidDeviceAdded()
+        return false;
+    }
+
     open();
 
     if (m_hidDevice == NULL)
@@ -363,7 +381,8 @@ void LedDevicePaintpack::restartPingDevice(bool isSuccess)
 {
     Q_UNUSED(isSuccess);
 
-    if (Settings::isBacklightEnabled() && Settings::isPingDeviceEverySecond())
+    if (Settings::isBacklightEnabled() && Settings::isPingDeviceEverySecond()
+            && m_hotplugMonitor->isAvailable() == false)
     {
         m_timerPingDevice->start(PingDeviceInterval);
     } else {
@@ -411,3 +430,28 @@ void LedDevicePaintpack::timerPingDeviceTimeout()
 
     emit ioDeviceSuccess(true);
 }
+
+void LedDevicePaintpack::hidDeviceAdded(int vid, int pid)
+{
+    if (vid != USB_PP_VENDOR_ID || pid != USB_PP_PRODUCT_ID)
+        return;
+
+    DEBUG_LOW_LEVEL << Q_FUNC_INFO << "device plugged";
+
+    if (m_hidDevice == NULL)
+        open();
+}
+
+void LedDevicePaintpack::hidDeviceRemoved(int vid, int pid)
+{
+    if (vid != USB_PP_VENDOR_ID || pid != USB_PP_PRODUCT_ID)
+        return;
+
+    DEBUG_LOW_LEVEL << Q_FUNC_INFO << "device unplugged";
+
+    if (m_hidDevice != NULL)
+    {
+        closeDevice();
+        emit ioDeviceSuccess(false);
+    }
+}
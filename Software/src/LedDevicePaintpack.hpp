@@ -30,6 +30,8 @@
 #include "ILedDevice.hpp"
 #include "TimeEvaluations.hpp"
 #include "LightpackMath.hpp"
+#include "TemporalDither.hpp"
+#include "DeviceHotplugMonitor.hpp"
 
 #include "../../CommonHeaders/USB_ID.h"     /* For device VID, PID, vendor name and product name */
 #include "hidapi.h" /* USB HID API */
@@ -77,6 +79,8 @@ private:
 private slots:
     void restartPingDevice(bool isSuccess);
     void timerPingDeviceTimeout();
+    void hidDeviceAdded(int vid, int pid);
+    void hidDeviceRemoved(int vid, int pid);
 
 private:
     hid_device *m_hidDevice;
@@ -89,8 +93,10 @@ private:
 
     QList<QRgb> m_colorsSaved;
     QList<StructRgb> m_colorsBuffer;
+    TemporalDither m_dither;
 
     QTimer *m_timerPingDevice;
+    DeviceHotplugMonitor *m_hotplugMonitor;
 
     static const int PingDeviceInterval;
     static const int MaximumLedsCount;
@@ -0,0 +1,183 @@
+/*
+ * LedDeviceUdp.cpp
+ *
+ *  Created on: 19.10.2026
+ *     Project: Lightpack
+ *
+ *  Lightpack is very simple implementation of the backlight for a laptop
+ *
+ *  Copyright (c) 2011 Mike Shatohin, mikeshatohin [at] gmail.com
+ *
+ *  Lightpack is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Lightpack is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "LedDeviceUdp.hpp"
+#include "LightpackMath.hpp"
+#include "SharedFrame.hpp"
+#include "Settings.hpp"
+#include "enums.hpp"
+#include "debug.h"
+
+using namespace SettingsScope;
+
+LedDeviceUdp::LedDeviceUdp(QObject * parent) : ILedDevice(parent)
+{
+    DEBUG_LOW_LEVEL << Q_FUNC_INFO;
+
+    m_gamma = Settings::getDeviceGamma();
+    m_brightness = Settings::getDeviceBrightness();
+
+    DEBUG_LOW_LEVEL << Q_FUNC_INFO << "initialized";
+}
+
+LedDeviceUdp::~LedDeviceUdp()
+{
+    m_ddpSender.close();
+}
+
+void LedDeviceUdp::setColors(const QList<QRgb> & colors)
+{
+    // Save colors for showing changes of the brightness
+    m_colorsSaved = colors;
+
+    resizeColorsBuffer(colors.count());
+
+    LightpackMath::gammaCorrection(m_gamma, colors, m_colorsBuffer);
+    LightpackMath::brightnessCorrection(m_brightness, m_colorsBuffer);
+
+    SharedFramePublisher::instance()->publish(m_colorsBuffer);
+
+    char *data = m_writeBuffer.data();
+
+    for (int i = 0; i < m_colorsBuffer.count(); i++)
+    {
+        *data++ = m_colorsBuffer[i].r;
+        *data++ = m_colorsBuffer[i].g;
+        *data++ = m_colorsBuffer[i].b;
+    }
+
+    bool ok = m_ddpSender.isOpen();
+
+    if (ok && m_writeBuffer.isEmpty() == false)
+        ok = m_ddpSender.sendFrame(m_writeBuffer.constData(), m_writeBuffer.size());
+
+    emit commandCompleted(ok);
+}
+
+void LedDeviceUdp::switchOffLeds()
+{
+    int count = m_colorsSaved.count();
+    m_colorsSaved.clear();
+
+    for (int i = 0; i < count; i++)
+        m_colorsSaved << 0;
+
+    setColors(m_colorsSaved);
+}
+
+void LedDeviceUdp::setRefreshDelay(int /*value*/)
+{
+    emit commandCompleted(true);
+}
+
+void LedDeviceUdp::setColorDepth(int /*value*/)
+{
+    emit commandCompleted(true);
+}
+
+void LedDeviceUdp::setSmoothSlowdown(int /*value*/)
+{
+    emit commandCompleted(true);
+}
+
+void LedDeviceUdp::setGamma(double value)
+{
+    DEBUG_LOW_LEVEL << Q_FUNC_INFO << value;
+
+    m_gamma = value;
+    setColors(m_colorsSaved);
+}
+
+void LedDeviceUdp::setBrightness(int percent)
+{
+    DEBUG_LOW_LEVEL << Q_FUNC_INFO << percent;
+
+    m_brightness = percent;
+    setColors(m_colorsSaved);
+}
+
+void LedDeviceUdp::setColorSequence(QString /*value*/)
+{
+    // Color order is configured on the controller
+    emit commandCompleted(true);
+}
+
+void LedDeviceUdp::requestFirmwareVersion()
+{
+    emit firmwareVersion("unknown (DDP device)");
+    emit commandCompleted(true);
+}
+
+void LedDeviceUdp::updateDeviceSettings()
+{
+    DEBUG_LOW_LEVEL << Q_FUNC_INFO;
+
+    setGamma(Settings::getDeviceGamma());
+    setBrightness(Settings::getDeviceBrightness());
+}
+
+void LedDeviceUdp::open()
+{
+    DEBUG_LOW_LEVEL << Q_FUNC_INFO;
+
+    m_gamma = Settings::getDeviceGamma();
+    m_brightness = Settings::getDeviceBrightness();
+
+    m_ddpSender.setMtu(Settings::getUdpMtu());
+
+    bool ok = m_ddpSender.open(Settings::getUdpHost(), Settings::getUdpPort());
+
+    if (ok)
+    {
+        DEBUG_LOW_LEVEL << Q_FUNC_INFO << "DDP target" << Settings::getUdpHost() << Settings::getUdpPort()
+                        << "payload per packet:" << m_ddpSender.payloadSize();
+    } else {
+        qWarning() << Q_FUNC_INFO << "DDP target" << Settings::getUdpHost() << "open fail";
+    }
+
+    emit openDeviceSuccess(ok);
+}
+
+void LedDeviceUdp::resizeColorsBuffer(int buffSize)
+{
+    if (m_colorsBuffer.count() == buffSize)
+        return;
+
+    m_colorsBuffer.clear();
+
+    if (buffSize > MaximumNumberOfLeds::Udp)
+    {
+        qCritical() << Q_FUNC_INFO << "buffSize > MaximumNumberOfLeds::Udp" << buffSize << ">" << MaximumNumberOfLeds::Udp;
+
+        buffSize = MaximumNumberOfLeds::Udp;
+    }
+
+    for (int i = 0; i < buffSize; i++)
+    {
+        m_colorsBuffer << StructRgb();
+    }
+
+    m_writeBuffer.fill(0, buffSize * 3);
+}
@@ -0,0 +1,69 @@
+/*
+ * LedDeviceUdp.hpp
+ *
+ *  Created on: 19.10.2026
+ *     Project: Lightpack
+ *
+ *  Lightpack is very simple implementation of the backlight for a laptop
+ *
+ *  Copyright (c) 2011 Mike Shatohin, mikeshatohin [at] gmail.com
+ *
+ *  Lightpack is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Lightpack is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "ILedDevice.hpp"
+#include "StructRgb.hpp"
+#include "DdpSender.hpp"
+
+/*!
+  Network LED controller (WLED, ESPixelStick, ...) driven over DDP.
+*/
+class LedDeviceUdp : public ILedDevice
+{
+    Q_OBJECT
+public:
+    LedDeviceUdp(QObject * parent = 0);
+    ~LedDeviceUdp();
+
+public slots:
+    void open();
+    void setColors(const QList<QRgb> & /*colors*/);
+    void switchOffLeds();
+    void setRefreshDelay(int /*value*/);
+    void setColorDepth(int /*value*/);
+    void setSmoothSlowdown(int /*value*/);
+    void setGamma(double /*value*/);
+    void setBrightness(int /*value*/);
+    void setColorSequence(QString /*value*/);
+    void requestFirmwareVersion();
+    void updateDeviceSettings();
+
+private:
+    void resizeColorsBuffer(int buffSize);
+
+private:
+    DdpSender m_ddpSender;
+
+    // RGB bytes of the frame, allocated once for the LEDs count
+    QByteArray m_writeBuffer;
+
+    double m_gamma;
+    int m_brightness;
+
+    QList<QRgb> m_colorsSaved;
+    QList<StructRgb> m_colorsBuffer;
+};
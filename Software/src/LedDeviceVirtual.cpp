@@ -26,6 +26,7 @@
 
 #include "LedDeviceVirtual.hpp"
 #include "LightpackMath.hpp"
+#include "SharedFrame.hpp"
 #include "Settings.hpp"
 #include "enums.hpp"
 #include "debug.h"
@@ -38,26 +39,43 @@ LedDeviceVirtual::LedDeviceVirtual(QObject * parent) : ILedDevice(parent)
 
     m_gamma = Settings::getDeviceGamma();
     m_brightness = Settings::getDeviceBrightness();
+
+    m_interpolator = new FrameInterpolator(this);
+    // Smooth slowdown of the profile is tuned for Lightpack firmware,
+    // on host it is applied only when enabled in main config
+    m_interpolator->setSmoothSlowdown(Settings::isHostSmoothingEnabled() ? Settings::getDeviceSmooth() : 0);
+
+    connect(m_interpolator, SIGNAL(frameReady(QList<QRgb>)), this, SLOT(writeColors(QList<QRgb>)));
 }
 
 void LedDeviceVirtual::setColors(const QList<QRgb> & colors)
 {
     m_colorsSaved = colors;
 
-    QList<QRgb> callbackColors;
+    if (m_interpolator->isEnabled())
+        m_interpolator->setTarget(colors);
+    else
+        writeColors(colors);
+
+    emit commandCompleted(true);
+}
 
+void LedDeviceVirtual::writeColors(const QList<QRgb> & colors)
+{
     resizeColorsBuffer(colors.count());
 
     LightpackMath::gammaCorrection(m_gamma, colors, m_colorsBuffer);
     LightpackMath::brightnessCorrection(m_brightness, m_colorsBuffer);
 
+    SharedFramePublisher::instance()->publish(m_colorsBuffer);
+
+    // Nodes are reused when the receiver has released the previous frame
     for (int i = 0; i < m_colorsBuffer.count(); i++)
     {
-        callbackColors.append(qRgb(m_colorsBuffer[i].r, m_colorsBuffer[i].g, m_colorsBuffer[i].b));
+        m_callbackColors[i] = qRgb(m_colorsBuffer[i].r, m_colorsBuffer[i].g, m_colorsBuffer[i].b);
     }
 
-    emit colorsUpdated(callbackColors);
-    emit commandCompleted(true);
+    emit colorsUpdated(m_callbackColors);
 }
 
 void LedDeviceVirtual::switchOffLeds()
@@ -68,6 +86,8 @@ void LedDeviceVirtual::switchOffLeds()
     for (int i = 0; i < count; i++)
         m_colorsSaved << 0;
 
+    // Switch off at once, without fading
+    m_interpolator->jumpTo(m_colorsSaved);
     setColors(m_colorsSaved);
 }
 
@@ -81,8 +101,11 @@ void LedDeviceVirtual::setColorDepth(int /*value*/)
     emit commandCompleted(true);
 }
 
-void LedDeviceVirtual::setSmoothSlowdown(int /*value*/)
+void LedDeviceVirtual::setSmoothSlowdown(int value)
 {
+    DEBUG_LOW_LEVEL << Q_FUNC_INFO << value;
+
+    m_interpolator->setSmoothSlowdown(Settings::isHostSmoothingEnabled() ? value : 0);
     emit commandCompleted(true);
 }
 
@@ -141,9 +164,12 @@ void LedDeviceVirtual::resizeColorsBuffer(int buffSize)
         buffSize = MaximumNumberOfLeds::Virtual;
     }
 
+    m_callbackColors.clear();
+
     for (int i = 0; i < buffSize; i++)
     {
         m_colorsBuffer << StructRgb();
+        m_callbackColors << 0;
     }
 }
 
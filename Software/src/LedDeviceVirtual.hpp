@@ -28,6 +28,7 @@
 
 #include "ILedDevice.hpp"
 #include "StructRgb.hpp"
+#include "FrameInterpolator.hpp"
 
 class LedDeviceVirtual : public ILedDevice
 {
@@ -41,20 +42,25 @@ public slots:
     void switchOffLeds();
     void setRefreshDelay(int /*value*/);
     void setColorDepth(int /*value*/);
-    void setSmoothSlowdown(int /*value*/);
+    void setSmoothSlowdown(int value);
     void setColorSequence(QString /*value*/);
     void setGamma(double value);
     void setBrightness(int value);
     void requestFirmwareVersion();
     void updateDeviceSettings();
 
+private slots:
+    void writeColors(const QList<QRgb> & colors);
+
 private:
     void resizeColorsBuffer(int buffSize);
 
 private:
+    FrameInterpolator *m_interpolator;
     double m_gamma;
     int m_brightness;
 
     QList<QRgb> m_colorsSaved;
     QList<StructRgb> m_colorsBuffer;
+    QList<QRgb> m_callbackColors;
 };
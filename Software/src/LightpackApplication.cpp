@@ -25,6 +25,7 @@
  */
 
 #include "LightpackApplication.hpp"
+#include "SharedFrame.hpp"
 #include "LedDeviceLightpack.hpp"
 #include "LightpackPluginInterface.hpp"
 #include "version.h"
@@ -59,6 +60,7 @@ void LightpackApplication::initializeAll(const QString & appDirPath)
 
     m_applicationDirPath = appDirPath;
     m_noGui = false;
+    m_replaySpeed = 1.0;
 
     processCommandLineArguments();
 
@@ -98,8 +100,20 @@ void LightpackApplication::initializeAll(const QString & appDirPath)
     }
     m_deviceLockStatus = DeviceLocked::Unlocked;
 
+    // Before devices are started, they publish to it from their thread
+    if (Settings::isSharedMemoryEnabled())
+        SharedFramePublisher::instance()->open();
+
     startLedDeviceManager();
 
+    if (m_recordFileName.isEmpty() == false)
+        QMetaObject::invokeMethod(m_ledDeviceManager, "startRecording", Qt::QueuedConnection,
+                                  Q_ARG(QString, m_recordFileName));
+
+    if (m_replayFileName.isEmpty() == false)
+        QMetaObject::invokeMethod(m_ledDeviceManager, "startReplay", Qt::QueuedConnection,
+                                  Q_ARG(QString, m_replayFileName), Q_ARG(double, m_replaySpeed));
+
     startApiServer();
 
     startGrabManager();
@@ -286,6 +300,26 @@ void LightpackApplication::processCommandLineArguments()
         {
             g_debugLevel = Debug::ZeroLevel;
             m_isDebugLevelObtainedFromCmdArgs = true;
+        }
+        else if (arguments().at(i) == "--record" && i + 1 < arguments().count())
+        {
+            m_recordFileName = arguments().at(++i);
+        }
+        else if (arguments().at(i) == "--replay" && i + 1 < arguments().count())
+        {
+            m_replayFileName = arguments().at(++i);
+        }
+        else if (arguments().at(i) == "--replay-speed" && i + 1 < arguments().count())
+        {
+            bool ok = false;
+            m_replaySpeed = arguments().at(++i).toDouble(&ok);
+
+            if (ok == false || m_replaySpeed <= 0)
+            {
+                qDebug() << "Wrong replay speed:" << arguments().at(i);
+                printHelpMessage();
+                exit(WrongCommandLineArgument_ErrorCode);
+            }
         } else {
             qDebug() << "Wrong argument:" << arguments().at(i);
             printHelpMessage();
@@ -315,6 +349,9 @@ void LightpackApplication::printHelpMessage() const
     fprintf(stderr, "Options: \n");
     fprintf(stderr, "  --nogui       - no GUI (console mode) \n");
     fprintf(stderr, "  --off         - send 'off leds' cmd to device \n");
+    fprintf(stderr, "  --record FILE - write frames sent to device into FILE\n");
+    fprintf(stderr, "  --replay FILE - send frames recorded in FILE to device\n");
+    fprintf(stderr, "  --replay-speed N - replay N times faster, DEFAULT 1\n");
     fprintf(stderr, "  --help        - show this help \n");
     fprintf(stderr, "  --debug-high  - maximum verbose level of debug output\n");
     fprintf(stderr, "  --debug-mid   - middle debug level\n");
@@ -417,6 +454,8 @@ void LightpackApplication::startApiServer()
     connect(settings(), SIGNAL(lightpackNumberOfLedsChanged(int)), m_apiServer, SIGNAL(updateApiDeviceNumberOfLeds(int)));
     connect(settings(), SIGNAL(adalightNumberOfLedsChanged(int)),  m_apiServer, SIGNAL(updateApiDeviceNumberOfLeds(int)));
     connect(settings(), SIGNAL(ardulightNumberOfLedsChanged(int)), m_apiServer, SIGNAL(updateApiDeviceNumberOfLeds(int)));
+    connect(settings(), SIGNAL(udpNumberOfLedsChanged(int)),       m_apiServer, SIGNAL(updateApiDeviceNumberOfLeds(int)));
+    connect(settings(), SIGNAL(e131NumberOfLedsChanged(int)),      m_apiServer, SIGNAL(updateApiDeviceNumberOfLeds(int)));
     connect(settings(), SIGNAL(virtualNumberOfLedsChanged(int)),   m_apiServer, SIGNAL(updateApiDeviceNumberOfLeds(int)));
 
     if (!m_noGui)
@@ -511,6 +550,8 @@ void LightpackApplication::startGrabManager()
     connect(settings(), SIGNAL(lightpackNumberOfLedsChanged(int)), this, SLOT(numberOfLedsChanged(int)));
     connect(settings(), SIGNAL(adalightNumberOfLedsChanged(int)),  this, SLOT(numberOfLedsChanged(int)));
     connect(settings(), SIGNAL(ardulightNumberOfLedsChanged(int)), this, SLOT(numberOfLedsChanged(int)));
+    connect(settings(), SIGNAL(udpNumberOfLedsChanged(int)),       this, SLOT(numberOfLedsChanged(int)));
+    connect(settings(), SIGNAL(e131NumberOfLedsChanged(int)),      this, SLOT(numberOfLedsChanged(int)));
     connect(settings(), SIGNAL(virtualNumberOfLedsChanged(int)),   this, SLOT(numberOfLedsChanged(int)));
     connect(settings(), SIGNAL(profileLoaded(const QString &)),        m_grabManager, SLOT(settingsProfileChanged(const QString &)), Qt::QueuedConnection);
     connect(settings(), SIGNAL(currentProfileInited(const QString &)), m_grabManager, SLOT(settingsProfileChanged(const QString &)), Qt::QueuedConnection);
@@ -692,7 +733,7 @@ void LightpackApplication::requestBacklightStatus()
 }
 
 void LightpackApplication::handleConnectedDeviceChange(const SupportedDevices::DeviceType deviceType) {
-    QMutexLocker locker(&m_mutex);
+    QMutexLocker locker(ILedDevice::colorsMutex());
     int numOfLeds = Settings::getNumberOfLeds(deviceType);
     m_grabManager->setNumberOfLeds(numOfLeds);
     m_moodlampManager->setNumberOfLeds(numOfLeds);
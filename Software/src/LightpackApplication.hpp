@@ -94,9 +94,6 @@ private:
 
     virtual void commitData(QSessionManager &sessionManager);
 
-public:
-    QMutex m_mutex;
-
 private:
     SettingsWindow *m_settingsWindow;
     ApiServer *m_apiServer;
@@ -114,6 +111,9 @@ private:
     QWidget *consolePlugin;
 
     QString m_applicationDirPath;
+    QString m_recordFileName;
+    QString m_replayFileName;
+    double m_replaySpeed;
     bool m_isDebugLevelObtainedFromCmdArgs;
     bool m_isApiServerConnectedToLedDeviceSignalsSlots;
     bool m_noGui;
@@ -0,0 +1,47 @@
+/*
+ * LightpackFirmware.cpp
+ *
+ *  Created on: 19.10.2026
+ *     Project: Lightpack
+ *
+ *  Lightpack is very simple implementation of the backlight for a laptop
+ *
+ *  Copyright (c) 2011 Mike Shatohin, mikeshatohin [at] gmail.com
+ *
+ *  Lightpack is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Lightpack is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "LightpackFirmware.hpp"
+
+const int LightpackFirmware::RevisionBrightness = 1;
+const int LightpackFirmware::RevisionPartialUpdate = 2;
+const int LightpackFirmware::RevisionSmoothOptions = 3;
+const int LightpackFirmware::RevisionFeedback = 4;
+const int LightpackFirmware::RevisionLatest = LightpackFirmware::RevisionFeedback;
+
+int LightpackFirmware::revision(int major, int minor)
+{
+    switch (major)
+    {
+    case 4:
+        return minor - 5;
+    case 5:
+    case 6:
+        return minor - 2;
+    }
+
+    // Hardware newer than this host knows has everything it knows
+    return (major > 6) ? RevisionLatest : 0;
+}
@@ -0,0 +1,43 @@
+/*
+ * LightpackFirmware.hpp
+ *
+ *  Created on: 19.10.2026
+ *     Project: Lightpack
+ *
+ *  Lightpack is very simple implementation of the backlight for a laptop
+ *
+ *  Copyright (c) 2011 Mike Shatohin, mikeshatohin [at] gmail.com
+ *
+ *  Lightpack is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Lightpack is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+/*!
+  Revisions of Lightpack firmware: number of updates since fw4.5, fw5.2 and
+  fw6.2, each of them brought new commands to all hardware at the same time.
+*/
+class LightpackFirmware
+{
+public:
+    static const int RevisionBrightness;
+    static const int RevisionPartialUpdate;
+    static const int RevisionSmoothOptions;
+    static const int RevisionFeedback;
+    // Newest one, keep it equal to the last revision above
+    static const int RevisionLatest;
+
+    static int revision(int major, int minor);
+};
@@ -20,6 +20,8 @@ LightpackPluginInterface::LightpackPluginInterface(QObject *parent) :
     m_timerLock = new QTimer(this);
     m_timerLock->start(5000); // check in 5000 ms
     connect(m_timerLock, SIGNAL(timeout()), this, SLOT(timeoutLock()));
+    // Colors set by plugins and API are current colors too
+    connect(this, SIGNAL(updateLedsColors(QList<QRgb>)), this, SIGNAL(colorsChanged(QList<QRgb>)));
 }
 
 LightpackPluginInterface::~LightpackPluginInterface()
@@ -112,6 +114,8 @@ void LightpackPluginInterface::refreshAmbilightEvaluated(double updateResultMs)
     if(secs != 0){
         hz = 1 / secs;
     }
+
+    emit fpsChanged(hz);
 }
 
 void LightpackPluginInterface::refreshScreenRect(QRect rect)
@@ -123,6 +127,8 @@ void LightpackPluginInterface::updateColors(const QList<QRgb> & colors)
 {
     DEBUG_MID_LEVEL << Q_FUNC_INFO;
     m_curColors = colors;
+
+    emit colorsChanged(m_curColors);
 }
 
 QString LightpackPluginInterface::Version()
@@ -266,14 +272,25 @@ bool LightpackPluginInterface::SetColors(QString sessionKey, int r, int g, int b
 }
 
 bool LightpackPluginInterface::SetFrame(QString sessionKey, QList<QColor> colors)
+{
+    QList<QRgb> rgbColors;
+    rgbColors.reserve(colors.size());
+    for (int i = 0; i < colors.size(); i++)
+    {
+        rgbColors << colors[i].rgb();
+    }
+    return SetFrameRgb(sessionKey, rgbColors);
+}
+
+bool LightpackPluginInterface::SetFrameRgb(const QString & sessionKey, const QList<QRgb> & colors)
 {
     if (lockSessionKeys.isEmpty()) return false;
     if (lockSessionKeys[0]!=sessionKey) return false;
     lockAlive = true;
-    int availSize = colors.size() < m_setColors.size() ? colors.size() : m_setColors.size();
+    int availSize = qMin(colors.size(), m_setColors.size());
     for (int i = 0; i < availSize; i++)
     {
-            m_setColors[i] = colors[i].rgb();
+        m_setColors[i] = colors[i];
     }
     m_curColors = m_setColors;
     emit updateLedsColors(m_setColors);
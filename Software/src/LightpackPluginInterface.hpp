@@ -13,6 +13,9 @@ public:
     LightpackPluginInterface(QObject *parent = 0);
     ~LightpackPluginInterface();
 
+    // SetFrame for callers which already have QRgb colors (API binary frames)
+    bool SetFrameRgb(const QString & sessionKey, const QList<QRgb> & colors);
+
  public slots:
 // Plugin section
      QString GetSessionKey(QString module);
@@ -72,6 +75,9 @@ signals:
      void updateProfile(QString profileName);
      void updateStatus(Backlight::Status status);
      void updateBacklight(Lightpack::Mode status);
+     // For API subscribers, see ApiServer::CmdSubscribe
+     void colorsChanged(const QList<QRgb> & colors);
+     void fpsChanged(double fps);
 
 
 public slots:
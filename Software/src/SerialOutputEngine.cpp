@@ -0,0 +1,303 @@
+/*
+ * SerialOutputEngine.cpp
+ *
+ *  Created on: 19.10.2026
+ *     Project: Lightpack
+ *
+ *  Lightpack is very simple implementation of the backlight for a laptop
+ *
+ *  Copyright (c) 2011 Mike Shatohin, mikeshatohin [at] gmail.com
+ *
+ *  Lightpack is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Lightpack is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <QTimer>
+
+#include "SerialOutputEngine.hpp"
+#include "abstractserial.h"
+#include "debug.h"
+
+#ifdef Q_OS_UNIX
+#   include <unistd.h>
+#   include <fcntl.h>
+#   include <errno.h>
+#   include <sys/ioctl.h>
+#endif
+
+// 8N1: start bit + 8 data bits + stop bit
+const int SerialOutputEngine::BitsPerByte = 10;
+const int SerialOutputEngine::StatisticsIntervalMs = 1000;
+
+SerialOutputEngine::SerialOutputEngine(QObject * parent) : QObject(parent)
+{
+    m_serialDevice = NULL;
+    m_descriptor = -1;
+    m_baudRate = 115200;
+    m_frameEncoder = NULL;
+
+    m_timerDrain = new QTimer(this);
+    m_timerDrain->setSingleShot(true);
+    connect(m_timerDrain, SIGNAL(timeout()), this, SLOT(writePendingFrame()));
+
+    m_time.start();
+
+    reset();
+}
+
+void SerialOutputEngine::setSerialDevice(AbstractSerial * serialDevice)
+{
+    m_serialDevice = serialDevice;
+
+#ifdef Q_OS_UNIX
+    // NULL is set when port is closed, forget its descriptor as well
+    setDescriptor(m_serialDevice != NULL ? m_serialDevice->nativeDescriptor() : -1);
+#else
+    reset();
+#endif
+}
+
+void SerialOutputEngine::setDescriptor(int descriptor)
+{
+    m_descriptor = descriptor;
+
+#ifdef Q_OS_UNIX
+    // Never let write() sleep on the full tx buffer, unsent tail is kept in m_unsentTail
+    if (m_descriptor >= 0)
+        fcntl(m_descriptor, F_SETFL, fcntl(m_descriptor, F_GETFL) | O_NONBLOCK);
+#endif
+
+    reset();
+}
+
+void SerialOutputEngine::setBaudRate(int baudRate)
+{
+    DEBUG_LOW_LEVEL << Q_FUNC_INFO << baudRate;
+
+    if (baudRate <= 0)
+    {
+        qWarning() << Q_FUNC_INFO << "invalid baud rate:" << baudRate;
+        return;
+    }
+
+    m_baudRate = baudRate;
+}
+
+void SerialOutputEngine::setFrameEncoder(SerialFrameEncoder * encoder)
+{
+    m_frameEncoder = encoder;
+}
+
+void SerialOutputEngine::reset()
+{
+    m_timerDrain->stop();
+
+    m_pendingFrame.clear();
+    m_unsentTail.clear();
+    m_hasPendingFrame = false;
+    m_linkBusyUntilMs = 0;
+
+    m_framesWritten = 0;
+    m_framesReplaced = 0;
+    m_framesInInterval = 0;
+    m_intervalStartMs = m_time.elapsed();
+    m_achievedFps = 0;
+}
+
+double SerialOutputEngine::wireTimeMs(int bytesCount) const
+{
+    return (1000.0 * bytesCount * BitsPerByte) / m_baudRate;
+}
+
+double SerialOutputEngine::maximumFps(int frameSize) const
+{
+    if (frameSize <= 0)
+        return 0;
+
+    return (double)m_baudRate / (frameSize * BitsPerByte);
+}
+
+bool SerialOutputEngine::writeFrame(const QByteArray & frame)
+{
+    if (m_serialDevice == NULL && m_descriptor < 0)
+        return false;
+
+    if (m_hasPendingFrame || isLinkBusy())
+    {
+        if (m_hasPendingFrame)
+            m_framesReplaced++;
+
+        // Link is still transmitting previous frame, replace the waiting one
+        m_pendingFrame = frame;
+        m_hasPendingFrame = true;
+
+        if (m_timerDrain->isActive() == false)
+            m_timerDrain->start(linkDrainTimeMs());
+
+        return true;
+    }
+
+    if (sendFrame(frame) == false)
+        return false;
+
+    if (m_unsentTail.isEmpty() == false)
+        m_timerDrain->start(linkDrainTimeMs());
+
+    return true;
+}
+
+void SerialOutputEngine::writePendingFrame()
+{
+    if (isLinkBusy())
+    {
+        m_timerDrain->start(linkDrainTimeMs());
+        return;
+    }
+
+    if (m_hasPendingFrame == false)
+        return;
+
+    m_hasPendingFrame = false;
+
+    if (sendFrame(m_pendingFrame) == false)
+        qWarning() << Q_FUNC_INFO << "write pending frame fail";
+
+    // Frame may be left in m_unsentTail, let it go on the next timeout
+    if (m_unsentTail.isEmpty() == false)
+        m_timerDrain->start(linkDrainTimeMs());
+}
+
+bool SerialOutputEngine::sendFrame(const QByteArray & frame)
+{
+    const QByteArray * packet = &frame;
+
+    if (m_frameEncoder != NULL)
+    {
+        m_frameEncoder->encode(frame, m_encodedFrame);
+        packet = &m_encodedFrame;
+    }
+
+    if (writeToDevice(*packet) == false)
+    {
+        if (m_frameEncoder != NULL)
+            m_frameEncoder->reset();
+        return false;
+    }
+
+    frameWritten(packet->size());
+    return true;
+}
+
+bool SerialOutputEngine::isLinkBusy()
+{
+    if (m_unsentTail.isEmpty() == false)
+    {
+        // Finish previous frame first, otherwise device loses sync
+        if (writeToDevice(QByteArray()) == false || m_unsentTail.isEmpty() == false)
+            return true;
+    }
+
+    return m_time.elapsed() < m_linkBusyUntilMs || bytesInTxQueue() > 0;
+}
+
+int SerialOutputEngine::linkDrainTimeMs()
+{
+    qint64 modelMs = m_linkBusyUntilMs - m_time.elapsed();
+    qint64 queueMs = (qint64)(wireTimeMs(bytesInTxQueue() + m_unsentTail.size()) + 0.5);
+
+    qint64 drainMs = qMax(modelMs, queueMs);
+
+    return (int)qMax(drainMs, (qint64)1);
+}
+
+qint64 SerialOutputEngine::bytesInTxQueue() const
+{
+#ifdef Q_OS_UNIX
+    if (m_descriptor < 0)
+        return 0;
+
+    int bytes = 0;
+    if (ioctl(m_descriptor, TIOCOUTQ, &bytes) == -1)
+        return 0;
+
+    return bytes;
+#else
+    return 0;
+#endif
+}
+
+bool SerialOutputEngine::writeToDevice(const QByteArray & data)
+{
+#ifdef Q_OS_UNIX
+    if (m_descriptor >= 0)
+    {
+        QByteArray buffer = m_unsentTail + data;
+        m_unsentTail.clear();
+
+        ssize_t bytesWritten = ::write(m_descriptor, buffer.constData(), buffer.size());
+
+        if (bytesWritten < 0)
+        {
+            if (errno == EAGAIN || errno == EINTR)
+                bytesWritten = 0;
+            else
+                return false;
+        }
+
+        if (bytesWritten < buffer.size())
+            m_unsentTail = buffer.mid(bytesWritten);
+
+        return true;
+    }
+#endif
+
+    if (m_serialDevice == NULL || m_serialDevice->isOpen() == false)
+        return false;
+
+    qint64 bytesWritten = m_serialDevice->write(data);
+
+    if (bytesWritten != data.size())
+    {
+        qWarning() << Q_FUNC_INFO << "bytesWritten != data.size():" << bytesWritten << data.size();
+        return false;
+    }
+
+    return true;
+}
+
+void SerialOutputEngine::frameWritten(int frameSize)
+{
+    qint64 now = m_time.elapsed();
+
+    m_linkBusyUntilMs = qMax(m_linkBusyUntilMs, now) + (qint64)(wireTimeMs(frameSize) + 0.5);
+
+    m_framesWritten++;
+    m_framesInInterval++;
+
+    emit frameSent();
+
+    qint64 intervalMs = now - m_intervalStartMs;
+
+    if (intervalMs >= StatisticsIntervalMs)
+    {
+        m_achievedFps = (1000.0 * m_framesInInterval) / intervalMs;
+        m_framesInInterval = 0;
+        m_intervalStartMs = now;
+
+        DEBUG_LOW_LEVEL << Q_FUNC_INFO << "fps:" << m_achievedFps << "of max" << maximumFps(frameSize)
+                        << "at" << m_baudRate << "baud, replaced frames:" << m_framesReplaced;
+
+        emit statisticsUpdated(m_achievedFps, maximumFps(frameSize));
+    }
+}
@@ -0,0 +1,117 @@
+/*
+ * SerialOutputEngine.hpp
+ *
+ *  Created on: 19.10.2026
+ *     Project: Lightpack
+ *
+ *  Lightpack is very simple implementation of the backlight for a laptop
+ *
+ *  Copyright (c) 2011 Mike Shatohin, mikeshatohin [at] gmail.com
+ *
+ *  Lightpack is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Lightpack is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QByteArray>
+#include <QElapsedTimer>
+
+class QTimer;
+class AbstractSerial;
+
+/*!
+  Converts frame to the bytes which are sent to the device. Encoder is called
+  right before writing, so replaced frames never reach it.
+*/
+class SerialFrameEncoder
+{
+public:
+    virtual ~SerialFrameEncoder() {}
+    virtual void encode(const QByteArray & frame, QByteArray & packet) = 0;
+    // Called when packet was not delivered
+    virtual void reset() = 0;
+};
+
+/*!
+  Non-blocking frame writer for serial LED devices (Adalight, Ardulight).
+
+  Wire time of each frame is evaluated from the baud rate. A frame is written
+  only when the previous one has left the UART: the kernel tx queue (TIOCOUTQ)
+  is empty and the estimated wire time is over. Frames which come while the
+  link is busy are not queued, the last one replaces the pending one.
+*/
+class SerialOutputEngine : public QObject
+{
+    Q_OBJECT
+public:
+    SerialOutputEngine(QObject * parent = 0);
+
+    void setSerialDevice(AbstractSerial * serialDevice);
+    void setDescriptor(int descriptor);
+    void setBaudRate(int baudRate);
+    void setFrameEncoder(SerialFrameEncoder * encoder);
+    int baudRate() const { return m_baudRate; }
+
+    bool writeFrame(const QByteArray & frame);
+    void reset();
+
+    double wireTimeMs(int bytesCount) const;
+    double maximumFps(int frameSize) const;
+    double achievedFps() const { return m_achievedFps; }
+
+    int framesWritten() const { return m_framesWritten; }
+    int framesReplaced() const { return m_framesReplaced; }
+
+    static const int BitsPerByte;
+    static const int StatisticsIntervalMs;
+
+signals:
+    void statisticsUpdated(double achievedFps, double maximumFps);
+    // Frame is written to the device, replaced frames don't come here
+    void frameSent();
+
+private slots:
+    void writePendingFrame();
+
+private:
+    bool sendFrame(const QByteArray & frame);
+    bool isLinkBusy();
+    int linkDrainTimeMs();
+    qint64 bytesInTxQueue() const;
+    bool writeToDevice(const QByteArray & data);
+    void frameWritten(int frameSize);
+
+private:
+    AbstractSerial *m_serialDevice;
+    int m_descriptor;
+    int m_baudRate;
+    SerialFrameEncoder *m_frameEncoder;
+    QByteArray m_encodedFrame;
+
+    QTimer *m_timerDrain;
+    QElapsedTimer m_time;
+    qint64 m_linkBusyUntilMs;
+
+    QByteArray m_pendingFrame;
+    QByteArray m_unsentTail;
+    bool m_hasPendingFrame;
+
+    int m_framesWritten;
+    int m_framesReplaced;
+    int m_framesInInterval;
+    qint64 m_intervalStartMs;
+    double m_achievedFps;
+};
@@ -0,0 +1,205 @@
+/*
+ * SetColorParser.cpp
+ *
+ *  Created on: 19.10.2026
+ *     Project: Lightpack
+ *
+ *  Lightpack is very simple implementation of the backlight for a laptop
+ *
+ *  Copyright (c) 2011 Mike Shatohin, mikeshatohin [at] gmail.com
+ *
+ *  Lightpack is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Lightpack is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "SetColorParser.hpp"
+
+static inline int decimalDigit(char c)
+{
+    return (c >= '0' && c <= '9') ? c - '0' : -1;
+}
+
+static inline int hexDigit(char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    return -1;
+}
+
+SetColorParser::SetColorParser()
+{
+    m_data = 0;
+    m_size = 0;
+    m_pos = 0;
+    m_error = ErrorNone;
+    m_errorPosition = -1;
+    m_itemsCount = 0;
+}
+
+bool SetColorParser::parse(const char * data, int size, QRgb * colors, int numberOfLeds)
+{
+    m_data = data;
+    m_size = size;
+    m_pos = 0;
+    m_error = ErrorNone;
+    m_errorPosition = -1;
+    m_itemsCount = 0;
+
+    if (size <= 0)
+        return setError(ErrorEmpty, 0);
+
+    while (true)
+    {
+        int first = 0, last = 0;
+
+        if (readNumber(1, numberOfLeds, ErrorLedNumberExpected, ErrorLedNumberOutOfRange, first) == false)
+            return false;
+
+        last = first;
+
+        if (m_pos + 1 < m_size && m_data[m_pos] == '.' && m_data[m_pos + 1] == '.')
+        {
+            m_pos += 2;
+
+            int lastPosition = m_pos;
+            if (readNumber(1, numberOfLeds, ErrorLedNumberExpected, ErrorLedNumberOutOfRange, last) == false)
+                return false;
+            if (last < first)
+                return setError(ErrorLedRangeReversed, lastPosition);
+        }
+
+        if (expect('-', ErrorDashExpected) == false)
+            return false;
+
+        QRgb color;
+
+        if (m_pos < m_size && m_data[m_pos] == '#')
+        {
+            m_pos++;
+            if (readHexColor(color) == false)
+                return false;
+        } else {
+            int red, green, blue;
+
+            if (readNumber(0, 255, ErrorColorExpected, ErrorColorOutOfRange, red) == false
+                    || expect(',', ErrorCommaExpected) == false
+                    || readNumber(0, 255, ErrorColorExpected, ErrorColorOutOfRange, green) == false
+                    || expect(',', ErrorCommaExpected) == false
+                    || readNumber(0, 255, ErrorColorExpected, ErrorColorOutOfRange, blue) == false)
+                return false;
+
+            color = qRgb(red, green, blue);
+        }
+
+        for (int i = first - 1; i < last; i++)
+            colors[i] = color;
+
+        m_itemsCount++;
+
+        if (m_pos == m_size)
+            return true;
+
+        if (expect(';', ErrorSemicolonExpected) == false)
+            return false;
+
+        // Semicolon after the last item is optional
+        if (m_pos == m_size)
+            return true;
+    }
+}
+
+bool SetColorParser::readNumber(int minimum, int maximum, Error expectedError, Error rangeError, int & value)
+{
+    int start = m_pos;
+
+    if (m_pos == m_size || decimalDigit(m_data[m_pos]) < 0)
+        return setError(expectedError, m_pos);
+
+    value = 0;
+
+    for (int d; m_pos < m_size && (d = decimalDigit(m_data[m_pos])) >= 0; m_pos++)
+    {
+        value = value * 10 + d;
+
+        // Stop before overflow on long numbers
+        if (value > maximum)
+            return setError(rangeError, start);
+    }
+
+    if (value < minimum)
+        return setError(rangeError, start);
+
+    return true;
+}
+
+bool SetColorParser::readHexColor(QRgb & color)
+{
+    unsigned rgb = 0;
+
+    for (int i = 0; i < 6; i++, m_pos++)
+    {
+        int d = (m_pos < m_size) ? hexDigit(m_data[m_pos]) : -1;
+
+        if (d < 0)
+            return setError(ErrorHexColorExpected, m_pos);
+
+        rgb = (rgb << 4) | d;
+    }
+
+    color = qRgb((rgb >> 16) & 0xff, (rgb >> 8) & 0xff, rgb & 0xff);
+
+    return true;
+}
+
+bool SetColorParser::expect(char c, Error error)
+{
+    if (m_pos == m_size || m_data[m_pos] != c)
+        return setError(error, m_pos);
+
+    m_pos++;
+
+    return true;
+}
+
+bool SetColorParser::setError(Error error, int position)
+{
+    m_error = error;
+    m_errorPosition = position;
+
+    return false;
+}
+
+const char * SetColorParser::errorString(Error error)
+{
+    switch (error)
+    {
+    case ErrorNone:                 return "no error";
+    case ErrorEmpty:                return "empty command";
+    case ErrorLedNumberExpected:    return "expected LED number";
+    case ErrorLedNumberOutOfRange:  return "LED number is out of range";
+    case ErrorLedRangeReversed:     return "last LED of range is less than first one";
+    case ErrorDashExpected:         return "expected '-'";
+    case ErrorColorExpected:        return "expected color component";
+    case ErrorColorOutOfRange:      return "color component is greater than 255";
+    case ErrorCommaExpected:        return "expected ','";
+    case ErrorHexColorExpected:     return "expected 6 hex digits of color";
+    case ErrorSemicolonExpected:    return "expected ';'";
+    }
+
+    return "unknown error";
+}
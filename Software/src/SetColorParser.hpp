@@ -0,0 +1,88 @@
+/*
+ * SetColorParser.hpp
+ *
+ *  Created on: 19.10.2026
+ *     Project: Lightpack
+ *
+ *  Lightpack is very simple implementation of the backlight for a laptop
+ *
+ *  Copyright (c) 2011 Mike Shatohin, mikeshatohin [at] gmail.com
+ *
+ *  Lightpack is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Lightpack is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <QRgb>
+
+/*!
+  Parser of the setcolor command arguments. It reads buffer once from start
+  to end and writes colors in place, nothing is allocated.
+
+    colors := item { ";" item } [ ";" ]
+    item   := leds "-" color
+    leds   := N | N ".." N          LED numbers from 1, range includes both ends
+    color  := R "," G "," B | "#" RRGGBB
+
+  Components R, G, B are decimal 0..255, RRGGBB are hex digits in any case.
+  On error parsing stops, errorPosition() is the offset of the wrong byte
+  (or of the number which is out of range) and colors are partially written,
+  so caller should parse into a copy.
+*/
+class SetColorParser
+{
+public:
+    enum Error
+    {
+        ErrorNone,
+        ErrorEmpty,
+        ErrorLedNumberExpected,
+        ErrorLedNumberOutOfRange,
+        ErrorLedRangeReversed,
+        ErrorDashExpected,
+        ErrorColorExpected,
+        ErrorColorOutOfRange,
+        ErrorCommaExpected,
+        ErrorHexColorExpected,
+        ErrorSemicolonExpected
+    };
+
+    SetColorParser();
+
+    // colors has numberOfLeds items, LED number N is written to colors[N - 1]
+    bool parse(const char * data, int size, QRgb * colors, int numberOfLeds);
+
+    Error error() const { return m_error; }
+    int errorPosition() const { return m_errorPosition; }
+    // Number of parsed "leds-color" items
+    int itemsCount() const { return m_itemsCount; }
+
+    static const char * errorString(Error error);
+
+private:
+    bool readNumber(int minimum, int maximum, Error expectedError, Error rangeError, int & value);
+    bool readHexColor(QRgb & color);
+    bool expect(char c, Error error);
+    bool setError(Error error, int position);
+
+private:
+    const char * m_data;
+    int m_size;
+    int m_pos;
+
+    Error m_error;
+    int m_errorPosition;
+    int m_itemsCount;
+};
@@ -55,6 +55,9 @@ static const QString DebugLevel = "DebugLevel";
 static const QString IsExpertModeEnabled = "IsExpertModeEnabled";
 static const QString IsKeepLightsOnAfterExit = "IsKeepLightsOnAfterExit";
 static const QString IsPingDeviceEverySecond = "IsPingDeviceEverySecond";
+static const QString IsSharedMemoryEnabled = "IsSharedMemoryEnabled";
+static const QString IsTemporalDitheringEnabled = "IsTemporalDitheringEnabled";
+static const QString IsHostSmoothingEnabled = "IsHostSmoothingEnabled";
 static const QString IsUpdateFirmwareMessageShown = "IsUpdateFirmwareMessageShown";
 static const QString ConnectedDevice = "ConnectedDevice";
 static const QString SupportedDevices = "SupportedDevices";
@@ -72,6 +75,10 @@ static const QString IsEnabled = "API/IsEnabled";
 static const QString Port = "API/Port";
 static const QString IsAuthEnabled = "API/IsAuthEnabled";
 static const QString AuthKey = "API/AuthKey";
+static const QString IsUdpEnabled = "API/IsUdpEnabled";
+static const QString UdpPort = "API/UdpPort";
+static const QString IsLocalSocketEnabled = "API/IsLocalSocketEnabled";
+static const QString LocalSocketName = "API/LocalSocketName";
 }
 namespace Adalight
 {
@@ -79,6 +86,7 @@ static const QString NumberOfLeds = "Adalight/NumberOfLeds";
 static const QString ColorSequence = "Adalight/ColorSequence";
 static const QString Port = "Adalight/SerialPort";
 static const QString BaudRate = "Adalight/BaudRate";
+static const QString IsDeltaProtocolEnabled = "Adalight/IsDeltaProtocolEnabled";
 }
 namespace Paintpack
 {
@@ -101,6 +109,25 @@ static const QString NumberOfLeds = "AlienFx/NumberOfLeds";
 namespace Lightpack
 {
 static const QString NumberOfLeds = "Lightpack/NumberOfLeds";
+static const QString WriteQueueDepth = "Lightpack/WriteQueueDepth";
+static const QString SmoothCurve = "Lightpack/SmoothCurve";
+}
+namespace Udp
+{
+static const QString NumberOfLeds = "Udp/NumberOfLeds";
+static const QString Host = "Udp/Host";
+static const QString Port = "Udp/Port";
+static const QString Mtu = "Udp/Mtu";
+}
+namespace E131
+{
+static const QString NumberOfLeds = "E131/NumberOfLeds";
+static const QString Protocol = "E131/Protocol";
+static const QString Host = "E131/Host";
+static const QString Universe = "E131/Universe";
+static const QString StartAddress = "E131/StartAddress";
+static const QString IsSyncEnabled = "E131/IsSyncEnabled";
+static const QString SyncUniverse = "E131/SyncUniverse";
 }
 namespace Virtual
 {
@@ -119,6 +146,8 @@ static const QString PaintpackDevice = "Paintpack";
 static const QString AlienFxDevice = "AlienFx";
 static const QString AdalightDevice = "Adalight";
 static const QString ArdulightDevice = "Ardulight";
+static const QString UdpDevice = "Udp";
+static const QString E131Device = "E131";
 static const QString VirtualDevice = "Virtual";
 }
 
@@ -237,6 +266,9 @@ void Settings::Initialize( const QString & applicationDirPath, bool isDebugLevel
     setNewOptionMain(Main::Key::IsExpertModeEnabled,    Main::IsExpertModeEnabledDefault);
     setNewOptionMain(Main::Key::IsKeepLightsOnAfterExit,   Main::IsKeepLightsOnAfterExit);
     setNewOptionMain(Main::Key::IsPingDeviceEverySecond,Main::IsPingDeviceEverySecond);
+    setNewOptionMain(Main::Key::IsSharedMemoryEnabled,  Main::IsSharedMemoryEnabled);
+    setNewOptionMain(Main::Key::IsTemporalDitheringEnabled, Main::IsTemporalDitheringEnabled);
+    setNewOptionMain(Main::Key::IsHostSmoothingEnabled, Main::IsHostSmoothingEnabled);
     setNewOptionMain(Main::Key::IsUpdateFirmwareMessageShown, Main::IsUpdateFirmwareMessageShown);
     setNewOptionMain(Main::Key::ConnectedDevice,        Main::ConnectedDeviceDefault);
     setNewOptionMain(Main::Key::SupportedDevices,       Main::SupportedDevices, true /* always rewrite this information to main config */);
@@ -245,12 +277,17 @@ void Settings::Initialize( const QString & applicationDirPath, bool isDebugLevel
     setNewOptionMain(Main::Key::Api::IsAuthEnabled,     Main::Api::IsAuthEnabledDefault);
     // Generation AuthKey as new UUID
     setNewOptionMain(Main::Key::Api::AuthKey,           QUuid::createUuid().toString());
+    setNewOptionMain(Main::Key::Api::IsUdpEnabled,      Main::Api::IsUdpEnabledDefault);
+    setNewOptionMain(Main::Key::Api::UdpPort,           Main::Api::UdpPortDefault);
+    setNewOptionMain(Main::Key::Api::IsLocalSocketEnabled, Main::Api::IsLocalSocketEnabledDefault);
+    setNewOptionMain(Main::Key::Api::LocalSocketName,   Main::Api::LocalSocketNameDefault);
 
     // Serial device configuration
     setNewOptionMain(Main::Key::Adalight::Port,             Main::Adalight::PortDefault);
     setNewOptionMain(Main::Key::Adalight::BaudRate,         Main::Adalight::BaudRateDefault);
     setNewOptionMain(Main::Key::Adalight::NumberOfLeds,     Main::Adalight::NumberOfLedsDefault);
     setNewOptionMain(Main::Key::Adalight::ColorSequence,    Main::Adalight::ColorSequence);
+    setNewOptionMain(Main::Key::Adalight::IsDeltaProtocolEnabled, Main::Adalight::IsDeltaProtocolEnabledDefault);
 
     setNewOptionMain(Main::Key::Ardulight::Port,            Main::Ardulight::PortDefault);
     setNewOptionMain(Main::Key::Ardulight::BaudRate,        Main::Ardulight::BaudRateDefault);
@@ -259,8 +296,23 @@ void Settings::Initialize( const QString & applicationDirPath, bool isDebugLevel
 
     setNewOptionMain(Main::Key::AlienFx::NumberOfLeds,      Main::AlienFx::NumberOfLedsDefault);
     setNewOptionMain(Main::Key::Lightpack::NumberOfLeds,    Main::Lightpack::NumberOfLedsDefault);
+    setNewOptionMain(Main::Key::Lightpack::WriteQueueDepth, Main::Lightpack::WriteQueueDepthDefault);
+    setNewOptionMain(Main::Key::Lightpack::SmoothCurve,     Main::Lightpack::SmoothCurveDefault);
     setNewOptionMain(Main::Key::Virtual::NumberOfLeds,      Main::Virtual::NumberOfLedsDefault);
 
+    setNewOptionMain(Main::Key::Udp::NumberOfLeds,          Main::Udp::NumberOfLedsDefault);
+    setNewOptionMain(Main::Key::Udp::Host,                  Main::Udp::HostDefault);
+    setNewOptionMain(Main::Key::Udp::Port,                  Main::Udp::PortDefault);
+    setNewOptionMain(Main::Key::Udp::Mtu,                   Main::Udp::MtuDefault);
+
+    setNewOptionMain(Main::Key::E131::NumberOfLeds,         Main::E131::NumberOfLedsDefault);
+    setNewOptionMain(Main::Key::E131::Protocol,             Main::E131::ProtocolDefault);
+    setNewOptionMain(Main::Key::E131::Host,                 Main::E131::HostDefault);
+    setNewOptionMain(Main::Key::E131::Universe,             Main::E131::UniverseDefault);
+    setNewOptionMain(Main::Key::E131::StartAddress,         Main::E131::StartAddressDefault);
+    setNewOptionMain(Main::Key::E131::IsSyncEnabled,        Main::E131::IsSyncEnabledDefault);
+    setNewOptionMain(Main::Key::E131::SyncUniverse,         Main::E131::SyncUniverseDefault);
+
     setNewOptionMain(Main::Key::Paintpack::NumberOfLeds,    Main::Paintpack::NumberOfLedsDefault);
 
     if (isDebugLevelObtainedFromCmdArgs == false)
@@ -537,6 +589,26 @@ bool Settings::isApiAuthEnabled()
     return getApiAuthKey().isEmpty();
 }
 
+bool Settings::isApiUdpEnabled()
+{
+    return valueMain(Main::Key::Api::IsUdpEnabled).toBool();
+}
+
+int Settings::getApiUdpPort()
+{
+    return valueMain(Main::Key::Api::UdpPort).toInt();
+}
+
+bool Settings::isApiLocalSocketEnabled()
+{
+    return valueMain(Main::Key::Api::IsLocalSocketEnabled).toBool();
+}
+
+QString Settings::getApiLocalSocketName()
+{
+    return valueMain(Main::Key::Api::LocalSocketName).toString();
+}
+
 bool Settings::isExpertModeEnabled()
 {   
     return valueMain(Main::Key::IsExpertModeEnabled).toBool();
@@ -573,6 +645,21 @@ void Settings::setPingDeviceEverySecond(bool isEnabled)
     m_this->pingDeviceEverySecondEnabledChanged(isEnabled);
 }
 
+bool Settings::isSharedMemoryEnabled()
+{
+    return valueMain(Main::Key::IsSharedMemoryEnabled).toBool();
+}
+
+bool Settings::isTemporalDitheringEnabled()
+{
+    return valueMain(Main::Key::IsTemporalDitheringEnabled).toBool();
+}
+
+bool Settings::isHostSmoothingEnabled()
+{
+    return valueMain(Main::Key::IsHostSmoothingEnabled).toBool();
+}
+
 bool Settings::isUpdateFirmwareMessageShown()
 {
     return valueMain(Main::Key::IsUpdateFirmwareMessageShown).toBool();
@@ -686,6 +773,40 @@ void Settings::setAdalightSerialPortBaudRate(const QString & baud)
     m_this->adalightSerialPortBaudRateChanged(baud);
 }
 
+int Settings::getLightpackWriteQueueDepth()
+{
+    int depth = valueMain(Main::Key::Lightpack::WriteQueueDepth).toInt();
+
+    if (depth < 0)
+        depth = 0;
+    else if (depth > Main::Lightpack::WriteQueueDepthMax)
+        depth = Main::Lightpack::WriteQueueDepthMax;
+    return depth;
+}
+
+QString Settings::getLightpackSmoothCurve()
+{
+    QString curve = valueMain(Main::Key::Lightpack::SmoothCurve).toString();
+
+    if (curve != "linear" && curve != "ease-out" && curve != "exponential")
+    {
+        qWarning() << Q_FUNC_INFO << "Unknown smooth curve:" << curve << "using" << Main::Lightpack::SmoothCurveDefault;
+        return Main::Lightpack::SmoothCurveDefault;
+    }
+    return curve;
+}
+
+bool Settings::isAdalightDeltaProtocolEnabled()
+{
+    return valueMain(Main::Key::Adalight::IsDeltaProtocolEnabled).toBool();
+}
+
+void Settings::setAdalightDeltaProtocolEnabled(bool isEnabled)
+{
+    DEBUG_LOW_LEVEL << Q_FUNC_INFO;
+    setValueMain(Main::Key::Adalight::IsDeltaProtocolEnabled, isEnabled);
+}
+
 QString Settings::getArdulightSerialPortName()
 {
     return valueMain(Main::Key::Ardulight::Port).toString();
@@ -712,6 +833,115 @@ void Settings::setArdulightSerialPortBaudRate(const QString & baud)
     m_this->ardulightSerialPortBaudRateChanged(baud);
 }
 
+QString Settings::getUdpHost()
+{
+    return valueMain(Main::Key::Udp::Host).toString();
+}
+
+void Settings::setUdpHost(const QString & host)
+{
+    DEBUG_LOW_LEVEL << Q_FUNC_INFO;
+    setValueMain(Main::Key::Udp::Host, host);
+}
+
+int Settings::getUdpPort()
+{
+    bool ok = false;
+    int port = valueMain(Main::Key::Udp::Port).toInt(&ok);
+
+    if (ok == false || port <= 0 || port > 0xffff)
+        return Main::Udp::PortDefault;
+    return port;
+}
+
+void Settings::setUdpPort(int port)
+{
+    DEBUG_LOW_LEVEL << Q_FUNC_INFO;
+    setValueMain(Main::Key::Udp::Port, port);
+}
+
+int Settings::getUdpMtu()
+{
+    bool ok = false;
+    int mtu = valueMain(Main::Key::Udp::Mtu).toInt(&ok);
+
+    // IPv4 minimum MTU
+    if (ok == false || mtu < 576)
+        return Main::Udp::MtuDefault;
+    return mtu;
+}
+QString Settings::getE131Protocol()
+{
+    QString protocol = valueMain(Main::Key::E131::Protocol).toString();
+
+    if (protocol != Main::E131::ProtocolArtNet)
+        return Main::E131::ProtocolE131;
+    return protocol;
+}
+
+void Settings::setE131Protocol(const QString & protocol)
+{
+    DEBUG_LOW_LEVEL << Q_FUNC_INFO;
+    setValueMain(Main::Key::E131::Protocol, protocol);
+}
+
+QString Settings::getE131Host()
+{
+    return valueMain(Main::Key::E131::Host).toString();
+}
+
+void Settings::setE131Host(const QString & host)
+{
+    DEBUG_LOW_LEVEL << Q_FUNC_INFO;
+    setValueMain(Main::Key::E131::Host, host);
+}
+
+int Settings::getE131Universe()
+{
+    bool ok = false;
+    int universe = valueMain(Main::Key::E131::Universe).toInt(&ok);
+
+    if (ok == false || universe < 0 || universe > 63999)
+        return Main::E131::UniverseDefault;
+
+    // E1.31 universes are 1..63999, universe 0 is reserved.
+    // Art-Net port-addresses are 0..32767
+    if (getE131Protocol() == Main::E131::ProtocolArtNet)
+        return qMin(universe, 32767);
+    return qMax(universe, 1);
+}
+
+void Settings::setE131Universe(int universe)
+{
+    DEBUG_LOW_LEVEL << Q_FUNC_INFO;
+    setValueMain(Main::Key::E131::Universe, universe);
+}
+
+int Settings::getE131StartAddress()
+{
+    bool ok = false;
+    int address = valueMain(Main::Key::E131::StartAddress).toInt(&ok);
+
+    if (ok == false || address < 1 || address > 512)
+        return Main::E131::StartAddressDefault;
+    return address;
+}
+
+void Settings::setE131StartAddress(int address)
+{
+    DEBUG_LOW_LEVEL << Q_FUNC_INFO;
+    setValueMain(Main::Key::E131::StartAddress, address);
+}
+
+bool Settings::isE131SyncEnabled()
+{
+    return valueMain(Main::Key::E131::IsSyncEnabled).toBool();
+}
+
+int Settings::getE131SyncUniverse()
+{
+    return valueMain(Main::Key::E131::SyncUniverse).toInt();
+}
 
 QStringList Settings::getSupportedSerialPortBaudRates()
 {
@@ -768,6 +998,14 @@ void Settings::setNumberOfLeds(SupportedDevices::DeviceType device, int numberOf
             m_this->ardulightNumberOfLedsChanged(numberOfLeds);
             break;
 
+            case DeviceTypeUdp:
+            m_this->udpNumberOfLedsChanged(numberOfLeds);
+            break;
+
+            case DeviceTypeE131:
+            m_this->e131NumberOfLedsChanged(numberOfLeds);
+            break;
+
             case DeviceTypeVirtual:
             m_this->virtualNumberOfLedsChanged(numberOfLeds);
             break;
@@ -1467,12 +1705,16 @@ void Settings::initDevicesMap()
     m_devicesTypeToNameMap[SupportedDevices::DeviceTypePaintpack]   = Main::Value::ConnectedDevice::PaintpackDevice;
     m_devicesTypeToNameMap[SupportedDevices::DeviceTypeArdulight] = Main::Value::ConnectedDevice::ArdulightDevice;
     m_devicesTypeToNameMap[SupportedDevices::DeviceTypeLightpack] = Main::Value::ConnectedDevice::LightpackDevice;
+    m_devicesTypeToNameMap[SupportedDevices::DeviceTypeUdp]       = Main::Value::ConnectedDevice::UdpDevice;
+    m_devicesTypeToNameMap[SupportedDevices::DeviceTypeE131]      = Main::Value::ConnectedDevice::E131Device;
     m_devicesTypeToNameMap[SupportedDevices::DeviceTypeVirtual]   = Main::Value::ConnectedDevice::VirtualDevice;
 
     m_devicesTypeToKeyNumberOfLedsMap[SupportedDevices::DeviceTypeAdalight]  = Main::Key::Adalight::NumberOfLeds;
     m_devicesTypeToKeyNumberOfLedsMap[SupportedDevices::DeviceTypePaintpack]  = Main::Key::Paintpack::NumberOfLeds;
     m_devicesTypeToKeyNumberOfLedsMap[SupportedDevices::DeviceTypeArdulight] = Main::Key::Ardulight::NumberOfLeds;
     m_devicesTypeToKeyNumberOfLedsMap[SupportedDevices::DeviceTypeLightpack] = Main::Key::Lightpack::NumberOfLeds;
+    m_devicesTypeToKeyNumberOfLedsMap[SupportedDevices::DeviceTypeUdp]       = Main::Key::Udp::NumberOfLeds;
+    m_devicesTypeToKeyNumberOfLedsMap[SupportedDevices::DeviceTypeE131]      = Main::Key::E131::NumberOfLeds;
     m_devicesTypeToKeyNumberOfLedsMap[SupportedDevices::DeviceTypeVirtual]   = Main::Key::Virtual::NumberOfLeds;
 
 #ifdef ALIEN_FX_SUPPORTED
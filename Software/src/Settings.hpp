@@ -82,12 +82,19 @@ public:
     static void setApiKey(const QString & apiKey);
     static bool isApiAuthEnabled();
     static void setIsApiAuthEnabled(bool isEnabled);
+    static bool isApiUdpEnabled();
+    static int getApiUdpPort();
+    static bool isApiLocalSocketEnabled();
+    static QString getApiLocalSocketName();
     static bool isExpertModeEnabled();
     static void setExpertModeEnabled(bool isEnabled);
     static bool isKeepLightsOnAfterExit();
     static void setKeepLightsOnAfterExit(bool isEnabled);
     static bool isPingDeviceEverySecond();
     static void setPingDeviceEverySecond(bool isEnabled);
+    static bool isSharedMemoryEnabled();
+    static bool isTemporalDitheringEnabled();
+    static bool isHostSmoothingEnabled();
     static bool isUpdateFirmwareMessageShown();
     static void setUpdateFirmwareMessageShown(bool isShown);
     static SupportedDevices::DeviceType getConnectedDevice();
@@ -101,10 +108,29 @@ public:
     static void setAdalightSerialPortName(const QString & port);
     static QString getAdalightSerialPortBaudRate();
     static void setAdalightSerialPortBaudRate(const QString & baud);
+    static int getLightpackWriteQueueDepth();
+    static QString getLightpackSmoothCurve();
+    static bool isAdalightDeltaProtocolEnabled();
+    static void setAdalightDeltaProtocolEnabled(bool isEnabled);
     static QString getArdulightSerialPortName();
     static void setArdulightSerialPortName(const QString & port);
     static QString getArdulightSerialPortBaudRate();
     static void setArdulightSerialPortBaudRate(const QString & baud);
+    static QString getUdpHost();
+    static void setUdpHost(const QString & host);
+    static int getUdpPort();
+    static void setUdpPort(int port);
+    static int getUdpMtu();
+    static QString getE131Protocol();
+    static void setE131Protocol(const QString & protocol);
+    static QString getE131Host();
+    static void setE131Host(const QString & host);
+    static int getE131Universe();
+    static void setE131Universe(int universe);
+    static int getE131StartAddress();
+    static void setE131StartAddress(int address);
+    static bool isE131SyncEnabled();
+    static int getE131SyncUniverse();
     static QStringList getSupportedSerialPortBaudRates();
     static bool isConnectedDeviceUsesSerialPort();
     // [Adalight | Ardulight | Lightpack | ... | Virtual]
@@ -222,6 +248,8 @@ signals:
     void paintpackNumberOfLedsChanged(int numberOfLeds);
     void adalightNumberOfLedsChanged(int numberOfLeds);
     void ardulightNumberOfLedsChanged(int numberOfLeds);
+    void udpNumberOfLedsChanged(int numberOfLeds);
+    void e131NumberOfLedsChanged(int numberOfLeds);
     void virtualNumberOfLedsChanged(int numberOfLeds);
     void grabSlowdownChanged(int value);
     void backlightEnabledChanged(bool isEnabled);
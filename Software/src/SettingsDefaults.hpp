@@ -32,9 +32,9 @@
 #include "enums.hpp"
 
 #ifdef ALIEN_FX_SUPPORTED
-#   define SUPPORTED_DEVICES            "Lightpack,Paintpack,AlienFx,Adalight,Ardulight,Virtual"
+#   define SUPPORTED_DEVICES            "Lightpack,Paintpack,AlienFx,Adalight,Ardulight,Udp,E131,Virtual"
 #else
-#   define SUPPORTED_DEVICES            "Lightpack,Paintpack,Adalight,Ardulight,Virtual"
+#   define SUPPORTED_DEVICES            "Lightpack,Paintpack,Adalight,Ardulight,Udp,E131,Virtual"
 #endif
 
 #ifdef WINAPI_GRAB_SUPPORT
@@ -70,6 +70,9 @@ static const Debug::DebugLevels DebugLevelDefault = Debug::LowLevel;
 static const bool IsExpertModeEnabledDefault = false;
 static const bool IsKeepLightsOnAfterExit = true;
 static const bool IsPingDeviceEverySecond = true;
+static const bool IsSharedMemoryEnabled = true;
+static const bool IsTemporalDitheringEnabled = true;
+static const bool IsHostSmoothingEnabled = false; /* smooth slowdown for devices without firmware smoothing */
 static const bool IsUpdateFirmwareMessageShown = false;
 static const QString ConnectedDeviceDefault = "Lightpack";
 static const QString SupportedDevices = SUPPORTED_DEVICES; /* comma separated values! */
@@ -87,6 +90,13 @@ static const bool IsEnabledDefault = true;
 static const int PortDefault = 3636;
 static const bool IsAuthEnabledDefault = true;
 // See ApiKey generation in Settings initialization
+// Frames over UDP, see getudpsession command of the API
+static const bool IsUdpEnabledDefault = false;
+static const int UdpPortDefault = 3637;
+// Same API for local clients, authorized by peer credentials on Linux.
+// Socket is in the user's runtime dir, see ApiServer::localSocketPath()
+static const bool IsLocalSocketEnabledDefault = true;
+static const QString LocalSocketNameDefault = "lightpack-api";
 }
 namespace Adalight
 {
@@ -94,6 +104,8 @@ static const int NumberOfLedsDefault = 25;
 static const QString ColorSequence = "RGB";
 static const QString PortDefault = SERIAL_PORT_DEFAULT;
 static const QString BaudRateDefault = "115200";
+// "Adz" protocol needs the delta decoder sketch on the device
+static const bool IsDeltaProtocolEnabledDefault = false;
 }
 namespace Ardulight
 {
@@ -109,11 +121,35 @@ static const int NumberOfLedsDefault = 1;
 namespace Lightpack
 {
 static const int NumberOfLedsDefault = 10;
+// Number of frames on the bus, 0 - blocking writes
+static const int WriteQueueDepthDefault = 2;
+static const int WriteQueueDepthMax = 8;
+// Curve of firmware smooth change: "linear", "ease-out" or "exponential"
+static const QString SmoothCurveDefault = "linear";
 }
 namespace Paintpack
 {
 static const int NumberOfLedsDefault = 10;
 }
+namespace Udp
+{
+static const int NumberOfLedsDefault = 60;
+static const QString HostDefault = "192.168.4.1"; /* ESP soft AP */
+static const int PortDefault = 4048;
+static const int MtuDefault = 1500;
+}
+namespace E131
+{
+static const QString ProtocolE131 = "E1.31";
+static const QString ProtocolArtNet = "Art-Net";
+static const int NumberOfLedsDefault = 170;
+static const QString ProtocolDefault = ProtocolE131;
+static const QString HostDefault = ""; /* multicast for E1.31, broadcast for Art-Net */
+static const int UniverseDefault = 1;
+static const int StartAddressDefault = 1;
+static const bool IsSyncEnabledDefault = true;
+static const int SyncUniverseDefault = 0; /* first universe */
+}
 namespace Virtual
 {
 static const int NumberOfLedsDefault = 10;
@@ -33,6 +33,7 @@
 #include "SpeedTest.hpp"
 #include "ColorButton.hpp"
 #include "LedDeviceManager.hpp"
+#include "DmxNetworkSender.hpp"
 #include "enums.hpp"
 #include "debug.h"
 
@@ -217,6 +218,12 @@ void SettingsWindow::connectSignalsSlots()
     connect(ui->comboBox_AdalightSerialPortBaudRate, SIGNAL(currentIndexChanged(QString)), this, SLOT(onAdalightSerialPortBaudRate_valueChanged(QString)));
     connect(ui->lineEdit_ArdulightSerialPort, SIGNAL(editingFinished()), this, SLOT(onArdulightSerialPort_editingFinished()));
     connect(ui->comboBox_ArdulightSerialPortBaudRate, SIGNAL(currentIndexChanged(QString)), this, SLOT(onArdulightSerialPortBaudRate_valueChanged(QString)));
+    connect(ui->lineEdit_UdpHost, SIGNAL(editingFinished()), this, SLOT(onUdpHost_editingFinished()));
+    connect(ui->spinBox_UdpPort, SIGNAL(editingFinished()), this, SLOT(onUdpPort_editingFinished()));
+    connect(ui->comboBox_E131Protocol, SIGNAL(currentIndexChanged(QString)), this, SLOT(onE131Protocol_valueChanged(QString)));
+    connect(ui->lineEdit_E131Host, SIGNAL(editingFinished()), this, SLOT(onE131Host_editingFinished()));
+    connect(ui->spinBox_E131Universe, SIGNAL(editingFinished()), this, SLOT(onE131Universe_editingFinished()));
+    connect(ui->spinBox_E131StartAddress, SIGNAL(editingFinished()), this, SLOT(onE131StartAddress_editingFinished()));
     connect(ui->doubleSpinBox_DeviceGamma, SIGNAL(valueChanged(double)), this, SLOT(onDeviceGammaCorrection_valueChanged(double)));
     connect(ui->horizontalSlider_GammaCorrection, SIGNAL(valueChanged(int)), this, SLOT(onSliderDeviceGammaCorrection_valueChanged(int)));
     connect(ui->checkBox_SendDataOnlyIfColorsChanges, SIGNAL(toggled(bool)), this, SLOT(onDeviceSendDataOnlyIfColorsChanged_toggled(bool)));
@@ -226,6 +233,8 @@ void SettingsWindow::connectSignalsSlots()
     connect(ui->spinBox_PaintpackNumberOfLeds, SIGNAL(valueChanged(int)), this, SLOT(onPaintpackNumberOfLeds_valueChanged(int)));
     connect(ui->spinBox_AdalightNumberOfLeds, SIGNAL(valueChanged(int)), this, SLOT(onAdalightNumberOfLeds_valueChanged(int)));
     connect(ui->spinBox_ArdulightNumberOfLeds, SIGNAL(valueChanged(int)), this, SLOT(onArdulightNumberOfLeds_valueChanged(int)));
+    connect(ui->spinBox_UdpNumberOfLeds, SIGNAL(valueChanged(int)), this, SLOT(onUdpNumberOfLeds_valueChanged(int)));
+    connect(ui->spinBox_E131NumberOfLeds, SIGNAL(valueChanged(int)), this, SLOT(onE131NumberOfLeds_valueChanged(int)));
     connect(ui->spinBox_VirtualNumberOfLeds, SIGNAL(valueChanged(int)), this, SLOT(onVirtualNumberOfLeds_valueChanged(int)));
 
     // Open Settings file
@@ -431,6 +440,16 @@ void SettingsWindow::updateDeviceTabWidgetsVisibility()
         ui->groupBox_DeviceSpecificSettings->hide();
         break;
 
+    case SupportedDevices::DeviceTypeUdp:
+        ui->groupBox_DeviceSpecificSettings->show();
+        ui->tabDevices->setCurrentWidget(ui->tabDeviceUdp);
+        break;
+
+    case SupportedDevices::DeviceTypeE131:
+        ui->groupBox_DeviceSpecificSettings->show();
+        ui->tabDevices->setCurrentWidget(ui->tabDeviceE131);
+        break;
+
     case SupportedDevices::DeviceTypeLightpack:
         ui->groupBox_DeviceSpecificSettings->show();
         ui->tabDevices->setCurrentWidget(ui->tabDeviceLightpack);
@@ -1178,6 +1197,20 @@ void SettingsWindow::onArdulightNumberOfLeds_valueChanged(int value)
 
 }
 
+void SettingsWindow::onUdpNumberOfLeds_valueChanged(int value)
+{
+    DEBUG_LOW_LEVEL << Q_FUNC_INFO << value;
+
+    Settings::setNumberOfLeds(SupportedDevices::DeviceTypeUdp, value);
+}
+
+void SettingsWindow::onE131NumberOfLeds_valueChanged(int value)
+{
+    DEBUG_LOW_LEVEL << Q_FUNC_INFO << value;
+
+    Settings::setNumberOfLeds(SupportedDevices::DeviceTypeE131, value);
+}
+
 void SettingsWindow::onVirtualNumberOfLeds_valueChanged(int value)
 {
     DEBUG_LOW_LEVEL << Q_FUNC_INFO << value;
@@ -1228,6 +1261,100 @@ void SettingsWindow::onArdulightSerialPortBaudRate_valueChanged(QString value)
         emit recreateLedDevice();
 }
 
+void SettingsWindow::onUdpHost_editingFinished()
+{
+    QString host = ui->lineEdit_UdpHost->text().trimmed();
+    DEBUG_LOW_LEVEL << Q_FUNC_INFO << host;
+
+    if (host == Settings::getUdpHost())
+        return;
+
+    Settings::setUdpHost(host);
+
+    if (Settings::getConnectedDevice() == SupportedDevices::DeviceTypeUdp)
+        emit recreateLedDevice();
+}
+
+void SettingsWindow::onUdpPort_editingFinished()
+{
+    int port = ui->spinBox_UdpPort->value();
+    DEBUG_LOW_LEVEL << Q_FUNC_INFO << port;
+
+    if (port == Settings::getUdpPort())
+        return;
+
+    Settings::setUdpPort(port);
+
+    if (Settings::getConnectedDevice() == SupportedDevices::DeviceTypeUdp)
+        emit recreateLedDevice();
+}
+
+void SettingsWindow::onE131Protocol_valueChanged(QString value)
+{
+    DEBUG_LOW_LEVEL << Q_FUNC_INFO << value;
+
+    if (value == Settings::getE131Protocol())
+        return;
+
+    Settings::setE131Protocol(value);
+
+    updateE131UniverseRange();
+
+    if (Settings::getConnectedDevice() == SupportedDevices::DeviceTypeE131)
+        emit recreateLedDevice();
+}
+
+void SettingsWindow::updateE131UniverseRange()
+{
+    DmxNetworkSender::Protocol protocol = (Settings::getE131Protocol() == Main::E131::ProtocolArtNet)
+            ? DmxNetworkSender::ProtocolArtNet : DmxNetworkSender::ProtocolE131;
+
+    ui->spinBox_E131Universe->setRange(DmxNetworkSender::minUniverse(protocol), DmxNetworkSender::maxUniverse(protocol));
+    ui->spinBox_E131Universe->setValue(Settings::getE131Universe());
+}
+
+void SettingsWindow::onE131Host_editingFinished()
+{
+    QString host = ui->lineEdit_E131Host->text().trimmed();
+    DEBUG_LOW_LEVEL << Q_FUNC_INFO << host;
+
+    if (host == Settings::getE131Host())
+        return;
+
+    Settings::setE131Host(host);
+
+    if (Settings::getConnectedDevice() == SupportedDevices::DeviceTypeE131)
+        emit recreateLedDevice();
+}
+
+void SettingsWindow::onE131Universe_editingFinished()
+{
+    int universe = ui->spinBox_E131Universe->value();
+    DEBUG_LOW_LEVEL << Q_FUNC_INFO << universe;
+
+    if (universe == Settings::getE131Universe())
+        return;
+
+    Settings::setE131Universe(universe);
+
+    if (Settings::getConnectedDevice() == SupportedDevices::DeviceTypeE131)
+        emit recreateLedDevice();
+}
+
+void SettingsWindow::onE131StartAddress_editingFinished()
+{
+    int address = ui->spinBox_E131StartAddress->value();
+    DEBUG_LOW_LEVEL << Q_FUNC_INFO << address;
+
+    if (address == Settings::getE131StartAddress())
+        return;
+
+    Settings::setE131StartAddress(address);
+
+    if (Settings::getConnectedDevice() == SupportedDevices::DeviceTypeE131)
+        emit recreateLedDevice();
+}
+
 void SettingsWindow::onColorSequence_valueChanged(QString value)
 {
     DEBUG_LOW_LEVEL << Q_FUNC_INFO << value;
@@ -1835,6 +1962,8 @@ void SettingsWindow::updateUiFromSettings()
     ui->spinBox_PaintpackNumberOfLeds->setValue         (Settings::getNumberOfLeds(SupportedDevices::DeviceTypePaintpack));
     ui->spinBox_AdalightNumberOfLeds->setValue          (Settings::getNumberOfLeds(SupportedDevices::DeviceTypeAdalight));
     ui->spinBox_ArdulightNumberOfLeds->setValue         (Settings::getNumberOfLeds(SupportedDevices::DeviceTypeArdulight));
+    ui->spinBox_UdpNumberOfLeds->setValue               (Settings::getNumberOfLeds(SupportedDevices::DeviceTypeUdp));
+    ui->spinBox_E131NumberOfLeds->setValue              (Settings::getNumberOfLeds(SupportedDevices::DeviceTypeE131));
     ui->spinBox_VirtualNumberOfLeds->setValue           (Settings::getNumberOfLeds(SupportedDevices::DeviceTypeVirtual));
     ui->horizontalSlider_DeviceRefreshDelay->setValue   (Settings::getDeviceRefreshDelay());
     ui->horizontalSlider_DeviceBrightness->setValue     (Settings::getDeviceBrightness());
@@ -1844,6 +1973,12 @@ void SettingsWindow::updateUiFromSettings()
     ui->horizontalSlider_GammaCorrection->setValue      (floor((Settings::getDeviceGamma() * 100 + 0.5)));
     ui->lineEdit_AdalightSerialPort->setText            (Settings::getAdalightSerialPortName());
     ui->lineEdit_ArdulightSerialPort->setText           (Settings::getArdulightSerialPortName());
+    ui->lineEdit_UdpHost->setText                       (Settings::getUdpHost());
+    ui->spinBox_UdpPort->setValue                       (Settings::getUdpPort());
+    ui->comboBox_E131Protocol->setCurrentIndex          (ui->comboBox_E131Protocol->findText(Settings::getE131Protocol()));
+    ui->lineEdit_E131Host->setText                      (Settings::getE131Host());
+    updateE131UniverseRange();
+    ui->spinBox_E131StartAddress->setValue              (Settings::getE131StartAddress());
 
     ui->groupBox_Api->setChecked                        (Settings::isApiEnabled());
     ui->lineEdit_ApiPort->setText                       (QString::number(Settings::getApiPort()));
@@ -150,11 +150,19 @@ private slots:
     void onPaintpackNumberOfLeds_valueChanged(int value);
     void onAdalightNumberOfLeds_valueChanged(int value);
     void onArdulightNumberOfLeds_valueChanged(int value);
+    void onUdpNumberOfLeds_valueChanged(int value);
+    void onE131NumberOfLeds_valueChanged(int value);
     void onVirtualNumberOfLeds_valueChanged(int value);
     void onAdalightSerialPort_editingFinished();
     void onAdalightSerialPortBaudRate_valueChanged(QString value);
     void onArdulightSerialPort_editingFinished();
     void onArdulightSerialPortBaudRate_valueChanged(QString value);
+    void onUdpHost_editingFinished();
+    void onUdpPort_editingFinished();
+    void onE131Protocol_valueChanged(QString value);
+    void onE131Host_editingFinished();
+    void onE131Universe_editingFinished();
+    void onE131StartAddress_editingFinished();
     void onDeviceGammaCorrection_valueChanged(double value);
     void onSliderDeviceGammaCorrection_valueChanged(int value);
     void onDeviceSendDataOnlyIfColorsChanged_toggled(bool state);
@@ -214,6 +222,7 @@ private:
     void updateExpertModeWidgetsVisibility();
     void updateDeviceTabWidgetsVisibility();
     void setDeviceTabWidgetsVisibility(DeviceTab::Options options);
+    void updateE131UniverseRange();
     void syncLedDeviceWithSettingsWindow();
     MaximumNumberOfLeds::Devices getLightpackMaximumNumberOfLeds();
     int getLigtpackFirmwareVersionMajor();
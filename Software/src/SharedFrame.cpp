@@ -0,0 +1,342 @@
+/*
+ * SharedFrame.cpp
+ *
+ *  Created on: 19.10.2026
+ *     Project: Lightpack
+ *
+ *  Lightpack is very simple implementation of the backlight for a laptop
+ *
+ *  Copyright (c) 2011 Mike Shatohin, mikeshatohin [at] gmail.com
+ *
+ *  Lightpack is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Lightpack is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "SharedFrame.hpp"
+#include "debug.h"
+
+#ifdef Q_OS_LINUX
+#   include <string.h>
+#   include <errno.h>
+#   include <limits.h>
+#   include <time.h>
+#   include <fcntl.h>
+#   include <unistd.h>
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#   include <sys/syscall.h>
+#   include <linux/futex.h>
+#endif
+
+const char * SharedFrame::DefaultName = "/prismatik-leds";
+const char SharedFrame::Magic[4] = { 'L', 'P', 'L', 'S' };
+const quint32 SharedFrame::Version = 1;
+const int SharedFrame::DefaultCapacity = 4096;
+
+// Copy attempts while the writer is changing the frame
+static const int ReadRetriesCount = 100;
+
+#ifdef Q_OS_LINUX
+static quint32 loadSequence(const SharedFrame::Header * header)
+{
+    quint32 sequence = *(volatile const quint32 *)&header->sequence;
+    __sync_synchronize();
+    return sequence;
+}
+
+static void storeSequence(SharedFrame::Header * header, quint32 sequence)
+{
+    __sync_synchronize();
+    *(volatile quint32 *)&header->sequence = sequence;
+    __sync_synchronize();
+}
+#endif
+
+SharedFramePublisher::SharedFramePublisher()
+{
+    m_descriptor = -1;
+    m_header = NULL;
+    m_colors = NULL;
+    m_size = 0;
+}
+
+SharedFramePublisher::~SharedFramePublisher()
+{
+    close();
+}
+
+SharedFramePublisher * SharedFramePublisher::instance()
+{
+    static SharedFramePublisher publisher;
+    return &publisher;
+}
+
+bool SharedFramePublisher::open(const QString & name, int capacity)
+{
+    DEBUG_LOW_LEVEL << Q_FUNC_INFO << name << capacity;
+
+    close();
+
+#ifdef Q_OS_LINUX
+    m_name = name;
+    m_size = sizeof(SharedFrame::Header) + capacity * sizeof(quint32);
+
+    // Readers map it read-only
+    m_descriptor = shm_open(m_name.toLocal8Bit().constData(), O_CREAT | O_RDWR, 0644);
+
+    if (m_descriptor < 0)
+    {
+        qWarning() << Q_FUNC_INFO << "shm_open fail:" << m_name << strerror(errno);
+        return false;
+    }
+
+    void *map = MAP_FAILED;
+
+    if (ftruncate(m_descriptor, m_size) == 0)
+        map = mmap(NULL, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, m_descriptor, 0);
+
+    if (map == MAP_FAILED)
+    {
+        qWarning() << Q_FUNC_INFO << "map fail:" << m_name << strerror(errno);
+        close();
+        return false;
+    }
+
+    m_header = (SharedFrame::Header *)map;
+    m_colors = (quint32 *)((char *)map + sizeof(SharedFrame::Header));
+
+    memset(map, 0, m_size);
+    m_header->version = SharedFrame::Version;
+    m_header->capacity = capacity;
+    m_header->headerSize = sizeof(SharedFrame::Header);
+
+    // Readers check magic last
+    __sync_synchronize();
+    memcpy(m_header->magic, SharedFrame::Magic, sizeof(m_header->magic));
+
+    return true;
+#else
+    Q_UNUSED(capacity);
+    qWarning() << Q_FUNC_INFO << "shared memory output is not supported on this system";
+    return false;
+#endif
+}
+
+void SharedFramePublisher::close()
+{
+#ifdef Q_OS_LINUX
+    if (m_header != NULL)
+    {
+        munmap(m_header, m_size);
+        m_header = NULL;
+        m_colors = NULL;
+    }
+
+    if (m_descriptor >= 0)
+    {
+        ::close(m_descriptor);
+        m_descriptor = -1;
+
+        // Mapped readers keep the old segment until they reopen
+        shm_unlink(m_name.toLocal8Bit().constData());
+    }
+#endif
+}
+
+void SharedFramePublisher::publish(const QList<StructRgb> & colors, int bitsPerChannel)
+{
+#ifdef Q_OS_LINUX
+    if (m_header == NULL)
+        return;
+
+    int count = qMin(colors.count(), (int)m_header->capacity);
+    int shift = bitsPerChannel - 8;
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    quint32 sequence = m_header->sequence;
+    storeSequence(m_header, sequence + 1);
+
+    for (int i = 0; i < count; i++)
+    {
+        const StructRgb & color = colors[i];
+        m_colors[i] = qRgb(color.r >> shift, color.g >> shift, color.b >> shift) & 0xffffff;
+    }
+
+    m_header->ledsCount = count;
+    m_header->timestamp = (quint64)now.tv_sec * 1000000000 + now.tv_nsec;
+
+    storeSequence(m_header, sequence + 2);
+
+    // Shared futex, readers are in other processes
+    syscall(SYS_futex, &m_header->sequence, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+#else
+    Q_UNUSED(colors);
+    Q_UNUSED(bitsPerChannel);
+#endif
+}
+
+SharedFrameReader::SharedFrameReader()
+{
+    m_header = NULL;
+    m_colors = NULL;
+    m_size = 0;
+}
+
+SharedFrameReader::~SharedFrameReader()
+{
+    close();
+}
+
+bool SharedFrameReader::open(const QString & name)
+{
+    close();
+
+#ifdef Q_OS_LINUX
+    int descriptor = shm_open(name.toLocal8Bit().constData(), O_RDONLY, 0);
+
+    if (descriptor < 0)
+    {
+        DEBUG_LOW_LEVEL << Q_FUNC_INFO << "shm_open fail:" << name << strerror(errno);
+        return false;
+    }
+
+    struct stat info;
+    void *map = MAP_FAILED;
+
+    if (fstat(descriptor, &info) == 0 && info.st_size >= (off_t)sizeof(SharedFrame::Header))
+        map = mmap(NULL, info.st_size, PROT_READ, MAP_SHARED, descriptor, 0);
+
+    // Mapping stays valid without the descriptor
+    ::close(descriptor);
+
+    if (map == MAP_FAILED)
+    {
+        DEBUG_LOW_LEVEL << Q_FUNC_INFO << "map fail:" << name;
+        return false;
+    }
+
+    const SharedFrame::Header *header = (const SharedFrame::Header *)map;
+
+    if (memcmp(header->magic, SharedFrame::Magic, sizeof(header->magic)) != 0
+            || header->version != SharedFrame::Version
+            || header->headerSize + header->capacity * sizeof(quint32) > (size_t)info.st_size)
+    {
+        DEBUG_LOW_LEVEL << Q_FUNC_INFO << "wrong segment format:" << name;
+        munmap(map, info.st_size);
+        return false;
+    }
+
+    m_header = header;
+    m_colors = (const quint32 *)((const char *)map + header->headerSize);
+    m_size = info.st_size;
+
+    return true;
+#else
+    Q_UNUSED(name);
+    return false;
+#endif
+}
+
+void SharedFrameReader::close()
+{
+#ifdef Q_OS_LINUX
+    if (m_header != NULL)
+        munmap((void *)m_header, m_size);
+#endif
+    m_header = NULL;
+    m_colors = NULL;
+}
+
+quint32 SharedFrameReader::sequence() const
+{
+#ifdef Q_OS_LINUX
+    if (m_header != NULL)
+        return loadSequence(m_header);
+#endif
+    return 0;
+}
+
+bool SharedFrameReader::read(QList<QRgb> & colors, quint32 * sequence, quint64 * timestamp) const
+{
+#ifdef Q_OS_LINUX
+    if (m_header == NULL)
+        return false;
+
+    for (int attempt = 0; attempt < ReadRetriesCount; attempt++)
+    {
+        quint32 before = loadSequence(m_header);
+
+        if (before & 1)
+            continue;
+
+        int count = qMin(m_header->ledsCount, m_header->capacity);
+        quint64 frameTimestamp = m_header->timestamp;
+
+        while (colors.count() > count)
+            colors.removeLast();
+        while (colors.count() < count)
+            colors.append(0);
+
+        for (int i = 0; i < count; i++)
+            colors[i] = m_colors[i];
+
+        if (loadSequence(m_header) != before)
+            continue;
+
+        if (sequence != NULL)
+            *sequence = before;
+        if (timestamp != NULL)
+            *timestamp = frameTimestamp;
+
+        return true;
+    }
+#else
+    Q_UNUSED(colors);
+    Q_UNUSED(sequence);
+    Q_UNUSED(timestamp);
+#endif
+    return false;
+}
+
+bool SharedFrameReader::waitForFrame(quint32 lastSequence, int timeoutMs) const
+{
+#ifdef Q_OS_LINUX
+    if (m_header == NULL)
+        return false;
+
+    struct timespec timeout;
+    timeout.tv_sec = timeoutMs / 1000;
+    timeout.tv_nsec = (timeoutMs % 1000) * 1000000;
+
+    for (;;)
+    {
+        quint32 current = loadSequence(m_header);
+
+        if (current != lastSequence && (current & 1) == 0)
+            return true;
+
+        // Returns at once if the sequence is already changed, writer wakes
+        // readers when the frame is complete
+        if (syscall(SYS_futex, &m_header->sequence, FUTEX_WAIT, current, &timeout, NULL, 0) != 0
+                && errno == ETIMEDOUT)
+            return false;
+    }
+#else
+    Q_UNUSED(lastSequence);
+    Q_UNUSED(timeoutMs);
+    return false;
+#endif
+}
@@ -0,0 +1,120 @@
+/*
+ * SharedFrame.hpp
+ *
+ *  Created on: 19.10.2026
+ *     Project: Lightpack
+ *
+ *  Lightpack is very simple implementation of the backlight for a laptop
+ *
+ *  Copyright (c) 2011 Mike Shatohin, mikeshatohin [at] gmail.com
+ *
+ *  Lightpack is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Lightpack is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <QString>
+#include <QList>
+#include <QColor>
+
+#include "StructRgb.hpp"
+
+/*!
+  LED colors after gamma and brightness correction, published to the POSIX
+  shared memory segment "/prismatik-leds". Local tools follow the LEDs by
+  reading the segment, without API requests.
+
+  Segment (host byte order):
+    0..3    magic "LPLS"
+    4..7    format version
+    8..11   capacity, maximum LEDs count
+    12..15  header size, offset of the colors
+    16..19  sequence, odd while the frame is written
+    20..23  LEDs count
+    24..31  CLOCK_MONOTONIC timestamp of the frame, nsecs
+    32..    colors, 0x00RRGGBB, 8 bits per channel
+
+  Reader copies the frame when the sequence is even and repeats the copy if
+  the sequence is changed after it (seqlock). To sleep until the next frame
+  reader calls FUTEX_WAIT on the sequence word, it is woken after each frame.
+  Segment is read-only for readers, writer never waits for them.
+
+  Linux only, on other systems open() fails.
+*/
+namespace SharedFrame
+{
+struct Header
+{
+    char magic[4];
+    quint32 version;
+    quint32 capacity;
+    quint32 headerSize;
+    quint32 sequence;
+    quint32 ledsCount;
+    quint64 timestamp;
+};
+
+extern const char * DefaultName;
+extern const char Magic[4];
+extern const quint32 Version;
+extern const int DefaultCapacity;
+}
+
+class SharedFramePublisher
+{
+public:
+    SharedFramePublisher();
+    ~SharedFramePublisher();
+
+    // Publisher of the application, devices publish to it
+    static SharedFramePublisher * instance();
+
+    bool open(const QString & name = SharedFrame::DefaultName, int capacity = SharedFrame::DefaultCapacity);
+    void close();
+    bool isOpen() const { return m_header != NULL; }
+
+    // Lightpack keeps 12 bits per channel, other devices 8 bits
+    void publish(const QList<StructRgb> & colors, int bitsPerChannel = 8);
+
+private:
+    QString m_name;
+    int m_descriptor;
+    SharedFrame::Header *m_header;
+    quint32 *m_colors;
+    size_t m_size;
+};
+
+class SharedFrameReader
+{
+public:
+    SharedFrameReader();
+    ~SharedFrameReader();
+
+    bool open(const QString & name = SharedFrame::DefaultName);
+    void close();
+    bool isOpen() const { return m_header != NULL; }
+
+    // Returns false if the frame is written too often to get a consistent copy
+    bool read(QList<QRgb> & colors, quint32 * sequence = NULL, quint64 * timestamp = NULL) const;
+
+    // Waits until the sequence differs from lastSequence
+    bool waitForFrame(quint32 lastSequence, int timeoutMs) const;
+    quint32 sequence() const;
+
+private:
+    const SharedFrame::Header *m_header;
+    const quint32 *m_colors;
+    size_t m_size;
+};
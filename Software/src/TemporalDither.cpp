@@ -0,0 +1,160 @@
+/*
+ * TemporalDither.cpp
+ *
+ *  Created on: 19.10.2026
+ *     Project: Lightpack
+ *
+ *  Lightpack is very simple implementation of the backlight for a laptop
+ *
+ *  Copyright (c) 2011 Mike Shatohin, mikeshatohin [at] gmail.com
+ *
+ *  Lightpack is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Lightpack is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TemporalDither.hpp"
+
+const int TemporalDither::InputBits = 12;
+const int TemporalDither::OutputBits = 8;
+
+static const int Shift = TemporalDither::InputBits - TemporalDither::OutputBits;
+static const unsigned RemainderMask = (1 << Shift) - 1;
+static const unsigned OutputMax = (1 << TemporalDither::OutputBits) - 1;
+
+static inline unsigned ditherChannel(unsigned value, quint8 * error)
+{
+    unsigned sum = value + *error;
+    unsigned result = sum >> Shift;
+
+    if (result > OutputMax)
+    {
+        *error = 0;
+        return OutputMax;
+    }
+
+    *error = sum & RemainderMask;
+    return result;
+}
+
+static bool isSameFrame(const QList<StructRgb> & a, const QList<StructRgb> & b)
+{
+    if (a.count() != b.count())
+        return false;
+
+    for (int i = 0; i < a.count(); i++)
+    {
+        if (a[i].r != b[i].r || a[i].g != b[i].g || a[i].b != b[i].b)
+            return false;
+    }
+
+    return true;
+}
+
+TemporalDither::TemporalDither()
+{
+    m_isEnabled = true;
+    m_isCommitDeferred = false;
+    m_isHoldingUnchangedFrames = false;
+    m_hasPendingErrors = false;
+}
+
+void TemporalDither::setEnabled(bool isEnabled)
+{
+    m_isEnabled = isEnabled;
+    reset();
+}
+
+void TemporalDither::reset()
+{
+    m_errors.fill(0);
+    m_hasPendingErrors = false;
+    m_lastInput.clear();
+    m_lastOutput.clear();
+}
+
+void TemporalDither::setCommitDeferred(bool isDeferred)
+{
+    m_isCommitDeferred = isDeferred;
+    reset();
+}
+
+void TemporalDither::commit()
+{
+    if (m_hasPendingErrors == false)
+        return;
+
+    // Buffers are swapped, next apply() overwrites the pending one
+    qSwap(m_errors, m_pendingErrors);
+    m_hasPendingErrors = false;
+}
+
+void TemporalDither::setHoldUnchangedFrames(bool isHold)
+{
+    m_isHoldingUnchangedFrames = isHold;
+    reset();
+}
+
+void TemporalDither::apply(QList<StructRgb> & colors)
+{
+    int count = colors.count();
+
+    if (m_isEnabled == false)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            StructRgb & color = colors[i];
+
+            color.r = qMin(color.r >> Shift, OutputMax);
+            color.g = qMin(color.g >> Shift, OutputMax);
+            color.b = qMin(color.b >> Shift, OutputMax);
+        }
+        return;
+    }
+
+    if (m_isHoldingUnchangedFrames)
+    {
+        if (isSameFrame(colors, m_lastInput))
+        {
+            colors = m_lastOutput;
+            return;
+        }
+        m_lastInput = colors;
+    }
+
+    // Remainders of other LEDs make no sense after the layout is changed
+    if (m_errors.count() != count * 3)
+        m_errors.fill(0, count * 3);
+
+    m_pendingErrors.resize(count * 3);
+    qCopy(m_errors.constBegin(), m_errors.constEnd(), m_pendingErrors.begin());
+
+    quint8 *error = m_pendingErrors.data();
+
+    for (int i = 0; i < count; i++)
+    {
+        StructRgb & color = colors[i];
+
+        color.r = ditherChannel(color.r, error++);
+        color.g = ditherChannel(color.g, error++);
+        color.b = ditherChannel(color.b, error++);
+    }
+
+    m_hasPendingErrors = true;
+
+    if (m_isHoldingUnchangedFrames)
+        m_lastOutput = colors;
+
+    if (m_isCommitDeferred == false)
+        commit();
+}
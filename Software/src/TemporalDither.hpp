@@ -0,0 +1,76 @@
+/*
+ * TemporalDither.hpp
+ *
+ *  Created on: 19.10.2026
+ *     Project: Lightpack
+ *
+ *  Lightpack is very simple implementation of the backlight for a laptop
+ *
+ *  Copyright (c) 2011 Mike Shatohin, mikeshatohin [at] gmail.com
+ *
+ *  Lightpack is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Lightpack is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <QList>
+#include <QVector>
+#include "StructRgb.hpp"
+
+/*!
+  Temporal error diffusion of 12-bit colors to 8-bit output.
+
+  Low bits dropped by the conversion are kept per LED channel and added to
+  the same channel in the next frame, so on average the LED shows 12-bit
+  value. At high frame rates it hides banding of dark colors after gamma.
+
+  When frames may be dropped after apply(), commit is deferred: remainders
+  of the last applied frame are carried only when commit() is called for the
+  frame which was actually sent.
+*/
+class TemporalDither
+{
+public:
+    TemporalDither();
+
+    // Disabled dither only truncates colors to 8 bits
+    void setEnabled(bool isEnabled);
+    bool isEnabled() const { return m_isEnabled; }
+    void reset();
+
+    // Colors are 0..4095 on input and 0..255 on output
+    void apply(QList<StructRgb> & colors);
+
+    void setCommitDeferred(bool isDeferred);
+    void commit();
+
+    // Unchanged input gets previous output, so delta protocols can skip it
+    void setHoldUnchangedFrames(bool isHold);
+
+    static const int InputBits;
+    static const int OutputBits;
+
+private:
+    bool m_isEnabled;
+    bool m_isCommitDeferred;
+    bool m_isHoldingUnchangedFrames;
+    // Remainders of r, g, b for each LED
+    QVector<quint8> m_errors;
+    // Remainders of the last applied frame, waiting for commit()
+    QVector<quint8> m_pendingErrors;
+    bool m_hasPendingErrors;
+    QList<StructRgb> m_lastInput;
+    QList<StructRgb> m_lastOutput;
+};
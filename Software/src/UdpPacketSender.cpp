@@ -0,0 +1,237 @@
+/*
+ * UdpPacketSender.cpp
+ *
+ *  Created on: 19.10.2026
+ *     Project: Lightpack
+ *
+ *  Lightpack is very simple implementation of the backlight for a laptop
+ *
+ *  Copyright (c) 2011 Mike Shatohin, mikeshatohin [at] gmail.com
+ *
+ *  Lightpack is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Lightpack is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <QUdpSocket>
+#include <QHostInfo>
+
+#include "UdpPacketSender.hpp"
+#include "debug.h"
+
+#ifdef Q_OS_LINUX
+#   include <string.h>
+#   include <errno.h>
+#   include <arpa/inet.h>
+#endif
+
+UdpPacketSender::UdpPacketSender()
+{
+    m_socket = NULL;
+    m_packetCapacity = 0;
+}
+
+UdpPacketSender::~UdpPacketSender()
+{
+    close();
+}
+
+bool UdpPacketSender::open()
+{
+    close();
+
+    m_socket = new QUdpSocket();
+
+    // Bound socket has native descriptor which is used by sendmmsg()
+    if (m_socket->bind(QHostAddress::Any, 0) == false)
+    {
+        qWarning() << Q_FUNC_INFO << "bind fail:" << m_socket->errorString();
+        close();
+        return false;
+    }
+
+    DEBUG_LOW_LEVEL << Q_FUNC_INFO << "local port:" << m_socket->localPort();
+    return true;
+}
+
+void UdpPacketSender::close()
+{
+    delete m_socket;
+    m_socket = NULL;
+}
+
+bool UdpPacketSender::setMulticastTtl(int ttl)
+{
+    if (m_socket == NULL)
+        return false;
+
+    m_socket->setSocketOption(QAbstractSocket::MulticastTtlOption, ttl);
+    return true;
+}
+
+void UdpPacketSender::resize(int packetsCount, int packetCapacity)
+{
+    if (packetsCount == m_packetSizes.count() && packetCapacity == m_packetCapacity)
+        return;
+
+    m_packetCapacity = packetCapacity;
+    m_buffer.fill(0, packetsCount * packetCapacity);
+    m_packetSizes.fill(0, packetsCount);
+
+    // Keep destinations, packets are added to the end or removed from it
+    QHostAddress address = m_addresses.isEmpty() ? QHostAddress() : m_addresses.last();
+    quint16 port = m_ports.isEmpty() ? 0 : m_ports.last();
+    m_addresses.resize(packetsCount);
+    m_ports.resize(packetsCount);
+
+#ifdef Q_OS_LINUX
+    m_messages.resize(packetsCount);
+    m_iovecs.resize(packetsCount);
+    m_sockaddrs.resize(packetsCount);
+
+    for (int i = 0; i < packetsCount; i++)
+    {
+        memset(&m_messages[i], 0, sizeof(m_messages[i]));
+
+        m_iovecs[i].iov_base = packet(i);
+        m_iovecs[i].iov_len = 0;
+
+        m_messages[i].msg_hdr.msg_iov = &m_iovecs[i];
+        m_messages[i].msg_hdr.msg_iovlen = 1;
+        m_messages[i].msg_hdr.msg_name = &m_sockaddrs[i];
+        m_messages[i].msg_hdr.msg_namelen = sizeof(m_sockaddrs[i]);
+    }
+#endif
+
+    for (int i = 0; i < packetsCount; i++)
+    {
+        if (m_ports[i] == 0)
+            setDestination(i, address, port);
+    }
+}
+
+void UdpPacketSender::setPacketSize(int index, int size)
+{
+    Q_ASSERT(size <= m_packetCapacity);
+
+    m_packetSizes[index] = size;
+#ifdef Q_OS_LINUX
+    m_iovecs[index].iov_len = size;
+#endif
+}
+
+void UdpPacketSender::setDestination(const QHostAddress & address, quint16 port)
+{
+    for (int i = 0; i < packetsCount(); i++)
+        setDestination(i, address, port);
+}
+
+void UdpPacketSender::setDestination(int index, const QHostAddress & address, quint16 port)
+{
+    m_addresses[index] = address;
+    m_ports[index] = port;
+
+#ifdef Q_OS_LINUX
+    struct sockaddr_in & sockaddr = m_sockaddrs[index];
+
+    memset(&sockaddr, 0, sizeof(sockaddr));
+    sockaddr.sin_family = AF_INET;
+    sockaddr.sin_port = htons(port);
+    sockaddr.sin_addr.s_addr = htonl(address.toIPv4Address());
+#endif
+}
+
+int UdpPacketSender::send(int first, int count)
+{
+    if (m_socket == NULL)
+        return -1;
+
+    if (first < 0 || count <= 0 || first + count > packetsCount())
+        return 0;
+
+#ifdef Q_OS_LINUX
+    int descriptor = m_socket->socketDescriptor();
+    int sent = 0;
+
+    while (sent < count)
+    {
+        int result = sendmmsg(descriptor, &m_messages[first + sent], count - sent, MSG_DONTWAIT);
+
+        if (result < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            // Socket buffer is full, rest of the frame is dropped as any lost datagram
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS)
+                break;
+
+            DEBUG_MID_LEVEL << Q_FUNC_INFO << "sendmmsg fail:" << strerror(errno);
+            return -1;
+        }
+
+        sent += result;
+    }
+
+    return sent;
+#else
+    int sent = 0;
+
+    for (int i = first; i < first + count; i++)
+    {
+        qint64 result = m_socket->writeDatagram(packet(i), m_packetSizes[i], m_addresses[i], m_ports[i]);
+
+        if (result < 0)
+        {
+            DEBUG_MID_LEVEL << Q_FUNC_INFO << "writeDatagram fail:" << m_socket->errorString();
+            return sent > 0 ? sent : -1;
+        }
+
+        sent++;
+    }
+
+    return sent;
+#endif
+}
+
+QHostAddress UdpPacketSender::resolveHost(const QString & host)
+{
+    QHostAddress address;
+
+    if (address.setAddress(host))
+    {
+        // Socket and sendmmsg() addresses are IPv4 only
+        if (address.protocol() != QAbstractSocket::IPv4Protocol)
+        {
+            qWarning() << Q_FUNC_INFO << "IPv6 address isn't supported:" << host;
+            return QHostAddress();
+        }
+        return address;
+    }
+
+    // Blocking lookup, device is opened in its own thread
+    QHostInfo info = QHostInfo::fromName(host);
+
+    foreach (const QHostAddress & hostAddress, info.addresses())
+    {
+        if (hostAddress.protocol() == QAbstractSocket::IPv4Protocol)
+            return hostAddress;
+    }
+
+    if (info.addresses().isEmpty() == false)
+        qWarning() << Q_FUNC_INFO << "host has no IPv4 address, IPv6 isn't supported:" << host;
+    else
+        qWarning() << Q_FUNC_INFO << "can't resolve host:" << host << info.errorString();
+
+    return QHostAddress();
+}
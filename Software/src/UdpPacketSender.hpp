@@ -0,0 +1,94 @@
+/*
+ * UdpPacketSender.hpp
+ *
+ *  Created on: 19.10.2026
+ *     Project: Lightpack
+ *
+ *  Lightpack is very simple implementation of the backlight for a laptop
+ *
+ *  Copyright (c) 2011 Mike Shatohin, mikeshatohin [at] gmail.com
+ *
+ *  Lightpack is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Lightpack is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <QByteArray>
+#include <QHostAddress>
+#include <QVector>
+
+#ifdef Q_OS_LINUX
+#   include <sys/socket.h>
+#   include <netinet/in.h>
+#endif
+
+class QUdpSocket;
+
+/*!
+  Sends a set of UDP packets per frame for network LED devices.
+
+  Packet buffers are allocated by resize() and reused for every frame, the
+  caller writes packets in place with packet() and setPacketSize(). On Linux
+  all packets of the frame leave with a single sendmmsg() call, on other
+  systems they are sent one by one.
+
+  Socket is created by open(), call it from the thread which sends packets.
+*/
+class UdpPacketSender
+{
+public:
+    UdpPacketSender();
+    ~UdpPacketSender();
+
+    bool open();
+    void close();
+    bool isOpen() const { return m_socket != NULL; }
+
+    bool setMulticastTtl(int ttl);
+
+    void resize(int packetsCount, int packetCapacity);
+    int packetsCount() const { return m_packetSizes.count(); }
+    int packetCapacity() const { return m_packetCapacity; }
+
+    char * packet(int index) { return m_buffer.data() + index * m_packetCapacity; }
+    const char * packet(int index) const { return m_buffer.constData() + index * m_packetCapacity; }
+    int packetSize(int index) const { return m_packetSizes[index]; }
+    void setPacketSize(int index, int size);
+
+    void setDestination(const QHostAddress & address, quint16 port);
+    void setDestination(int index, const QHostAddress & address, quint16 port);
+
+    // Returns count of sent packets or -1 on socket error
+    int send(int first, int count);
+    int sendAll() { return send(0, packetsCount()); }
+
+    // Returns IPv4 address of the host or null address if it has none
+    static QHostAddress resolveHost(const QString & host);
+
+private:
+    QUdpSocket *m_socket;
+
+    QByteArray m_buffer;
+    int m_packetCapacity;
+    QVector<int> m_packetSizes;
+    QVector<QHostAddress> m_addresses;
+    QVector<quint16> m_ports;
+
+#ifdef Q_OS_LINUX
+    QVector<struct mmsghdr> m_messages;
+    QVector<struct iovec> m_iovecs;
+    QVector<struct sockaddr_in> m_sockaddrs;
+#endif
+};
@@ -88,6 +88,8 @@ enum DeviceType {
     DeviceTypeAdalight,
     DeviceTypeVirtual,
     DeviceTypeArdulight,
+    DeviceTypeUdp,
+    DeviceTypeE131,
 
     DeviceTypesCount,
     DefaultDeviceType = DeviceTypeLightpack
@@ -105,6 +107,10 @@ enum Devices
     AlienFx     = 1,
     Virtual     = 255,
 
+    // Network controllers, grab profile keeps only AbsoluteMaximum LEDs
+    Udp         = 4096,
+    E131        = 4096,
+
     Paintpack   = 10,
 
     Lightpack4  = 8,
@@ -200,6 +200,69 @@ extern "C" {
 		*/
 		int  HID_API_EXPORT HID_API_CALL hid_write(hid_device *device, const unsigned char *data, size_t length);
 
+#ifdef HID_API_ASYNC_WRITE
+		/** @brief Completion callback of hid_write_async().
+
+			Called from the thread which handles USB events of the
+			device (the read thread), so it must not block and must not
+			call hidapi functions on the same device.
+
+			@param device The device the report was written to.
+			@param user_data Pointer passed to hid_write_async().
+			@param result The number of bytes written (as hid_write()
+				returns) or -1 on error or when the write was cancelled.
+		*/
+		typedef void (HID_API_CALL *hid_write_callback)(hid_device *device, void *user_data, int result);
+
+		/** @brief Set the number of asynchronous writes which may be in flight.
+
+			Transfers and their buffers are allocated here once and
+			reused by hid_write_async(). Must not be called while
+			asynchronous writes are in flight.
+
+			@ingroup API
+			@param device A device handle returned from hid_open().
+			@param depth Number of transfers, 0 frees them.
+
+			@returns
+				This function returns 0 on success and -1 on error.
+		*/
+		int HID_API_EXPORT HID_API_CALL hid_set_write_depth(hid_device *device, int depth);
+
+		/** @brief Write an Output report without waiting for the transfer.
+
+			The data is copied to one of the preallocated transfers, so
+			the caller may reuse its buffer immediately. Reports are
+			delivered in the order of the calls. Devices without
+			interrupt OUT endpoint get Set_Report requests through the
+			Control Endpoint, as with hid_write().
+
+			@ingroup API
+			@param device A device handle returned from hid_open().
+			@param data The data to send, including the report number as
+				the first byte.
+			@param length The length in bytes of the data to send.
+			@param callback Function called when the transfer completes.
+			@param user_data Pointer passed to the callback.
+
+			@returns
+				This function returns the number of bytes queued, 0 if
+				all transfers are in flight and -1 on error.
+		*/
+		int HID_API_EXPORT HID_API_CALL hid_write_async(hid_device *device, const unsigned char *data, size_t length, hid_write_callback callback, void *user_data);
+
+		/** @brief Get the number of asynchronous writes in flight.
+
+			@ingroup API
+			@param device A device handle returned from hid_open().
+
+			@returns
+				This function returns the number of transfers which are
+				submitted and not completed yet.
+		*/
+		int HID_API_EXPORT HID_API_CALL hid_write_async_in_flight(hid_device *device);
+#endif
+
 		/** @brief Read an Input report from a HID device with timeout.
 
 			Input reports are returned
@@ -43,6 +43,10 @@
 #include "libusb.h"
 #include "iconv.h"
 
+/* This backend always provides hid_write_async() */
+#ifndef HID_API_ASYNC_WRITE
+#define HID_API_ASYNC_WRITE
+#endif
 #include "hidapi.h"
 
 #ifdef __cplusplus
@@ -71,6 +75,20 @@ struct input_report {
 };
 
 
+/* Largest report hid_write_async() sends through the Control Endpoint,
+   devices without interrupt OUT endpoint don't tell their report size. */
+#define MAX_CONTROL_WRITE_SIZE 1024
+
+/* Preallocated transfer for hid_write_async(). */
+struct write_transfer {
+	hid_device *dev;
+	struct libusb_transfer *transfer;
+	hid_write_callback callback;
+	void *user_data;
+	int skipped_report_id;
+	int in_flight; /* boolean */
+};
+
 struct hid_device_ {
 	/* Handle to the actual device. */
 	libusb_device_handle *device_handle;
@@ -79,6 +97,7 @@ struct hid_device_ {
 	int input_endpoint;
 	int output_endpoint;
 	int input_ep_max_packet_size;
+	int output_ep_max_packet_size;
 
 	/* The interface number of the HID */	
 	int interface;
@@ -101,6 +120,14 @@ struct hid_device_ {
 
 	/* List of received input reports. */
 	struct input_report *input_reports;
+
+	/* Asynchronous writes. Transfers are used round robin, they
+	   complete in the order of submission on the same endpoint. */
+	pthread_mutex_t write_mutex; /* Protects write_transfers */
+	struct write_transfer *write_transfers;
+	int write_depth;
+	int write_next;
+	int writes_in_flight;
 };
 
 static int initialized = 0;
@@ -115,6 +142,7 @@ static hid_device *new_hid_device(void)
 	dev->input_endpoint = 0;
 	dev->output_endpoint = 0;
 	dev->input_ep_max_packet_size = 0;
+	dev->output_ep_max_packet_size = 0;
 	dev->interface = 0;
 	dev->manufacturer_index = 0;
 	dev->product_index = 0;
@@ -123,8 +151,13 @@ static hid_device *new_hid_device(void)
 	dev->shutdown_thread = 0;
 	dev->transfer = NULL;
 	dev->input_reports = NULL;
+	dev->write_transfers = NULL;
+	dev->write_depth = 0;
+	dev->write_next = 0;
+	dev->writes_in_flight = 0;
 	
 	pthread_mutex_init(&dev->mutex, NULL);
+	pthread_mutex_init(&dev->write_mutex, NULL);
 	pthread_cond_init(&dev->condition, NULL);
 	pthread_barrier_init(&dev->barrier, NULL, 2);
 	
@@ -137,6 +170,7 @@ static void free_hid_device(hid_device *dev)
 	pthread_barrier_destroy(&dev->barrier);
 	pthread_cond_destroy(&dev->condition);
 	pthread_mutex_destroy(&dev->mutex);
+	pthread_mutex_destroy(&dev->write_mutex);
 
 	/* Free the device itself */
 	free(dev);
@@ -839,6 +873,7 @@ hid_device * HID_API_EXPORT hid_open_path(const char *path)
 							    is_interrupt && is_output) {
 								/* Use this endpoint for OUTPUT */
 								dev->output_endpoint = ep->bEndpointAddress;
+								dev->output_ep_max_packet_size = ep->wMaxPacketSize;
 							}
 						}
 						
@@ -920,6 +955,182 @@ int HID_API_EXPORT hid_write(hid_device *dev, const unsigned char *data, size_t
 	}
 }
 
+static void write_callback(struct libusb_transfer *transfer)
+{
+	struct write_transfer *wt = transfer->user_data;
+	hid_device *dev = wt->dev;
+	int result = -1;
+
+	if (transfer->status == LIBUSB_TRANSFER_COMPLETED)
+		result = transfer->actual_length + wt->skipped_report_id;
+	else
+		LOG("Write transfer failed: %d\n", transfer->status);
+
+	pthread_mutex_lock(&dev->write_mutex);
+	wt->in_flight = 0;
+	dev->writes_in_flight--;
+	pthread_mutex_unlock(&dev->write_mutex);
+
+	if (wt->callback)
+		wt->callback(dev, wt->user_data, result);
+}
+
+/* Maximum length of the report data, without report id */
+static int write_report_size(hid_device *dev)
+{
+	if (dev->output_endpoint <= 0)
+		return MAX_CONTROL_WRITE_SIZE;
+	return dev->output_ep_max_packet_size;
+}
+
+static void free_write_transfers(hid_device *dev)
+{
+	int i;
+
+	for (i = 0; i < dev->write_depth; i++) {
+		free(dev->write_transfers[i].transfer->buffer);
+		libusb_free_transfer(dev->write_transfers[i].transfer);
+	}
+	free(dev->write_transfers);
+
+	dev->write_transfers = NULL;
+	dev->write_depth = 0;
+	dev->write_next = 0;
+}
+
+int HID_API_EXPORT hid_set_write_depth(hid_device *dev, int depth)
+{
+	int i;
+	int res = 0;
+
+	if (depth < 0)
+		return -1;
+
+	pthread_mutex_lock(&dev->write_mutex);
+
+	if (dev->writes_in_flight > 0) {
+		pthread_mutex_unlock(&dev->write_mutex);
+		return -1;
+	}
+
+	free_write_transfers(dev);
+
+	if (depth > 0) {
+		dev->write_transfers = calloc(depth, sizeof(struct write_transfer));
+
+		for (i = 0; i < depth; i++) {
+			struct write_transfer *wt = &dev->write_transfers[i];
+
+			wt->dev = dev;
+			wt->transfer = libusb_alloc_transfer(0);
+
+			if (dev->output_endpoint <= 0) {
+				/* No interrupt out endpoint. Set_Report requests
+				   are filled in hid_write_async(), the buffer
+				   starts with the setup packet. */
+				unsigned char *buf = malloc(LIBUSB_CONTROL_SETUP_SIZE + MAX_CONTROL_WRITE_SIZE);
+
+				libusb_fill_control_transfer(wt->transfer,
+					dev->device_handle,
+					buf,
+					write_callback,
+					wt,
+					1000/*timeout millis*/);
+			}
+			else {
+				unsigned char *buf = malloc(dev->output_ep_max_packet_size);
+
+				libusb_fill_interrupt_transfer(wt->transfer,
+					dev->device_handle,
+					dev->output_endpoint,
+					buf,
+					dev->output_ep_max_packet_size,
+					write_callback,
+					wt,
+					1000/*timeout millis*/);
+			}
+		}
+		dev->write_depth = depth;
+	}
+
+	pthread_mutex_unlock(&dev->write_mutex);
+
+	return res;
+}
+
+int HID_API_EXPORT hid_write_async(hid_device *dev, const unsigned char *data, size_t length, hid_write_callback callback, void *user_data)
+{
+	struct write_transfer *wt;
+	int report_number = data[0];
+	int skipped_report_id = 0;
+
+	if (report_number == 0x0) {
+		data++;
+		length--;
+		skipped_report_id = 1;
+	}
+
+	pthread_mutex_lock(&dev->write_mutex);
+
+	if (dev->write_depth == 0 || length > (size_t)write_report_size(dev)) {
+		pthread_mutex_unlock(&dev->write_mutex);
+		return -1;
+	}
+
+	wt = &dev->write_transfers[dev->write_next];
+	if (wt->in_flight) {
+		/* All transfers are on the bus, wait for the callback */
+		pthread_mutex_unlock(&dev->write_mutex);
+		return 0;
+	}
+
+	if (dev->output_endpoint <= 0) {
+		/* Same request as hid_write() sends through the Control Endpoint */
+		libusb_fill_control_setup(wt->transfer->buffer,
+			LIBUSB_REQUEST_TYPE_CLASS|LIBUSB_RECIPIENT_INTERFACE|LIBUSB_ENDPOINT_OUT,
+			0x09/*HID Set_Report*/,
+			(2/*HID output*/ << 8) | report_number,
+			dev->interface,
+			length);
+		memcpy(wt->transfer->buffer + LIBUSB_CONTROL_SETUP_SIZE, data, length);
+		wt->transfer->length = LIBUSB_CONTROL_SETUP_SIZE + length;
+	}
+	else {
+		memcpy(wt->transfer->buffer, data, length);
+		wt->transfer->length = length;
+	}
+	wt->callback = callback;
+	wt->user_data = user_data;
+	wt->skipped_report_id = skipped_report_id;
+	wt->in_flight = 1;
+
+	/* write_callback() waits for write_mutex, so counters are
+	   consistent even if the transfer completes right away */
+	if (libusb_submit_transfer(wt->transfer) < 0) {
+		wt->in_flight = 0;
+		pthread_mutex_unlock(&dev->write_mutex);
+		return -1;
+	}
+
+	dev->writes_in_flight++;
+	dev->write_next = (dev->write_next + 1) % dev->write_depth;
+
+	pthread_mutex_unlock(&dev->write_mutex);
+
+	return length + skipped_report_id;
+}
+
+int HID_API_EXPORT hid_write_async_in_flight(hid_device *dev)
+{
+	int in_flight;
+
+	pthread_mutex_lock(&dev->write_mutex);
+	in_flight = dev->writes_in_flight;
+	pthread_mutex_unlock(&dev->write_mutex);
+
+	return in_flight;
+}
+
 /* Helper function, to simplify hid_read().
    This should be called with dev->mutex locked. */
 static int return_data(hid_device *dev, unsigned char *data, size_t length)
@@ -1104,9 +1315,19 @@ int HID_API_EXPORT hid_get_feature_report(hid_device *dev, unsigned char *data,
 
 void HID_API_EXPORT hid_close(hid_device *dev)
 {
+	int i;
+
 	if (!dev)
 		return;
 	
+	/* Cancel asynchronous writes, their callbacks report -1. */
+	pthread_mutex_lock(&dev->write_mutex);
+	for (i = 0; i < dev->write_depth; i++) {
+		if (dev->write_transfers[i].in_flight)
+			libusb_cancel_transfer(dev->write_transfers[i].transfer);
+	}
+	pthread_mutex_unlock(&dev->write_mutex);
+
 	/* Cause read_thread() to stop. */
 	dev->shutdown_thread = 1;
 	libusb_cancel_transfer(dev->transfer);
@@ -1117,6 +1338,18 @@ void HID_API_EXPORT hid_close(hid_device *dev)
 	/* Clean up the Transfer objects allocated in read_thread(). */
 	free(dev->transfer->buffer);
 	libusb_free_transfer(dev->transfer);
+
+	/* read_thread() may stop before cancelled writes are completed,
+	   handle their events here. */
+	for (i = 0; i < 10 && hid_write_async_in_flight(dev) > 0; i++) {
+		struct timeval tv = { 0, 100000 };
+		if (libusb_handle_events_timeout(NULL, &tv) < 0)
+			break;
+	}
+	if (hid_write_async_in_flight(dev) == 0)
+		free_write_transfers(dev);
+	else
+		LOG("Write transfers are not completed, leak them\n");
 	
 	/* release the interface */
 	libusb_release_interface(dev->device_handle, dev->interface);
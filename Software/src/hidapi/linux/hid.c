@@ -0,0 +1,503 @@
+/*******************************************************
+ HIDAPI - Multi-Platform library for
+ communication with HID devices.
+
+ Linux hidraw Version
+
+ Writes go to /dev/hidrawN with plain write(), there is
+ no read thread: hid_read() polls the descriptor and keeps
+ input reports in a fixed ring buffer. The kernel driver
+ stays attached, so reconnect needs no detach/claim.
+
+ At the discretion of the user of this library,
+ this software may be licensed under the terms of the
+ GNU Public License v3, a BSD-Style license, or the
+ original HIDAPI license as outlined in the LICENSE.txt,
+ LICENSE-gpl3.txt, LICENSE-bsd.txt, and LICENSE-orig.txt
+ files located at the root of the source distribution.
+ These files may also be found in the public source
+ code repository located at:
+        http://github.com/signal11/hidapi .
+********************************************************/
+
+/* C */
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <locale.h>
+#include <errno.h>
+#include <wchar.h>
+
+/* Unix */
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/ioctl.h>
+#include <fcntl.h>
+#include <poll.h>
+
+/* Linux */
+#include <linux/hidraw.h>
+#include <libudev.h>
+
+#include "hidapi.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef DEBUG_PRINTF
+#define LOG(...) fprintf(stderr, __VA_ARGS__)
+#else
+#define LOG(...) do {} while (0)
+#endif
+
+/* Input reports are kept here until hid_read() takes them. When
+   the ring is full the oldest report is dropped, so it doesn't
+   grow if the user never reads anything from the device. */
+#define INPUT_RING_SIZE		32
+#define INPUT_REPORT_MAX_SIZE	256
+
+struct hid_device_ {
+	int device_handle;
+	int blocking; /* boolean */
+
+	unsigned char input_ring[INPUT_RING_SIZE][INPUT_REPORT_MAX_SIZE];
+	size_t input_lengths[INPUT_RING_SIZE];
+	int input_head; /* Index of the oldest report */
+	int input_count;
+};
+
+static hid_device *new_hid_device(void)
+{
+	hid_device *dev = calloc(1, sizeof(hid_device));
+	dev->device_handle = -1;
+	dev->blocking = 1;
+	dev->input_head = 0;
+	dev->input_count = 0;
+
+	return dev;
+}
+
+static wchar_t *utf8_to_wchar_t(const char *utf8)
+{
+	wchar_t *ret = NULL;
+
+	if (utf8) {
+		size_t wlen = mbstowcs(NULL, utf8, 0);
+		if ((size_t)-1 == wlen)
+			return wcsdup(L"");
+		ret = calloc(wlen+1, sizeof(wchar_t));
+		mbstowcs(ret, utf8, wlen+1);
+		ret[wlen] = 0x0000;
+	}
+
+	return ret;
+}
+
+/* Parses HID_ID of the uevent: "bus:vendor:product", all in hex. */
+static int parse_hid_id(struct udev_device *hid_dev, unsigned short *vendor_id, unsigned short *product_id)
+{
+	const char *hid_id = udev_device_get_property_value(hid_dev, "HID_ID");
+	unsigned int bus, vendor, product;
+
+	if (!hid_id || sscanf(hid_id, "%x:%x:%x", &bus, &vendor, &product) != 3)
+		return -1;
+
+	*vendor_id = vendor;
+	*product_id = product;
+	return 0;
+}
+
+/* USB device of the hidraw node or NULL for Bluetooth and others,
+   it's owned by raw_dev. */
+static struct udev_device *get_usb_device(struct udev_device *raw_dev)
+{
+	return udev_device_get_parent_with_subsystem_devtype(raw_dev, "usb", "usb_device");
+}
+
+static int get_device_string(hid_device *dev, const char *attribute, wchar_t *string, size_t maxlen)
+{
+	struct udev *udev;
+	struct udev_device *raw_dev, *usb_dev;
+	struct stat s;
+	int ret = -1;
+
+	if (fstat(dev->device_handle, &s) < 0)
+		return -1;
+
+	udev = udev_new();
+	if (!udev)
+		return -1;
+
+	raw_dev = udev_device_new_from_devnum(udev, 'c', s.st_rdev);
+	if (raw_dev) {
+		usb_dev = get_usb_device(raw_dev);
+		if (usb_dev) {
+			const char *str = udev_device_get_sysattr_value(usb_dev, attribute);
+			if (str) {
+				size_t len = mbstowcs(string, str, maxlen);
+				if (len != (size_t)-1) {
+					string[maxlen-1] = L'\0';
+					ret = 0;
+				}
+			}
+		}
+		udev_device_unref(raw_dev);
+	}
+	udev_unref(udev);
+
+	return ret;
+}
+
+int HID_API_EXPORT hid_init(void)
+{
+	/* For mbstowcs() of the device strings */
+	setlocale(LC_ALL, "");
+	return 0;
+}
+
+int HID_API_EXPORT hid_exit(void)
+{
+	return 0;
+}
+
+struct hid_device_info  HID_API_EXPORT *hid_enumerate(unsigned short vendor_id, unsigned short product_id)
+{
+	struct udev *udev;
+	struct udev_enumerate *enumerate;
+	struct udev_list_entry *devices, *dev_list_entry;
+
+	struct hid_device_info *root = NULL; /* return object */
+	struct hid_device_info *cur_dev = NULL;
+
+	hid_init();
+
+	udev = udev_new();
+	if (!udev) {
+		LOG("Can't create udev\n");
+		return NULL;
+	}
+
+	enumerate = udev_enumerate_new(udev);
+	udev_enumerate_add_match_subsystem(enumerate, "hidraw");
+	udev_enumerate_scan_devices(enumerate);
+	devices = udev_enumerate_get_list_entry(enumerate);
+
+	udev_list_entry_foreach(dev_list_entry, devices) {
+		const char *sysfs_path = udev_list_entry_get_name(dev_list_entry);
+		struct udev_device *raw_dev = udev_device_new_from_syspath(udev, sysfs_path);
+		struct udev_device *hid_dev, *usb_dev, *intf_dev;
+		unsigned short dev_vid, dev_pid;
+		struct hid_device_info *tmp;
+		const char *dev_path;
+
+		if (!raw_dev)
+			continue;
+
+		dev_path = udev_device_get_devnode(raw_dev);
+		hid_dev = udev_device_get_parent_with_subsystem_devtype(raw_dev, "hid", NULL);
+
+		if (!dev_path || !hid_dev || parse_hid_id(hid_dev, &dev_vid, &dev_pid) < 0)
+			goto next;
+
+		/* Check the VID/PID against the arguments */
+		if ((vendor_id != 0x0 || product_id != 0x0) &&
+		    (vendor_id != dev_vid || product_id != dev_pid))
+			goto next;
+
+		/* VID/PID match. Create the record. */
+		tmp = calloc(1, sizeof(struct hid_device_info));
+		if (cur_dev)
+			cur_dev->next = tmp;
+		else
+			root = tmp;
+		cur_dev = tmp;
+
+		/* Fill out the record */
+		cur_dev->next = NULL;
+		cur_dev->path = strdup(dev_path);
+		cur_dev->vendor_id = dev_vid;
+		cur_dev->product_id = dev_pid;
+		cur_dev->interface_number = -1;
+
+		usb_dev = get_usb_device(raw_dev);
+		if (usb_dev) {
+			const char *release = udev_device_get_sysattr_value(usb_dev, "bcdDevice");
+
+			cur_dev->serial_number = utf8_to_wchar_t(udev_device_get_sysattr_value(usb_dev, "serial"));
+			cur_dev->manufacturer_string = utf8_to_wchar_t(udev_device_get_sysattr_value(usb_dev, "manufacturer"));
+			cur_dev->product_string = utf8_to_wchar_t(udev_device_get_sysattr_value(usb_dev, "product"));
+
+			if (release)
+				cur_dev->release_number = strtol(release, NULL, 16);
+
+			intf_dev = udev_device_get_parent_with_subsystem_devtype(raw_dev, "usb", "usb_interface");
+			if (intf_dev) {
+				const char *str = udev_device_get_sysattr_value(intf_dev, "bInterfaceNumber");
+				cur_dev->interface_number = str ? strtol(str, NULL, 16) : -1;
+			}
+		}
+		else {
+			/* Not a USB device, take what the HID layer knows */
+			cur_dev->serial_number = utf8_to_wchar_t(udev_device_get_property_value(hid_dev, "HID_UNIQ"));
+			cur_dev->product_string = utf8_to_wchar_t(udev_device_get_property_value(hid_dev, "HID_NAME"));
+		}
+
+	next:
+		udev_device_unref(raw_dev);
+	}
+
+	udev_enumerate_unref(enumerate);
+	udev_unref(udev);
+
+	return root;
+}
+
+void  HID_API_EXPORT hid_free_enumeration(struct hid_device_info *devs)
+{
+	struct hid_device_info *d = devs;
+	while (d) {
+		struct hid_device_info *next = d->next;
+		free(d->path);
+		free(d->serial_number);
+		free(d->manufacturer_string);
+		free(d->product_string);
+		free(d);
+		d = next;
+	}
+}
+
+hid_device * hid_open(unsigned short vendor_id, unsigned short product_id, wchar_t *serial_number)
+{
+	struct hid_device_info *devs, *cur_dev;
+	const char *path_to_open = NULL;
+	hid_device *handle = NULL;
+
+	devs = hid_enumerate(vendor_id, product_id);
+	cur_dev = devs;
+	while (cur_dev) {
+		if (cur_dev->vendor_id == vendor_id &&
+		    cur_dev->product_id == product_id) {
+			if (serial_number) {
+				if (cur_dev->serial_number &&
+				    wcscmp(serial_number, cur_dev->serial_number) == 0) {
+					path_to_open = cur_dev->path;
+					break;
+				}
+			}
+			else {
+				path_to_open = cur_dev->path;
+				break;
+			}
+		}
+		cur_dev = cur_dev->next;
+	}
+
+	if (path_to_open) {
+		/* Open the device */
+		handle = hid_open_path(path_to_open);
+	}
+
+	hid_free_enumeration(devs);
+
+	return handle;
+}
+
+hid_device * HID_API_EXPORT hid_open_path(const char *path)
+{
+	hid_device *dev = NULL;
+
+	hid_init();
+
+	dev = new_hid_device();
+
+	/* Blocking reads are done with poll(), so the descriptor
+	   itself is always non-blocking. */
+	dev->device_handle = open(path, O_RDWR | O_NONBLOCK | O_CLOEXEC);
+
+	if (dev->device_handle < 0) {
+		LOG("can't open %s: %s\n", path, strerror(errno));
+		free(dev);
+		return NULL;
+	}
+
+	return dev;
+}
+
+int HID_API_EXPORT hid_write(hid_device *dev, const unsigned char *data, size_t length)
+{
+	ssize_t bytes_written;
+
+	/* hidraw takes the report number as the first byte, like hidapi.
+	   Output reports are sent synchronously by the kernel driver,
+	   the descriptor is still polled in case the queue is full. */
+	for (;;) {
+		bytes_written = write(dev->device_handle, data, length);
+
+		if (bytes_written >= 0)
+			return bytes_written;
+
+		if (errno == EAGAIN) {
+			struct pollfd fds;
+			fds.fd = dev->device_handle;
+			fds.events = POLLOUT;
+			fds.revents = 0;
+			if (poll(&fds, 1, 1000/*timeout millis*/) <= 0)
+				return -1;
+		}
+		else if (errno != EINTR) {
+			return -1;
+		}
+	}
+}
+
+/* Moves all reports which are ready to the ring.
+   Returns -1 if the device is gone. */
+static int fill_input_ring(hid_device *dev)
+{
+	for (;;) {
+		int slot;
+		ssize_t bytes_read;
+
+		if (dev->input_count == INPUT_RING_SIZE) {
+			/* Drop the oldest report */
+			dev->input_head = (dev->input_head + 1) % INPUT_RING_SIZE;
+			dev->input_count--;
+		}
+
+		slot = (dev->input_head + dev->input_count) % INPUT_RING_SIZE;
+		bytes_read = read(dev->device_handle, dev->input_ring[slot], INPUT_REPORT_MAX_SIZE);
+
+		if (bytes_read < 0) {
+			if (errno == EAGAIN || errno == EINTR)
+				return 0;
+			return -1;
+		}
+
+		dev->input_lengths[slot] = bytes_read;
+		dev->input_count++;
+	}
+}
+
+static int return_data(hid_device *dev, unsigned char *data, size_t length)
+{
+	int slot = dev->input_head;
+	size_t len = (length < dev->input_lengths[slot])? length: dev->input_lengths[slot];
+
+	if (len > 0)
+		memcpy(data, dev->input_ring[slot], len);
+
+	dev->input_head = (dev->input_head + 1) % INPUT_RING_SIZE;
+	dev->input_count--;
+
+	return len;
+}
+
+int HID_API_EXPORT hid_read_timeout(hid_device *dev, unsigned char *data, size_t length, int milliseconds)
+{
+	struct pollfd fds;
+	int ret;
+
+	if (dev->input_count > 0)
+		return return_data(dev, data, length);
+
+	fds.fd = dev->device_handle;
+	fds.events = POLLIN;
+	fds.revents = 0;
+
+	ret = poll(&fds, 1, milliseconds);
+	if (ret < 0)
+		return (errno == EINTR)? 0: -1;
+	if (ret == 0)
+		return 0; /* Timeout */
+
+	if (fds.revents & (POLLERR | POLLHUP | POLLNVAL))
+		return -1; /* Device is unplugged */
+
+	if (fill_input_ring(dev) < 0 && dev->input_count == 0)
+		return -1;
+
+	if (dev->input_count > 0)
+		return return_data(dev, data, length);
+
+	return 0;
+}
+
+int HID_API_EXPORT hid_read(hid_device *dev, unsigned char *data, size_t length)
+{
+	return hid_read_timeout(dev, data, length, (dev->blocking)? -1: 0);
+}
+
+int HID_API_EXPORT hid_set_nonblocking(hid_device *dev, int nonblock)
+{
+	dev->blocking = !nonblock;
+
+	return 0; /* Success */
+}
+
+int HID_API_EXPORT hid_send_feature_report(hid_device *dev, const unsigned char *data, size_t length)
+{
+	int res;
+
+	res = ioctl(dev->device_handle, HIDIOCSFEATURE(length), data);
+	if (res < 0)
+		LOG("ioctl (SFEATURE): %s\n", strerror(errno));
+
+	return res;
+}
+
+int HID_API_EXPORT hid_get_feature_report(hid_device *dev, unsigned char *data, size_t length)
+{
+	int res;
+
+	res = ioctl(dev->device_handle, HIDIOCGFEATURE(length), data);
+	if (res < 0)
+		LOG("ioctl (GFEATURE): %s\n", strerror(errno));
+
+	return res;
+}
+
+void HID_API_EXPORT hid_close(hid_device *dev)
+{
+	if (!dev)
+		return;
+
+	close(dev->device_handle);
+	free(dev);
+}
+
+int HID_API_EXPORT_CALL hid_get_manufacturer_string(hid_device *dev, wchar_t *string, size_t maxlen)
+{
+	return get_device_string(dev, "manufacturer", string, maxlen);
+}
+
+int HID_API_EXPORT_CALL hid_get_product_string(hid_device *dev, wchar_t *string, size_t maxlen)
+{
+	return get_device_string(dev, "product", string, maxlen);
+}
+
+int HID_API_EXPORT_CALL hid_get_serial_number_string(hid_device *dev, wchar_t *string, size_t maxlen)
+{
+	return get_device_string(dev, "serial", string, maxlen);
+}
+
+int HID_API_EXPORT_CALL hid_get_indexed_string(hid_device *dev, int string_index, wchar_t *string, size_t maxlen)
+{
+	/* hidraw gives no access to string descriptors by index */
+	(void)dev;
+	(void)string_index;
+	(void)string;
+	(void)maxlen;
+	return -1;
+}
+
+HID_API_EXPORT const wchar_t * HID_API_CALL  hid_error(hid_device *dev)
+{
+	(void)dev;
+	return NULL;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -1476,6 +1476,23 @@ qint64 AbstractSerial::bytesToWrite() const
     return qint64(d->writeBuffer.size());
 }
 
+#if defined (Q_OS_UNIX)
+/*! \~english
+    \fn int AbstractSerial::nativeDescriptor() const
+    Returns the native file descriptor of the opened serial device.
+    It allows to query the driver output queue (TIOCOUTQ) and to write
+    without the tcdrain() that the engine does after each write.
+    \return The descriptor or -1 if the device is not open.
+*/
+int AbstractSerial::nativeDescriptor() const
+{
+    Q_D(const AbstractSerial);
+    if (!this->isOpen())
+        return -1;
+    return d->serialEngine->descriptor();
+}
+#endif
+
 /*! \~english
     Returns true if a line of data can be read from the serial;
     otherwise returns false.
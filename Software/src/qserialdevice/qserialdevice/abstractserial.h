@@ -313,6 +313,9 @@ public:
 
     qint64 bytesAvailable() const;
     qint64 bytesToWrite() const;
+#if defined (Q_OS_UNIX)
+    int nativeDescriptor() const;
+#endif
 
     bool canReadLine() const;
 
@@ -81,8 +81,16 @@ win32 {
 }
 
 unix:!macx{
-    # Linux version using libusb and hidapi codes
-    SOURCES += hidapi/linux/hid-libusb.c
+    hidraw {
+        # Linux version using hidraw, kernel driver stays attached
+        # Build it with "qmake CONFIG+=hidraw" or set CONFIG in build-vars.prf
+        SOURCES += hidapi/linux/hid.c
+    } else {
+        # Linux version using libusb and hidapi codes
+        SOURCES += hidapi/linux/hid-libusb.c
+        # hid_write_async() and pipelined writes in LedDeviceLightpack
+        DEFINES += HID_API_ASYNC_WRITE
+    }
     # For QSerialDevice
     LIBS += -ludev -lrt -lXext -lX11
 }
@@ -109,16 +117,31 @@ SOURCES += \
       GrabWidget.cpp  GrabConfigWidget.cpp \
     SpeedTest.cpp \
     LedDeviceLightpack.cpp \
+    LightpackFirmware.cpp \
     LedDevicePaintpack.cpp \
     LedDeviceAlienFx.cpp \
     LedDeviceAdalight.cpp \
     LedDeviceArdulight.cpp \
+    SerialOutputEngine.cpp \
+    AdalightDeltaCodec.cpp \
+    DeviceHotplugMonitor.cpp \
+    UdpPacketSender.cpp \
+    DdpSender.cpp \
+    LedDeviceUdp.cpp \
+    DmxNetworkSender.cpp \
+    LedDeviceE131.cpp \
+    FrameRecorder.cpp \
+    FramePlayer.cpp \
+    SharedFrame.cpp \
+    TemporalDither.cpp \
+    FrameInterpolator.cpp \
     LedDeviceVirtual.cpp \
     ColorButton.cpp \
     grab/WinAPIGrabber.cpp \
     LightpackPluginInterface.cpp \
     ApiServer.cpp \
     ApiServerSetColorTask.cpp \
+    SetColorParser.cpp \
     LightpackMath.cpp \
     MoodLampManager.cpp \
     PluginManager.cpp \
@@ -153,15 +176,30 @@ HEADERS += \
     alienfx/LFX2.h \
     ILedDevice.hpp \    
     LedDeviceLightpack.hpp \
+    LightpackFirmware.hpp \
     LedDeviceAlienFx.hpp \
     LedDeviceAdalight.hpp \
     LedDeviceArdulight.hpp \
+    SerialOutputEngine.hpp \
+    AdalightDeltaCodec.hpp \
+    DeviceHotplugMonitor.hpp \
+    UdpPacketSender.hpp \
+    DdpSender.hpp \
+    LedDeviceUdp.hpp \
+    DmxNetworkSender.hpp \
+    LedDeviceE131.hpp \
+    FrameRecorder.hpp \
+    FramePlayer.hpp \
+    SharedFrame.hpp \
+    TemporalDither.hpp \
+    FrameInterpolator.hpp \
     LedDeviceVirtual.hpp \
     LedDevicePaintpack.hpp \
     ColorButton.hpp \
     grab/WinAPIGrabber.hpp \
     ../common/defs.h \
     enums.hpp     LightpackPluginInterface.hpp     ApiServer.hpp     ApiServerSetColorTask.hpp \
+    SetColorParser.hpp \
     hidapi/hidapi.h \
     ../../CommonHeaders/LIGHTPACK_HW.h \
     ../../CommonHeaders/COMMANDS.h \
@@ -0,0 +1,230 @@
+#include "AdalightDeltaCodecTest.hpp"
+#include "AdalightDeltaCodec.hpp"
+#include <QtTest/QtTest>
+#include <qmath.h>
+
+namespace
+{
+const int LedsCount = 255;
+const int RawFrameSize = 6 + 3 * LedsCount;
+}
+
+AdalightDeltaCodecTest::AdalightDeltaCodecTest(QObject *parent) :
+    QObject(parent)
+{
+}
+
+void AdalightDeltaCodecTest::testKeyframeRoundTrip()
+{
+    AdalightDeltaCodec codec;
+    QByteArray colors(3 * LedsCount, 0), packet, decoded;
+
+    for (int i = 0; i < colors.size(); i++)
+        colors[i] = (char)(i * 7);
+
+    codec.encode(colors, packet);
+
+    QVERIFY( packet.startsWith("Adz") );
+    QCOMPARE( packet.at(6), 'K' );
+    QVERIFY( AdalightDeltaCodec::decode(packet, decoded) );
+    QCOMPARE( decoded, colors );
+}
+
+void AdalightDeltaCodecTest::testDeltaRoundTrip()
+{
+    AdalightDeltaCodec codec;
+    QByteArray colors(3 * LedsCount, 0), packet, decoded;
+
+    codec.encode(colors, packet);
+    QVERIFY( AdalightDeltaCodec::decode(packet, decoded) );
+
+    // One changed LED costs header, one span header and color
+    colors[3 * 100 + 1] = 0x42;
+    codec.encode(colors, packet);
+
+    QCOMPARE( packet.at(6), 'D' );
+    QCOMPARE( packet.size(), AdalightDeltaCodec::HeaderSize + AdalightDeltaCodec::SpanHeaderSize + 3 );
+    QVERIFY( AdalightDeltaCodec::decode(packet, decoded) );
+    QCOMPARE( decoded, colors );
+
+    // Nothing changed
+    codec.encode(colors, packet);
+    QCOMPARE( packet.size(), AdalightDeltaCodec::HeaderSize );
+    QVERIFY( AdalightDeltaCodec::decode(packet, decoded) );
+    QCOMPARE( decoded, colors );
+}
+
+void AdalightDeltaCodecTest::testPeriodicKeyframe()
+{
+    AdalightDeltaCodec codec;
+    codec.setKeyframeInterval(5);
+
+    QByteArray colors(3 * 10, 0), packet;
+    QString types;
+
+    for (int i = 0; i < 12; i++)
+    {
+        codec.encode(colors, packet);
+        types += packet.at(6);
+    }
+    QCOMPARE( types, QString("KDDDDDKDDDDD") );
+
+    // LEDs count changed
+    colors.resize(3 * 11);
+    codec.encode(colors, packet);
+    QCOMPARE( packet.at(6), 'K' );
+
+    codec.reset();
+    codec.encode(colors, packet);
+    QCOMPARE( packet.at(6), 'K' );
+}
+
+void AdalightDeltaCodecTest::testDecoderRejectsBrokenPacket()
+{
+    AdalightDeltaCodec codec;
+    QByteArray colors(3 * LedsCount, 0x10), packet, decoded;
+
+    codec.encode(colors, packet);
+    codec.encode(colors, packet);
+
+    // Delta before keyframe
+    QVERIFY( AdalightDeltaCodec::decode(packet, decoded) == false );
+
+    codec.reset();
+    codec.encode(colors, packet);
+
+    QByteArray broken = packet;
+    broken[5] = broken[5] ^ 0x01;
+    QVERIFY2( AdalightDeltaCodec::decode(broken, decoded) == false, "checksum is not checked" );
+
+    broken = packet;
+    broken.chop(1);
+    QVERIFY2( AdalightDeltaCodec::decode(broken, decoded) == false, "truncated packet is accepted" );
+
+    QVERIFY( AdalightDeltaCodec::decode(packet, decoded) );
+    QCOMPARE( decoded, colors );
+}
+
+void AdalightDeltaCodecTest::testRandomEditsRoundTrip()
+{
+    AdalightDeltaCodec codec;
+    QByteArray packet, decoded;
+
+    qsrand(26);
+
+    for (int test = 0; test < 500; test++)
+    {
+        int ledsCount = 1 + qrand() % 300;
+        QByteArray colors(3 * ledsCount, 0);
+        codec.reset();
+
+        for (int frame = 0; frame < 20; frame++)
+        {
+            // Spans of few colors give both fill and literal spans
+            int edits = qrand() % (ledsCount + 1);
+            for (int e = 0; e < edits; e++)
+            {
+                int start = qrand() % ledsCount;
+                int length = 1 + qrand() % 200;
+                char value = (char)(qrand() % 4);
+                for (int i = start; i < ledsCount && i < start + length; i++)
+                {
+                    colors[3 * i] = value;
+                    colors[3 * i + 1] = value;
+                    colors[3 * i + 2] = (char)(qrand() % 2);
+                }
+            }
+
+            codec.encode(colors, packet);
+            // Never much bigger than frame in Ada protocol
+            QVERIFY( packet.size() <= AdalightDeltaCodec::HeaderSize + 3 * ledsCount
+                     + AdalightDeltaCodec::SpanHeaderSize * (ledsCount / AdalightDeltaCodec::MaximumSpanLeds + 1) );
+            QVERIFY( AdalightDeltaCodec::decode(packet, decoded) );
+            QCOMPARE( decoded, colors );
+        }
+    }
+}
+
+void AdalightDeltaCodecTest::benchmarkBytesPerFrame_data()
+{
+    QTest::addColumn<QString>("content");
+    QTest::addColumn<double>("maximumBytesPerFrame");
+
+    QTest::newRow("static desktop") << "static" << 20.0;
+    QTest::newRow("video in window") << "window" << 200.0;
+    QTest::newRow("slow gradient") << "gradient" << (double)RawFrameSize;
+    QTest::newRow("noise") << "noise" << RawFrameSize + 12.0;
+}
+
+void AdalightDeltaCodecTest::benchmarkBytesPerFrame()
+{
+    QFETCH(QString, content);
+    QFETCH(double, maximumBytesPerFrame);
+
+    const int FramesCount = 1000;
+
+    AdalightDeltaCodec codec;
+    QByteArray colors(3 * LedsCount, 0), packet, decoded;
+    qint64 bytes = 0;
+
+    qsrand(27);
+
+    for (int frame = 0; frame < FramesCount; frame++)
+    {
+        nextFrame(content, frame, colors);
+        codec.encode(colors, packet);
+        bytes += packet.size();
+
+        QVERIFY( AdalightDeltaCodec::decode(packet, decoded) );
+    }
+    QCOMPARE( decoded, colors );
+
+    double bytesPerFrame = (double)bytes / FramesCount;
+
+    qDebug() << content << "bytes per frame:" << bytesPerFrame << "of" << RawFrameSize << "in Ada protocol";
+
+    QVERIFY( bytesPerFrame <= maximumBytesPerFrame );
+}
+
+void AdalightDeltaCodecTest::nextFrame(const QString & content, int frame, QByteArray & colors)
+{
+    int ledsCount = colors.size() / 3;
+
+    if (content == "static")
+    {
+        // Blinking cursor on the same background
+        for (int i = 0; i < ledsCount; i++)
+        {
+            colors[3 * i] = 0x20;
+            colors[3 * i + 1] = 0x30;
+            colors[3 * i + 2] = 0x40;
+        }
+        if ((frame / 25) % 2)
+            colors[3 * 40] = 0x7f;
+    }
+    else if (content == "window")
+    {
+        // Changing colors of LEDs behind the window, background is static
+        for (int i = 100; i < 120; i++)
+        {
+            colors[3 * i] = (char)qrand();
+            colors[3 * i + 1] = (char)qrand();
+            colors[3 * i + 2] = (char)qrand();
+        }
+    }
+    else if (content == "gradient")
+    {
+        for (int i = 0; i < ledsCount; i++)
+        {
+            int value = 128 + (int)(127 * qSin((i + frame) * 0.05));
+            colors[3 * i] = (char)value;
+            colors[3 * i + 1] = (char)(value / 2);
+            colors[3 * i + 2] = 0;
+        }
+    }
+    else
+    {
+        for (int i = 0; i < colors.size(); i++)
+            colors[i] = (char)qrand();
+    }
+}
@@ -0,0 +1,26 @@
+#ifndef ADALIGHTDELTACODECTEST_HPP
+#define ADALIGHTDELTACODECTEST_HPP
+
+#include <QObject>
+#include <QByteArray>
+
+class AdalightDeltaCodecTest : public QObject
+{
+    Q_OBJECT
+public:
+    explicit AdalightDeltaCodecTest(QObject *parent = 0);
+
+private slots:
+    void testKeyframeRoundTrip();
+    void testDeltaRoundTrip();
+    void testPeriodicKeyframe();
+    void testDecoderRejectsBrokenPacket();
+    void testRandomEditsRoundTrip();
+    void benchmarkBytesPerFrame_data();
+    void benchmarkBytesPerFrame();
+
+private:
+    void nextFrame(const QString & content, int frame, QByteArray & colors);
+};
+
+#endif // ADALIGHTDELTACODECTEST_HPP
@@ -0,0 +1,178 @@
+#include "DdpSenderTest.hpp"
+#include "DdpSender.hpp"
+#include <QtTest/QtTest>
+#include <QUdpSocket>
+
+static int ddpOffset(const QByteArray & packet)
+{
+    const unsigned char *p = (const unsigned char *)packet.constData();
+    return (p[4] << 24) | (p[5] << 16) | (p[6] << 8) | p[7];
+}
+
+static int ddpLength(const QByteArray & packet)
+{
+    const unsigned char *p = (const unsigned char *)packet.constData();
+    return (p[8] << 8) | p[9];
+}
+
+static QByteArray makeFrame(int ledsCount, int seed)
+{
+    QByteArray frame(ledsCount * 3, 0);
+
+    for (int i = 0; i < frame.size(); i++)
+        frame[i] = (char)((i * 7 + seed) & 0xff);
+
+    return frame;
+}
+
+DdpSenderTest::DdpSenderTest(QObject *parent) :
+    QObject(parent)
+{
+    m_receiver = NULL;
+}
+
+void DdpSenderTest::init()
+{
+    // Stub of the LED controller
+    m_receiver = new QUdpSocket();
+    QVERIFY( m_receiver->bind(QHostAddress::LocalHost, 0) );
+}
+
+void DdpSenderTest::cleanup()
+{
+    delete m_receiver;
+    m_receiver = NULL;
+}
+
+QList<QByteArray> DdpSenderTest::receivePackets(int count)
+{
+    QList<QByteArray> packets;
+    QTime time;
+    time.start();
+
+    while (packets.count() < count && time.elapsed() < 1000)
+    {
+        if (m_receiver->hasPendingDatagrams() == false)
+            m_receiver->waitForReadyRead(100);
+
+        while (m_receiver->hasPendingDatagrams())
+        {
+            QByteArray datagram(m_receiver->pendingDatagramSize(), 0);
+            m_receiver->readDatagram(datagram.data(), datagram.size());
+            packets << datagram;
+        }
+    }
+
+    return packets;
+}
+
+void DdpSenderTest::testPayloadSize()
+{
+    DdpSender sender;
+
+    // 1500 - 28 (IPv4 + UDP) - 10 (DDP) = 1462, whole LEDs only
+    QCOMPARE( sender.payloadSize(), 1461 );
+    QCOMPARE( sender.packetsPerFrame(3 * 487), 1 );
+    QCOMPARE( sender.packetsPerFrame(3 * 488), 2 );
+
+    sender.setMtu(100);
+    QCOMPARE( sender.payloadSize(), 60 );
+
+    // At least one LED per packet
+    sender.setMtu(0);
+    QCOMPARE( sender.payloadSize(), 3 );
+}
+
+void DdpSenderTest::testFrameSplitByMtu()
+{
+    DdpSender sender;
+    QVERIFY( sender.open("127.0.0.1", m_receiver->localPort()) );
+
+    QByteArray frame = makeFrame(1000, 1);
+    QVERIFY( sender.sendFrame(frame.constData(), frame.size()) );
+
+    QList<QByteArray> packets = receivePackets(3);
+    QCOMPARE( packets.count(), 3 );
+
+    QByteArray received(frame.size(), 0);
+
+    for (int i = 0; i < packets.count(); i++)
+    {
+        const QByteArray & packet = packets[i];
+        bool isLast = (i == packets.count() - 1);
+
+        QVERIFY( packet.size() <= sender.mtu() - DdpSender::TransportOverhead );
+        QCOMPARE( (quint8)packet[0], (quint8)(isLast ? 0x41 : 0x40) );
+        QCOMPARE( (quint8)packet[1], (quint8)1 );
+        QCOMPARE( (quint8)packet[2], (quint8)0x0B );
+        QCOMPARE( (quint8)packet[3], (quint8)0x01 );
+        QCOMPARE( ddpLength(packet), packet.size() - 10 );
+        QCOMPARE( ddpLength(packet) % 3, 0 );
+
+        received.replace(ddpOffset(packet), ddpLength(packet), packet.mid(10));
+    }
+
+    QCOMPARE( received, frame );
+}
+
+void DdpSenderTest::testSequenceWraps()
+{
+    DdpSender sender;
+    QVERIFY( sender.open("127.0.0.1", m_receiver->localPort()) );
+
+    QByteArray frame = makeFrame(10, 2);
+
+    for (int i = 0; i < 20; i++)
+    {
+        QVERIFY( sender.sendFrame(frame.constData(), frame.size()) );
+
+        QList<QByteArray> packets = receivePackets(1);
+        QCOMPARE( packets.count(), 1 );
+
+        // Sequence 0 means "not used", so it goes 1..15
+        QCOMPARE( (int)(quint8)packets[0][1], (i % 15) + 1 );
+    }
+}
+
+void DdpSenderTest::testSmallFrameIsOnePacket()
+{
+    DdpSender sender;
+    QVERIFY( sender.open("127.0.0.1", m_receiver->localPort()) );
+
+    QByteArray frame = makeFrame(25, 3);
+    QVERIFY( sender.sendFrame(frame.constData(), frame.size()) );
+
+    QList<QByteArray> packets = receivePackets(1);
+    QCOMPARE( packets.count(), 1 );
+    QCOMPARE( (quint8)packets[0][0], (quint8)0x41 );
+    QCOMPARE( ddpOffset(packets[0]), 0 );
+    QCOMPARE( packets[0].mid(10), frame );
+}
+
+void DdpSenderTest::testIPv6HostIsRejected()
+{
+    DdpSender sender;
+
+    // Destination is IPv4 only, IPv6 must not turn into 0.0.0.0
+    QVERIFY( sender.open("::1", m_receiver->localPort()) == false );
+    QVERIFY( sender.open("fe80::1", m_receiver->localPort()) == false );
+}
+
+void DdpSenderTest::benchmarkSendFrame()
+{
+    DdpSender sender;
+    QVERIFY( sender.open("127.0.0.1", m_receiver->localPort()) );
+
+    // 4096 LEDs: 9 packets per frame
+    QByteArray frame = makeFrame(4096, 4);
+
+    QBENCHMARK {
+        sender.sendFrame(frame.constData(), frame.size());
+        // Keep receiver buffer from overflow
+        while (m_receiver->hasPendingDatagrams())
+        {
+            char byte;
+            m_receiver->readDatagram(&byte, 1);
+        }
+    }
+}
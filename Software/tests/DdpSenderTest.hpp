@@ -0,0 +1,34 @@
+#ifndef DDPSENDERTEST_HPP
+#define DDPSENDERTEST_HPP
+
+#include <QObject>
+#include <QList>
+#include <QByteArray>
+
+class QUdpSocket;
+
+class DdpSenderTest : public QObject
+{
+    Q_OBJECT
+public:
+    explicit DdpSenderTest(QObject *parent = 0);
+
+private slots:
+    void init();
+    void cleanup();
+
+    void testPayloadSize();
+    void testFrameSplitByMtu();
+    void testSequenceWraps();
+    void testSmallFrameIsOnePacket();
+    void testIPv6HostIsRejected();
+    void benchmarkSendFrame();
+
+private:
+    QList<QByteArray> receivePackets(int count);
+
+private:
+    QUdpSocket *m_receiver;
+};
+
+#endif // DDPSENDERTEST_HPP
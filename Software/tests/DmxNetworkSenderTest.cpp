@@ -0,0 +1,259 @@
+#include "DmxNetworkSenderTest.hpp"
+#include "DmxNetworkSender.hpp"
+#include <QtTest/QtTest>
+#include <QUdpSocket>
+
+static int readWord(const QByteArray & packet, int index)
+{
+    const unsigned char *p = (const unsigned char *)packet.constData();
+    return (p[index] << 8) | p[index + 1];
+}
+
+static QByteArray makeFrame(int ledsCount, int seed)
+{
+    QByteArray frame(ledsCount * 3, 0);
+
+    for (int i = 0; i < frame.size(); i++)
+        frame[i] = (char)((i * 5 + seed) & 0xff);
+
+    return frame;
+}
+
+DmxNetworkSenderTest::DmxNetworkSenderTest(QObject *parent) :
+    QObject(parent)
+{
+    m_receiver = NULL;
+}
+
+void DmxNetworkSenderTest::init()
+{
+    // Stub of the DMX node
+    m_receiver = new QUdpSocket();
+    QVERIFY( m_receiver->bind(QHostAddress::LocalHost, 0) );
+}
+
+void DmxNetworkSenderTest::cleanup()
+{
+    delete m_receiver;
+    m_receiver = NULL;
+}
+
+QList<QByteArray> DmxNetworkSenderTest::receivePackets(int count)
+{
+    QList<QByteArray> packets;
+    QTime time;
+    time.start();
+
+    while (packets.count() < count && time.elapsed() < 1000)
+    {
+        if (m_receiver->hasPendingDatagrams() == false)
+            m_receiver->waitForReadyRead(100);
+
+        while (m_receiver->hasPendingDatagrams())
+        {
+            QByteArray datagram(m_receiver->pendingDatagramSize(), 0);
+            m_receiver->readDatagram(datagram.data(), datagram.size());
+            packets << datagram;
+        }
+    }
+
+    return packets;
+}
+
+void DmxNetworkSenderTest::testUniversesLayout()
+{
+    DmxNetworkSender sender;
+
+    sender.setUniverse(1, 1);
+    QCOMPARE( sender.ledsInUniverse(0), 170 );
+    QCOMPARE( sender.universesCount(170), 1 );
+    QCOMPARE( sender.universesCount(171), 2 );
+
+    // Channels before the start address are left to other fixtures
+    sender.setUniverse(1, 100);
+    QCOMPARE( sender.ledsInUniverse(0), 137 );
+    QCOMPARE( sender.ledsInUniverse(1), 170 );
+    QCOMPARE( sender.universesCount(137), 1 );
+    QCOMPARE( sender.universesCount(308), 3 );
+}
+
+void DmxNetworkSenderTest::testE131DataPackets()
+{
+    DmxNetworkSender sender;
+    sender.setUniverse(7, 10);
+    QVERIFY( sender.open(DmxNetworkSender::ProtocolE131, "127.0.0.1", m_receiver->localPort()) );
+
+    // 165 LEDs fit into the first universe, 35 go to the next one
+    QByteArray frame = makeFrame(200, 1);
+    QVERIFY( sender.sendFrame(frame.constData(), frame.size()) );
+
+    QList<QByteArray> packets = receivePackets(2);
+    QCOMPARE( packets.count(), 2 );
+
+    for (int i = 0; i < packets.count(); i++)
+    {
+        const QByteArray & packet = packets[i];
+        int firstSlot = (i == 0) ? 9 : 0;
+        int leds = (i == 0) ? 165 : 35;
+
+        QCOMPARE( packet.size(), DmxNetworkSender::E131DataHeaderSize + firstSlot + leds * 3 );
+        QCOMPARE( packet.mid(4, 9), QByteArray("ASC-E1.17") );
+        QCOMPARE( readWord(packet, 16) & 0x0fff, packet.size() - 16 );
+        QCOMPARE( readWord(packet, 38) & 0x0fff, packet.size() - 38 );
+        QCOMPARE( packet.mid(44, 9), QByteArray("Lightpack") );
+        QCOMPARE( (int)(quint8)packet[108], 100 );
+        QCOMPARE( readWord(packet, 113), 7 + i );
+        QCOMPARE( readWord(packet, 115) & 0x0fff, packet.size() - 115 );
+        QCOMPARE( readWord(packet, 123), firstSlot + leds * 3 + 1 );
+
+        QByteArray dmxData = packet.mid(DmxNetworkSender::E131DataHeaderSize);
+        QCOMPARE( dmxData.left(firstSlot), QByteArray(firstSlot, 0) );
+        QCOMPARE( dmxData.mid(firstSlot), frame.mid(i * 165 * 3, leds * 3) );
+    }
+}
+
+void DmxNetworkSenderTest::testE131SyncIsLast()
+{
+    DmxNetworkSender sender;
+    sender.setUniverse(1, 1);
+    sender.setSyncEnabled(true);
+    QVERIFY( sender.open(DmxNetworkSender::ProtocolE131, "127.0.0.1", m_receiver->localPort()) );
+
+    QByteArray frame = makeFrame(400, 2);
+    QVERIFY( sender.sendFrame(frame.constData(), frame.size()) );
+
+    QList<QByteArray> packets = receivePackets(4);
+    QCOMPARE( packets.count(), 4 );
+
+    for (int i = 0; i < 3; i++)
+    {
+        // Data waits for the sync packet addressed to the first universe
+        QCOMPARE( readWord(packets[i], 109), 1 );
+        QCOMPARE( readWord(packets[i], 113), 1 + i );
+    }
+
+    const QByteArray & sync = packets[3];
+    QCOMPARE( sync.size(), DmxNetworkSender::E131SyncPacketSize );
+    QCOMPARE( (int)(quint8)sync[21], 0x08 );
+    QCOMPARE( (int)(quint8)sync[43], 0x01 );
+    QCOMPARE( readWord(sync, 45), 1 );
+}
+
+void DmxNetworkSenderTest::testE131SequenceIncrements()
+{
+    DmxNetworkSender sender;
+    QVERIFY( sender.open(DmxNetworkSender::ProtocolE131, "127.0.0.1", m_receiver->localPort()) );
+
+    QByteArray frame = makeFrame(10, 3);
+    quint8 previous = 0;
+
+    for (int i = 0; i < 300; i++)
+    {
+        QVERIFY( sender.sendFrame(frame.constData(), frame.size()) );
+
+        QList<QByteArray> packets = receivePackets(1);
+        QCOMPARE( packets.count(), 1 );
+
+        quint8 sequence = packets[0][111];
+        if (i > 0)
+            QCOMPARE( sequence, (quint8)(previous + 1) );
+        previous = sequence;
+    }
+}
+
+void DmxNetworkSenderTest::testArtNetDataPackets()
+{
+    DmxNetworkSender sender;
+    sender.setUniverse(0x123, 1);
+    QVERIFY( sender.open(DmxNetworkSender::ProtocolArtNet, "127.0.0.1", m_receiver->localPort()) );
+
+    // 171 LEDs: full universe and one LED, which is padded to even length
+    QByteArray frame = makeFrame(171, 4);
+
+    for (int n = 0; n < 256; n++)
+    {
+        QVERIFY( sender.sendFrame(frame.constData(), frame.size()) );
+
+        QList<QByteArray> packets = receivePackets(2);
+        QCOMPARE( packets.count(), 2 );
+
+        for (int i = 0; i < packets.count(); i++)
+        {
+            const QByteArray & packet = packets[i];
+
+            QCOMPARE( packet.left(8), QByteArray("Art-Net", 8) );
+            QCOMPARE( (int)(quint8)packet[8], 0x00 );
+            QCOMPARE( (int)(quint8)packet[9], 0x50 );
+            QCOMPARE( readWord(packet, 10), 14 );
+            // Sequence 0 disables reordering, so it is skipped
+            QVERIFY( packet[12] != 0 );
+            QCOMPARE( (int)(quint8)packet[14], (0x123 + i) & 0xff );
+            QCOMPARE( (int)(quint8)packet[15], (0x123 + i) >> 8 );
+            QCOMPARE( readWord(packet, 16) % 2, 0 );
+            QCOMPARE( readWord(packet, 16), packet.size() - DmxNetworkSender::ArtNetDataHeaderSize );
+        }
+
+        QCOMPARE( readWord(packets[0], 16), 510 );
+        QCOMPARE( readWord(packets[1], 16), 4 );
+        QCOMPARE( packets[1].mid(DmxNetworkSender::ArtNetDataHeaderSize, 3), frame.right(3) );
+    }
+}
+
+void DmxNetworkSenderTest::testUniverseRange()
+{
+    QByteArray frame = makeFrame(10, 5);
+
+    // Universe 0 is reserved by E1.31
+    DmxNetworkSender e131Sender;
+    e131Sender.setUniverse(0, 1);
+    QVERIFY( e131Sender.open(DmxNetworkSender::ProtocolE131, "127.0.0.1", m_receiver->localPort()) );
+    QVERIFY( e131Sender.sendFrame(frame.constData(), frame.size()) );
+
+    QList<QByteArray> packets = receivePackets(1);
+    QCOMPARE( packets.count(), 1 );
+    QCOMPARE( readWord(packets[0], 113), 1 );
+
+    // Art-Net port-address 0 is valid, the highest one is 32767
+    DmxNetworkSender artNetSender;
+    artNetSender.setUniverse(0, 1);
+    QVERIFY( artNetSender.open(DmxNetworkSender::ProtocolArtNet, "127.0.0.1", m_receiver->localPort()) );
+    QVERIFY( artNetSender.sendFrame(frame.constData(), frame.size()) );
+
+    packets = receivePackets(1);
+    QCOMPARE( packets.count(), 1 );
+    QCOMPARE( (int)(quint8)packets[0][14], 0 );
+    QCOMPARE( (int)(quint8)packets[0][15], 0 );
+
+    artNetSender.setUniverse(63999, 1);
+    QVERIFY( artNetSender.sendFrame(frame.constData(), frame.size()) );
+
+    packets = receivePackets(1);
+    QCOMPARE( packets.count(), 1 );
+    QCOMPARE( (int)(quint8)packets[0][14], 0xff );
+    QCOMPARE( (int)(quint8)packets[0][15], 0x7f );
+}
+
+void DmxNetworkSenderTest::testArtNetSync()
+{
+    DmxNetworkSender sender;
+    sender.setSyncEnabled(true);
+    QVERIFY( sender.open(DmxNetworkSender::ProtocolArtNet, "127.0.0.1", m_receiver->localPort()) );
+
+    QByteArray frame = makeFrame(20, 5);
+    QVERIFY( sender.sendFrame(frame.constData(), frame.size()) );
+
+    QList<QByteArray> packets = receivePackets(2);
+    QCOMPARE( packets.count(), 2 );
+
+    const QByteArray & sync = packets[1];
+    QCOMPARE( sync.size(), DmxNetworkSender::ArtNetSyncPacketSize );
+    QCOMPARE( sync.left(8), QByteArray("Art-Net", 8) );
+    QCOMPARE( (int)(quint8)sync[8], 0x00 );
+    QCOMPARE( (int)(quint8)sync[9], 0x52 );
+}
+
+void DmxNetworkSenderTest::testMulticastAddress()
+{
+    QCOMPARE( DmxNetworkSender::e131MulticastAddress(1), QHostAddress("239.255.0.1") );
+    QCOMPARE( DmxNetworkSender::e131MulticastAddress(0x1234), QHostAddress("239.255.18.52") );
+}
@@ -0,0 +1,36 @@
+#ifndef DMXNETWORKSENDERTEST_HPP
+#define DMXNETWORKSENDERTEST_HPP
+
+#include <QObject>
+#include <QList>
+#include <QByteArray>
+
+class QUdpSocket;
+
+class DmxNetworkSenderTest : public QObject
+{
+    Q_OBJECT
+public:
+    explicit DmxNetworkSenderTest(QObject *parent = 0);
+
+private slots:
+    void init();
+    void cleanup();
+
+    void testUniversesLayout();
+    void testE131DataPackets();
+    void testE131SyncIsLast();
+    void testE131SequenceIncrements();
+    void testArtNetDataPackets();
+    void testUniverseRange();
+    void testArtNetSync();
+    void testMulticastAddress();
+
+private:
+    QList<QByteArray> receivePackets(int count);
+
+private:
+    QUdpSocket *m_receiver;
+};
+
+#endif // DMXNETWORKSENDERTEST_HPP
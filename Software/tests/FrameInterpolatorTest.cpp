@@ -0,0 +1,116 @@
+#include "FrameInterpolatorTest.hpp"
+#include "FrameInterpolator.hpp"
+#include <QtTest/QtTest>
+
+namespace
+{
+QList<QRgb> frame(QRgb first, QRgb second)
+{
+    QList<QRgb> colors;
+    colors << first << second;
+    return colors;
+}
+}
+
+FrameInterpolatorTest::FrameInterpolatorTest(QObject *parent) :
+    QObject(parent)
+{
+    m_framesCount = 0;
+}
+
+void FrameInterpolatorTest::frameReady(const QList<QRgb> & colors)
+{
+    m_lastFrame = colors;
+    m_framesCount++;
+}
+
+void FrameInterpolatorTest::init()
+{
+    m_lastFrame.clear();
+    m_framesCount = 0;
+}
+
+void FrameInterpolatorTest::testSmoothSlowdownToTimeConstant()
+{
+    FrameInterpolator interpolator;
+    QVERIFY( interpolator.isEnabled() == false );
+
+    interpolator.setSmoothSlowdown(30);
+    QVERIFY( interpolator.isEnabled() );
+    QCOMPARE( interpolator.timeConstant(), 10.0 );
+
+    interpolator.setSmoothSlowdown(0);
+    QVERIFY( interpolator.isEnabled() == false );
+}
+
+void FrameInterpolatorTest::testFirstTargetIsShownAtOnce()
+{
+    FrameInterpolator interpolator;
+    interpolator.setTimeConstant(10);
+    connect(&interpolator, SIGNAL(frameReady(QList<QRgb>)), this, SLOT(frameReady(QList<QRgb>)));
+
+    QList<QRgb> colors = frame(qRgb(10, 20, 30), qRgb(40, 50, 60));
+    interpolator.setTarget(colors);
+
+    QCOMPARE( m_framesCount, 1 );
+    QCOMPARE( m_lastFrame, colors );
+    QVERIFY( interpolator.isMoving() == false );
+}
+
+void FrameInterpolatorTest::testEasesToTarget()
+{
+    FrameInterpolator interpolator;
+    interpolator.setTimeConstant(10);
+    interpolator.setFrameInterval(16);
+    connect(&interpolator, SIGNAL(frameReady(QList<QRgb>)), this, SLOT(frameReady(QList<QRgb>)));
+
+    QList<QRgb> target = frame(qRgb(255, 255, 255), qRgb(255, 128, 0));
+    interpolator.jumpTo(frame(0, 0));
+    interpolator.setTarget(target);
+
+    // First step is made at once: 255 * (1 - exp(-16 / 10))
+    QCOMPARE( m_framesCount, 1 );
+    QCOMPARE( qRed(m_lastFrame[0]), 204 );
+    QVERIFY( interpolator.isMoving() );
+
+    int previous = qRed(m_lastFrame[0]);
+    for (int i = 0; i < 5; i++)
+    {
+        interpolator.advance(10);
+        QVERIFY( qRed(m_lastFrame[0]) >= previous );
+        previous = qRed(m_lastFrame[0]);
+    }
+
+    interpolator.advance(200);
+    QCOMPARE( m_lastFrame, target );
+    QVERIFY( interpolator.isMoving() == false );
+}
+
+void FrameInterpolatorTest::testJumpToStopsEasing()
+{
+    FrameInterpolator interpolator;
+    interpolator.setTimeConstant(100);
+    connect(&interpolator, SIGNAL(frameReady(QList<QRgb>)), this, SLOT(frameReady(QList<QRgb>)));
+
+    interpolator.jumpTo(frame(0, 0));
+    interpolator.setTarget(frame(qRgb(255, 255, 255), qRgb(255, 255, 255)));
+    QVERIFY( interpolator.isMoving() );
+
+    interpolator.jumpTo(frame(0, 0));
+    QVERIFY( interpolator.isMoving() == false );
+
+    // Next target eases from the jumped colors
+    interpolator.setTarget(frame(0, 0));
+    QCOMPARE( m_lastFrame, frame(0, 0) );
+}
+
+void FrameInterpolatorTest::testFrameIntervalIsLimited()
+{
+    FrameInterpolator interpolator;
+
+    interpolator.setFrameInterval(1);
+    QCOMPARE( interpolator.frameInterval(), FrameInterpolator::MinimumFrameIntervalMs );
+
+    interpolator.setFrameInterval(25);
+    QCOMPARE( interpolator.frameInterval(), 25 );
+}
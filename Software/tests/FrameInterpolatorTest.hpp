@@ -0,0 +1,30 @@
+#ifndef FRAMEINTERPOLATORTEST_HPP
+#define FRAMEINTERPOLATORTEST_HPP
+
+#include <QObject>
+#include <QList>
+#include <QColor>
+
+class FrameInterpolatorTest : public QObject
+{
+    Q_OBJECT
+public:
+    explicit FrameInterpolatorTest(QObject *parent = 0);
+
+public slots:
+    void frameReady(const QList<QRgb> & colors);
+
+private slots:
+    void init();
+    void testSmoothSlowdownToTimeConstant();
+    void testFirstTargetIsShownAtOnce();
+    void testEasesToTarget();
+    void testJumpToStopsEasing();
+    void testFrameIntervalIsLimited();
+
+private:
+    QList<QRgb> m_lastFrame;
+    int m_framesCount;
+};
+
+#endif // FRAMEINTERPOLATORTEST_HPP
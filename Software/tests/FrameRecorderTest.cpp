@@ -0,0 +1,170 @@
+#include "FrameRecorderTest.hpp"
+#include "FrameRecorder.hpp"
+#include "FramePlayer.hpp"
+#include <QtTest/QtTest>
+#include <QDir>
+
+static QList<QRgb> makeFrame(int ledsCount, int seed)
+{
+    QList<QRgb> colors;
+
+    for (int i = 0; i < ledsCount; i++)
+        colors << qRgb(i + seed, i * 3 + seed, 255 - i);
+
+    return colors;
+}
+
+FrameRecorderTest::FrameRecorderTest(QObject *parent) :
+    QObject(parent)
+{
+}
+
+void FrameRecorderTest::init()
+{
+    qRegisterMetaType< QList<QRgb> >("QList<QRgb>");
+
+    m_fileName = QDir::temp().filePath("LightpackFrameRecorderTest.log");
+}
+
+void FrameRecorderTest::cleanup()
+{
+    QFile::remove(m_fileName);
+}
+
+void FrameRecorderTest::testRoundTrip()
+{
+    FrameRecorder recorder;
+    QVERIFY( recorder.open(m_fileName) );
+
+    for (int i = 0; i < 10; i++)
+        QVERIFY( recorder.append(makeFrame(10 + i, i)) );
+
+    // Empty frames are not recorded
+    QVERIFY( recorder.append(QList<QRgb>()) == false );
+    QCOMPARE( recorder.framesCount(), (quint32)10 );
+
+    qint64 size = recorder.size();
+    recorder.close();
+
+    QCOMPARE( QFileInfo(m_fileName).size(), size );
+
+    FramePlayer player;
+    QVERIFY( player.open(m_fileName) );
+    QCOMPARE( player.framesCount(), 10 );
+
+    QList<QRgb> colors;
+
+    for (int i = 0; i < 10; i++)
+    {
+        QCOMPARE( player.frameSequence(i), (quint32)i );
+        if (i > 0)
+            QVERIFY( player.frameTimestamp(i) >= player.frameTimestamp(i - 1) );
+
+        player.readFrame(i, colors);
+        QCOMPARE( colors, makeFrame(10 + i, i) );
+    }
+}
+
+void FrameRecorderTest::testGrowsPastInitialCapacity()
+{
+    FrameRecorder recorder;
+    QVERIFY( recorder.open(m_fileName) );
+
+    QList<QRgb> frame = makeFrame(255, 1);
+    int framesCount = 2 * FrameRecorder::InitialCapacity / (16 + 255 * 4) + 1;
+
+    for (int i = 0; i < framesCount; i++)
+        QVERIFY( recorder.append(frame) );
+
+    QVERIFY( recorder.size() > 2 * FrameRecorder::InitialCapacity );
+    recorder.close();
+
+    FramePlayer player;
+    QVERIFY( player.open(m_fileName) );
+    QCOMPARE( player.framesCount(), framesCount );
+
+    QList<QRgb> colors;
+    player.readFrame(framesCount - 1, colors);
+    QCOMPARE( colors, frame );
+}
+
+void FrameRecorderTest::testUnclosedLogEndsAtLastFrame()
+{
+    FrameRecorder recorder;
+    QVERIFY( recorder.open(m_fileName) );
+
+    for (int i = 0; i < 3; i++)
+        QVERIFY( recorder.append(makeFrame(50, i)) );
+
+    // File still has the preallocated zero tail, as after a crash
+    QVERIFY( QFileInfo(m_fileName).size() > recorder.size() );
+
+    FramePlayer player;
+    QVERIFY( player.open(m_fileName) );
+    QCOMPARE( player.framesCount(), 3 );
+}
+
+void FrameRecorderTest::testNotFrameLogIsRejected()
+{
+    QFile file(m_fileName);
+    QVERIFY( file.open(QIODevice::WriteOnly) );
+    file.write(QByteArray(64, 'x'));
+    file.close();
+
+    FramePlayer player;
+    QVERIFY( player.open(m_fileName) == false );
+    QVERIFY( player.isOpen() == false );
+}
+
+void FrameRecorderTest::testReplaySpeed()
+{
+    FrameRecorder recorder;
+    QVERIFY( recorder.open(m_fileName) );
+
+    // 5 frames in ~400 ms
+    for (int i = 0; i < 5; i++)
+    {
+        if (i > 0)
+            QTest::qSleep(100);
+        QVERIFY( recorder.append(makeFrame(5, i)) );
+    }
+    recorder.close();
+
+    FramePlayer player;
+    QVERIFY( player.open(m_fileName) );
+
+    QSignalSpy framesSpy(&player, SIGNAL(frameReady(QList<QRgb>)));
+    QSignalSpy finishedSpy(&player, SIGNAL(finished()));
+
+    QElapsedTimer time;
+    time.start();
+
+    player.start(4.0);
+
+    // First frame goes at once
+    QCOMPARE( framesSpy.count(), 1 );
+    QVERIFY( player.isPlaying() );
+
+    while (finishedSpy.count() == 0 && time.elapsed() < 2000)
+        QTest::qWait(5);
+
+    QCOMPARE( finishedSpy.count(), 1 );
+    QCOMPARE( framesSpy.count(), 5 );
+    QVERIFY( player.isPlaying() == false );
+
+    // 400 ms at 4x speed
+    QVERIFY( time.elapsed() >= 95 );
+    QVERIFY( time.elapsed() < 300 );
+}
+
+void FrameRecorderTest::benchmarkAppend()
+{
+    FrameRecorder recorder;
+    QVERIFY( recorder.open(m_fileName) );
+
+    QList<QRgb> frame = makeFrame(255, 2);
+
+    QBENCHMARK {
+        recorder.append(frame);
+    }
+}
@@ -0,0 +1,28 @@
+#ifndef FRAMERECORDERTEST_HPP
+#define FRAMERECORDERTEST_HPP
+
+#include <QObject>
+#include <QString>
+
+class FrameRecorderTest : public QObject
+{
+    Q_OBJECT
+public:
+    explicit FrameRecorderTest(QObject *parent = 0);
+
+private slots:
+    void init();
+    void cleanup();
+
+    void testRoundTrip();
+    void testGrowsPastInitialCapacity();
+    void testUnclosedLogEndsAtLastFrame();
+    void testNotFrameLogIsRejected();
+    void testReplaySpeed();
+    void benchmarkAppend();
+
+private:
+    QString m_fileName;
+};
+
+#endif // FRAMERECORDERTEST_HPP
@@ -0,0 +1,162 @@
+#include "HidAsyncWriteTest.hpp"
+#include "libusb_mock.h"
+#include <QtTest/QtTest>
+
+namespace
+{
+const unsigned short VendorId = 0x1d50;
+const unsigned short ProductId = 0x6022;
+const int ReportSize = 65; // report id + 64 bytes
+}
+
+HidAsyncWriteTest::HidAsyncWriteTest(QObject *parent) :
+    QObject(parent)
+{
+    m_device = NULL;
+}
+
+void HidAsyncWriteTest::init()
+{
+    libusb_mock_reset(VendorId, ProductId);
+
+    m_results.clear();
+
+    m_device = hid_open(VendorId, ProductId, NULL);
+    QVERIFY( m_device != NULL );
+}
+
+void HidAsyncWriteTest::cleanup()
+{
+    hid_close(m_device);
+    m_device = NULL;
+}
+
+void HidAsyncWriteTest::testWriteWithoutDepthFails()
+{
+    unsigned char report[ReportSize] = { 0 };
+
+    QCOMPARE( hid_write_async(m_device, report, sizeof(report), writeCallback, this), -1 );
+    QCOMPARE( hid_write(m_device, report, sizeof(report)), ReportSize );
+}
+
+void HidAsyncWriteTest::testQueueDepth()
+{
+    QCOMPARE( hid_set_write_depth(m_device, 3), 0 );
+
+    QCOMPARE( writeReport(1), ReportSize );
+    QCOMPARE( writeReport(2), ReportSize );
+    QCOMPARE( writeReport(3), ReportSize );
+
+    // All transfers are on the bus
+    QCOMPARE( writeReport(4), 0 );
+    QCOMPARE( hid_write_async_in_flight(m_device), 3 );
+    QCOMPARE( libusb_mock_pending_writes(), 3 );
+
+    // Depth can't be changed with writes in flight
+    QCOMPARE( hid_set_write_depth(m_device, 1), -1 );
+
+    QCOMPARE( libusb_mock_complete_writes(1), 1 );
+    QVERIFY( waitForResults(1) );
+    QCOMPARE( hid_write_async_in_flight(m_device), 2 );
+
+    QCOMPARE( writeReport(4), ReportSize );
+    QCOMPARE( libusb_mock_max_pending_writes(), 3 );
+}
+
+void HidAsyncWriteTest::testCompletionOrder()
+{
+    QCOMPARE( hid_set_write_depth(m_device, 4), 0 );
+
+    // Bus takes 2 ms for each report
+    libusb_mock_set_write_latency(2000);
+
+    int written = 0;
+    for (int id = 0; id < 20; id++)
+    {
+        while (writeReport(id) == 0)
+            QTest::qSleep(1);
+        written++;
+    }
+    QVERIFY( waitForResults(written) );
+
+    QMutexLocker locker(&m_mutex);
+    QCOMPARE( m_results.count(), 20 );
+    QCOMPARE( m_results.count(ReportSize), 20 );
+    locker.unlock();
+
+    // Device got reports in the same order, without report id
+    QCOMPARE( libusb_mock_written_reports(), 20 );
+    for (int i = 0; i < 20; i++)
+    {
+        unsigned char data[LIBUSB_MOCK_REPORT_SIZE];
+        QCOMPARE( libusb_mock_written_report(i, data, sizeof(data)), ReportSize - 1 );
+        QCOMPARE( (int)data[0], i );
+    }
+    QVERIFY( libusb_mock_max_pending_writes() <= 4 );
+}
+
+void HidAsyncWriteTest::testCloseCancelsWrites()
+{
+    QCOMPARE( hid_set_write_depth(m_device, 2), 0 );
+
+    QCOMPARE( writeReport(1), ReportSize );
+    QCOMPARE( writeReport(2), ReportSize );
+
+    hid_close(m_device);
+    m_device = NULL;
+
+    // Callbacks are called before hid_close() returns
+    QMutexLocker locker(&m_mutex);
+    QCOMPARE( m_results, QList<int>() << -1 << -1 );
+
+    locker.unlock();
+
+    libusb_mock_reset(VendorId, ProductId);
+    m_device = hid_open(VendorId, ProductId, NULL);
+    QVERIFY( m_device != NULL );
+}
+
+void HidAsyncWriteTest::testUnplugFailsWrites()
+{
+    QCOMPARE( hid_set_write_depth(m_device, 2), 0 );
+
+    QCOMPARE( writeReport(1), ReportSize );
+    libusb_mock_unplug();
+
+    QVERIFY( waitForResults(1) );
+    QCOMPARE( m_results.first(), -1 );
+    QCOMPARE( writeReport(2), -1 );
+}
+
+void HidAsyncWriteTest::writeCallback(hid_device * /*device*/, void *userData, int result)
+{
+    HidAsyncWriteTest *self = static_cast<HidAsyncWriteTest *>(userData);
+
+    QMutexLocker locker(&self->m_mutex);
+    self->m_results << result;
+}
+
+bool HidAsyncWriteTest::waitForResults(int count, int timeoutMs)
+{
+    QTime time;
+    time.start();
+
+    while (time.elapsed() < timeoutMs)
+    {
+        {
+            QMutexLocker locker(&m_mutex);
+            if (m_results.count() >= count)
+                return true;
+        }
+        QTest::qSleep(1);
+    }
+    return false;
+}
+
+int HidAsyncWriteTest::writeReport(unsigned char id)
+{
+    unsigned char report[ReportSize] = { 0 };
+    report[1] = id;
+
+    return hid_write_async(m_device, report, sizeof(report), writeCallback, this);
+}
@@ -0,0 +1,37 @@
+#ifndef HIDASYNCWRITETEST_HPP
+#define HIDASYNCWRITETEST_HPP
+
+#include <QObject>
+#include <QList>
+#include <QMutex>
+#include "hidapi.h"
+
+class HidAsyncWriteTest : public QObject
+{
+    Q_OBJECT
+public:
+    explicit HidAsyncWriteTest(QObject *parent = 0);
+
+private slots:
+    void init();
+    void cleanup();
+
+    void testWriteWithoutDepthFails();
+    void testQueueDepth();
+    void testCompletionOrder();
+    void testCloseCancelsWrites();
+    void testUnplugFailsWrites();
+
+private:
+    static void writeCallback(hid_device *device, void *userData, int result);
+    bool waitForResults(int count, int timeoutMs = 1000);
+    int writeReport(unsigned char id);
+
+private:
+    hid_device *m_device;
+
+    QMutex m_mutex;
+    QList<int> m_results;
+};
+
+#endif // HIDASYNCWRITETEST_HPP
@@ -60,7 +60,7 @@ void LightpackApiTest::initTestCase()
     m_socket = NULL;
 
     // Start Api Server in separate thread for access by QTcpSocket-s
-    m_apiServer = new ApiServer(3636);
+    m_apiServer = new ApiServer(3636, 3637, "lightpack-api-test");
     m_interfaceApi = new LightpackPluginInterface();
     m_apiServer->setInterface(m_interfaceApi);
     m_apiServerThread = new QThread();
@@ -361,6 +361,8 @@ void LightpackApiTest::testCase_SetColorValid_data()
     QTest::newRow("8") << "10-255,255,255;" << 10 << 255 << 255 << 255;
     QTest::newRow("9") << "10-0,0,1;" << 10 << 0 << 0 << 1;
     QTest::newRow("10") << "10-1,0,0;" << 10 << 1 << 0 << 0;
+    QTest::newRow("11") << "1..10-3,2,1;" << 10 << 3 << 2 << 1;
+    QTest::newRow("12") << "2-#0a0B0c;" << 2 << 10 << 11 << 12;
 }
 
 void LightpackApiTest::testCase_SetColorValid2()
@@ -442,6 +444,267 @@ void LightpackApiTest::testCase_SetColorInvalid_data()
     QTest::newRow("17") << "1-1,1,1;;";
 }
 
+void LightpackApiTest::testCase_SetColorPipelined()
+{
+    QTcpSocket sockOther;
+    sockOther.connectToHost("127.0.0.1", 3636);
+    QVERIFY(checkVersion(&sockOther));
+
+    QVERIFY(lock(m_socket));
+
+    // Commands are sent without waiting for replies, replies come in the same order
+    QByteArray setColorCmd = ApiServer::CmdSetColor;
+    QByteArray commands;
+    commands += setColorCmd + "1-1,1,1;\n";
+    commands += setColorCmd + "1-1,1,256;\n";
+    commands += setColorCmd + "2-4,5,6;\n";
+    commands += ApiServer::CmdGetStatusAPI + QByteArray("\n");
+    commands += setColorCmd + "1-7,8,9;\n";
+
+    m_socket->write(commands);
+
+    // Other clients are not blocked by running tasks
+    QVERIFY(writeCommandWithCheck(&sockOther, setColorCmd + "1-1,1,1;", ApiServer::CmdSetResult_Busy));
+
+    QVERIFY(readResult(m_socket) == ApiServer::CmdSetResult_Ok);
+    QVERIFY(readResult(m_socket) == ApiServer::CmdSetResult_Error);
+    QVERIFY(readResult(m_socket) == ApiServer::CmdSetResult_Ok);
+    QVERIFY(readResult(m_socket) == ApiServer::CmdResultStatusAPI_Busy);
+    QVERIFY(readResult(m_socket) == ApiServer::CmdSetResult_Ok);
+    QVERIFY(m_sockReadLineOk);
+
+    processEventsFromLittle();
+
+    QVERIFY(m_little->m_colors[0] == qRgb(7, 8, 9));
+    QVERIFY(m_little->m_colors[1] == qRgb(4, 5, 6));
+
+    QVERIFY(unlock(m_socket));
+}
+
+void LightpackApiTest::testCase_SetFrame()
+{
+    QVERIFY(writeCommandWithCheck(m_socket, ApiServer::CmdSetFrame, ApiServer::CmdSetResult_NotLocked));
+
+    QVERIFY(lock(m_socket));
+
+    QVERIFY(writeCommandWithCheck(m_socket, ApiServer::CmdSetFrame, ApiServer::CmdSetResult_Ok));
+
+    // RGB8 frame for 2 LEDs, RGB16 frame for 1 LED and end of frames
+    QByteArray frames = frameHeader(ApiServer::FrameFormatRgb8, 2);
+    frames.append("\x17\x02\x41\x01\x02\x03", 6);
+    frames += frameHeader(ApiServer::FrameFormatRgb16, 1);
+    frames.append("\xc8\x00\x0a\xff\x00\x01", 6);
+    frames += frameHeader(ApiServer::FrameFormatRgb8, 0);
+
+    m_socket->write(frames);
+
+    QVERIFY(readResult(m_socket) == ApiServer::CmdSetResult_Ok);
+    QVERIFY(m_sockReadLineOk);
+
+    processEventsFromLittle();
+
+    QVERIFY(m_little->m_colors[0] == qRgb(200, 10, 0));
+    QVERIFY(m_little->m_colors[1] == qRgb(1, 2, 3));
+
+    // Connection is back to text commands
+    QVERIFY(unlock(m_socket));
+}
+
+void LightpackApiTest::testCase_SetFrameInvalid()
+{
+    QVERIFY(lock(m_socket));
+
+    QVERIFY(writeCommandWithCheck(m_socket, ApiServer::CmdSetFrame, ApiServer::CmdSetResult_Ok));
+
+    QByteArray header = frameHeader(ApiServer::FrameFormatRgb8, 1);
+    header[0] = 'X';
+
+    m_socket->write(header);
+
+    QVERIFY(readResult(m_socket) == ApiServer::CmdSetResult_Error);
+    QVERIFY(m_sockReadLineOk);
+
+    // Too many LEDs are rejected by the header, payload isn't waited for
+    QVERIFY(writeCommandWithCheck(m_socket, ApiServer::CmdSetFrame, ApiServer::CmdSetResult_Ok));
+
+    m_socket->write(frameHeader(ApiServer::FrameFormatRgb16, MaximumNumberOfLeds::AbsoluteMaximum + 1));
+
+    QVERIFY(readResult(m_socket) == ApiServer::CmdSetResult_Error);
+    QVERIFY(m_sockReadLineOk);
+
+    QVERIFY(unlock(m_socket));
+}
+
+void LightpackApiTest::testCase_UdpFrames()
+{
+    writeCommand(m_socket, ApiServer::CmdGetUdpSession);
+
+    QString result = readResult(m_socket).trimmed();
+    QVERIFY(m_sockReadLineOk);
+    QVERIFY(result.startsWith(ApiServer::CmdResultUdpSession));
+
+    QStringList session = result.mid(strlen(ApiServer::CmdResultUdpSession)).split(',');
+    QVERIFY(session.count() == 2);
+    QVERIFY(session[0] == "3637");
+
+    bool ok = false;
+    quint64 token = session[1].toULongLong(&ok, 16);
+    QVERIFY(ok);
+
+    QVERIFY(lock(m_socket));
+
+    QList<int> statsBefore = getUdpStats(m_socket);
+    QVERIFY(statsBefore.count() == 3);
+
+    // Sequence 2 comes after 3 and is skipped, unknown token is dropped
+    QUdpSocket udp;
+    udp.writeDatagram(udpDatagram(token, 1, qRgb(1, 2, 3)), QHostAddress::LocalHost, 3637);
+    udp.writeDatagram(udpDatagram(token, 3, qRgb(4, 5, 6)), QHostAddress::LocalHost, 3637);
+    udp.writeDatagram(udpDatagram(token, 2, qRgb(7, 8, 9)), QHostAddress::LocalHost, 3637);
+    udp.writeDatagram(udpDatagram(token + 1, 4, qRgb(10, 11, 12)), QHostAddress::LocalHost, 3637);
+
+    QList<int> stats;
+    QTime time;
+    time.restart();
+
+    do
+    {
+        stats = getUdpStats(m_socket);
+    }
+    while (stats.count() == 3 && stats[0] - statsBefore[0] < 4 && time.elapsed() < ApiServer::SignalWaitTimeoutMs);
+
+    QVERIFY(stats.count() == 3);
+    QVERIFY(stats[0] - statsBefore[0] == 4);
+    QVERIFY(stats[1] - statsBefore[1] == 1);
+    QVERIFY(stats[2] - statsBefore[2] == 1);
+
+    processEventsFromLittle();
+
+    QVERIFY(m_little->m_colors[0] == qRgb(4, 5, 6));
+
+    QVERIFY(unlock(m_socket));
+}
+
+void LightpackApiTest::testCase_Subscribe()
+{
+    QByteArray subscribeCmd = ApiServer::CmdSubscribe;
+    subscribeCmd += "colors=100,profile,lock";
+
+    QVERIFY(writeCommandWithCheck(m_socket, subscribeCmd, ApiServer::CmdSetResult_Ok));
+
+    // Current values are pushed after the reply
+    QString result = readResult(m_socket);
+    QVERIFY(m_sockReadLineOk);
+    QVERIFY(result.startsWith(ApiServer::CmdResultProfile));
+
+    QVERIFY(readResult(m_socket) == ApiServer::CmdResultStatusAPI_Idle);
+
+    result = readResult(m_socket);
+    QVERIFY(m_sockReadLineOk);
+    QVERIFY(result.startsWith(ApiServer::CmdResultGetColors));
+
+    // Colors from grabber
+    m_interfaceApi->updateColors(makeColors(20));
+
+    result = readResult(m_socket);
+    QVERIFY(m_sockReadLineOk);
+    QVERIFY(result.startsWith(QString(ApiServer::CmdResultGetColors) + "0-0,20,0;1-1,20,0;"));
+
+    // Lock by the other client
+    QTcpSocket sockLock;
+    sockLock.connectToHost("127.0.0.1", 3636);
+    QVERIFY(sockLock.waitForConnected(5000));
+    QVERIFY(checkVersion(&sockLock));
+
+    QVERIFY(lock(&sockLock));
+    QVERIFY(readResult(m_socket) == ApiServer::CmdResultStatusAPI_Busy);
+
+    QVERIFY(unlock(&sockLock));
+    QVERIFY(readResult(m_socket) == ApiServer::CmdResultStatusAPI_Idle);
+
+    QByteArray unsubscribeCmd = ApiServer::CmdUnsubscribe;
+    unsubscribeCmd += "colors,profile,lock";
+
+    QVERIFY(writeCommandWithCheck(m_socket, unsubscribeCmd, ApiServer::CmdSetResult_Ok));
+
+    m_interfaceApi->updateColors(makeColors(21));
+
+    // Next line is the result, not the pushed colors
+    QVERIFY(writeCommandWithCheck(m_socket, ApiServer::CmdGetStatusAPI, ApiServer::CmdResultStatusAPI_Idle));
+}
+
+void LightpackApiTest::testCase_SubscribeColorsRateLimit()
+{
+    QByteArray subscribeCmd = ApiServer::CmdSubscribe;
+    subscribeCmd += "colors=2";
+
+    QVERIFY(writeCommandWithCheck(m_socket, subscribeCmd, ApiServer::CmdSetResult_Ok));
+
+    QString result = readResult(m_socket);
+    QVERIFY(m_sockReadLineOk);
+    QVERIFY(result.startsWith(ApiServer::CmdResultGetColors));
+
+    // Two frames in 500 ms, only the latest one is pushed
+    m_interfaceApi->updateColors(makeColors(30));
+    m_interfaceApi->updateColors(makeColors(31));
+
+    result = readResult(m_socket);
+    QVERIFY(m_sockReadLineOk);
+    QVERIFY(result.startsWith(QString(ApiServer::CmdResultGetColors) + "0-0,31,0;"));
+
+    QByteArray unsubscribeCmd = ApiServer::CmdUnsubscribe;
+    unsubscribeCmd += "colors";
+
+    QVERIFY(writeCommandWithCheck(m_socket, unsubscribeCmd, ApiServer::CmdSetResult_Ok));
+}
+
+void LightpackApiTest::testCase_SubscribeStatus()
+{
+    m_little->setStatus(Backlight::StatusOn);
+
+    QByteArray subscribeCmd = ApiServer::CmdSubscribe;
+    subscribeCmd += "status";
+
+    writeCommand(m_socket, subscribeCmd);
+
+    processEventsFromLittle();
+
+    QVERIFY(readResult(m_socket) == ApiServer::CmdSetResult_Ok);
+
+    // Current status is pushed even if it was never changed
+    QVERIFY(readResult(m_socket) == ApiServer::CmdResultStatus_On);
+
+    QByteArray unsubscribeCmd = ApiServer::CmdUnsubscribe;
+    unsubscribeCmd += "status";
+
+    QVERIFY(writeCommandWithCheck(m_socket, unsubscribeCmd, ApiServer::CmdSetResult_Ok));
+}
+
+void LightpackApiTest::testCase_SubscribeInvalid()
+{
+    QFETCH(QString, cmd);
+
+    QVERIFY(writeCommandWithCheck(m_socket, cmd.toAscii(), ApiServer::CmdSetResult_Error));
+}
+
+void LightpackApiTest::testCase_SubscribeInvalid_data()
+{
+    QTest::addColumn<QString>("cmd");
+
+    QString subscribe = ApiServer::CmdSubscribe;
+    QString unsubscribe = ApiServer::CmdUnsubscribe;
+
+    QTest::newRow("0") << subscribe;
+    QTest::newRow("1") << subscribe + "foo";
+    QTest::newRow("2") << subscribe + "colors,,fps";
+    QTest::newRow("3") << subscribe + "colors=0";
+    QTest::newRow("4") << subscribe + "colors=101";
+    QTest::newRow("5") << subscribe + "colors=x";
+    QTest::newRow("6") << subscribe + "fps=10";
+    QTest::newRow("7") << unsubscribe + "colors=10";
+    QTest::newRow("8") << unsubscribe + "colors;fps";
+}
+
 void LightpackApiTest::testCase_SetGammaValid()
 {
     QVERIFY(lock(m_socket));
@@ -699,21 +962,52 @@ void LightpackApiTest::testCase_ApiAuthorization()
     QVERIFY(writeCommandWithCheck(m_socket, ApiServer::CmdLock, ApiServer::CmdApiCheck_AuthRequired));
 }
 
+void LightpackApiTest::testCase_LocalSocket()
+{
+    m_little->setApiKey("test-key");
+
+    QLocalSocket sockLocal;
+    sockLocal.connectToServer(ApiServer::localSocketPath("lightpack-api-test"));
+    QVERIFY(sockLocal.waitForConnected(5000));
+    QVERIFY(checkVersion(&sockLocal));
+
+#ifdef Q_OS_LINUX
+    // Same user, authorized by peer credentials without apikey command
+    QVERIFY(lock(&sockLocal));
+    QVERIFY(unlock(&sockLocal));
+#else
+    QVERIFY(writeCommandWithCheck(&sockLocal, ApiServer::CmdLock, ApiServer::CmdApiCheck_AuthRequired));
+#endif
+
+    // TCP clients still need the key
+    QTcpSocket sockTcp;
+    sockTcp.connectToHost("127.0.0.1", 3636);
+    QVERIFY(sockTcp.waitForConnected(5000));
+    QVERIFY(checkVersion(&sockTcp));
+
+    QVERIFY(writeCommandWithCheck(&sockTcp, ApiServer::CmdLock, ApiServer::CmdApiCheck_AuthRequired));
+
+    m_little->setApiKey("");
+}
+
 // Private help functions
 
-QByteArray LightpackApiTest::readResult(QTcpSocket * socket)
+QByteArray LightpackApiTest::readResult(QIODevice * socket)
 {
-    m_sockReadLineOk = socket->waitForReadyRead(1000) && socket->canReadLine();
+    // Several replies can be received at once
+    while (socket->canReadLine() == false && socket->waitForReadyRead(1000))
+        ;
+    m_sockReadLineOk = socket->canReadLine();
     return socket->readLine();
 }
 
-void LightpackApiTest::writeCommand(QTcpSocket * socket, const char * cmd)
+void LightpackApiTest::writeCommand(QIODevice * socket, const char * cmd)
 {
     socket->write(cmd);
     socket->write("\n");
 }
 
-bool LightpackApiTest::writeCommandWithCheck(QTcpSocket * socket, const QByteArray & command, const QByteArray & result)
+bool LightpackApiTest::writeCommandWithCheck(QIODevice * socket, const QByteArray & command, const QByteArray & result)
 {
     writeCommand(socket, command);
     QByteArray read = readResult(socket);
@@ -744,7 +1038,7 @@ void LightpackApiTest::processEventsFromLittle()
     }
 }
 
-bool LightpackApiTest::checkVersion(QTcpSocket * socket)
+bool LightpackApiTest::checkVersion(QIODevice * socket)
 {
     // Check the version of the API and API Tests on match
 
@@ -755,12 +1049,71 @@ bool LightpackApiTest::checkVersion(QTcpSocket * socket)
     return (m_sockReadLineOk && result.trimmed() == versionTests);
 }
 
-bool LightpackApiTest::lock(QTcpSocket * socket)
+QByteArray LightpackApiTest::frameHeader(int format, int ledsCount)
+{
+    QByteArray header = ApiServer::FrameMagic;
+
+    header.append((char)format);
+    header.append((char)0);
+    header.append((char)(ledsCount >> 8));
+    header.append((char)(ledsCount & 0xff));
+
+    return header;
+}
+
+QByteArray LightpackApiTest::udpDatagram(quint64 token, quint32 sequence, QRgb color)
+{
+    QByteArray datagram;
+
+    for (int i = 7; i >= 0; i--)
+        datagram.append((char)((token >> (i * 8)) & 0xff));
+
+    for (int i = 3; i >= 0; i--)
+        datagram.append((char)((sequence >> (i * 8)) & 0xff));
+
+    datagram += frameHeader(ApiServer::FrameFormatRgb8, 1);
+    datagram.append((char)qRed(color));
+    datagram.append((char)qGreen(color));
+    datagram.append((char)qBlue(color));
+
+    return datagram;
+}
+
+QList<QRgb> LightpackApiTest::makeColors(int green)
+{
+    QList<QRgb> colors;
+
+    for (int i = 0; i < 10; i++)
+        colors << qRgb(i, green, 0);
+
+    return colors;
+}
+
+QList<int> LightpackApiTest::getUdpStats(QTcpSocket * socket)
+{
+    QList<int> stats;
+
+    writeCommand(socket, ApiServer::CmdGetUdpStats);
+
+    QString result = readResult(socket).trimmed();
+
+    if (m_sockReadLineOk == false || result.startsWith(ApiServer::CmdResultUdpStats) == false)
+        return stats;
+
+    QStringList values = result.mid(strlen(ApiServer::CmdResultUdpStats)).split(',');
+
+    for (int i = 0; i < values.count(); i++)
+        stats << values[i].toInt();
+
+    return stats;
+}
+
+bool LightpackApiTest::lock(QIODevice * socket)
 {
     return writeCommandWithCheck(socket, ApiServer::CmdLock, ApiServer::CmdResultLock_Success);
 }
 
-bool LightpackApiTest::unlock(QTcpSocket * socket)
+bool LightpackApiTest::unlock(QIODevice * socket)
 {
     // Must be locked before unlock, else unlock() return false,
     // because result will be ApiServer::CmdResultUnlock_NotLocked
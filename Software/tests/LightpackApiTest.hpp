@@ -51,6 +51,17 @@ private Q_SLOTS:
     void testCase_SetColorValid2_data();
     void testCase_SetColorInvalid();
     void testCase_SetColorInvalid_data();
+    void testCase_SetColorPipelined();
+
+    void testCase_SetFrame();
+    void testCase_SetFrameInvalid();
+    void testCase_UdpFrames();
+
+    void testCase_Subscribe();
+    void testCase_SubscribeColorsRateLimit();
+    void testCase_SubscribeStatus();
+    void testCase_SubscribeInvalid();
+    void testCase_SubscribeInvalid_data();
 
     void testCase_SetGammaValid();
     void testCase_SetGammaValid_data();
@@ -71,19 +82,24 @@ private Q_SLOTS:
     void testCase_SetStatus();
 
     void testCase_ApiAuthorization();
+    void testCase_LocalSocket();
 
 private:
-    QByteArray readResult(QTcpSocket * socket);
-    void writeCommand(QTcpSocket * socket, const char * cmd);
-    bool writeCommandWithCheck(QTcpSocket * socket, const QByteArray & command, const QByteArray & result);
+    QByteArray readResult(QIODevice * socket);
+    void writeCommand(QIODevice * socket, const char * cmd);
+    bool writeCommandWithCheck(QIODevice * socket, const QByteArray & command, const QByteArray & result);
 
     QString getProfilesResultString();
     void processEventsFromLittle();
 
-    bool checkVersion(QTcpSocket * socket);
-    bool lock(QTcpSocket * socket);
-    bool unlock(QTcpSocket * socket);
+    bool checkVersion(QIODevice * socket);
+    bool lock(QIODevice * socket);
+    bool unlock(QIODevice * socket);
     bool setGamma(QTcpSocket * socket, QString gammaStr);
+    QByteArray frameHeader(int format, int ledsCount);
+    QByteArray udpDatagram(quint64 token, quint32 sequence, QRgb color);
+    QList<int> getUdpStats(QTcpSocket * socket);
+    QList<QRgb> makeColors(int green);
 
 private:
     ApiServer *m_apiServer;
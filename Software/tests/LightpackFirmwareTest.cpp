@@ -0,0 +1,45 @@
+#include "LightpackFirmwareTest.hpp"
+#include "LightpackFirmware.hpp"
+#include <QtTest/QtTest>
+
+LightpackFirmwareTest::LightpackFirmwareTest(QObject *parent) :
+    QObject(parent)
+{
+}
+
+void LightpackFirmwareTest::testKnownVersions_data()
+{
+    QTest::addColumn<int>("major");
+    QTest::addColumn<int>("minor");
+    QTest::addColumn<int>("revision");
+
+    QTest::newRow("fw4.5") << 4 << 5 << 0;
+    QTest::newRow("fw5.2") << 5 << 2 << 0;
+    QTest::newRow("fw6.2") << 6 << 2 << 0;
+    QTest::newRow("fw6.3 brightness") << 6 << 3 << LightpackFirmware::RevisionBrightness;
+    QTest::newRow("fw4.8 smooth options") << 4 << 8 << LightpackFirmware::RevisionSmoothOptions;
+    QTest::newRow("fw4.9 feedback") << 4 << 9 << LightpackFirmware::RevisionFeedback;
+    QTest::newRow("fw5.6 feedback") << 5 << 6 << LightpackFirmware::RevisionFeedback;
+    QTest::newRow("fw6.6 feedback") << 6 << 6 << LightpackFirmware::RevisionFeedback;
+    QTest::newRow("unknown hardware") << 3 << 9 << 0;
+}
+
+void LightpackFirmwareTest::testKnownVersions()
+{
+    QFETCH(int, major);
+    QFETCH(int, minor);
+    QFETCH(int, revision);
+
+    QCOMPARE(LightpackFirmware::revision(major, minor), revision);
+}
+
+void LightpackFirmwareTest::testNewerHardwareHasFeedback()
+{
+    QCOMPARE(LightpackFirmware::RevisionLatest, LightpackFirmware::RevisionFeedback);
+
+    for (int major = 7; major <= 9; major++)
+    {
+        QCOMPARE(LightpackFirmware::revision(major, 0), LightpackFirmware::RevisionLatest);
+        QVERIFY(LightpackFirmware::revision(major, 0) >= LightpackFirmware::RevisionFeedback);
+    }
+}
@@ -0,0 +1,18 @@
+#ifndef LIGHTPACKFIRMWARETEST_HPP
+#define LIGHTPACKFIRMWARETEST_HPP
+
+#include <QObject>
+
+class LightpackFirmwareTest : public QObject
+{
+    Q_OBJECT
+public:
+    explicit LightpackFirmwareTest(QObject *parent = 0);
+
+private slots:
+    void testKnownVersions_data();
+    void testKnownVersions();
+    void testNewerHardwareHasFeedback();
+};
+
+#endif // LIGHTPACKFIRMWARETEST_HPP
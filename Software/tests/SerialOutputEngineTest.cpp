@@ -0,0 +1,123 @@
+#include "SerialOutputEngineTest.hpp"
+#include "SerialOutputEngine.hpp"
+#include <QtTest/QtTest>
+
+#ifdef Q_OS_UNIX
+#   include <stdlib.h>
+#   include <unistd.h>
+#   include <fcntl.h>
+#   include <termios.h>
+#endif
+
+SerialOutputEngineTest::SerialOutputEngineTest(QObject *parent) :
+    QObject(parent)
+{
+}
+
+void SerialOutputEngineTest::testWireTime()
+{
+    SerialOutputEngine engine;
+    engine.setBaudRate(115200);
+
+    // Adalight frame for 255 LEDs: 6 bytes header + 765 bytes of colors
+    QVERIFY2( qAbs(engine.wireTimeMs(771) - 66.93) < 0.01, "wireTimeMs() is incorrect");
+    QVERIFY2( qAbs(engine.maximumFps(771) - 14.94) < 0.01, "maximumFps() is incorrect");
+    QVERIFY2( engine.maximumFps(0) == 0, "maximumFps() of empty frame is incorrect");
+}
+
+void SerialOutputEngineTest::testFirstFrameWrittenImmediately()
+{
+#ifdef Q_OS_UNIX
+    int master, slave;
+    QVERIFY( openPty(master, slave) );
+
+    SerialOutputEngine engine;
+    engine.setBaudRate(9600);
+    engine.setDescriptor(slave);
+
+    QByteArray frame(48, 'a');
+    QVERIFY( engine.writeFrame(frame) );
+    QCOMPARE( engine.framesWritten(), 1 );
+    QCOMPARE( readAll(master), frame );
+
+    ::close(slave);
+    ::close(master);
+#else
+    QSKIP("pty is not available on this platform", SkipAll);
+#endif
+}
+
+void SerialOutputEngineTest::testBusyLinkReplacesPendingFrame()
+{
+#ifdef Q_OS_UNIX
+    int master, slave;
+    QVERIFY( openPty(master, slave) );
+
+    SerialOutputEngine engine;
+    engine.setBaudRate(9600);
+    engine.setDescriptor(slave);
+
+    // 96 bytes at 9600 baud keep the link busy for 100 ms
+    QByteArray first(96, 'a');
+    QByteArray second(96, 'b');
+    QByteArray third(96, 'c');
+
+    QVERIFY( engine.writeFrame(first) );
+    QVERIFY( engine.writeFrame(second) );
+    QVERIFY( engine.writeFrame(third) );
+
+    QCOMPARE( engine.framesWritten(), 1 );
+    QCOMPARE( engine.framesReplaced(), 1 );
+    QCOMPARE( readAll(master), first );
+
+    QTest::qWait(engine.wireTimeMs(first.size()) + 50);
+
+    QCOMPARE( engine.framesWritten(), 2 );
+    QCOMPARE( readAll(master), third );
+
+    ::close(slave);
+    ::close(master);
+#else
+    QSKIP("pty is not available on this platform", SkipAll);
+#endif
+}
+
+bool SerialOutputEngineTest::openPty(int & master, int & slave)
+{
+#ifdef Q_OS_UNIX
+    master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0)
+        return false;
+
+    slave = ::open(ptsname(master), O_RDWR | O_NOCTTY);
+    if (slave < 0)
+        return false;
+
+    // No output post-processing should touch the frame
+    struct termios tio;
+    tcgetattr(slave, &tio);
+    cfmakeraw(&tio);
+    tcsetattr(slave, TCSANOW, &tio);
+
+    fcntl(master, F_SETFL, fcntl(master, F_GETFL) | O_NONBLOCK);
+    return true;
+#else
+    Q_UNUSED(master);
+    Q_UNUSED(slave);
+    return false;
+#endif
+}
+
+QByteArray SerialOutputEngineTest::readAll(int fd)
+{
+    QByteArray result;
+#ifdef Q_OS_UNIX
+    char buf[256];
+    ssize_t n;
+    while ((n = ::read(fd, buf, sizeof(buf))) > 0)
+        result.append(buf, n);
+#else
+    Q_UNUSED(fd);
+#endif
+    return result;
+}
@@ -0,0 +1,22 @@
+#ifndef SERIALOUTPUTENGINETEST_HPP
+#define SERIALOUTPUTENGINETEST_HPP
+
+#include <QObject>
+
+class SerialOutputEngineTest : public QObject
+{
+    Q_OBJECT
+public:
+    explicit SerialOutputEngineTest(QObject *parent = 0);
+
+private slots:
+    void testWireTime();
+    void testFirstFrameWrittenImmediately();
+    void testBusyLinkReplacesPendingFrame();
+
+private:
+    bool openPty(int & master, int & slave);
+    QByteArray readAll(int fd);
+};
+
+#endif // SERIALOUTPUTENGINETEST_HPP
@@ -0,0 +1,254 @@
+#include "SetColorParserTest.hpp"
+#include "SetColorParser.hpp"
+#include "enums.hpp"
+#include <QtTest/QtTest>
+
+namespace
+{
+const int LedsCount = MaximumNumberOfLeds::AbsoluteMaximum;
+const QRgb Guard = 0x12345678;
+}
+
+SetColorParserTest::SetColorParserTest(QObject *parent) :
+    QObject(parent)
+{
+}
+
+void SetColorParserTest::testValid_data()
+{
+    QTest::addColumn<QByteArray>("cmd");
+    QTest::addColumn<int>("led");
+    QTest::addColumn<uint>("rgb");
+    QTest::addColumn<int>("itemsCount");
+
+    QTest::newRow("without semicolon") << QByteArray("1-1,2,3") << 1 << qRgb(1, 2, 3) << 1;
+    QTest::newRow("semicolon") << QByteArray("2-1,2,3;") << 2 << qRgb(1, 2, 3) << 1;
+    QTest::newRow("two digits") << QByteArray("10-255,255,255;") << 10 << qRgb(255, 255, 255) << 1;
+    QTest::newRow("three digits") << QByteArray("100-0,0,1;") << 100 << qRgb(0, 0, 1) << 1;
+    QTest::newRow("last led") << QByteArray("255-9,8,7") << 255 << qRgb(9, 8, 7) << 1;
+    QTest::newRow("leading zeros") << QByteArray("007-010,0,00") << 7 << qRgb(10, 0, 0) << 1;
+    QTest::newRow("last one wins") << QByteArray("1-1,1,1;1-2,2,2;1-3,3,3;") << 1 << qRgb(3, 3, 3) << 3;
+    QTest::newRow("hex") << QByteArray("3-#0a0B0c") << 3 << qRgb(10, 11, 12) << 1;
+    QTest::newRow("range") << QByteArray("1..50-4,5,6;") << 50 << qRgb(4, 5, 6) << 1;
+    QTest::newRow("range of one") << QByteArray("7..7-#ffffff") << 7 << qRgb(255, 255, 255) << 1;
+}
+
+void SetColorParserTest::testValid()
+{
+    QFETCH(QByteArray, cmd);
+    QFETCH(int, led);
+    QFETCH(uint, rgb);
+    QFETCH(int, itemsCount);
+
+    QRgb colors[LedsCount];
+    memset(colors, 0, sizeof(colors));
+
+    SetColorParser parser;
+    QVERIFY2( parser.parse(cmd.constData(), cmd.size(), colors, LedsCount),
+              SetColorParser::errorString(parser.error()) );
+    QCOMPARE( parser.error(), SetColorParser::ErrorNone );
+    QCOMPARE( parser.itemsCount(), itemsCount );
+    QCOMPARE( colors[led - 1], (QRgb)rgb );
+}
+
+void SetColorParserTest::testInvalid_data()
+{
+    QTest::addColumn<QByteArray>("cmd");
+    QTest::addColumn<int>("error");
+    QTest::addColumn<int>("position");
+
+    QTest::newRow("empty") << QByteArray("") << (int)SetColorParser::ErrorEmpty << 0;
+    QTest::newRow("no led") << QByteArray("-1,1,1;") << (int)SetColorParser::ErrorLedNumberExpected << 0;
+    QTest::newRow("not digit") << QByteArray("!-1,1,1;") << (int)SetColorParser::ErrorLedNumberExpected << 0;
+    QTest::newRow("zero led") << QByteArray("0-1,1,1;") << (int)SetColorParser::ErrorLedNumberOutOfRange << 0;
+    QTest::newRow("led out of range") << QByteArray("1-1,1,1;11-1,1,1;") << (int)SetColorParser::ErrorLedNumberOutOfRange << 8;
+    QTest::newRow("long led number") << QByteArray("100000000000000000000-1,1,1") << (int)SetColorParser::ErrorLedNumberOutOfRange << 0;
+    QTest::newRow("reversed range") << QByteArray("5..2-1,1,1") << (int)SetColorParser::ErrorLedRangeReversed << 3;
+    QTest::newRow("range without end") << QByteArray("1..-1,1,1") << (int)SetColorParser::ErrorLedNumberExpected << 3;
+    QTest::newRow("single dot") << QByteArray("1.2-1,1,1") << (int)SetColorParser::ErrorDashExpected << 1;
+    QTest::newRow("double dash") << QByteArray("1--1,1,1;") << (int)SetColorParser::ErrorColorExpected << 2;
+    QTest::newRow("double comma") << QByteArray("1-1,,1,1;") << (int)SetColorParser::ErrorColorExpected << 4;
+    QTest::newRow("dots") << QByteArray("1-1.1.1") << (int)SetColorParser::ErrorCommaExpected << 3;
+    QTest::newRow("two components") << QByteArray("1-1,1;") << (int)SetColorParser::ErrorCommaExpected << 5;
+    QTest::newRow("empty component") << QByteArray("1-1,1,;") << (int)SetColorParser::ErrorColorExpected << 6;
+    QTest::newRow("component > 255") << QByteArray("1-1,1,256;") << (int)SetColorParser::ErrorColorOutOfRange << 6;
+    QTest::newRow("long component") << QByteArray("1-1,100000000000000000000000;") << (int)SetColorParser::ErrorColorOutOfRange << 4;
+    QTest::newRow("short hex") << QByteArray("1-#12345") << (int)SetColorParser::ErrorHexColorExpected << 8;
+    QTest::newRow("not hex") << QByteArray("1-#12g456") << (int)SetColorParser::ErrorHexColorExpected << 5;
+    QTest::newRow("long hex") << QByteArray("1-#1234567") << (int)SetColorParser::ErrorSemicolonExpected << 9;
+    QTest::newRow("no item") << QByteArray("1-1,1,1;2-") << (int)SetColorParser::ErrorColorExpected << 10;
+    QTest::newRow("double semicolon") << QByteArray("1-1,1,1;;") << (int)SetColorParser::ErrorLedNumberExpected << 8;
+    QTest::newRow("trailing space") << QByteArray("1-1,1,1 ") << (int)SetColorParser::ErrorSemicolonExpected << 7;
+}
+
+void SetColorParserTest::testInvalid()
+{
+    QFETCH(QByteArray, cmd);
+    QFETCH(int, error);
+    QFETCH(int, position);
+
+    QRgb colors[10];
+
+    SetColorParser parser;
+    QVERIFY( parser.parse(cmd.constData(), cmd.size(), colors, 10) == false );
+    QCOMPARE( (int)parser.error(), error );
+    QCOMPARE( parser.errorPosition(), position );
+}
+
+void SetColorParserTest::testRangeAndHex()
+{
+    QRgb colors[10];
+    memset(colors, 0, sizeof(colors));
+
+    QByteArray cmd = "2..4-#102030;6..10-1,2,3;8-#FFFFFF";
+
+    SetColorParser parser;
+    QVERIFY( parser.parse(cmd.constData(), cmd.size(), colors, 10) );
+
+    QCOMPARE( colors[0], (QRgb)0 );
+    for (int i = 1; i < 4; i++)
+        QCOMPARE( colors[i], qRgb(0x10, 0x20, 0x30) );
+    QCOMPARE( colors[4], (QRgb)0 );
+    for (int i = 5; i < 10; i++)
+        QCOMPARE( colors[i], (i == 7) ? qRgb(255, 255, 255) : qRgb(1, 2, 3) );
+}
+
+void SetColorParserTest::testAllLeds()
+{
+    QByteArray cmd = makeFullStripCommand(LedsCount);
+    QRgb colors[LedsCount];
+
+    SetColorParser parser;
+    QVERIFY( parser.parse(cmd.constData(), cmd.size(), colors, LedsCount) );
+    QCOMPARE( parser.itemsCount(), LedsCount );
+
+    for (int i = 0; i < LedsCount; i++)
+        QCOMPARE( colors[i], qRgb(i, 255 - i, i / 2) );
+
+    // Number of LEDs of the device is the limit
+    QVERIFY( parser.parse(cmd.constData(), cmd.size(), colors, LedsCount - 1) == false );
+    QCOMPARE( parser.error(), SetColorParser::ErrorLedNumberOutOfRange );
+}
+
+void SetColorParserTest::testRandomValidCommands()
+{
+    SetColorParser parser;
+    QRgb colors[LedsCount], expected[LedsCount];
+
+    qsrand(47);
+
+    for (int test = 0; test < 2000; test++)
+    {
+        int ledsCount = 1 + qrand() % LedsCount;
+        int itemsCount = 1 + qrand() % 20;
+        QByteArray cmd;
+
+        memset(colors, 0, sizeof(colors));
+        memset(expected, 0, sizeof(expected));
+
+        for (int item = 0; item < itemsCount; item++)
+        {
+            int first = 1 + qrand() % ledsCount;
+            int last = (qrand() % 2) ? first : first + qrand() % (ledsCount - first + 1);
+            QRgb color = qRgb(qrand() % 256, qrand() % 256, qrand() % 256);
+
+            cmd += QByteArray::number(first);
+            if (last != first || qrand() % 4 == 0)
+                cmd += ".." + QByteArray::number(last);
+
+            if (qrand() % 2)
+                cmd += "-#" + QByteArray::number(color & 0xffffff, 16).rightJustified(6, '0');
+            else
+                cmd += QString("-%1,%2,%3").arg(qRed(color)).arg(qGreen(color)).arg(qBlue(color)).toAscii();
+
+            if (item != itemsCount - 1 || qrand() % 2)
+                cmd += ';';
+
+            for (int i = first - 1; i < last; i++)
+                expected[i] = color;
+        }
+
+        QVERIFY2( parser.parse(cmd.constData(), cmd.size(), colors, ledsCount), cmd.constData() );
+        QCOMPARE( parser.itemsCount(), itemsCount );
+        QVERIFY2( memcmp(colors, expected, sizeof(colors)) == 0, cmd.constData() );
+    }
+}
+
+void SetColorParserTest::testFuzzDoesNotWriteOutside()
+{
+    // Mostly bytes of the grammar, so parser goes deep into the commands
+    const char Alphabet[] = "0123456789,;-.#aF";
+    const int GuardSize = 4;
+    const int ledsCount = 10;
+
+    SetColorParser parser;
+    QRgb colors[GuardSize + ledsCount + GuardSize];
+    char buffer[64];
+
+    qsrand(48);
+
+    for (int test = 0; test < 200000; test++)
+    {
+        int size = qrand() % (int)sizeof(buffer);
+        for (int i = 0; i < size; i++)
+            buffer[i] = (qrand() % 8) ? Alphabet[qrand() % (sizeof(Alphabet) - 1)] : (char)qrand();
+
+        for (int i = 0; i < GuardSize + ledsCount + GuardSize; i++)
+            colors[i] = Guard;
+
+        bool isOk = parser.parse(buffer, size, colors + GuardSize, ledsCount);
+
+        for (int i = 0; i < GuardSize; i++)
+        {
+            QCOMPARE( colors[i], Guard );
+            QCOMPARE( colors[GuardSize + ledsCount + i], Guard );
+        }
+
+        if (isOk)
+        {
+            QCOMPARE( parser.error(), SetColorParser::ErrorNone );
+            QVERIFY( parser.itemsCount() > 0 );
+        } else {
+            QVERIFY( parser.error() != SetColorParser::ErrorNone );
+            QVERIFY( parser.errorPosition() >= 0 && parser.errorPosition() <= size );
+        }
+    }
+}
+
+void SetColorParserTest::benchmarkParse_data()
+{
+    QTest::addColumn<QByteArray>("cmd");
+
+    QTest::newRow("255 leds") << makeFullStripCommand(LedsCount);
+    QTest::newRow("255 leds hex") << makeFullStripCommand(LedsCount, true);
+    QTest::newRow("range") << QByteArray("1..255-12,34,56");
+}
+
+void SetColorParserTest::benchmarkParse()
+{
+    QFETCH(QByteArray, cmd);
+
+    SetColorParser parser;
+    QRgb colors[LedsCount];
+
+    QVERIFY( parser.parse(cmd.constData(), cmd.size(), colors, LedsCount) );
+
+    QBENCHMARK {
+        parser.parse(cmd.constData(), cmd.size(), colors, LedsCount);
+    }
+}
+
+QByteArray SetColorParserTest::makeFullStripCommand(int ledsCount, bool isHex)
+{
+    QByteArray cmd;
+
+    for (int i = 0; i < ledsCount; i++)
+    {
+        if (isHex)
+            cmd += QString("%1-#%2;").arg(i + 1).arg(qRgb(i, 255 - i, i / 2) & 0xffffff, 6, 16, QChar('0')).toAscii();
+        else
+            cmd += QString("%1-%2,%3,%4;").arg(i + 1).arg(i).arg(255 - i).arg(i / 2).toAscii();
+    }
+
+    return cmd;
+}
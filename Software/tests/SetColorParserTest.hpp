@@ -0,0 +1,29 @@
+#ifndef SETCOLORPARSERTEST_HPP
+#define SETCOLORPARSERTEST_HPP
+
+#include <QObject>
+#include <QByteArray>
+
+class SetColorParserTest : public QObject
+{
+    Q_OBJECT
+public:
+    explicit SetColorParserTest(QObject *parent = 0);
+
+private slots:
+    void testValid_data();
+    void testValid();
+    void testInvalid_data();
+    void testInvalid();
+    void testRangeAndHex();
+    void testAllLeds();
+    void testRandomValidCommands();
+    void testFuzzDoesNotWriteOutside();
+    void benchmarkParse_data();
+    void benchmarkParse();
+
+private:
+    QByteArray makeFullStripCommand(int ledsCount, bool isHex = false);
+};
+
+#endif // SETCOLORPARSERTEST_HPP
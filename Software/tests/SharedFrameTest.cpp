@@ -0,0 +1,155 @@
+#include "SharedFrameTest.hpp"
+#include "SharedFrame.hpp"
+#include <QtTest/QtTest>
+#include <QThread>
+
+static const char * SegmentName = "/prismatik-leds-test";
+
+static QList<StructRgb> makeFrame(int ledsCount, int seed)
+{
+    QList<StructRgb> colors;
+
+    for (int i = 0; i < ledsCount; i++)
+    {
+        StructRgb color;
+        color.r = (i + seed) & 0xff;
+        color.g = (i * 3 + seed) & 0xff;
+        color.b = 255 - (i & 0xff);
+        colors << color;
+    }
+
+    return colors;
+}
+
+// Publishes one frame after delay, while the test thread waits for it
+class DelayedPublisher : public QThread
+{
+public:
+    DelayedPublisher(SharedFramePublisher * publisher) : m_publisher(publisher) {}
+
+protected:
+    void run()
+    {
+        msleep(50);
+        m_publisher->publish(makeFrame(10, 7));
+    }
+
+private:
+    SharedFramePublisher *m_publisher;
+};
+
+SharedFrameTest::SharedFrameTest(QObject *parent) :
+    QObject(parent)
+{
+    m_publisher = NULL;
+}
+
+void SharedFrameTest::init()
+{
+    m_publisher = new SharedFramePublisher();
+    QVERIFY( m_publisher->open(SegmentName, 300) );
+}
+
+void SharedFrameTest::cleanup()
+{
+    delete m_publisher;
+    m_publisher = NULL;
+}
+
+void SharedFrameTest::testReadPublishedFrame()
+{
+    SharedFrameReader reader;
+    QVERIFY( reader.open(SegmentName) );
+
+    QList<QRgb> colors;
+    quint32 sequence = 1;
+
+    // Nothing published yet
+    QVERIFY( reader.read(colors, &sequence) );
+    QCOMPARE( colors.count(), 0 );
+    QCOMPARE( sequence, (quint32)0 );
+
+    QList<StructRgb> frame = makeFrame(100, 1);
+    m_publisher->publish(frame);
+
+    quint64 timestamp = 0;
+    QVERIFY( reader.read(colors, &sequence, &timestamp) );
+    QCOMPARE( colors.count(), 100 );
+    QCOMPARE( sequence, (quint32)2 );
+    QVERIFY( timestamp > 0 );
+
+    for (int i = 0; i < frame.count(); i++)
+        QCOMPARE( colors[i], (QRgb)((frame[i].r << 16) | (frame[i].g << 8) | frame[i].b) );
+}
+
+void SharedFrameTest::testTwelveBitColorsAreScaled()
+{
+    SharedFrameReader reader;
+    QVERIFY( reader.open(SegmentName) );
+
+    QList<StructRgb> frame;
+    StructRgb color;
+    color.r = 4095;
+    color.g = 0x800;
+    color.b = 0x00f;
+    frame << color;
+
+    m_publisher->publish(frame, 12);
+
+    QList<QRgb> colors;
+    QVERIFY( reader.read(colors) );
+    QCOMPARE( colors.count(), 1 );
+    QCOMPARE( colors[0], (QRgb)0xff8000 );
+}
+
+void SharedFrameTest::testFrameIsCutToCapacity()
+{
+    SharedFrameReader reader;
+    QVERIFY( reader.open(SegmentName) );
+
+    m_publisher->publish(makeFrame(500, 2));
+
+    QList<QRgb> colors;
+    QVERIFY( reader.read(colors) );
+    QCOMPARE( colors.count(), 300 );
+}
+
+void SharedFrameTest::testWaitForFrame()
+{
+    SharedFrameReader reader;
+    QVERIFY( reader.open(SegmentName) );
+
+    quint32 sequence = reader.sequence();
+    QVERIFY( reader.waitForFrame(sequence, 20) == false );
+
+    DelayedPublisher publisher(m_publisher);
+    QElapsedTimer time;
+    time.start();
+    publisher.start();
+
+    QVERIFY( reader.waitForFrame(sequence, 2000) );
+    QVERIFY( time.elapsed() < 1000 );
+    QCOMPARE( reader.sequence(), sequence + 2 );
+
+    publisher.wait();
+}
+
+void SharedFrameTest::testReaderWithoutPublisher()
+{
+    m_publisher->close();
+
+    SharedFrameReader reader;
+    QVERIFY( reader.open(SegmentName) == false );
+
+    QList<QRgb> colors;
+    QVERIFY( reader.read(colors) == false );
+}
+
+void SharedFrameTest::benchmarkPublish()
+{
+    QList<StructRgb> frame = makeFrame(255, 3);
+
+    QBENCHMARK {
+        m_publisher->publish(frame);
+    }
+}
@@ -0,0 +1,29 @@
+#ifndef SHAREDFRAMETEST_HPP
+#define SHAREDFRAMETEST_HPP
+
+#include <QObject>
+
+class SharedFramePublisher;
+
+class SharedFrameTest : public QObject
+{
+    Q_OBJECT
+public:
+    explicit SharedFrameTest(QObject *parent = 0);
+
+private slots:
+    void init();
+    void cleanup();
+
+    void testReadPublishedFrame();
+    void testTwelveBitColorsAreScaled();
+    void testFrameIsCutToCapacity();
+    void testWaitForFrame();
+    void testReaderWithoutPublisher();
+    void benchmarkPublish();
+
+private:
+    SharedFramePublisher *m_publisher;
+};
+
+#endif // SHAREDFRAMETEST_HPP
@@ -0,0 +1,145 @@
+#include "TemporalDitherTest.hpp"
+#include "TemporalDither.hpp"
+#include <QtTest/QtTest>
+
+namespace
+{
+const int FramesInCycle = 16;
+
+QList<StructRgb> frame(int ledsCount, unsigned r, unsigned g, unsigned b)
+{
+    QList<StructRgb> colors;
+    StructRgb color;
+    color.r = r;
+    color.g = g;
+    color.b = b;
+
+    for (int i = 0; i < ledsCount; i++)
+        colors << color;
+
+    return colors;
+}
+}
+
+TemporalDitherTest::TemporalDitherTest(QObject *parent) :
+    QObject(parent)
+{
+}
+
+void TemporalDitherTest::testAverageKeepsLowBits()
+{
+    TemporalDither dither;
+    unsigned sumR = 0, sumG = 0, sumB = 0;
+
+    // 12-bit 0x805 is 128 + 5/16 in 8 bits
+    for (int i = 0; i < FramesInCycle; i++)
+    {
+        QList<StructRgb> colors = frame(3, 0x805, 0x001, 0x00f);
+        dither.apply(colors);
+
+        QVERIFY( colors[0].r == 128 || colors[0].r == 129 );
+        sumR += colors[0].r;
+        sumG += colors[0].g;
+        sumB += colors[0].b;
+    }
+
+    QCOMPARE( sumR, 128u * FramesInCycle + 5 );
+    QCOMPARE( sumG, 1u );
+    QCOMPARE( sumB, 15u );
+}
+
+void TemporalDitherTest::testDisabledTruncates()
+{
+    TemporalDither dither;
+    dither.setEnabled(false);
+
+    for (int i = 0; i < FramesInCycle; i++)
+    {
+        QList<StructRgb> colors = frame(1, 0x80f, 0x00f, 0xfff);
+        dither.apply(colors);
+
+        QCOMPARE( colors[0].r, 0x80u );
+        QCOMPARE( colors[0].g, 0u );
+        QCOMPARE( colors[0].b, 0xffu );
+    }
+}
+
+void TemporalDitherTest::testWhiteIsNotOverflowed()
+{
+    TemporalDither dither;
+
+    for (int i = 0; i < FramesInCycle; i++)
+    {
+        QList<StructRgb> colors = frame(1, 0xfff, 0xfff, 0xfff);
+        dither.apply(colors);
+
+        QCOMPARE( colors[0].r, 0xffu );
+    }
+}
+
+void TemporalDitherTest::testLayoutChangeResetsRemainders()
+{
+    TemporalDither dither;
+
+    QList<StructRgb> colors = frame(2, 0x00f, 0, 0);
+    dither.apply(colors);
+    QCOMPARE( colors[0].r, 0u );
+
+    // Remainder 15 of the previous layout would give 1 here
+    colors = frame(3, 0x001, 0, 0);
+    dither.apply(colors);
+    QCOMPARE( colors[0].r, 0u );
+
+    colors = frame(3, 0x00f, 0, 0);
+    dither.apply(colors);
+    QCOMPARE( colors[0].r, 1u );
+}
+
+void TemporalDitherTest::testDroppedFrameKeepsRemainders()
+{
+    TemporalDither dither;
+    dither.setCommitDeferred(true);
+
+    QList<StructRgb> colors = frame(1, 0x008, 0, 0);
+    dither.apply(colors);
+    dither.commit();
+    QCOMPARE( colors[0].r, 0u );
+
+    // Frame is replaced before sending, its remainder is not carried
+    colors = frame(1, 0x00f, 0, 0);
+    dither.apply(colors);
+    QCOMPARE( colors[0].r, 1u );
+
+    colors = frame(1, 0x007, 0, 0);
+    dither.apply(colors);
+    dither.commit();
+    QCOMPARE( colors[0].r, 0u );
+
+    // Remainders are 8 + 7 of the sent frames
+    colors = frame(1, 0x001, 0, 0);
+    dither.apply(colors);
+    QCOMPARE( colors[0].r, 1u );
+}
+
+void TemporalDitherTest::testUnchangedFrameIsHeld()
+{
+    TemporalDither dither;
+    dither.setHoldUnchangedFrames(true);
+
+    QList<StructRgb> first = frame(2, 0x805, 0x001, 0x00f);
+    dither.apply(first);
+
+    for (int i = 0; i < FramesInCycle; i++)
+    {
+        QList<StructRgb> colors = frame(2, 0x805, 0x001, 0x00f);
+        dither.apply(colors);
+
+        QCOMPARE( colors[0].r, first[0].r );
+        QCOMPARE( colors[1].b, first[1].b );
+    }
+
+    // Changed frame is dithered with remainders of the first one
+    QList<StructRgb> colors = frame(2, 0x80b, 0x001, 0x001);
+    dither.apply(colors);
+    QCOMPARE( colors[0].r, 129u );
+}
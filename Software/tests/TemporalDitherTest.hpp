@@ -0,0 +1,21 @@
+#ifndef TEMPORALDITHERTEST_HPP
+#define TEMPORALDITHERTEST_HPP
+
+#include <QObject>
+
+class TemporalDitherTest : public QObject
+{
+    Q_OBJECT
+public:
+    explicit TemporalDitherTest(QObject *parent = 0);
+
+private slots:
+    void testAverageKeepsLowBits();
+    void testDisabledTruncates();
+    void testWhiteIsNotOverflowed();
+    void testLayoutChangeResetsRemainders();
+    void testDroppedFrameKeepsRemainders();
+    void testUnchangedFrameIsHeld();
+};
+
+#endif // TEMPORALDITHERTEST_HPP
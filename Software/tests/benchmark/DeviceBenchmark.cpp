@@ -0,0 +1,385 @@
+/*
+ * DeviceBenchmark.cpp
+ *
+ *  Created on: 19.10.2026
+ *     Project: Lightpack
+ *
+ *  Lightpack is very simple implementation of the backlight for a laptop
+ *
+ *  Copyright (c) 2011 Mike Shatohin, mikeshatohin [at] gmail.com
+ *
+ *  Lightpack is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Lightpack is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <QEventLoop>
+#include <QTimer>
+#include <QThread>
+#include <QSemaphore>
+#include <QElapsedTimer>
+#include <pthread.h>
+
+#include "DeviceBenchmark.hpp"
+#include "LedDeviceLightpack.hpp"
+#include "LedDevicePaintpack.hpp"
+#include "LedDeviceAdalight.hpp"
+#include "LedDeviceArdulight.hpp"
+#include "Settings.hpp"
+#include "hidapi_mock.h"
+#include "pty_serial.h"
+
+using namespace SettingsScope;
+
+const int DeviceBenchmark::CommandTimeoutMs = 1000;
+const int DeviceBenchmark::ReconnectTimeoutMs = 5000;
+
+/*!
+  Thread of the device. Its CPU clock is read from the benchmark thread,
+  device is deleted in this thread after the event loop is finished.
+*/
+class DeviceThread : public QThread
+{
+public:
+    DeviceThread() : m_cpuClock(CLOCK_THREAD_CPUTIME_ID), m_object(NULL) {}
+
+    void startAndWait() { start(); m_started.acquire(); }
+    void deleteOnExit(QObject * object) { m_object = object; }
+    clockid_t cpuClock() const { return m_cpuClock; }
+
+protected:
+    void run()
+    {
+        pthread_getcpuclockid(pthread_self(), &m_cpuClock);
+        m_started.release();
+
+        exec();
+
+        delete m_object;
+    }
+
+private:
+    clockid_t m_cpuClock;
+    QObject *m_object;
+    QSemaphore m_started;
+};
+
+static QString deviceName(SupportedDevices::DeviceType deviceType)
+{
+    switch (deviceType)
+    {
+    case SupportedDevices::DeviceTypePaintpack:
+        return "Paintpack";
+    case SupportedDevices::DeviceTypeAdalight:
+        return "Adalight";
+    case SupportedDevices::DeviceTypeArdulight:
+        return "Ardulight";
+    default:
+        return "Lightpack";
+    }
+}
+
+DeviceBenchmarkResult::DeviceBenchmarkResult()
+{
+    isOpened = false;
+    framesPerSecond = 0;
+    deliveredFps = 0;
+    cpuUsPerFrame = 0;
+    failedFrames = 0;
+    isReconnected = false;
+    reconnectMs = 0;
+}
+
+DeviceBenchmark::DeviceBenchmark(const QString & workDir, QObject * parent)
+    : QObject(parent)
+{
+    m_workDir = workDir;
+    m_framesCount = 1000;
+    m_ledsCount = 10;
+    // Full speed USB interrupt endpoint with 1 ms polling interval
+    m_hidWriteLatencyUs = 1000;
+    m_hidWriteFailures = 0;
+    m_serialBaudRate = 115200;
+    m_unpluggedTimeMs = 300;
+
+    m_deviceType = SupportedDevices::DeviceTypeLightpack;
+    m_device = NULL;
+    m_deviceThread = NULL;
+    m_serial = NULL;
+    m_frameBytes = 1;
+
+    m_isCommandCompleted = false;
+    m_isCommandOk = false;
+}
+
+DeviceBenchmark::~DeviceBenchmark()
+{
+    releaseDevice();
+}
+
+DeviceBenchmarkResult DeviceBenchmark::run(SupportedDevices::DeviceType deviceType)
+{
+    DeviceBenchmarkResult result;
+
+    m_deviceType = deviceType;
+    result.deviceName = deviceName(deviceType);
+
+    m_colors.clear();
+    for (int i = 0; i < m_ledsCount; i++)
+        m_colors << qRgb((i * 37) & 0xff, (i * 73) & 0xff, (i * 151) & 0xff);
+
+    hid_mock_reset();
+    hid_mock_set_write_latency(m_hidWriteLatencyUs);
+
+    if (isHidDevice())
+    {
+        plug();
+    } else {
+        m_serialPortName = m_workDir + "/ttyMOCK0";
+        m_serial = pty_serial_open(m_serialPortName.toLocal8Bit().constData());
+
+        if (m_serial == NULL)
+        {
+            qWarning() << Q_FUNC_INFO << "pty_serial_open fail";
+            return result;
+        }
+
+        pty_serial_set_baud_rate(m_serial, m_serialBaudRate);
+
+        if (deviceType == SupportedDevices::DeviceTypeAdalight)
+        {
+            Settings::setAdalightSerialPortName(m_serialPortName);
+            Settings::setAdalightSerialPortBaudRate(QString::number(m_serialBaudRate));
+            // "Ada", LEDs count and checksum
+            m_frameBytes = 6 + m_ledsCount * 3;
+        } else {
+            Settings::setArdulightSerialPortName(m_serialPortName);
+            Settings::setArdulightSerialPortBaudRate(QString::number(m_serialBaudRate));
+            m_frameBytes = 1 + m_ledsCount * 3;
+        }
+    }
+
+    m_device = createDevice(deviceType);
+    m_deviceThread = new DeviceThread();
+    m_deviceThread->deleteOnExit(m_device);
+    m_deviceThread->startAndWait();
+    m_device->moveToThread(m_deviceThread);
+
+    connect(this, SIGNAL(setColors(QList<QRgb>)), m_device, SLOT(setColors(QList<QRgb>)), Qt::QueuedConnection);
+    connect(m_device, SIGNAL(commandCompleted(bool)), this, SLOT(commandCompleted(bool)), Qt::QueuedConnection);
+
+    QMetaObject::invokeMethod(m_device, "open", Qt::BlockingQueuedConnection);
+
+    bool ok = false;
+    result.isOpened = sendFrame(&ok) && ok;
+
+    if (result.isOpened == false)
+    {
+        qWarning() << Q_FUNC_INFO << result.deviceName << "isn't opened";
+        releaseDevice();
+        return result;
+    }
+
+    hid_mock_fail_writes(m_hidWriteFailures);
+
+    // Maximum throughput: next frame as soon as the previous one is completed
+    int completedFrames = 0;
+    qint64 deliveredStart = deliveredCount();
+    qint64 cpuStartUs = cpuTimeUs();
+
+    QElapsedTimer timer;
+    timer.start();
+
+    for (int i = 0; i < m_framesCount; i++)
+    {
+        m_colors[0] = qRgb(i & 0xff, (i >> 8) & 0xff, 0);
+
+        if (sendFrame(&ok) == false)
+        {
+            qWarning() << Q_FUNC_INFO << result.deviceName << "command timeout";
+            break;
+        }
+
+        if (ok)
+            completedFrames++;
+        else
+            result.failedFrames++;
+    }
+
+    double seconds = timer.nsecsElapsed() / 1e9;
+
+    result.cpuUsPerFrame = (cpuTimeUs() - cpuStartUs) / (double)m_framesCount;
+    result.framesPerSecond = completedFrames / seconds;
+    result.deliveredFps = (deliveredCount() - deliveredStart) / seconds;
+
+    // Reconnect: frames come with 60 fps while device is unplugged
+    unplug();
+
+    timer.restart();
+    while (timer.elapsed() < m_unpluggedTimeMs)
+    {
+        if (sendFrame(&ok) && ok == false)
+            result.failedFrames++;
+
+        wait(16);
+    }
+
+    qint64 deliveredBefore = deliveredCount();
+
+    plug();
+
+    timer.restart();
+    while (timer.elapsed() < ReconnectTimeoutMs)
+    {
+        if (sendFrame(&ok) && ok && deliveredCount() > deliveredBefore)
+        {
+            result.isReconnected = true;
+            result.reconnectMs = timer.nsecsElapsed() / 1e6;
+            break;
+        }
+
+        wait(1);
+    }
+
+    releaseDevice();
+
+    return result;
+}
+
+void DeviceBenchmark::commandCompleted(bool ok)
+{
+    m_isCommandCompleted = true;
+    m_isCommandOk = ok;
+
+    emit commandReceived();
+}
+
+ILedDevice * DeviceBenchmark::createDevice(SupportedDevices::DeviceType deviceType)
+{
+    switch (deviceType)
+    {
+    case SupportedDevices::DeviceTypePaintpack:
+        return new LedDevicePaintpack();
+    case SupportedDevices::DeviceTypeAdalight:
+        return new LedDeviceAdalight();
+    case SupportedDevices::DeviceTypeArdulight:
+        return new LedDeviceArdulight();
+    default:
+        return new LedDeviceLightpack();
+    }
+}
+
+bool DeviceBenchmark::isHidDevice() const
+{
+    return m_deviceType == SupportedDevices::DeviceTypeLightpack
+            || m_deviceType == SupportedDevices::DeviceTypePaintpack;
+}
+
+bool DeviceBenchmark::sendFrame(bool * ok)
+{
+    QEventLoop loop;
+    QTimer timeout;
+
+    timeout.setSingleShot(true);
+    connect(&timeout, SIGNAL(timeout()), &loop, SLOT(quit()));
+    connect(this, SIGNAL(commandReceived()), &loop, SLOT(quit()));
+
+    m_isCommandCompleted = false;
+    m_isCommandOk = false;
+
+    emit setColors(m_colors);
+
+    timeout.start(CommandTimeoutMs);
+    loop.exec();
+
+    *ok = m_isCommandOk;
+
+    return m_isCommandCompleted;
+}
+
+void DeviceBenchmark::wait(int ms)
+{
+    QEventLoop loop;
+    QTimer::singleShot(ms, &loop, SLOT(quit()));
+    loop.exec();
+}
+
+void DeviceBenchmark::plug()
+{
+    if (isHidDevice())
+    {
+        int vid = (m_deviceType == SupportedDevices::DeviceTypePaintpack) ? USB_PP_VENDOR_ID : USB_VENDOR_ID;
+        int pid = (m_deviceType == SupportedDevices::DeviceTypePaintpack) ? USB_PP_PRODUCT_ID : USB_PRODUCT_ID;
+
+        hid_mock_plug(vid, pid);
+
+        if (m_device != NULL)
+            QMetaObject::invokeMethod(m_device, "hidDeviceAdded", Qt::QueuedConnection, Q_ARG(int, vid), Q_ARG(int, pid));
+    } else {
+        if (pty_serial_replug(m_serial) != 0)
+            qWarning() << Q_FUNC_INFO << "pty_serial_replug fail";
+
+        QMetaObject::invokeMethod(m_device, "serialPortAdded", Qt::QueuedConnection, Q_ARG(QString, m_serialPortName));
+    }
+}
+
+void DeviceBenchmark::unplug()
+{
+    if (isHidDevice())
+    {
+        int vid = (m_deviceType == SupportedDevices::DeviceTypePaintpack) ? USB_PP_VENDOR_ID : USB_VENDOR_ID;
+        int pid = (m_deviceType == SupportedDevices::DeviceTypePaintpack) ? USB_PP_PRODUCT_ID : USB_PRODUCT_ID;
+
+        hid_mock_unplug(vid, pid);
+        QMetaObject::invokeMethod(m_device, "hidDeviceRemoved", Qt::QueuedConnection, Q_ARG(int, vid), Q_ARG(int, pid));
+    } else {
+        pty_serial_hangup(m_serial);
+        QMetaObject::invokeMethod(m_device, "serialPortRemoved", Qt::QueuedConnection, Q_ARG(QString, m_serialPortName));
+    }
+}
+
+void DeviceBenchmark::releaseDevice()
+{
+    if (m_deviceThread != NULL)
+    {
+        // Device is deleted in its thread
+        m_deviceThread->quit();
+        m_deviceThread->wait();
+        delete m_deviceThread;
+        m_deviceThread = NULL;
+        m_device = NULL;
+    }
+
+    if (m_serial != NULL)
+    {
+        pty_serial_close(m_serial);
+        m_serial = NULL;
+    }
+}
+
+// Reports written to HID device or whole frames received by serial port
+qint64 DeviceBenchmark::deliveredCount()
+{
+    if (isHidDevice())
+        return hid_mock_written_reports();
+
+    return pty_serial_bytes_received(m_serial) / m_frameBytes;
+}
+
+qint64 DeviceBenchmark::cpuTimeUs() const
+{
+    struct timespec ts;
+    clock_gettime(m_deviceThread->cpuClock(), &ts);
+
+    return (qint64)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
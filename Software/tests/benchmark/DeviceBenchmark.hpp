@@ -0,0 +1,121 @@
+/*
+ * DeviceBenchmark.hpp
+ *
+ *  Created on: 19.10.2026
+ *     Project: Lightpack
+ *
+ *  Lightpack is very simple implementation of the backlight for a laptop
+ *
+ *  Copyright (c) 2011 Mike Shatohin, mikeshatohin [at] gmail.com
+ *
+ *  Lightpack is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Lightpack is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QList>
+#include <QColor>
+#include <time.h>
+
+#include "enums.hpp"
+
+class ILedDevice;
+class DeviceThread;
+struct pty_serial;
+
+struct DeviceBenchmarkResult
+{
+    DeviceBenchmarkResult();
+
+    QString deviceName;
+    bool isOpened;
+    // Frames completed by the device, LedDeviceManager waits for each of them
+    double framesPerSecond;
+    // Frames which reached the device, serial devices drop frames while UART is busy
+    double deliveredFps;
+    double cpuUsPerFrame;
+    int failedFrames;
+    bool isReconnected;
+    double reconnectMs;
+};
+
+/*!
+  Drives LED device classes against hidapi mock and pty serial stand-in.
+
+  Device lives in its own thread like in LedDeviceManager, next frame is
+  sent when commandCompleted() of the previous one arrives. CPU time is
+  taken from the clock of the device thread. For reconnect the device is
+  unplugged for a while, then plugged again and hotplug slot is called as
+  DeviceHotplugMonitor does; time is measured till the first delivered frame.
+*/
+class DeviceBenchmark : public QObject
+{
+    Q_OBJECT
+public:
+    DeviceBenchmark(const QString & workDir, QObject * parent = 0);
+    ~DeviceBenchmark();
+
+    void setFramesCount(int framesCount) { m_framesCount = framesCount; }
+    void setLedsCount(int ledsCount) { m_ledsCount = ledsCount; }
+    void setHidWriteLatency(int microseconds) { m_hidWriteLatencyUs = microseconds; }
+    // Writes which fail right after the device is opened
+    void setHidWriteFailures(int count) { m_hidWriteFailures = count; }
+    void setSerialBaudRate(int baudRate) { m_serialBaudRate = baudRate; }
+    void setUnpluggedTime(int ms) { m_unpluggedTimeMs = ms; }
+
+    DeviceBenchmarkResult run(SupportedDevices::DeviceType deviceType);
+
+    static const int CommandTimeoutMs;
+    static const int ReconnectTimeoutMs;
+
+signals:
+    void setColors(const QList<QRgb> & colors);
+    void commandReceived();
+
+private slots:
+    void commandCompleted(bool ok);
+
+private:
+    ILedDevice * createDevice(SupportedDevices::DeviceType deviceType);
+    bool isHidDevice() const;
+    bool sendFrame(bool * ok);
+    void wait(int ms);
+    void plug();
+    void unplug();
+    void releaseDevice();
+    qint64 deliveredCount();
+    qint64 cpuTimeUs() const;
+
+private:
+    QString m_workDir;
+    int m_framesCount;
+    int m_ledsCount;
+    int m_hidWriteLatencyUs;
+    int m_hidWriteFailures;
+    int m_serialBaudRate;
+    int m_unpluggedTimeMs;
+
+    SupportedDevices::DeviceType m_deviceType;
+    ILedDevice *m_device;
+    DeviceThread *m_deviceThread;
+    pty_serial *m_serial;
+    QList<QRgb> m_colors;
+    QString m_serialPortName;
+    int m_frameBytes;
+
+    bool m_isCommandCompleted;
+    bool m_isCommandOk;
+};
@@ -0,0 +1,71 @@
+#-------------------------------------------------
+#
+# Throughput and reconnect benchmark of LED devices
+#
+# Devices are linked against hidapi mock and write to
+# pseudo terminals instead of real hardware
+#
+#-------------------------------------------------
+
+QT         += gui
+
+TARGET      = LightpackBenchmark
+DESTDIR     = bin
+
+CONFIG     += console
+CONFIG     -= app_bundle
+
+TEMPLATE    = app
+
+# QMake and GCC produce a lot of stuff
+OBJECTS_DIR = stuff
+MOC_DIR     = stuff
+UI_DIR      = stuff
+RCC_DIR     = stuff
+
+# hidapi_mock.c replaces hidapi/linux/hid*.c
+DEFINES += HID_API_ASYNC_WRITE
+
+INCLUDEPATH += ../../src/ ../../src/hidapi ../mocks
+SOURCES += \
+    main.cpp \
+    DeviceBenchmark.cpp \
+    ../../src/LedDeviceLightpack.cpp \
+    ../../src/LightpackFirmware.cpp \
+    ../../src/LedDevicePaintpack.cpp \
+    ../../src/LedDeviceAdalight.cpp \
+    ../../src/LedDeviceArdulight.cpp \
+    ../../src/AdalightDeltaCodec.cpp \
+    ../../src/SerialOutputEngine.cpp \
+    ../../src/DeviceHotplugMonitor.cpp \
+    ../../src/LightpackMath.cpp \
+    ../../src/SharedFrame.cpp \
+    ../../src/TemporalDither.cpp \
+    ../../src/FrameInterpolator.cpp \
+    ../../src/Settings.cpp \
+    ../mocks/hidapi_mock.c \
+    ../mocks/pty_serial.c
+
+HEADERS += \
+    DeviceBenchmark.hpp \
+    ../../src/ILedDevice.hpp \
+    ../../src/LedDeviceLightpack.hpp \
+    ../../src/LightpackFirmware.hpp \
+    ../../src/LedDevicePaintpack.hpp \
+    ../../src/LedDeviceAdalight.hpp \
+    ../../src/LedDeviceArdulight.hpp \
+    ../../src/AdalightDeltaCodec.hpp \
+    ../../src/SerialOutputEngine.hpp \
+    ../../src/DeviceHotplugMonitor.hpp \
+    ../../src/LightpackMath.hpp \
+    ../../src/SharedFrame.hpp \
+    ../../src/TemporalDither.hpp \
+    ../../src/FrameInterpolator.hpp \
+    ../../src/Settings.hpp \
+    ../../src/hidapi/hidapi.h \
+    ../mocks/hidapi_mock.h \
+    ../mocks/pty_serial.h
+
+include(../../src/qserialdevice/qserialdevice/qserialdevice.pri)
+
+LIBS += -ludev -lrt -lpthread
@@ -0,0 +1,159 @@
+/*
+ * main.cpp
+ *
+ *  Created on: 19.10.2026
+ *     Project: Lightpack
+ *
+ *  Lightpack is very simple implementation of the backlight for a laptop
+ *
+ *  Copyright (c) 2011 Mike Shatohin, mikeshatohin [at] gmail.com
+ *
+ *  Lightpack is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Lightpack is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <QApplication>
+#include <QDir>
+#include <QStringList>
+#include <QTextStream>
+
+#include "DeviceBenchmark.hpp"
+#include "Settings.hpp"
+#include "debug.h"
+
+using namespace SettingsScope;
+
+unsigned g_debugLevel = Debug::ZeroLevel;
+
+static void printHelpMessage(QTextStream & out)
+{
+    out << "Usage: LightpackBenchmark [options]" << endl
+        << endl
+        << "Options:" << endl
+        << "  --device NAME        lightpack, paintpack, adalight or ardulight; all by default" << endl
+        << "  --frames N           frames sent for throughput, default 1000" << endl
+        << "  --leds N             LEDs in frame, default 10" << endl
+        << "  --hid-latency US     time of HID report on the bus, default 1000" << endl
+        << "  --hid-failures N     first N HID writes fail, default 0" << endl
+        << "  --baud N             baud rate of serial devices, default 115200" << endl
+        << "  --unplugged MS       time device is unplugged for reconnect, default 300" << endl
+        << "  --debug-low          print debug messages of the devices" << endl;
+}
+
+int main(int argc, char *argv[])
+{
+    QApplication app(argc, argv);
+    QTextStream out(stdout);
+
+    qRegisterMetaType< QList<QRgb> >("QList<QRgb>");
+
+    // Settings and pty symlink are kept out of the user config
+    QString workDir = QDir::tempPath() + "/LightpackBenchmark";
+    QDir().mkpath(workDir);
+    Settings::Initialize(workDir, false);
+
+    DeviceBenchmark benchmark(workDir);
+    QList<SupportedDevices::DeviceType> devices;
+    int hidFailures = 0;
+
+    QStringList args = app.arguments();
+
+    for (int i = 1; i < args.count(); i++)
+    {
+        QString arg = args[i];
+        QString value = (i + 1 < args.count()) ? args[i + 1] : QString();
+
+        if (arg == "--debug-low")
+        {
+            g_debugLevel = Debug::LowLevel;
+            continue;
+        }
+
+        if (value.isEmpty())
+        {
+            printHelpMessage(out);
+            return 1;
+        }
+
+        i++;
+
+        if (arg == "--device")
+        {
+            if (value == "lightpack")
+                devices << SupportedDevices::DeviceTypeLightpack;
+            else if (value == "paintpack")
+                devices << SupportedDevices::DeviceTypePaintpack;
+            else if (value == "adalight")
+                devices << SupportedDevices::DeviceTypeAdalight;
+            else if (value == "ardulight")
+                devices << SupportedDevices::DeviceTypeArdulight;
+            else {
+                printHelpMessage(out);
+                return 1;
+            }
+        }
+        else if (arg == "--frames")
+            benchmark.setFramesCount(qMax(1, value.toInt()));
+        else if (arg == "--leds")
+            benchmark.setLedsCount(qMax(1, value.toInt()));
+        else if (arg == "--hid-latency")
+            benchmark.setHidWriteLatency(qMax(0, value.toInt()));
+        else if (arg == "--hid-failures")
+            hidFailures = qMax(0, value.toInt());
+        else if (arg == "--baud")
+            benchmark.setSerialBaudRate(qMax(1, value.toInt()));
+        else if (arg == "--unplugged")
+            benchmark.setUnpluggedTime(qMax(0, value.toInt()));
+        else {
+            printHelpMessage(out);
+            return 1;
+        }
+    }
+
+    benchmark.setHidWriteFailures(hidFailures);
+
+    if (devices.isEmpty())
+    {
+        devices << SupportedDevices::DeviceTypeLightpack
+                << SupportedDevices::DeviceTypePaintpack
+                << SupportedDevices::DeviceTypeAdalight
+                << SupportedDevices::DeviceTypeArdulight;
+    }
+
+    out << QString("%1 %2 %3 %4 %5 %6")
+           .arg("Device", -10).arg("fps", 10).arg("delivered", 10)
+           .arg("cpu us", 10).arg("failed", 8).arg("reconnect ms", 13) << endl;
+
+    for (int i = 0; i < devices.count(); i++)
+    {
+        DeviceBenchmarkResult result = benchmark.run(devices[i]);
+
+        if (result.isOpened == false)
+        {
+            out << QString("%1 open fail").arg(result.deviceName, -10) << endl;
+            continue;
+        }
+
+        out << QString("%1 %2 %3 %4 %5 %6")
+               .arg(result.deviceName, -10)
+               .arg(result.framesPerSecond, 10, 'f', 1)
+               .arg(result.deliveredFps, 10, 'f', 1)
+               .arg(result.cpuUsPerFrame, 10, 'f', 1)
+               .arg(result.failedFrames, 8)
+               .arg(result.isReconnected ? QString::number(result.reconnectMs, 'f', 1) : QString("timeout"), 13)
+            << endl;
+    }
+
+    return 0;
+}
@@ -3,6 +3,21 @@
 #include "LightpackApiTest.hpp"
 #include "GrabCalculationTest.hpp"
 #include "lightpackmathtest.hpp"
+#include "SerialOutputEngineTest.hpp"
+#include "AdalightDeltaCodecTest.hpp"
+#include "DdpSenderTest.hpp"
+#include "DmxNetworkSenderTest.hpp"
+#include "FrameRecorderTest.hpp"
+#include "TemporalDitherTest.hpp"
+#include "FrameInterpolatorTest.hpp"
+#include "SetColorParserTest.hpp"
+#include "LightpackFirmwareTest.hpp"
+#ifdef HID_API_ASYNC_WRITE
+#include "HidAsyncWriteTest.hpp"
+#endif
+#ifdef Q_OS_LINUX
+#include "SharedFrameTest.hpp"
+#endif
 #include <iostream>
 
 using namespace std;
@@ -18,6 +33,21 @@ int main(int argc, char *argv[])
     tests.append(new GrabCalculationTest());
     tests.append(new LightpackMathTest());
     tests.append(new LightpackApiTest());
+    tests.append(new SerialOutputEngineTest());
+    tests.append(new AdalightDeltaCodecTest());
+    tests.append(new DdpSenderTest());
+    tests.append(new DmxNetworkSenderTest());
+    tests.append(new FrameRecorderTest());
+    tests.append(new TemporalDitherTest());
+    tests.append(new FrameInterpolatorTest());
+    tests.append(new SetColorParserTest());
+    tests.append(new LightpackFirmwareTest());
+#ifdef HID_API_ASYNC_WRITE
+    tests.append(new HidAsyncWriteTest());
+#endif
+#ifdef Q_OS_LINUX
+    tests.append(new SharedFrameTest());
+#endif
 
 
     for(int i=0; i < tests.size(); i++) {
@@ -0,0 +1,584 @@
+/*
+ * hidapi_mock.c
+ *
+ *  Created on: 19.10.2026
+ *     Project: Lightpack
+ *
+ *  Lightpack is very simple implementation of the backlight for a laptop
+ *
+ *  Copyright (c) 2011 Mike Shatohin, mikeshatohin [at] gmail.com
+ *
+ *  Lightpack is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Lightpack is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+#include <time.h>
+#include <errno.h>
+#include <pthread.h>
+
+#include "hidapi.h"
+#include "hidapi_mock.h"
+
+#define MOCK_MAX_WRITES_IN_FLIGHT   64
+
+struct mock_device {
+	int is_present;
+	unsigned short vendor_id;
+	unsigned short product_id;
+	int generation; /* Incremented on unplug, handles of old generation fail */
+};
+
+struct hid_device_ {
+	int index;
+	int generation;
+	int write_depth;
+	int writes_in_flight;
+};
+
+struct pending_write {
+	hid_device *device;
+	int64_t due_us;
+	int result;
+	hid_write_callback callback;
+	void *user_data;
+};
+
+static pthread_once_t g_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t g_mutex;
+static pthread_cond_t g_condition; /* Signaled when pending writes are changed */
+
+static struct mock_device g_devices[HID_MOCK_MAX_DEVICES];
+static int g_write_latency_us = 0;
+static int64_t g_bus_free_us = 0;
+static int g_fail_writes = 0;
+
+static struct pending_write g_pending[MOCK_MAX_WRITES_IN_FLIGHT];
+static int g_pending_count = 0;
+
+static int g_written_reports = 0;
+static int g_failed_writes = 0;
+static int g_opened_count = 0;
+static int g_max_writes_in_flight = 0;
+
+static const wchar_t g_mock_string[] = L"hidapi mock";
+
+static void *completion_thread(void *arg);
+
+static void init_once(void)
+{
+	pthread_condattr_t attr;
+	pthread_t thread;
+
+	pthread_mutex_init(&g_mutex, NULL);
+	pthread_condattr_init(&attr);
+	pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+	pthread_cond_init(&g_condition, &attr);
+	pthread_condattr_destroy(&attr);
+
+	/* Completes asynchronous writes for the whole process lifetime */
+	if (pthread_create(&thread, NULL, completion_thread, NULL) == 0)
+		pthread_detach(thread);
+}
+
+static void lock(void)
+{
+	pthread_once(&g_once, init_once);
+	pthread_mutex_lock(&g_mutex);
+}
+
+static void unlock(void)
+{
+	pthread_mutex_unlock(&g_mutex);
+}
+
+static int64_t now_us(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void sleep_until_us(int64_t time_us)
+{
+	struct timespec ts;
+	ts.tv_sec = time_us / 1000000;
+	ts.tv_nsec = (time_us % 1000000) * 1000;
+	while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR)
+		;
+}
+
+/* Should be called with g_mutex locked */
+static int find_device(unsigned short vendor_id, unsigned short product_id)
+{
+	int i;
+
+	for (i = 0; i < HID_MOCK_MAX_DEVICES; i++) {
+		if (g_devices[i].vendor_id == vendor_id && g_devices[i].product_id == product_id)
+			return i;
+	}
+	return -1;
+}
+
+/* Should be called with g_mutex locked */
+static int is_connected(const hid_device *dev)
+{
+	const struct mock_device *device = &g_devices[dev->index];
+	return device->is_present && device->generation == dev->generation;
+}
+
+/* Should be called with g_mutex locked.
+   Reserves the bus for one report, returns time when report is delivered
+   and 0 if it succeeded or -1 in result. */
+static int64_t submit_report(const hid_device *dev, int *result)
+{
+	int64_t start_us = now_us();
+
+	if (!is_connected(dev)) {
+		*result = -1;
+		return start_us;
+	}
+
+	if (g_bus_free_us > start_us)
+		start_us = g_bus_free_us;
+	g_bus_free_us = start_us + g_write_latency_us;
+
+	if (g_fail_writes > 0) {
+		g_fail_writes--;
+		g_failed_writes++;
+		*result = -1;
+	} else {
+		g_written_reports++;
+		*result = 0;
+	}
+
+	return g_bus_free_us;
+}
+
+static void *completion_thread(void *arg)
+{
+	(void)arg;
+
+	pthread_mutex_lock(&g_mutex);
+	for (;;) {
+		struct pending_write done;
+		struct timespec ts;
+		int i, first = 0;
+
+		if (g_pending_count == 0) {
+			pthread_cond_wait(&g_condition, &g_mutex);
+			continue;
+		}
+
+		for (i = 1; i < g_pending_count; i++) {
+			if (g_pending[i].due_us < g_pending[first].due_us)
+				first = i;
+		}
+
+		if (g_pending[first].due_us > now_us()) {
+			ts.tv_sec = g_pending[first].due_us / 1000000;
+			ts.tv_nsec = (g_pending[first].due_us % 1000000) * 1000;
+			pthread_cond_timedwait(&g_condition, &g_mutex, &ts);
+			continue;
+		}
+
+		done = g_pending[first];
+		g_pending_count--;
+		memmove(&g_pending[first], &g_pending[first + 1], (g_pending_count - first) * sizeof(g_pending[0]));
+		done.device->writes_in_flight--;
+		pthread_cond_broadcast(&g_condition);
+
+		/* Callback may submit the next write */
+		pthread_mutex_unlock(&g_mutex);
+		done.callback(done.device, done.user_data, done.result);
+		pthread_mutex_lock(&g_mutex);
+	}
+
+	return NULL;
+}
+
+void hid_mock_reset(void)
+{
+	lock();
+	memset(g_devices, 0, sizeof(g_devices));
+	g_write_latency_us = 0;
+	g_bus_free_us = 0;
+	g_fail_writes = 0;
+	g_written_reports = 0;
+	g_failed_writes = 0;
+	g_opened_count = 0;
+	g_max_writes_in_flight = 0;
+	unlock();
+}
+
+void hid_mock_plug(unsigned short vendor_id, unsigned short product_id)
+{
+	int i;
+
+	lock();
+	i = find_device(vendor_id, product_id);
+	if (i < 0)
+		i = find_device(0, 0);
+	if (i >= 0) {
+		g_devices[i].is_present = 1;
+		g_devices[i].vendor_id = vendor_id;
+		g_devices[i].product_id = product_id;
+	}
+	unlock();
+}
+
+void hid_mock_unplug(unsigned short vendor_id, unsigned short product_id)
+{
+	int i;
+
+	lock();
+	i = find_device(vendor_id, product_id);
+	if (i >= 0) {
+		g_devices[i].is_present = 0;
+		g_devices[i].generation++;
+	}
+	for (i = 0; i < g_pending_count; i++) {
+		if (!is_connected(g_pending[i].device)) {
+			g_pending[i].due_us = 0;
+			g_pending[i].result = -1;
+		}
+	}
+	pthread_cond_broadcast(&g_condition);
+	unlock();
+}
+
+void hid_mock_set_write_latency(int microseconds)
+{
+	lock();
+	g_write_latency_us = microseconds;
+	unlock();
+}
+
+void hid_mock_fail_writes(int count)
+{
+	lock();
+	g_fail_writes = count;
+	unlock();
+}
+
+int hid_mock_written_reports(void)
+{
+	int count;
+
+	lock();
+	count = g_written_reports;
+	unlock();
+
+	return count;
+}
+
+int hid_mock_failed_writes(void)
+{
+	int count;
+
+	lock();
+	count = g_failed_writes;
+	unlock();
+
+	return count;
+}
+
+int hid_mock_opened_count(void)
+{
+	int count;
+
+	lock();
+	count = g_opened_count;
+	unlock();
+
+	return count;
+}
+
+int hid_mock_max_writes_in_flight(void)
+{
+	int count;
+
+	lock();
+	count = g_max_writes_in_flight;
+	unlock();
+
+	return count;
+}
+
+int HID_API_EXPORT hid_init(void)
+{
+	return 0;
+}
+
+int HID_API_EXPORT hid_exit(void)
+{
+	return 0;
+}
+
+struct hid_device_info HID_API_EXPORT *hid_enumerate(unsigned short vendor_id, unsigned short product_id)
+{
+	struct hid_device_info *root = NULL;
+	int i;
+
+	lock();
+	for (i = HID_MOCK_MAX_DEVICES - 1; i >= 0; i--) {
+		struct hid_device_info *info;
+
+		if (!g_devices[i].is_present)
+			continue;
+		if ((vendor_id != 0 && vendor_id != g_devices[i].vendor_id) ||
+		    (product_id != 0 && product_id != g_devices[i].product_id))
+			continue;
+
+		info = calloc(1, sizeof(*info));
+		info->path = malloc(16);
+		strcpy(info->path, "mock:0");
+		info->path[5] += i;
+		info->vendor_id = g_devices[i].vendor_id;
+		info->product_id = g_devices[i].product_id;
+		info->manufacturer_string = wcsdup(g_mock_string);
+		info->product_string = wcsdup(g_mock_string);
+		info->next = root;
+		root = info;
+	}
+	unlock();
+
+	return root;
+}
+
+void HID_API_EXPORT hid_free_enumeration(struct hid_device_info *devs)
+{
+	while (devs) {
+		struct hid_device_info *next = devs->next;
+		free(devs->path);
+		free(devs->serial_number);
+		free(devs->manufacturer_string);
+		free(devs->product_string);
+		free(devs);
+		devs = next;
+	}
+}
+
+static hid_device *open_index(int index)
+{
+	hid_device *dev;
+
+	if (index < 0 || index >= HID_MOCK_MAX_DEVICES || !g_devices[index].is_present)
+		return NULL;
+
+	dev = calloc(1, sizeof(*dev));
+	dev->index = index;
+	dev->generation = g_devices[index].generation;
+	g_opened_count++;
+
+	return dev;
+}
+
+hid_device * HID_API_EXPORT hid_open(unsigned short vendor_id, unsigned short product_id, wchar_t *serial_number)
+{
+	hid_device *dev;
+	(void)serial_number;
+
+	lock();
+	dev = open_index(find_device(vendor_id, product_id));
+	unlock();
+
+	return dev;
+}
+
+hid_device * HID_API_EXPORT hid_open_path(const char *path)
+{
+	hid_device *dev = NULL;
+
+	lock();
+	if (strncmp(path, "mock:", 5) == 0)
+		dev = open_index(path[5] - '0');
+	unlock();
+
+	return dev;
+}
+
+int HID_API_EXPORT hid_write(hid_device *dev, const unsigned char *data, size_t length)
+{
+	int64_t due_us;
+	int result;
+	(void)data;
+
+	lock();
+	due_us = submit_report(dev, &result);
+	unlock();
+
+	/* Synchronous interrupt transfer returns when report is delivered */
+	sleep_until_us(due_us);
+
+	return result < 0 ? -1 : (int)length;
+}
+
+int HID_API_EXPORT hid_set_write_depth(hid_device *dev, int depth)
+{
+	int result = 0;
+
+	lock();
+	if (dev->writes_in_flight > 0 || depth < 0 || depth > MOCK_MAX_WRITES_IN_FLIGHT)
+		result = -1;
+	else
+		dev->write_depth = depth;
+	unlock();
+
+	return result;
+}
+
+int HID_API_EXPORT hid_write_async(hid_device *dev, const unsigned char *data, size_t length, hid_write_callback callback, void *user_data)
+{
+	struct pending_write *pending;
+	(void)data;
+
+	lock();
+	if (!is_connected(dev) || dev->writes_in_flight >= dev->write_depth || g_pending_count >= MOCK_MAX_WRITES_IN_FLIGHT) {
+		unlock();
+		return -1;
+	}
+
+	pending = &g_pending[g_pending_count++];
+	pending->device = dev;
+	pending->callback = callback;
+	pending->user_data = user_data;
+	pending->due_us = submit_report(dev, &pending->result);
+
+	dev->writes_in_flight++;
+	if (dev->writes_in_flight > g_max_writes_in_flight)
+		g_max_writes_in_flight = dev->writes_in_flight;
+
+	pthread_cond_broadcast(&g_condition);
+	unlock();
+
+	return (int)length;
+}
+
+int HID_API_EXPORT hid_write_async_in_flight(hid_device *dev)
+{
+	int in_flight;
+
+	lock();
+	in_flight = dev->writes_in_flight;
+	unlock();
+
+	return in_flight;
+}
+
+int HID_API_EXPORT hid_read_timeout(hid_device *dev, unsigned char *data, size_t length, int milliseconds)
+{
+	int result;
+	(void)data;
+	(void)length;
+	(void)milliseconds;
+
+	/* Device never sends input reports */
+	lock();
+	result = is_connected(dev) ? 0 : -1;
+	unlock();
+
+	return result;
+}
+
+int HID_API_EXPORT hid_read(hid_device *dev, unsigned char *data, size_t length)
+{
+	return hid_read_timeout(dev, data, length, 0);
+}
+
+int HID_API_EXPORT hid_set_nonblocking(hid_device *dev, int nonblock)
+{
+	(void)dev;
+	(void)nonblock;
+	return 0;
+}
+
+int HID_API_EXPORT hid_send_feature_report(hid_device *dev, const unsigned char *data, size_t length)
+{
+	return hid_write(dev, data, length);
+}
+
+int HID_API_EXPORT hid_get_feature_report(hid_device *dev, unsigned char *data, size_t length)
+{
+	return hid_read_timeout(dev, data, length, 0);
+}
+
+void HID_API_EXPORT hid_close(hid_device *dev)
+{
+	struct pending_write cancelled[MOCK_MAX_WRITES_IN_FLIGHT];
+	int i, j, count = 0;
+
+	if (!dev)
+		return;
+
+	lock();
+	for (i = 0, j = 0; i < g_pending_count; i++) {
+		if (g_pending[i].device == dev)
+			cancelled[count++] = g_pending[i];
+		else
+			g_pending[j++] = g_pending[i];
+	}
+	g_pending_count = j;
+	pthread_cond_broadcast(&g_condition);
+	unlock();
+
+	/* Like libusb backend: callbacks of cancelled writes report -1 */
+	for (i = 0; i < count; i++)
+		cancelled[i].callback(dev, cancelled[i].user_data, -1);
+
+	free(dev);
+}
+
+static int copy_string(hid_device *dev, wchar_t *string, size_t maxlen)
+{
+	(void)dev;
+
+	if (maxlen == 0)
+		return -1;
+
+	wcsncpy(string, g_mock_string, maxlen);
+	string[maxlen - 1] = L'\0';
+
+	return 0;
+}
+
+int HID_API_EXPORT_CALL hid_get_manufacturer_string(hid_device *dev, wchar_t *string, size_t maxlen)
+{
+	return copy_string(dev, string, maxlen);
+}
+
+int HID_API_EXPORT_CALL hid_get_product_string(hid_device *dev, wchar_t *string, size_t maxlen)
+{
+	return copy_string(dev, string, maxlen);
+}
+
+int HID_API_EXPORT_CALL hid_get_serial_number_string(hid_device *dev, wchar_t *string, size_t maxlen)
+{
+	return copy_string(dev, string, maxlen);
+}
+
+int HID_API_EXPORT_CALL hid_get_indexed_string(hid_device *dev, int string_index, wchar_t *string, size_t maxlen)
+{
+	(void)string_index;
+	return copy_string(dev, string, maxlen);
+}
+
+HID_API_EXPORT const wchar_t * HID_API_CALL hid_error(hid_device *dev)
+{
+	(void)dev;
+	return NULL;
+}
@@ -0,0 +1,65 @@
+/*
+ * hidapi_mock.h
+ *
+ *  Created on: 19.10.2026
+ *     Project: Lightpack
+ *
+ *  Lightpack is very simple implementation of the backlight for a laptop
+ *
+ *  Copyright (c) 2011 Mike Shatohin, mikeshatohin [at] gmail.com
+ *
+ *  Lightpack is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Lightpack is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef HIDAPI_MOCK_H
+#define HIDAPI_MOCK_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+  hidapi implementation without hardware. It is linked instead of
+  hidapi/<platform>/hid*.c, devices are plugged and unplugged by the test.
+  Reports are "on the bus" for the write latency one after another, like
+  interrupt transfers of a real device.
+*/
+
+#define HID_MOCK_MAX_DEVICES    4
+
+/* Unplug all devices, forget latency, failures and counters */
+void hid_mock_reset(void);
+
+void hid_mock_plug(unsigned short vendor_id, unsigned short product_id);
+
+/* Opened handles of the device fail from now, pending writes complete with error */
+void hid_mock_unplug(unsigned short vendor_id, unsigned short product_id);
+
+/* Time of one report on the bus, hid_write() blocks for it */
+void hid_mock_set_write_latency(int microseconds);
+
+/* Next count writes fail as if report wasn't acknowledged */
+void hid_mock_fail_writes(int count);
+
+int hid_mock_written_reports(void);
+int hid_mock_failed_writes(void);
+int hid_mock_opened_count(void);
+int hid_mock_max_writes_in_flight(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HIDAPI_MOCK_H */
@@ -0,0 +1,627 @@
+/*
+ * libusb_mock.c
+ *
+ *  Created on: 19.10.2026
+ *     Project: Lightpack
+ *
+ *  Lightpack is very simple implementation of the backlight for a laptop
+ *
+ *  Copyright (c) 2011 Mike Shatohin, mikeshatohin [at] gmail.com
+ *
+ *  Lightpack is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Lightpack is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "libusb.h"
+#include "libusb_mock.h"
+
+#define MOCK_MAX_TRANSFERS      64
+#define MOCK_IN_ENDPOINT        0x81
+
+struct pending_transfer {
+	struct libusb_transfer *transfer;
+	int64_t due_us; /* Write completes itself at this time */
+	int is_done;
+	enum libusb_transfer_status status;
+};
+
+static pthread_once_t g_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t g_mutex;
+static pthread_cond_t g_condition; /* Signaled when transfer is ready to complete */
+
+static int g_is_present = 0;
+static uint16_t g_vendor_id = 0;
+static uint16_t g_product_id = 0;
+static int g_write_latency_us = 0;
+static int64_t g_bus_free_us = 0;
+
+static struct pending_transfer g_pending[MOCK_MAX_TRANSFERS];
+static int g_pending_count = 0;
+static int g_max_pending_writes = 0;
+
+static unsigned char g_reports[LIBUSB_MOCK_REPORTS_LOGGED][LIBUSB_MOCK_REPORT_SIZE];
+static int g_reports_length[LIBUSB_MOCK_REPORTS_LOGGED];
+static int g_reports_count = 0;
+
+/* Any address will do, hidapi uses them as opaque pointers */
+static char g_device_storage;
+static char g_handle_storage;
+
+/* Same as Firmware/Descriptors.c, Output reports use the Control Endpoint */
+static const struct libusb_endpoint_descriptor g_endpoints[] = {
+	{ 7, 5, MOCK_IN_ENDPOINT, LIBUSB_TRANSFER_TYPE_INTERRUPT, LIBUSB_MOCK_REPORT_SIZE, 1 }
+};
+
+static const struct libusb_interface_descriptor g_interface_descriptor = {
+	9, 4, 0 /* number */, 0, 1, LIBUSB_CLASS_HID, 0, 0, 0, g_endpoints
+};
+
+static const struct libusb_interface g_interface = { &g_interface_descriptor, 1 };
+
+static struct libusb_config_descriptor g_config = {
+	9, 2, 0, 1 /* interfaces */, 1, 0, 0x80, 50, &g_interface
+};
+
+static void init_once(void)
+{
+	pthread_condattr_t attr;
+
+	pthread_mutex_init(&g_mutex, NULL);
+	pthread_condattr_init(&attr);
+	pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+	pthread_cond_init(&g_condition, &attr);
+	pthread_condattr_destroy(&attr);
+}
+
+static void lock(void)
+{
+	pthread_once(&g_once, init_once);
+	pthread_mutex_lock(&g_mutex);
+}
+
+static void unlock(void)
+{
+	pthread_mutex_unlock(&g_mutex);
+}
+
+static int64_t now_us(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static int is_out(const struct libusb_transfer *transfer)
+{
+	/* Direction of the control transfer is in its setup packet */
+	if (transfer->type == LIBUSB_TRANSFER_TYPE_CONTROL)
+		return (transfer->buffer[0] & LIBUSB_ENDPOINT_DIR_MASK) == LIBUSB_ENDPOINT_OUT;
+	return (transfer->endpoint & LIBUSB_ENDPOINT_DIR_MASK) == LIBUSB_ENDPOINT_OUT;
+}
+
+/* Should be called with g_mutex locked */
+static void log_report(const unsigned char *data, int length)
+{
+	int index = g_reports_count % LIBUSB_MOCK_REPORTS_LOGGED;
+
+	if (length > LIBUSB_MOCK_REPORT_SIZE)
+		length = LIBUSB_MOCK_REPORT_SIZE;
+
+	memcpy(g_reports[index], data, length);
+	g_reports_length[index] = length;
+	g_reports_count++;
+}
+
+/* Should be called with g_mutex locked */
+static int pending_writes(void)
+{
+	int i, count = 0;
+
+	for (i = 0; i < g_pending_count; i++) {
+		if (is_out(g_pending[i].transfer) && !g_pending[i].is_done)
+			count++;
+	}
+	return count;
+}
+
+/* Should be called with g_mutex locked */
+static void finish(struct pending_transfer *pending, enum libusb_transfer_status status)
+{
+	pending->is_done = 1;
+	pending->status = status;
+	pthread_cond_broadcast(&g_condition);
+}
+
+void libusb_mock_reset(uint16_t vendor_id, uint16_t product_id)
+{
+	lock();
+	g_is_present = 1;
+	g_vendor_id = vendor_id;
+	g_product_id = product_id;
+	g_write_latency_us = 0;
+	g_bus_free_us = 0;
+	g_pending_count = 0;
+	g_max_pending_writes = 0;
+	g_reports_count = 0;
+	unlock();
+}
+
+void libusb_mock_unplug(void)
+{
+	int i;
+
+	lock();
+	g_is_present = 0;
+	for (i = 0; i < g_pending_count; i++) {
+		if (!g_pending[i].is_done)
+			finish(&g_pending[i], LIBUSB_TRANSFER_NO_DEVICE);
+	}
+	unlock();
+}
+
+void libusb_mock_set_write_latency(int microseconds)
+{
+	lock();
+	g_write_latency_us = microseconds;
+	unlock();
+}
+
+int libusb_mock_complete_writes(int count)
+{
+	int i, completed = 0;
+
+	lock();
+	for (i = 0; i < g_pending_count && completed < count; i++) {
+		if (is_out(g_pending[i].transfer) && !g_pending[i].is_done) {
+			finish(&g_pending[i], LIBUSB_TRANSFER_COMPLETED);
+			completed++;
+		}
+	}
+	unlock();
+
+	return completed;
+}
+
+int libusb_mock_pending_writes(void)
+{
+	int count;
+
+	lock();
+	count = pending_writes();
+	unlock();
+
+	return count;
+}
+
+int libusb_mock_max_pending_writes(void)
+{
+	int count;
+
+	lock();
+	count = g_max_pending_writes;
+	unlock();
+
+	return count;
+}
+
+int libusb_mock_written_reports(void)
+{
+	int count;
+
+	lock();
+	count = g_reports_count;
+	unlock();
+
+	return count;
+}
+
+int libusb_mock_written_report(int index, unsigned char *data, int length)
+{
+	int slot;
+
+	lock();
+	if (index < 0 || index >= g_reports_count || index < g_reports_count - LIBUSB_MOCK_REPORTS_LOGGED) {
+		unlock();
+		return -1;
+	}
+	slot = index % LIBUSB_MOCK_REPORTS_LOGGED;
+	if (length > g_reports_length[slot])
+		length = g_reports_length[slot];
+	memcpy(data, g_reports[slot], length);
+	unlock();
+
+	return length;
+}
+
+int libusb_mock_input_report(const unsigned char *data, int length)
+{
+	int i;
+
+	lock();
+	for (i = 0; i < g_pending_count; i++) {
+		struct libusb_transfer *transfer = g_pending[i].transfer;
+
+		if (!is_out(transfer) && !g_pending[i].is_done) {
+			if (length > transfer->length)
+				length = transfer->length;
+			memcpy(transfer->buffer, data, length);
+			transfer->actual_length = length;
+			finish(&g_pending[i], LIBUSB_TRANSFER_COMPLETED);
+			unlock();
+			return length;
+		}
+	}
+	unlock();
+
+	return -1;
+}
+
+int libusb_init(libusb_context **ctx)
+{
+	(void)ctx;
+	return 0;
+}
+
+void libusb_exit(libusb_context *ctx)
+{
+	(void)ctx;
+}
+
+ssize_t libusb_get_device_list(libusb_context *ctx, libusb_device ***list)
+{
+	libusb_device **devs = calloc(2, sizeof(libusb_device *));
+	ssize_t count = 0;
+
+	(void)ctx;
+
+	lock();
+	if (g_is_present)
+		devs[count++] = (libusb_device *)&g_device_storage;
+	unlock();
+
+	*list = devs;
+	return count;
+}
+
+void libusb_free_device_list(libusb_device **list, int unref_devices)
+{
+	(void)unref_devices;
+	free(list);
+}
+
+int libusb_get_device_descriptor(libusb_device *dev, struct libusb_device_descriptor *desc)
+{
+	(void)dev;
+
+	memset(desc, 0, sizeof(*desc));
+	desc->bLength = 18;
+	desc->bDescriptorType = 1;
+	desc->bcdUSB = 0x0110;
+	desc->bDeviceClass = LIBUSB_CLASS_PER_INTERFACE;
+	desc->bMaxPacketSize0 = 8;
+	desc->idVendor = g_vendor_id;
+	desc->idProduct = g_product_id;
+	desc->bcdDevice = 0x0100;
+	desc->bNumConfigurations = 1;
+
+	return 0;
+}
+
+int libusb_get_active_config_descriptor(libusb_device *dev, struct libusb_config_descriptor **config)
+{
+	(void)dev;
+	*config = &g_config;
+	return 0;
+}
+
+int libusb_get_config_descriptor(libusb_device *dev, uint8_t config_index, struct libusb_config_descriptor **config)
+{
+	(void)config_index;
+	return libusb_get_active_config_descriptor(dev, config);
+}
+
+void libusb_free_config_descriptor(struct libusb_config_descriptor *config)
+{
+	(void)config;
+}
+
+uint8_t libusb_get_bus_number(libusb_device *dev)
+{
+	(void)dev;
+	return 1;
+}
+
+uint8_t libusb_get_device_address(libusb_device *dev)
+{
+	(void)dev;
+	return 2;
+}
+
+int libusb_open(libusb_device *dev, libusb_device_handle **handle)
+{
+	int res = LIBUSB_ERROR_NO_DEVICE;
+
+	(void)dev;
+
+	lock();
+	if (g_is_present) {
+		*handle = (libusb_device_handle *)&g_handle_storage;
+		res = 0;
+	}
+	unlock();
+
+	return res;
+}
+
+void libusb_close(libusb_device_handle *dev_handle)
+{
+	(void)dev_handle;
+}
+
+int libusb_kernel_driver_active(libusb_device_handle *dev, int interface_number)
+{
+	(void)dev;
+	(void)interface_number;
+	return 0;
+}
+
+int libusb_detach_kernel_driver(libusb_device_handle *dev, int interface_number)
+{
+	(void)dev;
+	(void)interface_number;
+	return 0;
+}
+
+int libusb_attach_kernel_driver(libusb_device_handle *dev, int interface_number)
+{
+	(void)dev;
+	(void)interface_number;
+	return 0;
+}
+
+int libusb_claim_interface(libusb_device_handle *dev, int interface_number)
+{
+	(void)dev;
+	(void)interface_number;
+	return 0;
+}
+
+int libusb_release_interface(libusb_device_handle *dev, int interface_number)
+{
+	(void)dev;
+	(void)interface_number;
+	return 0;
+}
+
+int libusb_control_transfer(libusb_device_handle *dev_handle,
+	uint8_t request_type, uint8_t bRequest, uint16_t wValue, uint16_t wIndex,
+	unsigned char *data, uint16_t wLength, unsigned int timeout)
+{
+	int latency_us = 0;
+
+	(void)dev_handle;
+	(void)bRequest;
+	(void)wValue;
+	(void)wIndex;
+	(void)timeout;
+
+	lock();
+	if (!g_is_present) {
+		unlock();
+		return LIBUSB_ERROR_NO_DEVICE;
+	}
+	if ((request_type & LIBUSB_ENDPOINT_DIR_MASK) == LIBUSB_ENDPOINT_OUT) {
+		log_report(data, wLength);
+		latency_us = g_write_latency_us;
+	} else {
+		memset(data, 0, wLength);
+	}
+	unlock();
+
+	/* Blocking transfer waits for the bus */
+	if (latency_us > 0)
+		usleep(latency_us);
+
+	return wLength;
+}
+
+int libusb_interrupt_transfer(libusb_device_handle *dev_handle,
+	unsigned char endpoint, unsigned char *data, int length,
+	int *actual_length, unsigned int timeout)
+{
+	int latency_us;
+
+	(void)dev_handle;
+	(void)timeout;
+
+	lock();
+	if (!g_is_present) {
+		unlock();
+		return LIBUSB_ERROR_NO_DEVICE;
+	}
+	if ((endpoint & LIBUSB_ENDPOINT_DIR_MASK) == LIBUSB_ENDPOINT_OUT)
+		log_report(data, length);
+	else
+		memset(data, 0, length);
+	latency_us = g_write_latency_us;
+	unlock();
+
+	/* Blocking transfer waits for the bus */
+	if (latency_us > 0)
+		usleep(latency_us);
+
+	*actual_length = length;
+	return 0;
+}
+
+int libusb_get_string_descriptor(libusb_device_handle *dev,
+	uint8_t desc_index, uint16_t langid, unsigned char *data, int length)
+{
+	(void)dev;
+	(void)desc_index;
+	(void)langid;
+	(void)data;
+	(void)length;
+	return LIBUSB_ERROR_IO;
+}
+
+struct libusb_transfer *libusb_alloc_transfer(int iso_packets)
+{
+	(void)iso_packets;
+	return calloc(1, sizeof(struct libusb_transfer));
+}
+
+void libusb_free_transfer(struct libusb_transfer *transfer)
+{
+	free(transfer);
+}
+
+int libusb_submit_transfer(struct libusb_transfer *transfer)
+{
+	struct pending_transfer *pending;
+
+	lock();
+	if (!g_is_present) {
+		unlock();
+		return LIBUSB_ERROR_NO_DEVICE;
+	}
+	if (g_pending_count == MOCK_MAX_TRANSFERS) {
+		unlock();
+		return LIBUSB_ERROR_BUSY;
+	}
+
+	pending = &g_pending[g_pending_count++];
+	pending->transfer = transfer;
+	pending->is_done = 0;
+	pending->due_us = INT64_MAX;
+
+	if (is_out(transfer)) {
+		int count;
+
+		/* Actual length of the control transfer doesn't count the setup */
+		if (transfer->type == LIBUSB_TRANSFER_TYPE_CONTROL) {
+			log_report(transfer->buffer + LIBUSB_CONTROL_SETUP_SIZE,
+				transfer->length - LIBUSB_CONTROL_SETUP_SIZE);
+			transfer->actual_length = transfer->length - LIBUSB_CONTROL_SETUP_SIZE;
+		} else {
+			log_report(transfer->buffer, transfer->length);
+			transfer->actual_length = transfer->length;
+		}
+
+		/* Reports go through the bus one by one */
+		if (g_write_latency_us > 0) {
+			int64_t start = now_us();
+			if (g_bus_free_us > start)
+				start = g_bus_free_us;
+			pending->due_us = start + g_write_latency_us;
+			g_bus_free_us = pending->due_us;
+			pthread_cond_broadcast(&g_condition);
+		}
+
+		count = pending_writes();
+		if (count > g_max_pending_writes)
+			g_max_pending_writes = count;
+	}
+	unlock();
+
+	return 0;
+}
+
+int libusb_cancel_transfer(struct libusb_transfer *transfer)
+{
+	int i;
+
+	lock();
+	for (i = 0; i < g_pending_count; i++) {
+		if (g_pending[i].transfer == transfer && !g_pending[i].is_done) {
+			finish(&g_pending[i], LIBUSB_TRANSFER_CANCELLED);
+			unlock();
+			return 0;
+		}
+	}
+	unlock();
+
+	return LIBUSB_ERROR_NOT_FOUND;
+}
+
+int libusb_handle_events_timeout(libusb_context *ctx, struct timeval *tv)
+{
+	struct pending_transfer ready[MOCK_MAX_TRANSFERS];
+	int ready_count = 0;
+	int64_t deadline = now_us() + (int64_t)tv->tv_sec * 1000000 + tv->tv_usec;
+	int i, j;
+
+	(void)ctx;
+
+	lock();
+	for (;;) {
+		int64_t now = now_us();
+		int64_t wake = deadline;
+
+		for (i = 0; i < g_pending_count; i++) {
+			if (!g_pending[i].is_done && g_pending[i].due_us <= now) {
+				g_pending[i].is_done = 1;
+				g_pending[i].status = LIBUSB_TRANSFER_COMPLETED;
+			}
+			if (g_pending[i].is_done)
+				ready_count++;
+			else if (g_pending[i].due_us < wake)
+				wake = g_pending[i].due_us;
+		}
+
+		if (ready_count > 0 || now >= deadline)
+			break;
+
+		{
+			struct timespec ts;
+			ts.tv_sec = wake / 1000000;
+			ts.tv_nsec = (wake % 1000000) * 1000;
+			pthread_cond_timedwait(&g_condition, &g_mutex, &ts);
+		}
+	}
+
+	/* Take completed transfers out keeping the order of submission */
+	ready_count = 0;
+	for (i = 0, j = 0; i < g_pending_count; i++) {
+		if (g_pending[i].is_done)
+			ready[ready_count++] = g_pending[i];
+		else
+			g_pending[j++] = g_pending[i];
+	}
+	g_pending_count = j;
+	unlock();
+
+	/* Callbacks may submit transfers again */
+	for (i = 0; i < ready_count; i++) {
+		struct libusb_transfer *transfer = ready[i].transfer;
+		transfer->status = ready[i].status;
+		if (transfer->status != LIBUSB_TRANSFER_COMPLETED && is_out(transfer))
+			transfer->actual_length = 0;
+		transfer->callback(transfer);
+	}
+
+	return 0;
+}
+
+int libusb_handle_events(libusb_context *ctx)
+{
+	struct timeval tv = { 0, 10000 };
+	return libusb_handle_events_timeout(ctx, &tv);
+}
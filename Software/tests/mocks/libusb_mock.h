@@ -0,0 +1,69 @@
+/*
+ * libusb_mock.h
+ *
+ *  Created on: 19.10.2026
+ *     Project: Lightpack
+ *
+ *  Lightpack is very simple implementation of the backlight for a laptop
+ *
+ *  Copyright (c) 2011 Mike Shatohin, mikeshatohin [at] gmail.com
+ *
+ *  Lightpack is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Lightpack is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef LIBUSB_MOCK_H
+#define LIBUSB_MOCK_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LIBUSB_MOCK_REPORT_SIZE     64
+#define LIBUSB_MOCK_REPORTS_LOGGED  1024
+
+/* Plug in the device and forget all transfers and written reports */
+void libusb_mock_reset(uint16_t vendor_id, uint16_t product_id);
+
+/* Unplug: pending transfers complete with LIBUSB_TRANSFER_NO_DEVICE */
+void libusb_mock_unplug(void);
+
+/* 0 - OUT transfers wait for libusb_mock_complete_writes(),
+   otherwise they complete after given number of microseconds */
+void libusb_mock_set_write_latency(int microseconds);
+
+/* Complete the oldest submitted OUT transfers, returns number of completed */
+int libusb_mock_complete_writes(int count);
+
+/* Number of OUT transfers submitted and not completed */
+int libusb_mock_pending_writes(void);
+
+/* Maximum of OUT transfers which were on the bus at the same time */
+int libusb_mock_max_pending_writes(void);
+
+/* Reports written by both synchronous and asynchronous transfers,
+   the last LIBUSB_MOCK_REPORTS_LOGGED are kept */
+int libusb_mock_written_reports(void);
+int libusb_mock_written_report(int index, unsigned char *data, int length);
+
+/* Complete the pending IN transfer with the report */
+int libusb_mock_input_report(const unsigned char *data, int length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LIBUSB_MOCK_H */
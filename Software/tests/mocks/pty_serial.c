@@ -0,0 +1,246 @@
+/*
+ * pty_serial.c
+ *
+ *  Created on: 19.10.2026
+ *     Project: Lightpack
+ *
+ *  Lightpack is very simple implementation of the backlight for a laptop
+ *
+ *  Copyright (c) 2011 Mike Shatohin, mikeshatohin [at] gmail.com
+ *
+ *  Lightpack is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Lightpack is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#define _XOPEN_SOURCE 600
+#define _DEFAULT_SOURCE
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <termios.h>
+#include <pthread.h>
+
+#include "pty_serial.h"
+
+#define PTY_READ_CHUNK      4096
+#define PTY_POLL_TIMEOUT_MS 10
+
+struct pty_serial {
+	char *link_path;
+	int master_fd;
+	/* Kept open, so master never gets EIO while device reopens the port */
+	int slave_fd;
+
+	pthread_t thread;
+	int is_running;
+
+	pthread_mutex_t mutex;
+	int baud_rate;
+	int read_latency_us;
+	int64_t bytes_received;
+	int64_t last_data_us;
+};
+
+static int64_t now_us(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void *drain_thread(void *arg)
+{
+	struct pty_serial *serial = arg;
+	char buffer[PTY_READ_CHUNK];
+
+	for (;;) {
+		struct pollfd fd = { serial->master_fd, POLLIN, 0 };
+		int is_running, baud_rate, latency_us;
+		ssize_t bytes;
+
+		pthread_mutex_lock(&serial->mutex);
+		is_running = serial->is_running;
+		baud_rate = serial->baud_rate;
+		latency_us = serial->read_latency_us;
+		pthread_mutex_unlock(&serial->mutex);
+
+		if (!is_running)
+			break;
+
+		if (poll(&fd, 1, PTY_POLL_TIMEOUT_MS) <= 0)
+			continue;
+
+		if (latency_us > 0)
+			usleep(latency_us);
+
+		bytes = read(serial->master_fd, buffer, sizeof(buffer));
+		if (bytes <= 0)
+			continue;
+
+		pthread_mutex_lock(&serial->mutex);
+		serial->bytes_received += bytes;
+		serial->last_data_us = now_us();
+		pthread_mutex_unlock(&serial->mutex);
+
+		/* 8N1: 10 bits on the wire per byte */
+		if (baud_rate > 0)
+			usleep((useconds_t)(bytes * 10 * 1000000LL / baud_rate));
+	}
+
+	return NULL;
+}
+
+static int open_pty(struct pty_serial *serial)
+{
+	struct termios options;
+	const char *slave_name;
+
+	serial->master_fd = posix_openpt(O_RDWR | O_NOCTTY);
+	if (serial->master_fd < 0)
+		return -1;
+
+	if (grantpt(serial->master_fd) < 0 || unlockpt(serial->master_fd) < 0)
+		goto fail;
+
+	slave_name = ptsname(serial->master_fd);
+	if (slave_name == NULL)
+		goto fail;
+
+	serial->slave_fd = open(slave_name, O_RDWR | O_NOCTTY);
+	if (serial->slave_fd < 0)
+		goto fail;
+
+	/* Frame bytes must not be translated, i.e. '\n' to "\r\n" */
+	if (tcgetattr(serial->slave_fd, &options) == 0) {
+		cfmakeraw(&options);
+		tcsetattr(serial->slave_fd, TCSANOW, &options);
+	}
+
+	unlink(serial->link_path);
+	if (symlink(slave_name, serial->link_path) < 0)
+		goto fail;
+
+	serial->is_running = 1;
+	if (pthread_create(&serial->thread, NULL, drain_thread, serial) != 0) {
+		serial->is_running = 0;
+		goto fail;
+	}
+
+	return 0;
+
+fail:
+	if (serial->slave_fd >= 0)
+		close(serial->slave_fd);
+	close(serial->master_fd);
+	serial->master_fd = -1;
+	serial->slave_fd = -1;
+	return -1;
+}
+
+struct pty_serial *pty_serial_open(const char *link_path)
+{
+	struct pty_serial *serial = calloc(1, sizeof(*serial));
+
+	serial->link_path = strdup(link_path);
+	serial->master_fd = -1;
+	serial->slave_fd = -1;
+	pthread_mutex_init(&serial->mutex, NULL);
+
+	if (open_pty(serial) < 0) {
+		pty_serial_close(serial);
+		return NULL;
+	}
+
+	return serial;
+}
+
+void pty_serial_close(struct pty_serial *serial)
+{
+	if (!serial)
+		return;
+
+	pty_serial_hangup(serial);
+	unlink(serial->link_path);
+	pthread_mutex_destroy(&serial->mutex);
+	free(serial->link_path);
+	free(serial);
+}
+
+void pty_serial_set_baud_rate(struct pty_serial *serial, int baud_rate)
+{
+	pthread_mutex_lock(&serial->mutex);
+	serial->baud_rate = baud_rate;
+	pthread_mutex_unlock(&serial->mutex);
+}
+
+void pty_serial_set_read_latency(struct pty_serial *serial, int microseconds)
+{
+	pthread_mutex_lock(&serial->mutex);
+	serial->read_latency_us = microseconds;
+	pthread_mutex_unlock(&serial->mutex);
+}
+
+void pty_serial_hangup(struct pty_serial *serial)
+{
+	if (serial->master_fd < 0)
+		return;
+
+	pthread_mutex_lock(&serial->mutex);
+	serial->is_running = 0;
+	pthread_mutex_unlock(&serial->mutex);
+	pthread_join(serial->thread, NULL);
+
+	close(serial->master_fd);
+	close(serial->slave_fd);
+	serial->master_fd = -1;
+	serial->slave_fd = -1;
+}
+
+int pty_serial_replug(struct pty_serial *serial)
+{
+	pty_serial_hangup(serial);
+	return open_pty(serial);
+}
+
+const char *pty_serial_link_path(const struct pty_serial *serial)
+{
+	return serial->link_path;
+}
+
+int64_t pty_serial_bytes_received(struct pty_serial *serial)
+{
+	int64_t bytes;
+
+	pthread_mutex_lock(&serial->mutex);
+	bytes = serial->bytes_received;
+	pthread_mutex_unlock(&serial->mutex);
+
+	return bytes;
+}
+
+int64_t pty_serial_last_data_us(struct pty_serial *serial)
+{
+	int64_t time_us;
+
+	pthread_mutex_lock(&serial->mutex);
+	time_us = serial->last_data_us;
+	pthread_mutex_unlock(&serial->mutex);
+
+	return time_us;
+}
@@ -0,0 +1,72 @@
+/*
+ * pty_serial.h
+ *
+ *  Created on: 19.10.2026
+ *     Project: Lightpack
+ *
+ *  Lightpack is very simple implementation of the backlight for a laptop
+ *
+ *  Copyright (c) 2011 Mike Shatohin, mikeshatohin [at] gmail.com
+ *
+ *  Lightpack is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Lightpack is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef PTY_SERIAL_H
+#define PTY_SERIAL_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+  Serial port stand-in for Adalight and Ardulight: a pseudo terminal whose
+  slave side is opened by the device as a serial port. Symlink with the
+  given name always points to the current slave, so port name in settings
+  stays the same after replug. Background thread reads the master side with
+  the speed of the UART.
+*/
+
+struct pty_serial;
+
+struct pty_serial *pty_serial_open(const char *link_path);
+void pty_serial_close(struct pty_serial *serial);
+
+/* 0 - data is drained as fast as it comes */
+void pty_serial_set_baud_rate(struct pty_serial *serial, int baud_rate);
+
+/* Delay of each read of the master side */
+void pty_serial_set_read_latency(struct pty_serial *serial, int microseconds);
+
+/* Unplug: master side is closed, writes to the slave fail with EIO */
+void pty_serial_hangup(struct pty_serial *serial);
+
+/* Plug in again as a new pseudo terminal, returns 0 on success */
+int pty_serial_replug(struct pty_serial *serial);
+
+const char *pty_serial_link_path(const struct pty_serial *serial);
+
+/* Counters are kept over replugs */
+int64_t pty_serial_bytes_received(struct pty_serial *serial);
+
+/* CLOCK_MONOTONIC time of the last received byte in microseconds, 0 - none */
+int64_t pty_serial_last_data_us(struct pty_serial *serial);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PTY_SERIAL_H */
@@ -29,6 +29,7 @@ INCLUDEPATH += ../src/ ../src/grab
 SOURCES += \
     LightpackApiTest.cpp \
     ../src/ApiServerSetColorTask.cpp \
+    ../src/SetColorParser.cpp \
     ../src/ApiServer.cpp \
     ../src/Settings.cpp \
     ../src/LightpackPluginInterface.cpp \
@@ -38,13 +39,33 @@ SOURCES += \
     main.cpp \
     GrabCalculationTest.cpp \
     lightpackmathtest.cpp \
-    ../src/LightpackMath.cpp
+    ../src/LightpackMath.cpp \
+    SerialOutputEngineTest.cpp \
+    ../src/SerialOutputEngine.cpp \
+    AdalightDeltaCodecTest.cpp \
+    ../src/AdalightDeltaCodec.cpp \
+    DdpSenderTest.cpp \
+    ../src/DdpSender.cpp \
+    ../src/UdpPacketSender.cpp \
+    DmxNetworkSenderTest.cpp \
+    ../src/DmxNetworkSender.cpp \
+    FrameRecorderTest.cpp \
+    ../src/FrameRecorder.cpp \
+    ../src/FramePlayer.cpp \
+    TemporalDitherTest.cpp \
+    ../src/TemporalDither.cpp \
+    FrameInterpolatorTest.cpp \
+    ../src/FrameInterpolator.cpp \
+    SetColorParserTest.cpp \
+    LightpackFirmwareTest.cpp \
+    ../src/LightpackFirmware.cpp
 
 HEADERS += \
     ../src/grab/calculations.hpp \
     ../common/defs.h \
     ../src/enums.hpp \
     ../src/ApiServerSetColorTask.hpp \
+    ../src/SetColorParser.hpp \
     ../src/ApiServer.hpp \
     ../src/debug.h \
     ../src/Settings.hpp \
@@ -54,8 +75,47 @@ HEADERS += \
     GrabCalculationTest.hpp \
     LightpackApiTest.hpp \
     lightpackmathtest.hpp \
-    ../src/LightpackMath.hpp
+    ../src/LightpackMath.hpp \
+    SerialOutputEngineTest.hpp \
+    ../src/SerialOutputEngine.hpp \
+    AdalightDeltaCodecTest.hpp \
+    ../src/AdalightDeltaCodec.hpp \
+    DdpSenderTest.hpp \
+    ../src/DdpSender.hpp \
+    ../src/UdpPacketSender.hpp \
+    DmxNetworkSenderTest.hpp \
+    ../src/DmxNetworkSender.hpp \
+    FrameRecorderTest.hpp \
+    ../src/FrameRecorder.hpp \
+    ../src/FramePlayer.hpp \
+    TemporalDitherTest.hpp \
+    ../src/TemporalDither.hpp \
+    FrameInterpolatorTest.hpp \
+    ../src/FrameInterpolator.hpp \
+    SetColorParserTest.hpp \
+    LightpackFirmwareTest.hpp \
+    ../src/LightpackFirmware.hpp
 
+include(../src/qserialdevice/qserialdevice/qserialdevice.pri)
+
+unix:!macx{
+    # Linux hidapi backend is tested against libusb mock
+    INCLUDEPATH += mocks ../src/hidapi
+    DEFINES += HID_API_ASYNC_WRITE
+    SOURCES += \
+        HidAsyncWriteTest.cpp \
+        ../src/hidapi/linux/hid-libusb.c \
+        mocks/libusb_mock.c \
+        SharedFrameTest.cpp \
+        ../src/SharedFrame.cpp
+    HEADERS += \
+        HidAsyncWriteTest.hpp \
+        mocks/libusb.h \
+        mocks/libusb_mock.h \
+        SharedFrameTest.hpp \
+        ../src/SharedFrame.hpp
+    LIBS += -lrt
+}
 
 #
 # PythonQt